@@ -0,0 +1,148 @@
+#ifndef BOUNDEDSPSCQUEUE_HPP
+#define BOUNDEDSPSCQUEUE_HPP
+
+// C++ standard libraries
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+/**
+ * A bounded queue to pass values from a single producer thread to a single consumer thread, e.g., between two stages of a pipeline. Pushing and popping
+ * are lock-free as long as the queue is neither full nor empty; a thread only sleeps (on a condition variable) when it has to wait for the other.
+ *
+ * Either side can close the queue: the producer closes it once it has no more values, while the consumer can close it to make the producer stop early.
+ * Values pushed before the queue was closed can still be popped.
+ * @tparam ValueType The type of value contained in the queue. It must be default constructible and move assignable.
+ */
+template <typename ValueType>
+class BoundedSPSCQueue {
+public:
+    // Constructors
+    explicit BoundedSPSCQueue (size_t capacity) : m_capacity(capacity), m_values(std::make_unique<ValueType[]>(capacity)), m_head(0), m_tail(0),
+            m_is_closed(false), m_num_waiters(0) {}
+
+    // Delete copy & move constructors and assignment operators
+    BoundedSPSCQueue (const BoundedSPSCQueue&) = delete;
+    BoundedSPSCQueue (BoundedSPSCQueue&&) = delete;
+    BoundedSPSCQueue& operator= (const BoundedSPSCQueue&) = delete;
+    BoundedSPSCQueue& operator= (BoundedSPSCQueue&&) = delete;
+
+    // Methods
+    /**
+     * Pushes the given value to the back of the queue, waiting while the queue is full. Must only be called by the producer.
+     * @param value
+     * @return false if the queue was closed (in which case the value isn't pushed), true otherwise
+     */
+    bool push (ValueType&& value);
+    /**
+     * Pops the value at the front of the queue, waiting while the queue is empty. Must only be called by the consumer.
+     * @param value Returns the popped value
+     * @return false if the queue is empty and was closed, true otherwise
+     */
+    bool pop (ValueType& value);
+
+    /**
+     * Closes the queue and wakes any waiting thread
+     */
+    void close ();
+
+private:
+    // Methods
+    /**
+     * Sleeps until the given predicate is satisfied
+     * @tparam Predicate
+     * @param predicate
+     */
+    template <typename Predicate>
+    void wait_until (Predicate predicate);
+    /**
+     * Wakes the other side if it's waiting
+     */
+    void notify_waiters ();
+
+    // Variables
+    size_t m_capacity;
+    std::unique_ptr<ValueType[]> m_values;
+
+    // Positions of the next value to pop and the next value to push respectively. They increase monotonically, so the queue is empty when they're
+    // equal and full when they're m_capacity apart.
+    // NOTE: These (along with m_is_closed and m_num_waiters) use sequentially-consistent operations so that a thread which is about to sleep always
+    // either sees the other side's update or is seen as a waiter by it.
+    std::atomic_size_t m_head;
+    std::atomic_size_t m_tail;
+    std::atomic_bool m_is_closed;
+
+    std::atomic_size_t m_num_waiters;
+    std::mutex m_mutex;
+    std::condition_variable m_condition_variable;
+};
+
+template <typename ValueType>
+bool BoundedSPSCQueue<ValueType>::push (ValueType&& value) {
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    auto is_not_full = [this, tail] () { return tail - m_head.load() < m_capacity || m_is_closed.load(); };
+    if (false == is_not_full()) {
+        wait_until(is_not_full);
+    }
+    if (m_is_closed.load()) {
+        return false;
+    }
+
+    m_values[tail % m_capacity] = std::move(value);
+    m_tail.store(tail + 1);
+    notify_waiters();
+    return true;
+}
+
+template <typename ValueType>
+bool BoundedSPSCQueue<ValueType>::pop (ValueType& value) {
+    auto head = m_head.load(std::memory_order_relaxed);
+    auto is_not_empty = [this, head] () { return m_tail.load() != head || m_is_closed.load(); };
+    if (false == is_not_empty()) {
+        wait_until(is_not_empty);
+    }
+    // NOTE: We check the tail again since the producer may push values and then close the queue
+    if (m_tail.load() == head) {
+        return false;
+    }
+
+    value = std::move(m_values[head % m_capacity]);
+    m_head.store(head + 1);
+    notify_waiters();
+    return true;
+}
+
+template <typename ValueType>
+void BoundedSPSCQueue<ValueType>::close () {
+    m_is_closed.store(true);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition_variable.notify_all();
+}
+
+template <typename ValueType>
+template <typename Predicate>
+void BoundedSPSCQueue<ValueType>::wait_until (Predicate predicate) {
+    m_num_waiters.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition_variable.wait(lock, predicate);
+    }
+    m_num_waiters.fetch_sub(1);
+}
+
+template <typename ValueType>
+void BoundedSPSCQueue<ValueType>::notify_waiters () {
+    if (m_num_waiters.load() > 0) {
+        // Acquire the mutex so that the waiter is either already asleep or hasn't yet checked its predicate
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_condition_variable.notify_all();
+    }
+}
+
+#endif // BOUNDEDSPSCQUEUE_HPP
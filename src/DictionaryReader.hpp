@@ -13,6 +13,7 @@
 #include "DictionaryEntry.hpp"
 #include "FileReader.hpp"
 #include "Profiler.hpp"
+#include "streaming_archive/ColumnEncoding.hpp"
 #include "streaming_compression/zstd/Decompressor.hpp"
 #include "Utils.hpp"
 
@@ -96,6 +97,7 @@ protected:
     // Methods
     /**
      * Reads a segment's worth of IDs from the segment index
+     * @throw DictionaryReader::OperationFailed if the IDs are corrupt
      */
     void read_segment_ids ();
 
@@ -147,6 +149,11 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_new_entries () {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
+    // Read segment index header
+    // NOTE: We read this before the dictionary since the writer adds a segment's entries to the dictionary before it indexes the segment. So if the
+    // archive is still being written, the dictionary we read will contain every entry that the counted segments refer to.
+    auto num_segments = read_segment_index_header(m_segment_index_file_reader);
+
     // Read dictionary header
     auto num_dictionary_entries = read_dictionary_header(m_dictionary_file_reader);
 
@@ -168,9 +175,6 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_new_entries () {
     }
 
     PROFILER_FRAGMENTED_MEASUREMENT_START(SegmentIndexRead)
-    // Read segment index header
-    auto num_segments = read_segment_index_header(m_segment_index_file_reader);
-
     // Validate segment index header
     if (num_segments < m_num_segments_read_from_index) {
         throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
@@ -181,6 +185,7 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_new_entries () {
         for (size_t i = m_num_segments_read_from_index; i < num_segments; ++i) {
             read_segment_ids();
         }
+        m_num_segments_read_from_index = num_segments;
     }
     PROFILER_FRAGMENTED_MEASUREMENT_STOP(SegmentIndexRead)
 }
@@ -243,14 +248,48 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_segment_ids () {
 
     uint64_t num_ids;
     m_segment_index_decompressor.read_numeric_value(num_ids, false);
-    for (uint64_t i = 0; i < num_ids; ++i) {
-        DictionaryIdType id;
-        m_segment_index_decompressor.read_numeric_value(id, false);
-        if (id >= m_entries.size()) {
+    uint64_t num_runs;
+    m_segment_index_decompressor.read_numeric_value(num_runs, false);
+    uint64_t encoded_runs_length;
+    m_segment_index_decompressor.read_numeric_value(encoded_runs_length, false);
+    if (num_ids > m_entries.size() || num_runs > num_ids ||
+        encoded_runs_length > streaming_archive::column_encoding::get_max_delta_varints_length(2 * num_runs))
+    {
+        throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+    }
+
+    // Decode the first ID of each run followed by the length of each run
+    std::vector<char> encoded_runs(encoded_runs_length);
+    if (encoded_runs_length > 0) {
+        m_segment_index_decompressor.read_exact_length(encoded_runs.data(), encoded_runs_length, false);
+    }
+    std::vector<int64_t> run_first_ids_and_lengths(2 * num_runs);
+    if (ErrorCode_Success != streaming_archive::column_encoding::try_decode_delta_varints(encoded_runs.data(), encoded_runs_length, 2 * num_runs,
+                                                                                         run_first_ids_and_lengths.data()))
+    {
+        throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+    }
+
+    uint64_t min_first_id = 0;
+    uint64_t num_ids_in_runs = 0;
+    for (uint64_t run_ix = 0; run_ix < num_runs; ++run_ix) {
+        auto first_id = run_first_ids_and_lengths[run_ix];
+        auto length = run_first_ids_and_lengths[num_runs + run_ix];
+        // Runs must be sorted, disjoint, and refer to existing entries
+        if (first_id < static_cast<int64_t>(min_first_id) || static_cast<uint64_t>(first_id) >= m_entries.size() || length <= 0 ||
+            static_cast<uint64_t>(length) > m_entries.size() - first_id)
+        {
             throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
         }
 
-        m_entries[id].add_segment_containing_entry(segment_id);
+        for (auto id = static_cast<uint64_t>(first_id); id < static_cast<uint64_t>(first_id + length); ++id) {
+            m_entries[id].add_segment_containing_entry(segment_id);
+        }
+        min_first_id = first_id + length;
+        num_ids_in_runs += length;
+    }
+    if (num_ids_in_runs != num_ids) {
+        throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
     }
 }
 
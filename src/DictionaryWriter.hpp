@@ -2,7 +2,15 @@
 #define DICTIONARYWRITER_HPP
 
 // C++ standard libraries
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
@@ -12,11 +20,20 @@
 // Project headers
 #include "Defs.h"
 #include "FileWriter.hpp"
+#include "streaming_archive/ColumnEncoding.hpp"
 #include "streaming_compression/zstd/Compressor.hpp"
 #include "TraceableException.hpp"
 
 /**
  * Template class for performing operations on dictionaries and writing them to disk
+ *
+ * Entries can be added and looked up from multiple threads concurrently, so several encoders can fill the same dictionary:
+ * - Values are mapped to entries by a lock-striped hash table, so threads only contend when adding values which fall in the same shard. Each shard is
+ *   a flat open-addressing table of (hash, entry) pairs, so a lookup only compares values whose hashes match.
+ * - Each thread keeps a small direct-mapped cache of the entries it recently looked up, so repeated values don't need to lock any shard.
+ * - IDs are allocated under a single commit lock. Since IDs are sequential, entries are stored by ID in an arena, which can be read without locking.
+ *   Entries are thus committed in ID order, which is the order readers expect them on disk, regardless of how threads interleave.
+ * Opening, closing, and indexing segments must not happen concurrently with other operations.
  * @tparam DictionaryIdType
  * @tparam EntryType
  */
@@ -36,7 +53,7 @@ public:
     };
 
     // Constructors
-    DictionaryWriter () : m_is_open(false) {}
+    DictionaryWriter () : m_is_open(false), m_num_committed_entries(0), m_generation(get_new_generation()), m_data_size(0) {}
 
     ~DictionaryWriter ();
 
@@ -65,7 +82,8 @@ public:
     void write_uncommitted_entries_to_disk ();
 
     /**
-     * Adds the given segment and IDs to the segment index
+     * Adds the given segment and IDs to the segment index. The IDs are stored as a run-length encoded bitmap, i.e., the first ID and length of each
+     * run of consecutive IDs. Since IDs are allocated in order, the entries first seen in a segment form long runs.
      * @param segment_id
      * @param ids
      */
@@ -78,44 +96,194 @@ public:
     size_t get_on_disk_size () const { return m_dictionary_file_writer.get_pos() + m_segment_index_file_writer.get_pos(); }
 
     /**
-     * Gets the size (in-memory) of the data contained in the dictionary
+     * Gets the size (in-memory) of the dictionary, including the entries themselves and the tables used to look them up
      * @return
      */
-    size_t get_data_size () const { return m_data_size; }
+    size_t get_data_size () const { return m_data_size.load(std::memory_order_relaxed); }
 
 protected:
-    // Types
-    typedef std::unordered_map<std::string, EntryType*> value_to_entry_t;
-    typedef std::unordered_map<DictionaryIdType, EntryType*> id_to_entry_t;
+    // Methods
+    /**
+     * Gets the entry with the given value, creating it if it doesn't exist
+     * @tparam EntryCreator Callable with signature EntryType (DictionaryIdType id)
+     * @param value
+     * @param create_entry Called (under a lock) to create the entry with the given ID and the given value, if necessary
+     * @param is_new_entry Whether the entry was created
+     * @return Pointer to the entry
+     * @throw DictionaryWriter::OperationFailed if the dictionary has run out of IDs
+     */
+    template <typename EntryCreator>
+    EntryType* get_or_create_entry (std::string_view value, EntryCreator create_entry, bool& is_new_entry);
+
+    /**
+     * Marks all entries as committed, e.g., after they've been preloaded from disk
+     */
+    void mark_all_entries_committed ();
 
     // Variables
     bool m_is_open;
 
     // Variables related to on-disk storage
-    std::vector<EntryType*> m_uncommitted_entries;
     FileWriter m_dictionary_file_writer;
     streaming_compression::zstd::Compressor m_dictionary_compressor;
     FileWriter m_segment_index_file_writer;
     streaming_compression::zstd::Compressor m_segment_index_compressor;
     size_t m_num_segments_in_index;
 
-    value_to_entry_t m_value_to_entry;
-    id_to_entry_t  m_id_to_entry;
-    DictionaryIdType m_next_id;
     DictionaryIdType m_max_id;
 
-    // Size (in-memory) of the data contained in the dictionary
-    size_t m_data_size;
+private:
+    // Constants
+    static constexpr size_t cNumShards = 64;
+    static constexpr size_t cMinShardCapacity = 16;
+    static constexpr size_t cFrontCacheSize = 1024;
+
+    // Types
+    /**
+     * A slot in a shard's hash table. The slot is empty if entry is nullptr.
+     */
+    struct HashTableSlot {
+        size_t hash;
+        EntryType* entry;
+    };
+
+    /**
+     * A shard of the value-to-entry table. The shard is an open-addressing table with linear probing, whose capacity is always zero or a power of two.
+     */
+    struct Shard {
+        Shard () : num_entries(0) {}
+
+        std::mutex mutex;
+        std::vector<HashTableSlot> slots;
+        size_t num_entries;
+    };
+
+    /**
+     * A slot in a thread's front cache. The slot is only valid if its generation matches the dictionary's generation.
+     */
+    struct FrontCacheSlot {
+        uint64_t generation;
+        EntryType* entry;
+    };
+
+    /**
+     * Arena storing entries by ID, which can be read concurrently with a single writer. Entries are stored in chunks whose sizes double, so the arena can
+     * grow without moving (and invalidating) existing entries.
+     */
+    class EntryArena {
+    public:
+        // Constructors
+        EntryArena () : m_chunks(), m_size(0) {}
+
+        // Destructor
+        ~EntryArena () { clear(); }
+
+        // Delete copy & move constructors and assignment operators
+        EntryArena (const EntryArena&) = delete;
+        EntryArena (EntryArena&&) = delete;
+        EntryArena& operator= (const EntryArena&) = delete;
+        EntryArena& operator= (EntryArena&&) = delete;
+
+        // Methods
+        /**
+         * @return The number of entries in the arena
+         */
+        size_t size () const { return m_size.load(std::memory_order_acquire); }
+
+        /**
+         * Gets the entry with the given ID
+         * @param id
+         * @return Pointer to the entry, or nullptr if there's no entry with the given ID
+         */
+        EntryType* get (size_t id) const;
+        /**
+         * Creates an entry with the next ID in the arena. Must not be called concurrently with itself or clear.
+         * @tparam EntryCreator Callable with signature EntryType (DictionaryIdType id)
+         * @param create_entry
+         * @return Pointer to the new entry
+         * @throw DictionaryWriter::OperationFailed if the arena is full
+         */
+        template <typename EntryCreator>
+        EntryType* emplace_back (EntryCreator create_entry);
+        /**
+         * Destroys all entries and frees the arena's memory. Must not be called concurrently with any other method.
+         */
+        void clear ();
+
+    private:
+        // Constants
+        static constexpr size_t cFirstChunkSize = 256;
+        static constexpr size_t cMaxNumChunks = 48;
+
+        // Methods
+        /**
+         * Locates the entry with the given ID
+         * @param id
+         * @param chunk_ix
+         * @param entry_ix Index of the entry within its chunk
+         */
+        static void locate (size_t id, size_t& chunk_ix, size_t& entry_ix);
+
+        // Variables
+        std::array<std::atomic<EntryType*>, cMaxNumChunks> m_chunks;
+        std::atomic_size_t m_size;
+    };
+
+    // Methods
+    /**
+     * @return A generation number which hasn't been used by any dictionary before
+     */
+    static uint64_t get_new_generation ();
+    /**
+     * @return The calling thread's front cache
+     */
+    static FrontCacheSlot* get_front_cache ();
+
+    /**
+     * Finds the entry with the given value in the given shard
+     * @param shard
+     * @param hash Hash of the value
+     * @param value
+     * @return Pointer to the entry if found, nullptr otherwise
+     */
+    static EntryType* find_in_shard (const Shard& shard, size_t hash, std::string_view value);
+    /**
+     * Inserts the given entry into the given shard, growing the shard if necessary
+     * @param shard
+     * @param hash Hash of the entry's value
+     * @param entry
+     */
+    void insert_into_shard (Shard& shard, size_t hash, EntryType* entry);
+
+    /**
+     * Deletes all entries and clears all tables
+     */
+    void delete_entries ();
+
+    // Variables
+    EntryArena m_entries;
+    // Entries with IDs below this have been written to disk
+    size_t m_num_committed_entries;
+
+    // Generation of the entries in this dictionary, used to invalidate front cache slots when the dictionary is closed or destroyed
+    uint64_t m_generation;
+
+    std::array<Shard, cNumShards> m_shards;
+
+    // Lock protecting ID allocation, committing entries, and the dictionary's files
+    // NOTE: When both a shard's lock and this lock are acquired, the shard's lock must be acquired first
+    std::mutex m_commit_mutex;
+
+    // Size (in-memory) of the dictionary
+    std::atomic_size_t m_data_size;
 };
 
 template <typename DictionaryIdType, typename EntryType>
 DictionaryWriter<DictionaryIdType, EntryType>::~DictionaryWriter () {
-    if (false == m_uncommitted_entries.empty()) {
+    if (m_entries.size() > m_num_committed_entries) {
         SPDLOG_ERROR("DictionaryWriter contains uncommitted entries while being destroyed - possible data loss.");
     }
-    for (const auto& value_entry_pair : m_value_to_entry) {
-        delete value_entry_pair.second;
-    }
+    delete_entries();
 }
 
 template <typename DictionaryIdType, typename EntryType>
@@ -137,7 +305,10 @@ void DictionaryWriter<DictionaryIdType, EntryType>::open (const std::string& dic
     m_segment_index_compressor.open(m_segment_index_file_writer);
     m_num_segments_in_index = 0;
 
-    m_next_id = 0;
+    // Flush the headers so the dictionary can be read while it's still being written
+    m_dictionary_file_writer.flush();
+    m_segment_index_file_writer.flush();
+
     m_max_id = max_id;
 
     m_data_size = 0;
@@ -157,12 +328,10 @@ void DictionaryWriter<DictionaryIdType, EntryType>::close () {
     m_dictionary_compressor.close();
     m_dictionary_file_writer.close();
 
-    // Delete entries and clear maps
-    for (const auto& value_entry_pair : m_value_to_entry) {
-        delete value_entry_pair.second;
-    }
-    m_id_to_entry.clear();
-    m_value_to_entry.clear();
+    delete_entries();
+    // Invalidate any entries cached by threads
+    m_generation = get_new_generation();
+    m_data_size = 0;
 
     m_is_open = false;
 }
@@ -173,10 +342,11 @@ const EntryType* DictionaryWriter<DictionaryIdType, EntryType>::get_entry (Dicti
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
-    if (m_id_to_entry.count(id) == 0) {
+    auto entry = m_entries.get(id);
+    if (nullptr == entry) {
         throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
     }
-    return m_id_to_entry.at(id);
+    return entry;
 }
 
 template <typename DictionaryIdType, typename EntryType>
@@ -185,26 +355,28 @@ void DictionaryWriter<DictionaryIdType, EntryType>::write_uncommitted_entries_to
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
-    if (m_uncommitted_entries.empty()) {
+    std::lock_guard<std::mutex> lock(m_commit_mutex);
+    auto num_entries = m_entries.size();
+    if (num_entries == m_num_committed_entries) {
         // Nothing to do
         return;
     }
 
-    for (auto entry : m_uncommitted_entries) {
-        entry->write_to_file(m_dictionary_compressor);
+    for (auto id = m_num_committed_entries; id < num_entries; ++id) {
+        m_entries.get(id)->write_to_file(m_dictionary_compressor);
     }
+    // NOTE: We flush the compressor before updating the header, so that readers of an archive that's still being written never see a header which
+    // counts entries that aren't in the file yet
+    m_dictionary_compressor.flush();
 
     // Update header
     auto dictionary_file_writer_pos = m_dictionary_file_writer.get_pos();
     m_dictionary_file_writer.seek_from_begin(0);
-    m_dictionary_file_writer.write_numeric_value<uint64_t>(m_id_to_entry.size());
+    m_dictionary_file_writer.write_numeric_value<uint64_t>(num_entries);
     m_dictionary_file_writer.seek_from_begin(dictionary_file_writer_pos);
 
-    m_segment_index_compressor.flush();
-    m_segment_index_file_writer.flush();
-    m_dictionary_compressor.flush();
     m_dictionary_file_writer.flush();
-    m_uncommitted_entries.clear();
+    m_num_committed_entries = num_entries;
 }
 
 template <typename DictionaryIdType, typename EntryType>
@@ -213,21 +385,212 @@ void DictionaryWriter<DictionaryIdType, EntryType>::index_segment (segment_id_t
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
+    std::lock_guard<std::mutex> lock(m_commit_mutex);
     m_segment_index_compressor.write_numeric_value(segment_id);
 
     // NOTE: The IDs in `ids` are not validated to exist in this dictionary since we perform validation when loading the dictionary.
-    m_segment_index_compressor.write_numeric_value<uint64_t>(ids.size());
-    for (auto id : ids) {
-        m_segment_index_compressor.write_numeric_value(id);
+    std::vector<DictionaryIdType> sorted_ids(ids.cbegin(), ids.cend());
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+    std::vector<int64_t> run_first_ids;
+    std::vector<int64_t> run_lengths;
+    for (size_t i = 0; i < sorted_ids.size(); ++i) {
+        if (i > 0 && sorted_ids[i - 1] + 1 == sorted_ids[i]) {
+            ++run_lengths.back();
+        } else {
+            run_first_ids.push_back(sorted_ids[i]);
+            run_lengths.push_back(1);
+        }
     }
+    // Delta-encode the first IDs followed by the lengths
+    auto num_runs = run_first_ids.size();
+    run_first_ids.insert(run_first_ids.cend(), run_lengths.cbegin(), run_lengths.cend());
+    std::vector<char> encoded_runs(streaming_archive::column_encoding::get_max_delta_varints_length(run_first_ids.size()));
+    auto encoded_runs_length = streaming_archive::column_encoding::encode_delta_varints(run_first_ids.data(), run_first_ids.size(), encoded_runs.data());
+
+    m_segment_index_compressor.write_numeric_value<uint64_t>(ids.size());
+    m_segment_index_compressor.write_numeric_value<uint64_t>(num_runs);
+    m_segment_index_compressor.write_numeric_value<uint64_t>(encoded_runs_length);
+    m_segment_index_compressor.write(encoded_runs.data(), encoded_runs_length);
 
     ++m_num_segments_in_index;
+    // NOTE: As with the dictionary, we flush the compressor before updating the header so that the header never counts segments that aren't in the file
+    m_segment_index_compressor.flush();
 
     // Update header
     auto segment_index_file_writer_pos = m_segment_index_file_writer.get_pos();
     m_segment_index_file_writer.seek_from_begin(0);
     m_segment_index_file_writer.write_numeric_value<uint64_t>(m_num_segments_in_index);
     m_segment_index_file_writer.seek_from_begin(segment_index_file_writer_pos);
+
+    m_segment_index_file_writer.flush();
+}
+
+template <typename DictionaryIdType, typename EntryType>
+template <typename EntryCreator>
+EntryType* DictionaryWriter<DictionaryIdType, EntryType>::get_or_create_entry (std::string_view value, EntryCreator create_entry, bool& is_new_entry) {
+    auto hash = std::hash<std::string_view>{}(value);
+
+    auto& front_cache_slot = get_front_cache()[hash % cFrontCacheSize];
+    if (m_generation == front_cache_slot.generation && front_cache_slot.entry->get_value() == value) {
+        is_new_entry = false;
+        return front_cache_slot.entry;
+    }
+
+    EntryType* entry;
+    auto& shard = m_shards[(hash / cFrontCacheSize) % cNumShards];
+    {
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        entry = find_in_shard(shard, hash, value);
+        if (nullptr != entry) {
+            is_new_entry = false;
+        } else {
+            std::lock_guard<std::mutex> commit_lock(m_commit_mutex);
+            DictionaryIdType next_id = m_entries.size();
+            if (next_id > m_max_id) {
+                SPDLOG_ERROR("DictionaryWriter ran out of IDs.");
+                throw OperationFailed(ErrorCode_OutOfBounds, __FILENAME__, __LINE__);
+            }
+
+            entry = m_entries.emplace_back(create_entry);
+            insert_into_shard(shard, hash, entry);
+
+            // TODO: This doesn't account for the segment index that's constantly updated
+            m_data_size.fetch_add(sizeof(EntryType) + entry->get_data_size(), std::memory_order_relaxed);
+
+            is_new_entry = true;
+        }
+    }
+
+    front_cache_slot.generation = m_generation;
+    front_cache_slot.entry = entry;
+    return entry;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryWriter<DictionaryIdType, EntryType>::mark_all_entries_committed () {
+    std::lock_guard<std::mutex> lock(m_commit_mutex);
+    m_num_committed_entries = m_entries.size();
+}
+
+template <typename DictionaryIdType, typename EntryType>
+uint64_t DictionaryWriter<DictionaryIdType, EntryType>::get_new_generation () {
+    // NOTE: Generations start at 1 so that zero-initialized front cache slots are never valid
+    static std::atomic<uint64_t> next_generation(1);
+    return next_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename DictionaryIdType, typename EntryType>
+typename DictionaryWriter<DictionaryIdType, EntryType>::FrontCacheSlot* DictionaryWriter<DictionaryIdType, EntryType>::get_front_cache () {
+    thread_local std::array<FrontCacheSlot, cFrontCacheSize> front_cache{};
+    return front_cache.data();
+}
+
+template <typename DictionaryIdType, typename EntryType>
+EntryType* DictionaryWriter<DictionaryIdType, EntryType>::find_in_shard (const Shard& shard, size_t hash, std::string_view value) {
+    if (shard.slots.empty()) {
+        return nullptr;
+    }
+
+    // NOTE: The low bits of the hash were used to pick the front cache slot and the shard, so we use the remaining bits
+    auto mask = shard.slots.size() - 1;
+    for (auto slot_ix = (hash / cFrontCacheSize / cNumShards) & mask; nullptr != shard.slots[slot_ix].entry; slot_ix = (slot_ix + 1) & mask) {
+        const auto& slot = shard.slots[slot_ix];
+        if (slot.hash == hash && slot.entry->get_value() == value) {
+            return slot.entry;
+        }
+    }
+    return nullptr;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryWriter<DictionaryIdType, EntryType>::insert_into_shard (Shard& shard, size_t hash, EntryType* entry) {
+    // Keep the load factor at or below 3/4
+    auto capacity = shard.slots.size();
+    if ((shard.num_entries + 1) * 4 > capacity * 3) {
+        auto new_capacity = std::max(cMinShardCapacity, capacity * 2);
+        std::vector<HashTableSlot> old_slots(new_capacity, HashTableSlot{0, nullptr});
+        old_slots.swap(shard.slots);
+        shard.num_entries = 0;
+        for (const auto& slot : old_slots) {
+            if (nullptr != slot.entry) {
+                insert_into_shard(shard, slot.hash, slot.entry);
+            }
+        }
+        m_data_size.fetch_add((new_capacity - capacity) * sizeof(HashTableSlot), std::memory_order_relaxed);
+    }
+
+    auto mask = shard.slots.size() - 1;
+    auto slot_ix = (hash / cFrontCacheSize / cNumShards) & mask;
+    while (nullptr != shard.slots[slot_ix].entry) {
+        slot_ix = (slot_ix + 1) & mask;
+    }
+    shard.slots[slot_ix] = HashTableSlot{hash, entry};
+    ++shard.num_entries;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryWriter<DictionaryIdType, EntryType>::delete_entries () {
+    for (auto& shard : m_shards) {
+        std::vector<HashTableSlot>().swap(shard.slots);
+        shard.num_entries = 0;
+    }
+    m_entries.clear();
+    m_num_committed_entries = 0;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+EntryType* DictionaryWriter<DictionaryIdType, EntryType>::EntryArena::get (size_t id) const {
+    if (id >= size()) {
+        return nullptr;
+    }
+    size_t chunk_ix;
+    size_t entry_ix;
+    locate(id, chunk_ix, entry_ix);
+    return m_chunks[chunk_ix].load(std::memory_order_acquire) + entry_ix;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+template <typename EntryCreator>
+EntryType* DictionaryWriter<DictionaryIdType, EntryType>::EntryArena::emplace_back (EntryCreator create_entry) {
+    auto id = m_size.load(std::memory_order_relaxed);
+    size_t chunk_ix;
+    size_t entry_ix;
+    locate(id, chunk_ix, entry_ix);
+    if (chunk_ix >= cMaxNumChunks) {
+        throw OperationFailed(ErrorCode_OutOfBounds, __FILENAME__, __LINE__);
+    }
+    auto chunk = m_chunks[chunk_ix].load(std::memory_order_relaxed);
+    if (nullptr == chunk) {
+        chunk = static_cast<EntryType*>(::operator new(sizeof(EntryType) * (cFirstChunkSize << chunk_ix)));
+        m_chunks[chunk_ix].store(chunk, std::memory_order_release);
+    }
+
+    auto entry = new (chunk + entry_ix) EntryType(create_entry(static_cast<DictionaryIdType>(id)));
+    // Publish the entry to readers
+    m_size.store(id + 1, std::memory_order_release);
+    return entry;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryWriter<DictionaryIdType, EntryType>::EntryArena::clear () {
+    auto num_entries = m_size.load(std::memory_order_relaxed);
+    for (size_t id = 0; id < num_entries; ++id) {
+        get(id)->~EntryType();
+    }
+    m_size.store(0, std::memory_order_relaxed);
+
+    for (auto& chunk : m_chunks) {
+        ::operator delete(chunk.load(std::memory_order_relaxed));
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryWriter<DictionaryIdType, EntryType>::EntryArena::locate (size_t id, size_t& chunk_ix, size_t& entry_ix) {
+    // Chunk i holds cFirstChunkSize * 2^i entries starting from ID cFirstChunkSize * (2^i - 1)
+    uint64_t chunk_num = id / cFirstChunkSize + 1;
+    chunk_ix = 63 - __builtin_clzll(chunk_num);
+    entry_ix = id - cFirstChunkSize * ((uint64_t{1} << chunk_ix) - 1);
 }
 
 #endif // DICTIONARYWRITER_HPP
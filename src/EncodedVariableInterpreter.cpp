@@ -10,8 +10,10 @@
 // Project headers
 #include "Defs.h"
 #include "Utils.hpp"
+#include "VariableTokenizer.hpp"
 
 using std::string;
+using std::string_view;
 using std::unordered_set;
 using std::vector;
 
@@ -36,7 +38,7 @@ variable_dictionary_id_t EncodedVariableInterpreter::decode_var_dict_id (encoded
     return id;
 }
 
-bool EncodedVariableInterpreter::convert_string_to_representable_integer_var (const string& value, encoded_variable_t& encoded_var) {
+bool EncodedVariableInterpreter::convert_string_to_representable_integer_var (string_view value, encoded_variable_t& encoded_var) {
     size_t length = value.length();
     if (0 == length) {
         // Empty string cannot be converted
@@ -75,7 +77,7 @@ bool EncodedVariableInterpreter::convert_string_to_representable_integer_var (co
     return true;
 }
 
-bool EncodedVariableInterpreter::convert_string_to_representable_double_var (const string& value, uint8_t& num_integer_digits, uint8_t& num_fractional_digits,
+bool EncodedVariableInterpreter::convert_string_to_representable_double_var (string_view value, uint8_t& num_integer_digits, uint8_t& num_fractional_digits,
                                                                              encoded_variable_t& encoded_var)
 {
     size_t length = value.length();
@@ -137,18 +139,20 @@ bool EncodedVariableInterpreter::convert_string_to_representable_double_var (con
     return true;
 }
 
-void EncodedVariableInterpreter::encode_and_add_to_dictionary (const string& message, LogTypeDictionaryEntry& logtype_dict_entry,
+void EncodedVariableInterpreter::encode_and_add_to_dictionary (string_view message, LogTypeDictionaryEntry& logtype_dict_entry,
                                                                VariableDictionaryWriter& var_dict, vector<encoded_variable_t>& encoded_vars)
 {
     // Extract all variables and add to dictionary while building logtype
     size_t tok_begin_pos = 0;
     size_t next_delim_pos = 0;
     size_t last_var_end_pos = 0;
-    string var_str;
+    string_view var_str;
+    encoded_vars.clear();
     logtype_dict_entry.clear();
     // To avoid reallocating the logtype as we append to it, reserve enough space to hold the entire message
     logtype_dict_entry.reserve_constant_length(message.length());
-    while (logtype_dict_entry.parse_next_var(message, tok_begin_pos, next_delim_pos, last_var_end_pos, var_str)) {
+    VariableTokenizer tokenizer(message);
+    while (logtype_dict_entry.parse_next_var(tokenizer, tok_begin_pos, next_delim_pos, last_var_end_pos, var_str)) {
         // Encode variable
         encoded_variable_t encoded_var;
         uint8_t num_integer_digits;
@@ -3,6 +3,7 @@
 
 // C++ standard libraries
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Project headers
@@ -50,7 +51,7 @@ public:
      * @param encoded_var
      * @return true if was successfully converted, false otherwise
      */
-    static bool convert_string_to_representable_integer_var (const std::string& value, encoded_variable_t& encoded_var);
+    static bool convert_string_to_representable_integer_var (std::string_view value, encoded_variable_t& encoded_var);
     /**
      * Converts the given string into a representable double variable if possible
      * @param value
@@ -58,17 +59,18 @@ public:
      * @param num_fractional_digits Number of digits after the decimal point
      * @return true if was successfully converted, false otherwise
      */
-    static bool convert_string_to_representable_double_var (const std::string& value, uint8_t& num_integer_digits, uint8_t& num_fractional_digits,
+    static bool convert_string_to_representable_double_var (std::string_view value, uint8_t& num_integer_digits, uint8_t& num_fractional_digits,
                                                             encoded_variable_t& encoded_var);
 
     /**
      * Parses all variables from a message (while constructing the logtype) and encodes them (adding them to the variable dictionary if necessary)
+     * NOTE: To avoid allocations, callers should reuse the same logtype_dict_entry and encoded_vars across messages
      * @param message
      * @param logtype_dict_entry
      * @param var_dict
-     * @param encoded_vars
+     * @param encoded_vars Cleared and then filled with the encoded variables
      */
-    static void encode_and_add_to_dictionary (const std::string& message, LogTypeDictionaryEntry& logtype_dict_entry, VariableDictionaryWriter& var_dict,
+    static void encode_and_add_to_dictionary (std::string_view message, LogTypeDictionaryEntry& logtype_dict_entry, VariableDictionaryWriter& var_dict,
                                               std::vector<encoded_variable_t>& encoded_vars);
     /**
      * Decodes all variables and decompresses them into a message
@@ -0,0 +1,87 @@
+#include "FileDescriptorReader.hpp"
+
+// C standard libraries
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+// C++ standard libraries
+#include <cerrno>
+
+ErrorCode FileDescriptorReader::try_get_pos (size_t& pos) {
+    if (-1 == m_fd) {
+        return ErrorCode_NotInit;
+    }
+
+    pos = m_pos;
+    return ErrorCode_Success;
+}
+
+ErrorCode FileDescriptorReader::try_seek_from_begin (size_t pos) {
+    return ErrorCode_Unsupported;
+}
+
+ErrorCode FileDescriptorReader::try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) {
+    if (-1 == m_fd) {
+        return ErrorCode_NotInit;
+    }
+    if (nullptr == buf) {
+        return ErrorCode_BadParam;
+    }
+    if (m_is_at_eof) {
+        return ErrorCode_EndOfFile;
+    }
+
+    while (true) {
+        if (m_read_timeout_ms >= 0) {
+            struct pollfd poll_fd = {};
+            poll_fd.fd = m_fd;
+            poll_fd.events = POLLIN;
+            auto retval = poll(&poll_fd, 1, m_read_timeout_ms);
+            if (-1 == retval) {
+                if (EINTR == errno) {
+                    continue;
+                }
+                return ErrorCode_errno;
+            }
+            if (0 == retval) {
+                return ErrorCode_NotReady;
+            }
+            // NOTE: If the poll returned an error or hang-up event, the read below will report it
+        }
+
+        auto retval = ::read(m_fd, buf, num_bytes_to_read);
+        if (-1 == retval) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return ErrorCode_errno;
+        }
+        if (0 == retval) {
+            m_is_at_eof = true;
+            return ErrorCode_EndOfFile;
+        }
+
+        num_bytes_read = retval;
+        m_pos += num_bytes_read;
+        return ErrorCode_Success;
+    }
+}
+
+void FileDescriptorReader::open (int fd, int read_timeout_ms) {
+    if (-1 != m_fd) {
+        throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+    }
+    if (-1 == fcntl(fd, F_GETFD)) {
+        throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+    }
+
+    m_fd = fd;
+    m_read_timeout_ms = read_timeout_ms;
+    m_pos = 0;
+    m_is_at_eof = false;
+}
+
+void FileDescriptorReader::close () {
+    m_fd = -1;
+}
@@ -0,0 +1,84 @@
+#ifndef FILEDESCRIPTORREADER_HPP
+#define FILEDESCRIPTORREADER_HPP
+
+// C++ standard libraries
+#include <cstddef>
+
+// Project headers
+#include "ErrorCode.hpp"
+#include "ReaderInterface.hpp"
+#include "TraceableException.hpp"
+
+/**
+ * Class for reading from a file descriptor that may be a stream, e.g., stdin or a pipe. Unlike FileReader, a read returns as soon as any content is
+ * available rather than waiting to fill the caller's buffer, and it can time out so that the caller can do other work while the stream is idle.
+ */
+class FileDescriptorReader : public ReaderInterface {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException (error_code, filename, line_number) {}
+
+        // Methods
+        const char* what () const noexcept override {
+            return "FileDescriptorReader operation failed";
+        }
+    };
+
+    // Constructors
+    FileDescriptorReader () : m_fd(-1), m_read_timeout_ms(-1), m_pos(0), m_is_at_eof(false) {}
+
+    // Methods implementing the ReaderInterface
+    /**
+     * Tries to get the number of bytes read from the file descriptor so far
+     * @param pos
+     * @return ErrorCode_NotInit if the reader is not open
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_get_pos (size_t& pos) override;
+    /**
+     * Unsupported method
+     * @param pos
+     * @return ErrorCode_Unsupported
+     */
+    ErrorCode try_seek_from_begin (size_t pos) override;
+    /**
+     * Tries to read up to a given number of bytes from the file descriptor, returning as soon as some bytes are available
+     * @param buf
+     * @param num_bytes_to_read The number of bytes to try and read
+     * @param num_bytes_read The actual number of bytes read
+     * @return ErrorCode_NotInit if the reader is not open
+     * @return ErrorCode_BadParam if buf is invalid
+     * @return ErrorCode_NotReady if no content became available before the read timeout expired
+     * @return ErrorCode_errno on error
+     * @return ErrorCode_EndOfFile on EOF
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override;
+
+    // Methods
+    /**
+     * Opens the reader on the given file descriptor. The reader doesn't take ownership of the file descriptor.
+     * @param fd
+     * @param read_timeout_ms How long a read should wait for content before returning ErrorCode_NotReady, or a negative value to wait indefinitely
+     * @throw FileDescriptorReader::OperationFailed if the reader is already open or the file descriptor is invalid
+     */
+    void open (int fd, int read_timeout_ms);
+    void close ();
+
+    /**
+     * @return Whether the end of the stream has been reached
+     */
+    bool is_at_eof () const { return m_is_at_eof; }
+
+private:
+    // Variables
+    int m_fd;
+    int m_read_timeout_ms;
+    size_t m_pos;
+    bool m_is_at_eof;
+};
+
+#endif // FILEDESCRIPTORREADER_HPP
@@ -29,6 +29,8 @@ ErrorCode FileReader::try_read (char* buf, size_t num_bytes_to_read, size_t& num
         if (ferror(m_file)) {
             return ErrorCode_errno;
         } else if (feof(m_file)) {
+            // Clear EOF so that later reads return any content appended to the file since
+            clearerr(m_file);
             if (0 == num_bytes_read) {
                 return ErrorCode_EndOfFile;
             }
@@ -38,6 +40,35 @@ ErrorCode FileReader::try_read (char* buf, size_t num_bytes_to_read, size_t& num
     return ErrorCode_Success;
 }
 
+ErrorCode FileReader::try_read_at (size_t pos, char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) {
+    if (nullptr == m_file) {
+        return ErrorCode_NotInit;
+    }
+    if (nullptr == buf) {
+        return ErrorCode_BadParam;
+    }
+
+    num_bytes_read = 0;
+    while (num_bytes_read < num_bytes_to_read) {
+        auto retval = pread(fileno(m_file), buf + num_bytes_read, num_bytes_to_read - num_bytes_read, pos + num_bytes_read);
+        if (-1 == retval) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return ErrorCode_errno;
+        }
+        if (0 == retval) {
+            break;
+        }
+        num_bytes_read += retval;
+    }
+    if (0 == num_bytes_read && num_bytes_to_read > 0) {
+        return ErrorCode_EndOfFile;
+    }
+
+    return ErrorCode_Success;
+}
+
 ErrorCode FileReader::try_seek_from_begin (size_t pos) {
     if (nullptr == m_file) {
         return ErrorCode_NotInit;
@@ -72,6 +72,21 @@ public:
     ErrorCode try_read_to_delimiter (char delim, bool keep_delimiter, bool append, std::string& str) override;
 
     // Methods
+    /**
+     * Tries to read up to a given number of bytes starting at the given position in the file. Unlike try_read, this bypasses the reader's buffer, so
+     * it returns content that was changed after the reader buffered it. The position of the read head is unchanged.
+     * @param pos
+     * @param buf
+     * @param num_bytes_to_read The number of bytes to try and read
+     * @param num_bytes_read The actual number of bytes read
+     * @return ErrorCode_NotInit if the file is not open
+     * @return ErrorCode_BadParam if buf is invalid
+     * @return ErrorCode_errno on error
+     * @return ErrorCode_EndOfFile if pos is at or beyond the end of the file
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_read_at (size_t pos, char* buf, size_t num_bytes_to_read, size_t& num_bytes_read);
+
     bool is_open () const { return m_file != nullptr; }
 
     /**
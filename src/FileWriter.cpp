@@ -16,6 +16,8 @@
 
 using std::string;
 
+bool FileWriter::m_sync_on_flush = true;
+
 FileWriter::~FileWriter () {
     if (nullptr != m_file) {
         SPDLOG_ERROR("FileWriter not closed before being destroyed - may cause data loss");
@@ -50,6 +52,10 @@ void FileWriter::flush () {
         throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
     }
 
+    if (false == m_sync_on_flush) {
+        return;
+    }
+
     // Flush page cache pages to disk
     if (0 != fdatasync(m_fd)) {
         SPDLOG_ERROR("fdatasync failed, errno={}", errno);
@@ -42,7 +42,7 @@ public:
      */
     void write (const char* data, size_t data_length) override;
     /**
-     * Flushes the file
+     * Flushes the file's userspace buffers and, if enabled, syncs the file to disk
      * @throw FileWriter::OperationFailed on failure
      */
     void flush () override;
@@ -87,7 +87,18 @@ public:
      */
     void close ();
 
+    /**
+     * Sets whether every FileWriter syncs its file to disk when it's flushed. This is process-wide since it's disabled when the caller instead syncs
+     * everything it has written with one barrier (see streaming_archive::writer::Archive::DurabilityPolicy), so it should only be set before any
+     * files are written.
+     * @param sync_on_flush
+     */
+    static void set_sync_on_flush (bool sync_on_flush) { m_sync_on_flush = sync_on_flush; }
+
 private:
+    // Variables
+    static bool m_sync_on_flush;
+
     FILE* m_file;
     int m_fd;
 };
@@ -1,6 +1,7 @@
 #include "GlobalMetadataDB.hpp"
 
 // C++ standard libraries
+#include <mutex>
 #include <tuple>
 #include <utility>
 
@@ -20,11 +21,13 @@ enum class ArchivesTableFieldIndexes : uint16_t {
     Size,
     CreatorId,
     CreationIx,
+    NumCommittedSegments,
     Length,
 };
-enum class UpdateArchiveSizeStmtFieldIndexes : uint16_t {
+enum class UpdateArchiveMetadataStmtFieldIndexes : uint16_t {
     UncompressedSize = 0,
     Size,
+    NumCommittedSegments,
     Id,
     Length,
 };
@@ -95,14 +98,15 @@ static void create_tables (const vector<std::pair<string, string>>& archive_fiel
 }
 
 static SQLitePreparedStatement get_archives_select_statement (SQLiteDB& db) {
-    string statement_string = "SELECT " STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID
+    string statement_string = "SELECT " STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID "," STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_NUM_COMMITTED_SEGMENTS
             " FROM " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME;
 
     return db.prepare_statement(statement_string);
 }
 
 static SQLitePreparedStatement get_archives_for_file_select_statement (SQLiteDB& db, const string& file_path) {
-    string statement_string = "SELECT DISTINCT " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME "." STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID
+    string statement_string = "SELECT DISTINCT " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME "." STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID ","
+            STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME "." STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_NUM_COMMITTED_SEGMENTS
             " FROM " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME
             " JOIN " STREAMING_ARCHIVE_METADATA_DB_FILES_TABLE_NAME
             " ON " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME "." STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID
@@ -138,12 +142,19 @@ void GlobalMetadataDB::ArchiveIterator::get_id (string& id) const {
     m_statement.column_string(0, id);
 }
 
-void GlobalMetadataDB::open (const string& path) {
+size_t GlobalMetadataDB::ArchiveIterator::get_num_committed_segments () const {
+    return m_statement.column_int64(1);
+}
+
+void GlobalMetadataDB::open (const string& path, bool is_writer) {
     if (m_is_open) {
         throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
     }
 
     m_db.open(path);
+    if (is_writer) {
+        m_db.enable_write_ahead_logging();
+    }
 
     vector<pair<string, string>> archive_field_names_and_types(enum_to_underlying_type(ArchivesTableFieldIndexes::Length));
     archive_field_names_and_types[enum_to_underlying_type(ArchivesTableFieldIndexes::Id)].first = STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID;
@@ -168,6 +179,10 @@ void GlobalMetadataDB::open (const string& path) {
             STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATION_IX;
     archive_field_names_and_types[enum_to_underlying_type(ArchivesTableFieldIndexes::CreationIx)].second = "INTEGER";
 
+    archive_field_names_and_types[enum_to_underlying_type(ArchivesTableFieldIndexes::NumCommittedSegments)].first =
+            STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_NUM_COMMITTED_SEGMENTS;
+    archive_field_names_and_types[enum_to_underlying_type(ArchivesTableFieldIndexes::NumCommittedSegments)].second = "INTEGER";
+
     vector<pair<string, string>> file_field_names_and_types(enum_to_underlying_type(FilesTableFieldIndexes::Length));
     file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].first = STREAMING_ARCHIVE_METADATA_DB_FILE_ID;
     file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].second = "TEXT PRIMARY KEY";
@@ -213,16 +228,18 @@ void GlobalMetadataDB::open (const string& path) {
 
     m_insert_archive_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement(statement_string));
 
-    vector<string> update_archive_size_stmt_field_names(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Length));
-    update_archive_size_stmt_field_names[enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Id)] =
+    vector<string> update_archive_metadata_stmt_field_names(enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::Length));
+    update_archive_metadata_stmt_field_names[enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::Id)] =
             STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID;
-    update_archive_size_stmt_field_names[enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::UncompressedSize)] =
+    update_archive_metadata_stmt_field_names[enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::UncompressedSize)] =
             STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_UNCOMPRESSED_SIZE;
-    update_archive_size_stmt_field_names[enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Size)] =
+    update_archive_metadata_stmt_field_names[enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::Size)] =
             STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_SIZE;
+    update_archive_metadata_stmt_field_names[enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::NumCommittedSegments)] =
+            STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_NUM_COMMITTED_SEGMENTS;
     statement_string = "UPDATE " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME " SET ";
-    for (size_t i = 0; i < update_archive_size_stmt_field_names.size() - 1; ++i) {
-        const auto& field_name = update_archive_size_stmt_field_names[i];
+    for (size_t i = 0; i < update_archive_metadata_stmt_field_names.size() - 1; ++i) {
+        const auto& field_name = update_archive_metadata_stmt_field_names[i];
         statement_string += field_name;
         statement_string += " = ?";
         statement_string += to_string(i + 1);
@@ -231,11 +248,11 @@ void GlobalMetadataDB::open (const string& path) {
     // Remove trailing comma
     statement_string.resize(statement_string.length() - 1);
     statement_string += " WHERE ";
-    statement_string += update_archive_size_stmt_field_names[enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Id)];
+    statement_string += update_archive_metadata_stmt_field_names[enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::Id)];
     statement_string += " = ?";
-    statement_string += to_string(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Id) + 1);
+    statement_string += to_string(enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::Id) + 1);
 
-    m_update_archive_size_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement(statement_string));
+    m_update_archive_metadata_statement = std::make_unique<SQLitePreparedStatement>(m_db.prepare_statement(statement_string));
 
     statement_string = "INSERT INTO " STREAMING_ARCHIVE_METADATA_DB_FILES_TABLE_NAME " (";
     for (const auto& field_name_and_type : file_field_names_and_types) {
@@ -273,10 +290,11 @@ void GlobalMetadataDB::open (const string& path) {
 
 void GlobalMetadataDB::close () {
     m_insert_archive_statement.reset(nullptr);
-    m_update_archive_size_statement.reset(nullptr);
+    m_update_archive_metadata_statement.reset(nullptr);
     m_upsert_file_statement.reset(nullptr);
     m_upsert_files_transaction_begin_statement.reset(nullptr);
     m_upsert_files_transaction_end_statement.reset(nullptr);
+    m_db.disable_write_ahead_logging();
     if (false == m_db.close()) {
         throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
     }
@@ -286,6 +304,8 @@ void GlobalMetadataDB::close () {
 void GlobalMetadataDB::add_archive (const string& id, const string& storage_id, size_t uncompressed_size, size_t size, const string& creator_id,
                                     size_t creation_num)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (false == m_is_open) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
@@ -296,23 +316,55 @@ void GlobalMetadataDB::add_archive (const string& id, const string& storage_id,
     m_insert_archive_statement->bind_int64(enum_to_underlying_type(ArchivesTableFieldIndexes::Size) + 1, (int64_t)size);
     m_insert_archive_statement->bind_text(enum_to_underlying_type(ArchivesTableFieldIndexes::CreatorId) + 1, creator_id, false);
     m_insert_archive_statement->bind_int64(enum_to_underlying_type(ArchivesTableFieldIndexes::CreationIx) + 1, (int64_t)creation_num);
+    // New archives have no committed segments
+    m_insert_archive_statement->bind_int64(enum_to_underlying_type(ArchivesTableFieldIndexes::NumCommittedSegments) + 1, 0);
     m_insert_archive_statement->step();
     m_insert_archive_statement->reset();
 }
 
-void GlobalMetadataDB::update_archive_size (const string& archive_id, size_t uncompressed_size, size_t size) {
+void GlobalMetadataDB::update_archive_metadata (const string& archive_id, size_t uncompressed_size, size_t size, size_t num_committed_segments) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (false == m_is_open) {
+        throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
+    }
+
+    m_update_archive_metadata_statement->bind_int64(enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::UncompressedSize) + 1, (int64_t)uncompressed_size);
+    m_update_archive_metadata_statement->bind_int64(enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::Size) + 1, (int64_t)size);
+    m_update_archive_metadata_statement->bind_int64(enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::NumCommittedSegments) + 1,
+                                                    (int64_t)num_committed_segments);
+    m_update_archive_metadata_statement->bind_text(enum_to_underlying_type(UpdateArchiveMetadataStmtFieldIndexes::Id) + 1, archive_id, false);
+    m_update_archive_metadata_statement->step();
+    m_update_archive_metadata_statement->reset();
+}
+
+bool GlobalMetadataDB::get_archive_creator (const string& archive_id, string& creator_id, size_t& last_creation_num) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (false == m_is_open) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
 
-    m_update_archive_size_statement->bind_int64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::UncompressedSize) + 1, (int64_t)uncompressed_size);
-    m_update_archive_size_statement->bind_int64(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Size) + 1, (int64_t)size);
-    m_update_archive_size_statement->bind_text(enum_to_underlying_type(UpdateArchiveSizeStmtFieldIndexes::Id) + 1, archive_id, false);
-    m_update_archive_size_statement->step();
-    m_update_archive_size_statement->reset();
+    string statement_string = "SELECT " STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATOR_ID ", MAX(" STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATION_IX ")"
+            " FROM " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME
+            " WHERE " STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATOR_ID " = ("
+                "SELECT " STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATOR_ID " FROM " STREAMING_ARCHIVE_METADATA_DB_ARCHIVES_TABLE_NAME
+                " WHERE " STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_ID " = ?"
+            ")"
+            " GROUP BY " STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATOR_ID;
+    auto statement = m_db.prepare_statement(statement_string);
+    statement.bind_text(1, archive_id, false);
+    if (false == statement.step()) {
+        return false;
+    }
+    statement.column_string(0, creator_id);
+    last_creation_num = statement.column_int64(1);
+    return true;
 }
 
 void GlobalMetadataDB::update_files (const string& archive_id, const vector<streaming_archive::writer::File*>& files) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (false == m_is_open) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
@@ -2,6 +2,7 @@
 #define GLOBALMETADATADB_HPP
 
 // C++ standard libraries
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -13,6 +14,10 @@
 #include "streaming_archive/writer/File.hpp"
 #include "TraceableException.hpp"
 
+/**
+ * Class representing the metadata database shared by all archives in an output directory. Methods which update the database may be called concurrently by
+ * archive writers on different threads.
+ */
 class GlobalMetadataDB {
 public:
     // Types
@@ -73,19 +78,44 @@ public:
 
         // Methods
         void get_id (std::string& id) const;
+        /**
+         * @return The number of segments whose files have been committed to the archive
+         */
+        size_t get_num_committed_segments () const;
     };
 
     // Constructors
     GlobalMetadataDB () : m_is_open(false) {};
 
     // Methods
-    void open (const std::string& path);
+    /**
+     * Opens the database
+     * @param path
+     * @param is_writer Whether archives and files will be written through this connection, in which case the database uses write-ahead logging until
+     * the last connection to it is closed
+     */
+    void open (const std::string& path, bool is_writer);
     void close ();
 
     void add_archive (const std::string& id, const std::string& storage_id, size_t uncompressed_size, size_t size, const std::string& creator_id,
                       size_t creation_num);
-    void update_archive_size (const std::string& archive_id, size_t uncompressed_size, size_t size);
+    /**
+     * Updates an archive's metadata after files are committed to it
+     * @param archive_id
+     * @param uncompressed_size
+     * @param size
+     * @param num_committed_segments
+     */
+    void update_archive_metadata (const std::string& archive_id, size_t uncompressed_size, size_t size, size_t num_committed_segments);
     void update_files (const std::string& archive_id, const std::vector<streaming_archive::writer::File*>& files);
+    /**
+     * Gets the creator of the given archive, along with the largest creation number among the archives it created
+     * @param archive_id
+     * @param creator_id
+     * @param last_creation_num
+     * @return false if the archive doesn't exist, true otherwise
+     */
+    bool get_archive_creator (const std::string& archive_id, std::string& creator_id, size_t& last_creation_num);
 
     ArchiveIterator get_archive_iterator () { return ArchiveIterator(m_db); }
     ArchiveIterator get_archive_iterator_for_file_path (const std::string& path) { return ArchiveIterator(m_db, path); }
@@ -95,9 +125,11 @@ private:
     bool m_is_open;
 
     SQLiteDB m_db;
+    // Serializes updates from concurrent archive writers since they share the database connection and prepared statements
+    std::mutex m_mutex;
 
     std::unique_ptr<SQLitePreparedStatement> m_insert_archive_statement;
-    std::unique_ptr<SQLitePreparedStatement> m_update_archive_size_statement;
+    std::unique_ptr<SQLitePreparedStatement> m_update_archive_metadata_statement;
     std::unique_ptr<SQLitePreparedStatement> m_upsert_file_statement;
     std::unique_ptr<SQLitePreparedStatement> m_upsert_files_transaction_begin_statement;
     std::unique_ptr<SQLitePreparedStatement> m_upsert_files_transaction_end_statement;
@@ -4,6 +4,7 @@
 #include "Utils.hpp"
 
 using std::string;
+using std::string_view;
 
 // Constants
 static constexpr char cEscapeChar = '\\';
@@ -118,7 +119,7 @@ size_t LogTypeDictionaryEntry::get_data_size () const {
            m_ids_of_segments_containing_entry.size() * sizeof(segment_id_t);
 }
 
-void LogTypeDictionaryEntry::add_constant (const string& value_containing_constant, size_t begin_pos, size_t length) {
+void LogTypeDictionaryEntry::add_constant (string_view value_containing_constant, size_t begin_pos, size_t length) {
     m_value.append(value_containing_constant, begin_pos, length);
 }
 
@@ -132,14 +133,17 @@ void LogTypeDictionaryEntry::add_double_var (uint8_t num_integer_digits, uint8_t
     add_double_var(num_integer_digits, num_fractional_digits, m_value);
 }
 
-bool LogTypeDictionaryEntry::parse_next_var (const string& msg, size_t& var_begin_pos, size_t& next_delim_pos, size_t& last_var_end_pos, string& var) {
+bool LogTypeDictionaryEntry::parse_next_var (VariableTokenizer& tokenizer, size_t& var_begin_pos, size_t& next_delim_pos, size_t& last_var_end_pos,
+                                             string_view& var)
+{
+    auto msg = tokenizer.get_msg();
     size_t var_end_pos = last_var_end_pos;
-    while (get_bounds_of_next_var(msg, next_delim_pos, var_begin_pos, var_end_pos)) {
+    while (tokenizer.get_bounds_of_next_var(next_delim_pos, var_begin_pos, var_end_pos)) {
         // Append to log type: from end of last variable to start of current variable
         add_constant(msg, last_var_end_pos, var_begin_pos - last_var_end_pos);
         last_var_end_pos = var_end_pos;
 
-        var.assign(msg, var_begin_pos, var_end_pos - var_begin_pos);
+        var = msg.substr(var_begin_pos, var_end_pos - var_begin_pos);
         return true;
     }
     if (last_var_end_pos < msg.length()) {
@@ -2,6 +2,8 @@
 #define LOGTYPEDICTIONARYENTRY_HPP
 
 // C++ standard libraries
+#include <string>
+#include <string_view>
 #include <vector>
 
 // Project headers
@@ -12,6 +14,7 @@
 #include "streaming_compression/zstd/Compressor.hpp"
 #include "streaming_compression/zstd/Decompressor.hpp"
 #include "TraceableException.hpp"
+#include "VariableTokenizer.hpp"
 
 /**
  * Class representing a logtype dictionary entry
@@ -43,12 +46,14 @@ public:
 
     // Constructors
     LogTypeDictionaryEntry () : m_verbosity(LogVerbosity_Length) {}
-    // Use default copy constructor
+    // Use default copy & move constructors
     LogTypeDictionaryEntry (const LogTypeDictionaryEntry&) = default;
+    LogTypeDictionaryEntry (LogTypeDictionaryEntry&&) = default;
 
     // Assignment operators
     // Use default
     LogTypeDictionaryEntry& operator= (const LogTypeDictionaryEntry&) = default;
+    LogTypeDictionaryEntry& operator= (LogTypeDictionaryEntry&&) = default;
 
     // Methods
     /**
@@ -104,7 +109,7 @@ public:
      * @param begin_pos Start of the constant in value_containing_constant
      * @param length
      */
-    void add_constant (const std::string& value_containing_constant, size_t begin_pos, size_t length);
+    void add_constant (std::string_view value_containing_constant, size_t begin_pos, size_t length);
     /**
      * Adds a non-double variable delimiter
      */
@@ -118,14 +123,14 @@ public:
 
     /**
      * Parses next variable from a message, constructing the constant part of the message's logtype as well
-     * @param msg
+     * @param tokenizer Tokenizer for the message
      * @param var_begin_pos Beginning position of last variable. Changes to beginning position of current variable.
      * @param next_delim_pos Position of delimiter after token
      * @param last_var_end_pos End position of last variable
-     * @param var
+     * @param var View of the variable within the message
      * @return true if another variable was found, false otherwise
      */
-    bool parse_next_var (const std::string& msg, size_t& var_begin_pos, size_t& next_delim_pos, size_t& last_var_end_pos, std::string& var);
+    bool parse_next_var (VariableTokenizer& tokenizer, size_t& var_begin_pos, size_t& next_delim_pos, size_t& last_var_end_pos, std::string_view& var);
 
     /**
      * Reserves space for a constant of the given length
@@ -24,12 +24,15 @@ void LogTypeDictionaryWriter::open_and_preload (const std::string& dictionary_pa
 
     // Read new dictionary entries
     logtype_dictionary_id_t id;
+    LogTypeDictionaryEntry logtype_dict_entry;
     for (size_t i = 0; i < num_dictionary_entries; ++i) {
-        auto logtype_dict_entry_wrapper = std::make_unique<LogTypeDictionaryEntry>();
-        logtype_dict_entry_wrapper->read_from_file(dictionary_decompressor);
-        add_occurrence(logtype_dict_entry_wrapper, id);
+        logtype_dict_entry.read_from_file(dictionary_decompressor);
+        add_occurrence(logtype_dict_entry, id);
     }
-    m_uncommitted_entries.clear();
+    mark_all_entries_committed();
+
+    // Continue the segment index after the segments already indexed
+    m_num_segments_in_index = read_segment_index_header(segment_index_file_reader);
 
     segment_index_decompressor.close();
     segment_index_file_reader.close();
@@ -47,24 +50,11 @@ void LogTypeDictionaryWriter::open_and_preload (const std::string& dictionary_pa
     m_is_open = true;
 }
 
-bool LogTypeDictionaryWriter::add_occurrence (std::unique_ptr<LogTypeDictionaryEntry>& entry_wrapper, logtype_dictionary_id_t& logtype_id) {
-    if (nullptr == entry_wrapper) {
-        throw OperationFailed(ErrorCode_BadParam, __FILENAME__, __LINE__);
-    }
-    auto& entry = *entry_wrapper;
-
-    bool is_new_entry = false;
-
-    const string& value = entry.get_value();
-    const auto ix = m_value_to_entry.find(value);
-    if (m_value_to_entry.end() != ix) {
-        // Entry exists so increment its count
-        auto& existing_entry = ix->second;
-        logtype_id = existing_entry->get_id();
-    } else {
-        // Dictionary entry doesn't exist so create it
-
+bool LogTypeDictionaryWriter::add_occurrence (LogTypeDictionaryEntry& entry, logtype_dictionary_id_t& logtype_id) {
+    bool is_new_entry;
+    auto create_entry = [&entry] (logtype_dictionary_id_t new_id) {
         // Determine verbosity
+        const string& value = entry.get_value();
         LogVerbosity verbosity;
         if (string::npos != value.find("FATAL")) {
             verbosity = LogVerbosity_FATAL;
@@ -82,24 +72,11 @@ bool LogTypeDictionaryWriter::add_occurrence (std::unique_ptr<LogTypeDictionaryE
             verbosity = LogVerbosity_UNKNOWN;
         }
         entry.set_verbosity(verbosity);
+        entry.set_id(new_id);
 
-        // Assign ID
-        logtype_id = m_next_id;
-        ++m_next_id;
-        entry.set_id(logtype_id);
-
-        // Insert new entry into dictionary
-        auto entry_ptr = entry_wrapper.release();
-        m_value_to_entry[value] = entry_ptr;
-        m_id_to_entry[logtype_id] = entry_ptr;
-
-        // Mark ID as dirty
-        m_uncommitted_entries.emplace_back(entry_ptr);
-
-        is_new_entry = true;
-
-        // TODO: This doesn't account for the segment index that's constantly updated
-        m_data_size += entry_ptr->get_data_size();
-    }
+        return std::move(entry);
+    };
+    auto existing_or_new_entry = get_or_create_entry(entry.get_value(), create_entry, is_new_entry);
+    logtype_id = existing_or_new_entry->get_id();
     return is_new_entry;
 }
@@ -2,7 +2,7 @@
 #define LOGTYPEDICTIONARYWRITER_HPP
 
 // C++ standard libraries
-#include <memory>
+#include <string>
 
 // Project headers
 #include "Defs.h"
@@ -37,12 +37,15 @@ public:
     void open_and_preload (const std::string& dictionary_path, const std::string& segment_index_path, logtype_dictionary_id_t max_id);
 
     /**
-     * Adds an entry to the dictionary if it doesn't exist, or increases its occurrence count if it does. If the entry does not exist, the entry pointer is
-     * released from entry_wrapper and stored in the dictionary.
-     * @param entry_wrapper
+     * Adds an entry to the dictionary if it doesn't exist, or increases its occurrence count if it does. If the entry does not exist, it's moved into
+     * the dictionary, leaving the given entry in an unspecified state, so it must be cleared before it's reused. Can be called from multiple threads
+     * concurrently.
+     * @param entry
      * @param logtype_id ID of the logtype matching the given entry
+     * @return true if the entry is new, false otherwise
+     * @throw DictionaryWriter::OperationFailed if the dictionary has run out of IDs
      */
-    bool add_occurrence (std::unique_ptr<LogTypeDictionaryEntry>& entry_wrapper, logtype_dictionary_id_t& logtype_id);
+    bool add_occurrence (LogTypeDictionaryEntry& entry, logtype_dictionary_id_t& logtype_id);
 };
 
 #endif // LOGTYPEDICTIONARYWRITER_HPP
@@ -0,0 +1,101 @@
+#include "MemoryMappedFileReader.hpp"
+
+// C standard libraries
+#include <sys/mman.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+
+// Project headers
+#include "Utils.hpp"
+
+using std::string;
+
+MemoryMappedFileReader::~MemoryMappedFileReader () {
+    close();
+}
+
+ErrorCode MemoryMappedFileReader::try_get_pos (size_t& pos) {
+    if (false == m_is_open) {
+        return ErrorCode_NotInit;
+    }
+
+    pos = m_pos;
+    return ErrorCode_Success;
+}
+
+ErrorCode MemoryMappedFileReader::try_seek_from_begin (size_t pos) {
+    if (false == m_is_open) {
+        return ErrorCode_NotInit;
+    }
+    if (pos > m_file_size) {
+        return ErrorCode_OutOfBounds;
+    }
+
+    m_pos = pos;
+    return ErrorCode_Success;
+}
+
+ErrorCode MemoryMappedFileReader::try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) {
+    const char* view;
+    auto error_code = try_read_view(num_bytes_to_read, view, num_bytes_read);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    memcpy(buf, view, num_bytes_read);
+    return ErrorCode_Success;
+}
+
+ErrorCode MemoryMappedFileReader::try_read_view (size_t max_num_bytes_to_read, const char*& view, size_t& view_length) {
+    if (false == m_is_open) {
+        return ErrorCode_NotInit;
+    }
+    if (m_file_size == m_pos) {
+        return ErrorCode_EndOfFile;
+    }
+
+    view = m_file_content + m_pos;
+    view_length = std::min(max_num_bytes_to_read, m_file_size - m_pos);
+    m_pos += view_length;
+    return ErrorCode_Success;
+}
+
+ErrorCode MemoryMappedFileReader::try_open (const string& path) {
+    // Cleanup in case caller forgot to call close before calling this function
+    close();
+
+    void* file_content = nullptr;
+    auto error_code = memory_map_file(path, false, m_fd, m_file_size, file_content);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    m_file_content = static_cast<const char*>(file_content);
+    if (m_file_size > 0) {
+        // NOTE: This is only advice, so we ignore any failure
+        madvise(file_content, m_file_size, MADV_SEQUENTIAL);
+    }
+
+    m_pos = 0;
+    m_is_open = true;
+    return ErrorCode_Success;
+}
+
+void MemoryMappedFileReader::open (const string& path) {
+    auto error_code = try_open(path);
+    if (ErrorCode_Success != error_code) {
+        throw OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+}
+
+void MemoryMappedFileReader::close () {
+    if (false == m_is_open) {
+        return;
+    }
+
+    memory_unmap_file(m_fd, m_file_size, const_cast<char*>(m_file_content));
+    m_is_open = false;
+    m_fd = -1;
+    m_file_size = 0;
+    m_file_content = nullptr;
+}
@@ -0,0 +1,102 @@
+#ifndef MEMORYMAPPEDFILEREADER_HPP
+#define MEMORYMAPPEDFILEREADER_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <string>
+
+// Project headers
+#include "ErrorCode.hpp"
+#include "ReaderInterface.hpp"
+#include "TraceableException.hpp"
+
+/**
+ * Class to read a file by mapping it into memory, so that content can be returned as views of the mapping rather than copied into the caller's buffer.
+ * The kernel is advised that the mapping is read sequentially, so it reads ahead aggressively and frees pages behind the read head.
+ * NOTE: Since the file is accessed through the mapping, the process will receive SIGBUS if the file is truncated while it's being read.
+ */
+class MemoryMappedFileReader : public ReaderInterface {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException (error_code, filename, line_number) {}
+
+        // Methods
+        const char* what () const noexcept override {
+            return "MemoryMappedFileReader operation failed";
+        }
+    };
+
+    // Constructors
+    MemoryMappedFileReader () : m_is_open(false), m_fd(-1), m_file_size(0), m_file_content(nullptr), m_pos(0) {}
+
+    // Destructor
+    ~MemoryMappedFileReader ();
+
+    // Methods implementing the ReaderInterface
+    /**
+     * Tries to get the current position of the read head in the file
+     * @param pos
+     * @return ErrorCode_NotInit if the file is not open
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_get_pos (size_t& pos) override;
+    /**
+     * Tries to seek from the beginning of the file to the given position
+     * @param pos
+     * @return ErrorCode_NotInit if the file is not open
+     * @return ErrorCode_OutOfBounds if the position is beyond the end of the file
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_seek_from_begin (size_t pos) override;
+    /**
+     * Tries to read up to a given number of bytes from the file
+     * @param buf
+     * @param num_bytes_to_read The number of bytes to try and read
+     * @param num_bytes_read The actual number of bytes read
+     * @return Same as MemoryMappedFileReader::try_read_view
+     */
+    ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override;
+    /**
+     * Tries to read up to a given number of bytes from the file, returning a view of the mapping. The view remains valid until the file is closed.
+     * @param max_num_bytes_to_read
+     * @param view
+     * @param view_length
+     * @return ErrorCode_NotInit if the file is not open
+     * @return ErrorCode_EndOfFile on EOF
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_read_view (size_t max_num_bytes_to_read, const char*& view, size_t& view_length) override;
+
+    // Methods
+    bool is_open () const { return m_is_open; }
+
+    /**
+     * Tries to open and map a file
+     * @param path
+     * @return Same as memory_map_file
+     */
+    ErrorCode try_open (const std::string& path);
+    /**
+     * Opens and maps a file
+     * @param path
+     * @throw MemoryMappedFileReader::OperationFailed on failure
+     */
+    void open (const std::string& path);
+    /**
+     * Unmaps and closes the file if it's open
+     */
+    void close ();
+
+private:
+    // Variables
+    bool m_is_open;
+    int m_fd;
+    size_t m_file_size;
+    const char* m_file_content;
+    size_t m_pos;
+};
+
+#endif // MEMORYMAPPEDFILEREADER_HPP
@@ -1,42 +1,37 @@
 #include "MessageParser.hpp"
 
+// C++ standard libraries
+#include <cstring>
+
 // Project headers
 #include "Defs.h"
 #include "TimestampPattern.hpp"
 
+using std::string_view;
+
 // Constants
 constexpr char cLineDelimiter = '\n';
 
 bool MessageParser::parse_next_message (bool drain_source, size_t buffer_length, const char* buffer, size_t& buf_pos, ParsedMessage& message) {
     message.clear_except_ts_patt();
 
-    while (true) {
-        // Check if the buffer was exhausted
-        if (buffer_length == buf_pos) {
-            break;
-        }
-
-        // Read a line up to the delimiter
-        bool found_delim = false;
-        for (; false == found_delim && buf_pos < buffer_length; ++buf_pos) {
-            auto c = buffer[buf_pos];
-
-            m_line += c;
-            if (cLineDelimiter == c) {
-                found_delim = true;
+    while (buf_pos < buffer_length) {
+        string_view line;
+        if (false == get_next_line(buffer_length, buffer, buf_pos, line)) {
+            if (false == drain_source) {
+                // No delimiter was found and the source doesn't need to be drained
+                break;
             }
+            line = m_line;
         }
 
-        if (false == found_delim && false == drain_source) {
-            // No delimiter was found and the source doesn't need to be drained
-            return false;
-        }
-
-        if (parse_line(message)) {
+        if (parse_line(line, message)) {
             return true;
         }
     }
 
+    // The caller may reuse the buffer once it's exhausted, so the buffered message can no longer refer to it
+    m_buffered_msg.own_content();
     return false;
 }
 
@@ -44,27 +39,49 @@ bool MessageParser::parse_next_message (bool drain_source, ReaderInterface& read
     message.clear_except_ts_patt();
 
     while (true) {
-        // Read message
-        auto error_code = reader.try_read_to_delimiter(cLineDelimiter, true, true, m_line);
-        if (ErrorCode_Success != error_code) {
-            if (ErrorCode_EndOfFile != error_code) {
-                throw OperationFailed(error_code, __FILENAME__, __LINE__);
+        if (m_read_buffer_length == m_read_buffer_pos) {
+            // Refilling the read buffer will overwrite any content that refers to it
+            m_buffered_msg.own_content();
+
+            m_read_buffer_pos = 0;
+            // Prefer a view of the reader's own buffer to avoid copying content
+            auto error_code = reader.try_read_view(cMaxReadViewLength, m_read_content, m_read_buffer_length);
+            if (ErrorCode_Unsupported == error_code) {
+                error_code = reader.try_read(m_read_buffer.get(), cReadBufferCapacity, m_read_buffer_length);
+                m_read_content = m_read_buffer.get();
             }
+            if (ErrorCode_Success != error_code) {
+                m_read_buffer_length = 0;
+                if (ErrorCode_NotReady == error_code) {
+                    // The reader has no content yet, so let the caller try again later
+                    return false;
+                }
+                if (ErrorCode_EndOfFile != error_code) {
+                    throw OperationFailed(error_code, __FILENAME__, __LINE__);
+                }
+
+                if (m_line.empty()) {
+                    if (m_buffered_msg.is_empty()) {
+                        break;
+                    } else {
+                        message.consume(m_buffered_msg);
+                        return true;
+                    }
+                }
+                if (false == drain_source) {
+                    return false;
+                }
 
-            if (m_line.empty()) {
-                if (m_buffered_msg.is_empty()) {
-                    break;
-                } else {
-                    message.consume(m_buffered_msg);
+                // Parse the last line, which has no delimiter
+                if (parse_line(m_line, message)) {
                     return true;
                 }
+                continue;
             }
         }
-        if (false == drain_source && cLineDelimiter != m_line[m_line.length() - 1]) {
-            return false;
-        }
 
-        if (parse_line(message)) {
+        string_view line;
+        if (get_next_line(m_read_buffer_length, m_read_content, m_read_buffer_pos, line) && parse_line(line, message)) {
             return true;
         }
     }
@@ -72,6 +89,38 @@ bool MessageParser::parse_next_message (bool drain_source, ReaderInterface& read
     return false;
 }
 
+bool MessageParser::take_buffered_message (ParsedMessage& message) {
+    if (m_buffered_msg.is_empty()) {
+        return false;
+    }
+
+    message.clear_except_ts_patt();
+    message.consume(m_buffered_msg);
+    return true;
+}
+
+bool MessageParser::get_next_line (size_t buffer_length, const char* buffer, size_t& buf_pos, string_view& line) {
+    const char* line_begin = buffer + buf_pos;
+    const size_t remaining_length = buffer_length - buf_pos;
+    const auto* delim = static_cast<const char*>(memchr(line_begin, cLineDelimiter, remaining_length));
+    if (nullptr == delim) {
+        m_line.append(line_begin, remaining_length);
+        buf_pos = buffer_length;
+        return false;
+    }
+
+    const size_t line_length = delim + 1 - line_begin;
+    buf_pos += line_length;
+    if (m_line.empty()) {
+        line = string_view(line_begin, line_length);
+    } else {
+        // Complete the line that began in a previous buffer
+        m_line.append(line_begin, line_length);
+        line = m_line;
+    }
+    return true;
+}
+
 /**
  * The general algorithm is as follows:
  * - Try to parse a timestamp from the line.
@@ -82,7 +131,7 @@ bool MessageParser::parse_next_message (bool drain_source, ReaderInterface& read
  *   - ...the buffered message is empty, return the line as a message.
  *   - ...the buffered message is not empty, add the line to the message and continue reading.
  */
-bool MessageParser::parse_line (ParsedMessage& message) {
+bool MessageParser::parse_line (string_view line, ParsedMessage& message) {
     bool message_completed = false;
 
     // Parse timestamp and content
@@ -90,35 +139,40 @@ bool MessageParser::parse_line (ParsedMessage& message) {
     epochtime_t timestamp = 0;
     size_t timestamp_begin_pos;
     size_t timestamp_end_pos;
-    if (nullptr == timestamp_pattern || false == timestamp_pattern->parse_timestamp(m_line, timestamp, timestamp_begin_pos, timestamp_end_pos)) {
-        timestamp_pattern = TimestampPattern::search_known_ts_patterns(m_line, timestamp, timestamp_begin_pos, timestamp_end_pos);
+    if (nullptr == timestamp_pattern || false == timestamp_pattern->parse_timestamp(line, timestamp, timestamp_begin_pos, timestamp_end_pos)) {
+        timestamp_pattern = TimestampPattern::search_known_ts_patterns(line, timestamp, timestamp_begin_pos, timestamp_end_pos);
     }
 
     if (nullptr != timestamp_pattern) {
         // A timestamp was parsed
         if (m_buffered_msg.is_empty()) {
             // Fill message with line
-            m_buffered_msg.set(timestamp_pattern, timestamp, m_line, timestamp_begin_pos, timestamp_end_pos);
+            m_buffered_msg.set(timestamp_pattern, timestamp, line, timestamp_begin_pos, timestamp_end_pos);
         } else {
             // Move buffered message to message
             message.consume(m_buffered_msg);
 
             // Save line for next message
-            m_buffered_msg.set(timestamp_pattern, timestamp, m_line, timestamp_begin_pos, timestamp_end_pos);
+            m_buffered_msg.set(timestamp_pattern, timestamp, line, timestamp_begin_pos, timestamp_end_pos);
             message_completed = true;
         }
     } else {
         // No timestamp was parsed
         if (m_buffered_msg.is_empty()) {
             // Fill message with line
-            message.set(timestamp_pattern, timestamp, m_line, timestamp_begin_pos, timestamp_end_pos);
+            message.set(timestamp_pattern, timestamp, line, timestamp_begin_pos, timestamp_end_pos);
             message_completed = true;
         } else {
             // Append line to message
-            m_buffered_msg.append_line(m_line);
+            m_buffered_msg.append_line(line);
         }
     }
 
-    m_line.clear();
+    if (false == m_line.empty()) {
+        // The line was assembled in m_line, which is about to be reused, so the messages can't continue to refer to it
+        m_buffered_msg.own_content();
+        message.own_content();
+        m_line.clear();
+    }
     return message_completed;
 }
@@ -2,7 +2,9 @@
 #define MESSAGEPARSER_HPP
 
 // C++ standard libraries
+#include <memory>
 #include <string>
+#include <string_view>
 
 // Project headers
 #include "ErrorCode.hpp"
@@ -27,9 +29,14 @@ public:
         }
     };
 
+    // Constructors
+    MessageParser () : m_read_buffer(std::make_unique<char[]>(cReadBufferCapacity)), m_read_content(nullptr), m_read_buffer_length(0),
+            m_read_buffer_pos(0) {}
+
     // Methods
     /**
      * Parses the next message from the given buffer. Messages are delimited either by i) a timestamp or ii) a line break if no timestamp is found.
+     * NOTE: The returned message may refer to the given buffer, so the buffer must remain unchanged until this method returns false
      * @param drain_source Whether to drain all content from the file or just lines with endings
      * @param buffer_length
      * @param buffer
@@ -40,24 +47,56 @@ public:
     bool parse_next_message (bool drain_source, size_t buffer_length, const char* buffer, size_t& buf_pos, ParsedMessage& message);
     /**
      * Parses the next message from the given reader. Messages are delimited either by i) a timestamp or ii) a line break if no timestamp is found.
+     * NOTE: The returned message may refer to the parser's read buffer (or a view of the reader's buffer), so it's only valid until the next call to
+     * this method
      * @param drain_source Whether to drain all content from the reader or just lines with endings
      * @param reader
      * @param message
-     * @return true if message parsed, false otherwise
+     * @return true if message parsed, false otherwise (including when the reader returns ErrorCode_NotReady, in which case parsing can resume later)
+     * @throw MessageParser::OperationFailed if reading from the reader fails
      */
     bool parse_next_message (bool drain_source, ReaderInterface& reader, ParsedMessage& message);
+    /**
+     * Takes the message that's buffered while the parser waits to see if the next line continues it. This is useful when a stream is idle, at the cost
+     * of any continuation lines that arrive later becoming separate messages.
+     * @param message
+     * @return true if there was a buffered message, false otherwise
+     */
+    bool take_buffered_message (ParsedMessage& message);
 
 private:
+    // Constants
+    static constexpr size_t cReadBufferCapacity = 64 * 1024;
+    // Views are larger since they don't need to be copied
+    static constexpr size_t cMaxReadViewLength = 1024 * 1024;
+
     // Methods
+    /**
+     * Gets the next line from the given buffer. If the buffer doesn't contain a complete line, the remaining content is saved in m_line, and the rest
+     * of the line is appended to it when the next buffer is given.
+     * @param buffer_length
+     * @param buffer
+     * @param buf_pos
+     * @param line Set to the line (including the line delimiter) if a complete line was found
+     * @return true if a complete line was found, false otherwise
+     */
+    bool get_next_line (size_t buffer_length, const char* buffer, size_t& buf_pos, std::string_view& line);
     /**
      * Parses the line and adds it either to the buffered message if incomplete, or the given message if complete
+     * @param line Either a line in the source's buffer or m_line
      * @param message
      * @return Whether a complete message has been parsed
      */
-    bool parse_line (ParsedMessage& message);
+    bool parse_line (std::string_view line, ParsedMessage& message);
 
     // Variables
+    // Lines that span multiple buffers are assembled here
     std::string m_line;
+    std::unique_ptr<char[]> m_read_buffer;
+    // Either m_read_buffer or a view returned by the reader
+    const char* m_read_content;
+    size_t m_read_buffer_length;
+    size_t m_read_buffer_pos;
     ParsedMessage m_buffered_msg;
 };
 
@@ -70,6 +70,12 @@ public:
      * Clears the vector
      */
     void clear () noexcept;
+    /**
+     * Releases ownership of the vector's memory region to the caller, leaving the vector empty. The caller is responsible for unmapping the region.
+     * @param region_size Returns the size of the region in bytes
+     * @return Pointer to the region, or nullptr if the vector has no region
+     */
+    ValueType* release (size_t& region_size) noexcept;
 
     /**
      * Gets underlying array
@@ -182,6 +188,19 @@ void PageAllocatedVector<ValueType>::clear () noexcept {
     }
 }
 
+template <typename ValueType>
+ValueType* PageAllocatedVector<ValueType>::release (size_t& region_size) noexcept {
+    auto values = m_values;
+    region_size = m_capacity_in_bytes;
+
+    m_values = nullptr;
+    m_capacity_in_bytes = 0;
+    m_capacity = 0;
+    m_size = 0;
+
+    return values;
+}
+
 template <typename ValueType>
 const ValueType* PageAllocatedVector<ValueType>::data () const noexcept {
     return m_values;
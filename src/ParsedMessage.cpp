@@ -1,6 +1,7 @@
 #include "ParsedMessage.hpp"
 
 using std::string;
+using std::string_view;
 
 void ParsedMessage::clear () {
     m_ts_patt = nullptr;
@@ -10,12 +11,14 @@ void ParsedMessage::clear () {
 void ParsedMessage::clear_except_ts_patt () {
     m_ts_patt_changed = false;
     m_ts = 0;
+    m_content_view = string_view();
     m_content.clear();
+    m_is_content_owned = false;
     m_orig_num_bytes = 0;
     m_is_set = false;
 }
 
-void ParsedMessage::set (const TimestampPattern* timestamp_pattern, const epochtime_t timestamp, const string& line, size_t timestamp_begin_pos,
+void ParsedMessage::set (const TimestampPattern* timestamp_pattern, const epochtime_t timestamp, string_view line, size_t timestamp_begin_pos,
                          size_t timestamp_end_pos)
 {
     if (timestamp_pattern != m_ts_patt) {
@@ -24,27 +27,45 @@ void ParsedMessage::set (const TimestampPattern* timestamp_pattern, const epocht
     }
     m_ts = timestamp;
     if (timestamp_begin_pos == timestamp_end_pos) {
-        m_content.assign(line);
+        m_content_view = line;
+        m_is_content_owned = false;
+    } else if (0 == timestamp_begin_pos) {
+        // Content is the remainder of the line, so we can still refer to it
+        m_content_view = line.substr(timestamp_end_pos);
+        m_is_content_owned = false;
     } else {
         m_content.assign(line, 0, timestamp_begin_pos);
         m_content.append(line, timestamp_end_pos, string::npos);
+        m_is_content_owned = true;
     }
     m_orig_num_bytes = line.length();
     m_is_set = true;
 }
 
-void ParsedMessage::append_line (const string& line) {
+void ParsedMessage::append_line (string_view line) {
+    own_content();
     m_content += line;
     m_orig_num_bytes += line.length();
 }
 
+void ParsedMessage::own_content () {
+    if (m_is_content_owned) {
+        return;
+    }
+    m_content.assign(m_content_view);
+    m_content_view = string_view();
+    m_is_content_owned = true;
+}
+
 void ParsedMessage::consume (ParsedMessage& message) {
     if (message.m_ts_patt != m_ts_patt) {
         m_ts_patt = message.m_ts_patt;
         m_ts_patt_changed = true;
     }
     m_ts = message.m_ts;
+    m_content_view = message.m_content_view;
     m_content.swap(message.m_content);
+    m_is_content_owned = message.m_is_content_owned;
     m_orig_num_bytes = message.m_orig_num_bytes;
     m_is_set = true;
 
@@ -3,17 +3,23 @@
 
 // C++ standard libraries
 #include <string>
+#include <string_view>
 
 // Project headers
 #include "TimestampPattern.hpp"
 
 /**
  * ParsedMessage represents a (potentially multiline) log message parsed into 3 primary fields: timestamp, timestamp pattern, and content.
+ *
+ * To avoid copying every line, the content of a single-line message may refer directly to the buffer the line was parsed from. Content is only copied
+ * into the message's own storage when it can't be represented as a contiguous slice of the line (e.g., the message is multiline or the timestamp is
+ * in the middle of the line) or when the buffer is about to be reused (see own_content).
  */
 class ParsedMessage {
 public:
     // Constructors
-    ParsedMessage () : m_ts_patt(nullptr), m_ts_patt_changed(false), m_ts(0), m_content({}), m_orig_num_bytes(0), m_is_set(false) {}
+    ParsedMessage () : m_ts_patt(nullptr), m_ts_patt_changed(false), m_ts(0), m_content_view(), m_content({}), m_is_content_owned(false),
+                       m_orig_num_bytes(0), m_is_set(false) {}
 
     // Disable copy and move constructor/assignment
     ParsedMessage (const ParsedMessage&) = delete;
@@ -26,8 +32,23 @@ public:
     void clear ();
     void clear_except_ts_patt ();
 
-    void set (const TimestampPattern* timestamp_pattern, epochtime_t timestamp, const std::string& line, size_t timestamp_begin_pos, size_t timestamp_end_pos);
-    void append_line (const std::string& line);
+    /**
+     * Sets the message to the given line
+     * NOTE: The message may refer to the line's buffer, so the buffer must remain unchanged until the message is cleared or own_content is called
+     * @param timestamp_pattern
+     * @param timestamp
+     * @param line
+     * @param timestamp_begin_pos
+     * @param timestamp_end_pos
+     */
+    void set (const TimestampPattern* timestamp_pattern, epochtime_t timestamp, std::string_view line, size_t timestamp_begin_pos,
+              size_t timestamp_end_pos);
+    void append_line (std::string_view line);
+
+    /**
+     * Copies the content into the message's own storage if it currently refers to an external buffer
+     */
+    void own_content ();
 
     /**
      * Move all data from the given message into the current message while clearing the given message
@@ -35,7 +56,7 @@ public:
      */
     void consume (ParsedMessage& message);
 
-    const std::string& get_content () const { return m_content; }
+    std::string_view get_content () const { return m_is_content_owned ? std::string_view(m_content) : m_content_view; }
     size_t get_orig_num_bytes () const { return m_orig_num_bytes; }
     epochtime_t get_ts () const { return m_ts; }
     const TimestampPattern* get_ts_patt () const { return m_ts_patt; }
@@ -47,7 +68,11 @@ private:
     const TimestampPattern* m_ts_patt;
     bool m_ts_patt_changed;
     epochtime_t m_ts;
+    // Content when it refers to an external buffer
+    std::string_view m_content_view;
+    // Content when it's owned by the message
     std::string m_content;
+    bool m_is_content_owned;
     size_t m_orig_num_bytes;
     bool m_is_set;
 };
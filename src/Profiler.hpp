@@ -30,6 +30,7 @@ public:
         MessageSearch,
         SegmentIndexRead,
         ColumnsAlloc,
+        MetadataWrite,
         Length
     };
     enum class FragmentedMeasurementEnabled : bool {
@@ -39,6 +40,7 @@ public:
         MessageSearch = true,
         SegmentIndexRead = true,
         ColumnsAlloc = true,
+        MetadataWrite = true,
     };
     enum class ContinuousMeasurementIndex : size_t {
         PipelineRequest = 0,
@@ -1,29 +1,8 @@
 #include "Query.hpp"
 
-using std::set;
 using std::string;
 using std::unordered_set;
-
-// Local function prototypes
-/**
- * Performs a set intersection of a & b, storing the result in b
- * @tparam SetType
- * @param a
- * @param b
- */
-template<typename SetType>
-static void inplace_set_intersection (const SetType& a, SetType& b);
-
-template<typename SetType>
-static void inplace_set_intersection (const SetType& a, SetType& b) {
-    for (auto ix = b.cbegin(); ix != b.cend();) {
-        if (a.count(*ix) == 0) {
-            ix = b.erase(ix);
-        } else {
-            ++ix;
-        }
-    }
-}
+using std::vector;
 
 QueryVar::QueryVar (encoded_variable_t precise_non_dict_var) {
     m_precise_var = precise_non_dict_var;
@@ -58,22 +37,20 @@ bool QueryVar::matches (encoded_variable_t var) const {
     return (m_is_precise_var && m_precise_var == var) || (!m_is_precise_var && m_possible_dict_vars.count(var) > 0);
 }
 
-void QueryVar::remove_segments_that_dont_contain_dict_var (set<segment_id_t>& segment_ids) const {
+void QueryVar::remove_segments_that_dont_contain_dict_var (SegmentIdSet& segment_ids) const {
     if (false == m_is_dict_var) {
         // Not a dictionary variable, so do nothing
         return;
     }
 
     if (m_is_precise_var) {
-        auto& ids_of_segments_containing_query_var = m_var_dict_entry->get_ids_of_segments_containing_entry();
-        inplace_set_intersection(ids_of_segments_containing_query_var, segment_ids);
+        segment_ids.intersect_with(m_var_dict_entry->get_ids_of_segments_containing_entry());
     } else {
-        set<segment_id_t> ids_of_segments_containing_query_var;
+        SegmentIdSet ids_of_segments_containing_query_var;
         for (auto entry : m_possible_var_dict_entries) {
-            auto& ids_of_segments_containing_var = entry->get_ids_of_segments_containing_entry();
-            ids_of_segments_containing_query_var.insert(ids_of_segments_containing_var.cbegin(), ids_of_segments_containing_var.cend());
+            ids_of_segments_containing_query_var.union_with(entry->get_ids_of_segments_containing_entry());
         }
-        inplace_set_intersection(ids_of_segments_containing_query_var, segment_ids);
+        segment_ids.intersect_with(ids_of_segments_containing_query_var);
     }
 }
 
@@ -107,12 +84,14 @@ void SubQuery::calculate_ids_of_matching_segments () {
     // Get IDs of segments containing logtypes
     m_ids_of_matching_segments.clear();
     for (auto entry : m_possible_logtype_entries) {
-        auto& ids_of_segments_containing_logtype = entry->get_ids_of_segments_containing_entry();
-        m_ids_of_matching_segments.insert(ids_of_segments_containing_logtype.cbegin(), ids_of_segments_containing_logtype.cend());
+        m_ids_of_matching_segments.union_with(entry->get_ids_of_segments_containing_entry());
     }
 
     // Intersect with IDs of segments containing variables
     for (auto& query_var : m_vars) {
+        if (m_ids_of_matching_segments.empty()) {
+            break;
+        }
         query_var.remove_segments_that_dont_contain_dict_var(m_ids_of_matching_segments);
     }
 }
@@ -161,7 +140,7 @@ void Query::add_sub_query (const SubQuery& sub_query) {
     m_sub_queries.push_back(sub_query);
 
     // Add to relevant sub-queries if necessary
-    if (m_all_subqueries_relevant || sub_query.get_ids_of_matching_segments().count(m_prev_segment_id)) {
+    if (m_all_subqueries_relevant || sub_query.get_ids_of_matching_segments().contains(m_prev_segment_id)) {
         m_relevant_sub_queries.push_back(&m_sub_queries.back());
     }
 }
@@ -185,6 +164,53 @@ void Query::make_all_sub_queries_relevant () {
     m_all_subqueries_relevant = true;
 }
 
+void Query::get_relevant_possible_logtype_ids (vector<logtype_dictionary_id_t>& logtype_ids) const {
+    logtype_ids.clear();
+    for (auto sub_query : m_relevant_sub_queries) {
+        for (auto logtype_entry : sub_query->get_possible_logtype_entries()) {
+            logtype_ids.push_back(logtype_entry->get_id());
+        }
+    }
+    std::sort(logtype_ids.begin(), logtype_ids.end());
+    logtype_ids.erase(std::unique(logtype_ids.begin(), logtype_ids.end()), logtype_ids.end());
+}
+
+bool Query::get_relevant_dict_var_ids (vector<variable_dictionary_id_t>& var_ids) const {
+    var_ids.clear();
+    for (auto sub_query : m_relevant_sub_queries) {
+        const QueryVar* most_selective_dict_var = nullptr;
+        for (const auto& var : sub_query->get_vars()) {
+            if (false == var.is_dict_var()) {
+                continue;
+            }
+            if (var.is_precise_var()) {
+                most_selective_dict_var = &var;
+                break;
+            }
+            if (nullptr == most_selective_dict_var ||
+                var.get_possible_var_dict_entries().size() < most_selective_dict_var->get_possible_var_dict_entries().size())
+            {
+                most_selective_dict_var = &var;
+            }
+        }
+        if (nullptr == most_selective_dict_var) {
+            var_ids.clear();
+            return false;
+        }
+
+        if (most_selective_dict_var->is_precise_var()) {
+            var_ids.push_back(most_selective_dict_var->get_var_dict_entry()->get_id());
+        } else {
+            for (auto var_dict_entry : most_selective_dict_var->get_possible_var_dict_entries()) {
+                var_ids.push_back(var_dict_entry->get_id());
+            }
+        }
+    }
+    std::sort(var_ids.begin(), var_ids.end());
+    var_ids.erase(std::unique(var_ids.begin(), var_ids.end()), var_ids.end());
+    return true;
+}
+
 void Query::make_sub_queries_relevant_to_segment (segment_id_t segment_id) {
     if (false == m_all_subqueries_relevant && segment_id == m_prev_segment_id) {
         // Sub-queries already relevant to segment
@@ -194,7 +220,7 @@ void Query::make_sub_queries_relevant_to_segment (segment_id_t segment_id) {
     // Make sub-queries relevant to segment
     m_relevant_sub_queries.clear();
     for (auto& sub_query : m_sub_queries) {
-        if (sub_query.get_ids_of_matching_segments().count(segment_id)) {
+        if (sub_query.get_ids_of_matching_segments().contains(segment_id)) {
             m_relevant_sub_queries.push_back(&sub_query);
         }
     }
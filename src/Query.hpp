@@ -2,7 +2,6 @@
 #define QUERY_HPP
 
 // C++ standard libraries
-#include <set>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -10,6 +9,7 @@
 // Project headers
 #include "Defs.h"
 #include "LogTypeDictionaryEntry.hpp"
+#include "SegmentIdSet.hpp"
 #include "VariableDictionaryEntry.hpp"
 
 /**
@@ -36,7 +36,7 @@ public:
      * Removes segments from the given set that don't contain the given variable
      * @param segment_ids
      */
-    void remove_segments_that_dont_contain_dict_var (std::set<segment_id_t>& segment_ids) const;
+    void remove_segments_that_dont_contain_dict_var (SegmentIdSet& segment_ids) const;
 
     bool is_precise_var () const { return m_is_precise_var; }
     bool is_dict_var () const { return m_is_dict_var; }
@@ -101,7 +101,7 @@ public:
     const std::unordered_set<const LogTypeDictionaryEntry*>& get_possible_logtype_entries () const { return m_possible_logtype_entries; };
     size_t get_num_possible_vars () const { return m_vars.size(); }
     const std::vector<QueryVar>& get_vars () const { return m_vars; }
-    const std::set<segment_id_t>& get_ids_of_matching_segments () const { return m_ids_of_matching_segments; }
+    const SegmentIdSet& get_ids_of_matching_segments () const { return m_ids_of_matching_segments; }
 
     /**
      * Whether the given logtype ID matches one of the possible logtypes in this subquery
@@ -120,7 +120,7 @@ private:
     // Variables
     std::unordered_set<const LogTypeDictionaryEntry*> m_possible_logtype_entries;
     std::unordered_set<logtype_dictionary_id_t> m_possible_logtype_ids;
-    std::set<segment_id_t> m_ids_of_matching_segments;
+    SegmentIdSet m_ids_of_matching_segments;
     std::vector<QueryVar> m_vars;
     bool m_wildcard_match_required;
 };
@@ -173,6 +173,18 @@ public:
     const std::vector<SubQuery>& get_sub_queries () const { return m_sub_queries; }
     bool contains_sub_queries () const { return m_sub_queries.empty() == false; }
     const std::vector<const SubQuery*>& get_relevant_sub_queries () const { return m_relevant_sub_queries; }
+    /**
+     * Gets the IDs of the logtypes that the relevant sub-queries may match
+     * @param logtype_ids Returns the distinct IDs in ascending order
+     */
+    void get_relevant_possible_logtype_ids (std::vector<logtype_dictionary_id_t>& logtype_ids) const;
+    /**
+     * Gets the IDs of dictionary variables, at least one of which must be in any message that the relevant sub-queries match. For each sub-query,
+     * these are the possible IDs of the sub-query's dictionary variable with the fewest possibilities.
+     * @param var_ids Returns the distinct IDs in ascending order
+     * @return false if a relevant sub-query contains no dictionary variables, true otherwise
+     */
+    bool get_relevant_dict_var_ids (std::vector<variable_dictionary_id_t>& var_ids) const;
 
 private:
     // Variables
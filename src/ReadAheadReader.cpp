@@ -0,0 +1,118 @@
+#include "ReadAheadReader.hpp"
+
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+
+ReadAheadReader::ReadAheadReader () : m_reader(nullptr), m_current_block_pos(0), m_pos(0) {}
+
+ReadAheadReader::~ReadAheadReader () {
+    close();
+}
+
+ErrorCode ReadAheadReader::try_get_pos (size_t& pos) {
+    if (nullptr == m_reader) {
+        return ErrorCode_NotInit;
+    }
+
+    pos = m_pos;
+    return ErrorCode_Success;
+}
+
+ErrorCode ReadAheadReader::try_seek_from_begin (size_t pos) {
+    return ErrorCode_Unsupported;
+}
+
+ErrorCode ReadAheadReader::try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) {
+    if (nullptr == m_reader) {
+        return ErrorCode_NotInit;
+    }
+
+    num_bytes_read = 0;
+    while (m_current_block.length == m_current_block_pos) {
+        if (ErrorCode_Success != m_current_block.error_code) {
+            return m_current_block.error_code;
+        }
+
+        // Return the exhausted block to the background thread and get the next one
+        if (nullptr != m_current_block.buf) {
+            m_free_blocks->push(std::move(m_current_block));
+        }
+        m_current_block_pos = 0;
+        if (false == m_filled_blocks->pop(m_current_block)) {
+            // The background thread only stops without passing on an error if it threw
+            if (nullptr != m_read_exception) {
+                std::rethrow_exception(m_read_exception);
+            }
+            m_current_block.length = 0;
+            m_current_block.error_code = ErrorCode_EndOfFile;
+        }
+    }
+
+    num_bytes_read = std::min(num_bytes_to_read, m_current_block.length - m_current_block_pos);
+    memcpy(buf, m_current_block.buf.get() + m_current_block_pos, num_bytes_read);
+    m_current_block_pos += num_bytes_read;
+    m_pos += num_bytes_read;
+
+    return ErrorCode_Success;
+}
+
+void ReadAheadReader::open (ReaderInterface& reader) {
+    if (nullptr != m_reader) {
+        throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+    }
+
+    m_reader = &reader;
+    m_read_exception = nullptr;
+    m_current_block = Block();
+    m_current_block_pos = 0;
+    m_pos = 0;
+
+    m_filled_blocks = std::make_unique<BoundedSPSCQueue<Block>>(cNumBlocks);
+    m_free_blocks = std::make_unique<BoundedSPSCQueue<Block>>(cNumBlocks);
+    for (size_t i = 0; i < cNumBlocks; ++i) {
+        Block block;
+        block.buf = std::unique_ptr<char[]>(new char[cBlockSize]);
+        m_free_blocks->push(std::move(block));
+    }
+
+    m_read_thread = std::thread(&ReadAheadReader::read_blocks, this);
+}
+
+void ReadAheadReader::close () {
+    if (nullptr == m_reader) {
+        return;
+    }
+
+    // Wake the background thread in case it's waiting for a free block or for space to pass on a filled block
+    m_free_blocks->close();
+    m_filled_blocks->close();
+    m_read_thread.join();
+
+    m_filled_blocks.reset();
+    m_free_blocks.reset();
+    m_current_block = Block();
+    m_read_exception = nullptr;
+    m_reader = nullptr;
+}
+
+void ReadAheadReader::read_blocks () {
+    try {
+        Block block;
+        while (m_free_blocks->pop(block)) {
+            block.error_code = m_reader->try_read(block.buf.get(), cBlockSize, block.length);
+            if (ErrorCode_Success != block.error_code) {
+                block.length = 0;
+            }
+
+            // Stop after passing on an error (including EOF) since the caller will see it once it reaches the block
+            bool is_last_block = (ErrorCode_Success != block.error_code);
+            if (false == m_filled_blocks->push(std::move(block)) || is_last_block) {
+                break;
+            }
+        }
+    } catch (...) {
+        m_read_exception = std::current_exception();
+    }
+    m_filled_blocks->close();
+}
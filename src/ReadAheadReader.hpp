@@ -0,0 +1,115 @@
+#ifndef READAHEADREADER_HPP
+#define READAHEADREADER_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+
+// Project headers
+#include "BoundedSPSCQueue.hpp"
+#include "ErrorCode.hpp"
+#include "ReaderInterface.hpp"
+#include "TraceableException.hpp"
+
+/**
+ * Class that reads ahead from another reader on a background thread, so that reading (and decompressing, in the case of compressed inputs) overlaps with
+ * whatever the caller does with the content. Blocks of content are passed from the background thread through a bounded queue, so at most
+ * cNumBlocks * cBlockSize bytes are buffered.
+ */
+class ReadAheadReader : public ReaderInterface {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException (error_code, filename, line_number) {}
+
+        // Methods
+        const char* what () const noexcept override {
+            return "ReadAheadReader operation failed";
+        }
+    };
+
+    // Constants
+    static constexpr size_t cBlockSize = 64 * 1024;
+    static constexpr size_t cNumBlocks = 8;
+
+    // Constructors
+    ReadAheadReader ();
+
+    // Destructor
+    ~ReadAheadReader ();
+
+    // Methods implementing the ReaderInterface
+    /**
+     * Tries to get the number of bytes read from this reader so far
+     * @param pos
+     * @return ErrorCode_NotInit if the reader is not open
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_get_pos (size_t& pos) override;
+    /**
+     * Unsupported method
+     * @param pos
+     * @return ErrorCode_Unsupported
+     */
+    ErrorCode try_seek_from_begin (size_t pos) override;
+    /**
+     * Tries to read up to a given number of bytes from the content read ahead
+     * @param buf
+     * @param num_bytes_to_read The number of bytes to try and read
+     * @param num_bytes_read The actual number of bytes read
+     * @return ErrorCode_NotInit if the reader is not open
+     * @return ErrorCode_EndOfFile on EOF
+     * @return Same as the underlying reader's try_read on failure
+     * @return ErrorCode_Success on success
+     * @throw Any exception thrown by the underlying reader
+     */
+    ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override;
+
+    // Methods
+    /**
+     * Starts reading ahead from the given reader. The reader must not be used by anyone else until this reader is closed.
+     * @param reader
+     * @throw ReadAheadReader::OperationFailed if the reader is already open
+     */
+    void open (ReaderInterface& reader);
+    /**
+     * Stops reading ahead (if the background thread isn't already done) and waits for the background thread to exit
+     */
+    void close ();
+
+private:
+    // Types
+    struct Block {
+        Block () : length(0), error_code(ErrorCode_Success) {}
+
+        std::unique_ptr<char[]> buf;
+        size_t length;
+        // Error returned by the underlying reader after reading this block, if any
+        ErrorCode error_code;
+    };
+
+    // Methods
+    /**
+     * Reads blocks from the underlying reader until it returns an error (EOF included) or this reader is closed. This runs on the background thread.
+     */
+    void read_blocks ();
+
+    // Variables
+    ReaderInterface* m_reader;
+    std::thread m_read_thread;
+    std::exception_ptr m_read_exception;
+
+    // Blocks flow from the background thread to the caller through m_filled_blocks and back through m_free_blocks
+    std::unique_ptr<BoundedSPSCQueue<Block>> m_filled_blocks;
+    std::unique_ptr<BoundedSPSCQueue<Block>> m_free_blocks;
+
+    Block m_current_block;
+    size_t m_current_block_pos;
+    size_t m_pos;
+};
+
+#endif // READAHEADREADER_HPP
@@ -36,6 +36,10 @@ ErrorCode ReaderInterface::try_read_to_delimiter (char delim, bool keep_delimite
     return ErrorCode_Success;
 }
 
+ErrorCode ReaderInterface::try_read_view (size_t max_num_bytes_to_read, const char*& view, size_t& view_length) {
+    return ErrorCode_Unsupported;
+}
+
 bool ReaderInterface::read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) {
     ErrorCode error_code = try_read(buf, num_bytes_to_read, num_bytes_read);
     if (ErrorCode_EndOfFile == error_code) {
@@ -41,6 +41,18 @@ public:
      */
     virtual ErrorCode try_read_to_delimiter (char delim, bool keep_delimiter, bool append, std::string& str);
 
+    /**
+     * Tries to read up to a given number of bytes without copying them, by returning a view of content buffered by the reader. The view remains valid
+     * at least until the next read from the reader.
+     * NOTE: Implementations should override this if they can avoid copying content.
+     * @param max_num_bytes_to_read
+     * @param view
+     * @param view_length
+     * @return ErrorCode_Unsupported if the reader doesn't support views
+     * @return Same as ReaderInterface::try_read otherwise
+     */
+    virtual ErrorCode try_read_view (size_t max_num_bytes_to_read, const char*& view, size_t& view_length);
+
     /**
      * Reads up to a given number of bytes
      * @param buf
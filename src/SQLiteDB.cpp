@@ -15,6 +15,7 @@ void SQLiteDB::open (const string& path) {
         close();
         throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
     }
+    sqlite3_busy_timeout(m_db_handle, cBusyTimeoutMs);
 }
 
 bool SQLiteDB::close () {
@@ -27,6 +28,35 @@ bool SQLiteDB::close () {
     return true;
 }
 
+void SQLiteDB::enable_write_ahead_logging () {
+    auto statement = prepare_statement("PRAGMA journal_mode = WAL");
+    statement.step();
+    statement = prepare_statement("PRAGMA synchronous = NORMAL");
+    statement.step();
+    statement = prepare_statement("PRAGMA cache_size = -" + std::to_string(cWriterCacheSizeKiB));
+    statement.step();
+}
+
+void SQLiteDB::disable_write_ahead_logging () {
+    // Avoid writing to databases that aren't using the log, since readers may not have write access
+    string journal_mode;
+    {
+        auto statement = prepare_statement("PRAGMA journal_mode");
+        statement.step();
+        statement.column_string(0, journal_mode);
+    }
+    if ("wal" != journal_mode) {
+        return;
+    }
+
+    // NOTE: This fails with SQLITE_BUSY while other connections are using the log, in which case we leave it to the last one to close
+    auto return_value = sqlite3_exec(m_db_handle, "PRAGMA journal_mode = DELETE", nullptr, nullptr, nullptr);
+    if (SQLITE_OK != return_value && SQLITE_BUSY != return_value) {
+        SPDLOG_ERROR("Failed to disable write-ahead logging - {}", sqlite3_errmsg(m_db_handle));
+        throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
+    }
+}
+
 SQLitePreparedStatement SQLiteDB::prepare_statement (const string& statement) {
     if (nullptr == m_db_handle) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
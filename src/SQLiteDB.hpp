@@ -26,6 +26,12 @@ public:
         }
     };
 
+    // Constants
+    // How long to wait for another process (e.g., a search of an archive that's still being written) to release its lock on the database
+    static constexpr int cBusyTimeoutMs = 10000;
+    // Size of the page cache for connections which use write-ahead logging
+    static constexpr int cWriterCacheSizeKiB = 64 * 1024;
+
     // Constructors
     SQLiteDB () : m_db_handle(nullptr) {}
 
@@ -33,6 +39,20 @@ public:
     void open (const std::string& path);
     bool close ();
 
+    /**
+     * Switches the database to write-ahead logging so that commits append to the log rather than rewriting the database, and readers aren't blocked
+     * while a transaction is committed. The log is only synced when it's checkpointed into the database, so a crash may lose the most recent
+     * transactions, but it can't corrupt the database. The page cache is also enlarged so that large transactions (e.g., the metadata of thousands of
+     * files) don't spill pages to the log before they're committed.
+     */
+    void enable_write_ahead_logging ();
+    /**
+     * Checkpoints the write-ahead log and switches the database back to a rollback journal, so that it can be read without creating the log's
+     * shared-memory file (e.g., on read-only storage). If other connections are still using the log, the database is left in write-ahead logging mode,
+     * so every connection (reader or writer) should call this before closing so that the last one switches it back.
+     */
+    void disable_write_ahead_logging ();
+
     SQLitePreparedStatement prepare_statement (const std::string& statement);
 
     const char* get_error_message () { return sqlite3_errmsg(m_db_handle); }
@@ -0,0 +1,141 @@
+#include "SegmentIdSet.hpp"
+
+// C++ standard libraries
+#include <algorithm>
+
+using std::vector;
+
+// Local function prototypes
+/**
+ * Finds the first run which ends at or after the given ID
+ * @param runs
+ * @param segment_id
+ * @return Iterator to the run, or runs.cend() if there is none
+ */
+static vector<SegmentIdSet::Run>::const_iterator find_first_run_ending_at_or_after (const vector<SegmentIdSet::Run>& runs, segment_id_t segment_id);
+
+static vector<SegmentIdSet::Run>::const_iterator find_first_run_ending_at_or_after (const vector<SegmentIdSet::Run>& runs, segment_id_t segment_id) {
+    return std::lower_bound(runs.cbegin(), runs.cend(), segment_id, [] (const SegmentIdSet::Run& run, segment_id_t id) {
+        return run.last < id;
+    });
+}
+
+SegmentIdSet::const_iterator& SegmentIdSet::const_iterator::operator++ () {
+    if (m_id == m_run->last) {
+        ++m_run;
+        m_id = (m_run == m_runs_end) ? 0 : m_run->first;
+    } else {
+        ++m_id;
+    }
+    return *this;
+}
+
+SegmentIdSet::const_iterator SegmentIdSet::const_iterator::operator++ (int) {
+    auto previous = *this;
+    ++(*this);
+    return previous;
+}
+
+void SegmentIdSet::insert (segment_id_t segment_id) {
+    if (m_runs.empty() || segment_id > m_runs.back().last) {
+        // Common case: IDs are mostly added in ascending order
+        if (false == m_runs.empty() && m_runs.back().last + 1 == segment_id) {
+            m_runs.back().last = segment_id;
+        } else {
+            m_runs.push_back({segment_id, segment_id});
+        }
+        return;
+    }
+
+    auto run = m_runs.begin() + (find_first_run_ending_at_or_after(m_runs, segment_id) - m_runs.cbegin());
+    if (run->first <= segment_id) {
+        // Already in the set
+        return;
+    }
+
+    bool extends_previous_run = (m_runs.begin() != run && (run - 1)->last + 1 == segment_id);
+    bool extends_next_run = (segment_id + 1 == run->first);
+    if (extends_previous_run && extends_next_run) {
+        (run - 1)->last = run->last;
+        m_runs.erase(run);
+    } else if (extends_previous_run) {
+        (run - 1)->last = segment_id;
+    } else if (extends_next_run) {
+        run->first = segment_id;
+    } else {
+        m_runs.insert(run, {segment_id, segment_id});
+    }
+}
+
+bool SegmentIdSet::contains (segment_id_t segment_id) const {
+    auto run = find_first_run_ending_at_or_after(m_runs, segment_id);
+    return m_runs.cend() != run && run->first <= segment_id;
+}
+
+void SegmentIdSet::union_with (const SegmentIdSet& other) {
+    if (other.m_runs.empty()) {
+        return;
+    }
+    if (m_runs.empty()) {
+        m_runs = other.m_runs;
+        return;
+    }
+
+    vector<Run> merged_runs;
+    merged_runs.reserve(m_runs.size() + other.m_runs.size());
+    auto run = m_runs.cbegin();
+    auto other_run = other.m_runs.cbegin();
+    while (m_runs.cend() != run || other.m_runs.cend() != other_run) {
+        // Take the run which starts first
+        const Run* next_run;
+        if (other.m_runs.cend() == other_run || (m_runs.cend() != run && run->first <= other_run->first)) {
+            next_run = &(*run++);
+        } else {
+            next_run = &(*other_run++);
+        }
+
+        if (false == merged_runs.empty() && (merged_runs.back().last >= next_run->first || merged_runs.back().last + 1 == next_run->first)) {
+            merged_runs.back().last = std::max(merged_runs.back().last, next_run->last);
+        } else {
+            merged_runs.push_back(*next_run);
+        }
+    }
+    m_runs = std::move(merged_runs);
+}
+
+void SegmentIdSet::intersect_with (const SegmentIdSet& other) {
+    if (m_runs.empty()) {
+        return;
+    }
+    if (other.m_runs.empty()) {
+        m_runs.clear();
+        return;
+    }
+
+    // NOTE: Since the runs of each set are separated by gaps, so are their overlaps
+    vector<Run> overlapping_runs;
+    auto run = m_runs.cbegin();
+    auto other_run = other.m_runs.cbegin();
+    while (m_runs.cend() != run && other.m_runs.cend() != other_run) {
+        auto first = std::max(run->first, other_run->first);
+        auto last = std::min(run->last, other_run->last);
+        if (first <= last) {
+            overlapping_runs.push_back({first, last});
+        }
+
+        if (run->last < other_run->last) {
+            ++run;
+        } else {
+            ++other_run;
+        }
+    }
+    m_runs = std::move(overlapping_runs);
+}
+
+size_t SegmentIdSet::size () const {
+    size_t num_ids = 0;
+    for (const auto& run : m_runs) {
+        num_ids += run.last - run.first + 1;
+    }
+    return num_ids;
+}
@@ -0,0 +1,105 @@
+#ifndef SEGMENTIDSET_HPP
+#define SEGMENTIDSET_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+// Project headers
+#include "Defs.h"
+
+/**
+ * A set of segment IDs stored as a compressed bitmap, i.e., a sorted list of disjoint runs of consecutive IDs. Since segments are created in ID order
+ * and most entries recur across many consecutive segments, a set typically holds a few runs regardless of how many segments it contains. Unions
+ * and intersections are computed by merging the runs of both sets, so their cost depends on the number of runs rather than the number of IDs.
+ */
+class SegmentIdSet {
+public:
+    // Types
+    /**
+     * A run of consecutive IDs, from first to last inclusive
+     */
+    struct Run {
+        segment_id_t first;
+        segment_id_t last;
+
+        bool operator== (const Run& rhs) const { return first == rhs.first && last == rhs.last; }
+    };
+
+    /**
+     * Iterates over the IDs in the set in ascending order
+     */
+    class const_iterator {
+    public:
+        // Types
+        typedef std::forward_iterator_tag iterator_category;
+        typedef segment_id_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const segment_id_t* pointer;
+        typedef const segment_id_t& reference;
+
+        // Constructors
+        const_iterator (const Run* run, const Run* runs_end) : m_run(run), m_runs_end(runs_end), m_id(run == runs_end ? 0 : run->first) {}
+
+        // Methods
+        reference operator* () const { return m_id; }
+        pointer operator-> () const { return &m_id; }
+        const_iterator& operator++ ();
+        const_iterator operator++ (int);
+        bool operator== (const const_iterator& rhs) const { return m_run == rhs.m_run && m_id == rhs.m_id; }
+        bool operator!= (const const_iterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        // Variables
+        const Run* m_run;
+        const Run* m_runs_end;
+        segment_id_t m_id;
+    };
+
+    // Methods
+    /**
+     * Adds the given ID to the set. Adding IDs in ascending order takes constant time.
+     * @param segment_id
+     */
+    void insert (segment_id_t segment_id);
+    /**
+     * Tests if the set contains the given ID
+     * @param segment_id
+     * @return true if it does, false otherwise
+     */
+    bool contains (segment_id_t segment_id) const;
+
+    /**
+     * Replaces the set with its union with the given set
+     * @param other
+     */
+    void union_with (const SegmentIdSet& other);
+    /**
+     * Replaces the set with its intersection with the given set
+     * @param other
+     */
+    void intersect_with (const SegmentIdSet& other);
+
+    void clear () { m_runs.clear(); }
+
+    bool empty () const { return m_runs.empty(); }
+    /**
+     * @return The number of IDs in the set
+     */
+    size_t size () const;
+    size_t get_num_runs () const { return m_runs.size(); }
+
+    const_iterator begin () const { return {m_runs.data(), m_runs.data() + m_runs.size()}; }
+    const_iterator end () const { return {m_runs.data() + m_runs.size(), m_runs.data() + m_runs.size()}; }
+
+    bool operator== (const SegmentIdSet& rhs) const { return m_runs == rhs.m_runs; }
+    bool operator!= (const SegmentIdSet& rhs) const { return m_runs != rhs.m_runs; }
+
+private:
+    // Variables
+    // Sorted, and no two runs overlap or are adjacent, so every set has exactly one representation
+    std::vector<Run> m_runs;
+};
+
+#endif // SEGMENTIDSET_HPP
@@ -1,6 +1,7 @@
 #include "TimestampPattern.hpp"
 
 // C++ standard libraries
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <vector>
@@ -12,12 +13,16 @@
 #include <spdlog/spdlog.h>
 
 using std::string;
+using std::string_view;
 using std::to_string;
 using std::vector;
 
 // Static member default initialization
 std::unique_ptr<TimestampPattern[]> TimestampPattern::m_known_ts_patterns = nullptr;
 size_t TimestampPattern::m_known_ts_patterns_len = 0;
+std::unique_ptr<uint64_t[]> TimestampPattern::m_known_ts_pattern_candidate_masks = nullptr;
+uint8_t TimestampPattern::m_known_ts_patterns_max_num_spaces_before_ts = 0;
+constexpr size_t TimestampPattern::cNumChars;
 
 // File-scope constants
 static constexpr int cNumDaysInWeek = 7;
@@ -27,6 +32,19 @@ static const char* cAbbrevMonthNames[cNumMonths] = { "Jan", "Feb", "Mar", "Apr",
 static const char* cMonthNames[cNumMonths] = {
     "January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"
 };
+static constexpr epochtime_t cNumMillisecondsInSecond = 1000;
+static constexpr epochtime_t cNumMillisecondsInMinute = 60 * cNumMillisecondsInSecond;
+static constexpr epochtime_t cNumMillisecondsInHour = 60 * cNumMillisecondsInMinute;
+static constexpr epochtime_t cNumMillisecondsInDay = 24 * cNumMillisecondsInHour;
+
+// File-scope variables
+// The most recently parsed date and the epoch time at its beginning. Consecutive lines almost always share the same date, so this lets us skip
+// converting the date to an epoch time for most lines. Since the conversion doesn't depend on the pattern, a single cache is shared by all patterns
+// (per thread).
+static thread_local int cached_parsed_year = 1970;
+static thread_local int cached_parsed_month = 1;
+static thread_local int cached_parsed_date = 1;
+static thread_local epochtime_t cached_parsed_day_begin_ts = 0;
 
 // File-scope functions
 /**
@@ -37,6 +55,21 @@ static const char* cMonthNames[cNumMonths] = {
 * @param str
 */
 static void append_padded_value (int value, char padding_character, size_t length, string& str);
+/**
+ * Writes a non-negative value as a padded string with the given length into the given buffer
+ * @param value
+ * @param padding_character
+ * @param length
+ * @param buf Buffer with at least length bytes
+ */
+static void write_padded_value (int value, char padding_character, size_t length, char* buf);
+/**
+ * Rounds the given value down to the nearest multiple (towards negative infinity)
+ * @param value
+ * @param multiple
+ * @return The rounded value
+ */
+static epochtime_t floor_to_multiple (epochtime_t value, epochtime_t multiple);
 /**
  * Converts a padded decimal integer string (from a larger string) to an integer
  * @param str String containing the numeric string
@@ -46,7 +79,7 @@ static void append_padded_value (int value, char padding_character, size_t lengt
  * @param value String as a number
  * @return true if conversion succeeds, false otherwise
  */
-static bool convert_string_to_number (const string& str, size_t begin_ix, size_t end_ix, char padding_character, int& value);
+static bool convert_string_to_number (string_view str, size_t begin_ix, size_t end_ix, char padding_character, int& value);
 
 static void append_padded_value (const int value, const char padding_character, const size_t length, string& str) {
     string value_str = to_string(value);
@@ -54,7 +87,26 @@ static void append_padded_value (const int value, const char padding_character,
     str += value_str;
 }
 
-static bool convert_string_to_number (const string& str, const size_t begin_ix, const size_t end_ix, const char padding_character, int& value) {
+static void write_padded_value (int value, const char padding_character, const size_t length, char* buf) {
+    size_t ix = length;
+    do {
+        buf[--ix] = (char)('0' + value % 10);
+        value /= 10;
+    } while (ix > 0 && value > 0);
+    while (ix > 0) {
+        buf[--ix] = padding_character;
+    }
+}
+
+static epochtime_t floor_to_multiple (const epochtime_t value, const epochtime_t multiple) {
+    epochtime_t remainder = value % multiple;
+    if (remainder < 0) {
+        remainder += multiple;
+    }
+    return value - remainder;
+}
+
+static bool convert_string_to_number (string_view str, const size_t begin_ix, const size_t end_ix, const char padding_character, int& value) {
     // Consume padding characters
     size_t ix = begin_ix;
     while (ix < end_ix && padding_character == str[ix]) {
@@ -140,12 +192,64 @@ void TimestampPattern::init () {
     for (size_t i = 0; i < patterns.size(); ++i) {
         m_known_ts_patterns[i] = patterns[i];
     }
+
+    // Build the candidate masks used to quickly rule out patterns in search_known_ts_patterns
+    if (m_known_ts_patterns_len > sizeof(uint64_t) * 8) {
+        SPDLOG_ERROR("Number of known timestamp patterns ({}) exceeds the width of the candidate masks", m_known_ts_patterns_len);
+        throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
+    }
+    m_known_ts_patterns_max_num_spaces_before_ts = 0;
+    for (size_t i = 0; i < m_known_ts_patterns_len; ++i) {
+        m_known_ts_patterns_max_num_spaces_before_ts = std::max(m_known_ts_patterns_max_num_spaces_before_ts,
+                                                                m_known_ts_patterns[i].m_num_spaces_before_ts);
+    }
+    size_t num_masks = (m_known_ts_patterns_max_num_spaces_before_ts + 1) * cNumChars;
+    m_known_ts_pattern_candidate_masks = std::make_unique<uint64_t[]>(num_masks);
+    for (size_t i = 0; i < num_masks; ++i) {
+        m_known_ts_pattern_candidate_masks[i] = 0;
+    }
+    bool possible_first_chars[cNumChars];
+    for (size_t i = 0; i < m_known_ts_patterns_len; ++i) {
+        const auto& pattern = m_known_ts_patterns[i];
+        pattern.get_possible_first_chars(possible_first_chars);
+        auto masks = &m_known_ts_pattern_candidate_masks[pattern.m_num_spaces_before_ts * cNumChars];
+        for (size_t c = 0; c < cNumChars; ++c) {
+            if (possible_first_chars[c]) {
+                masks[c] |= (uint64_t)1 << i;
+            }
+        }
+    }
 }
 
-const TimestampPattern* TimestampPattern::search_known_ts_patterns (const string& line, epochtime_t& timestamp, size_t& timestamp_begin_pos,
+const TimestampPattern* TimestampPattern::search_known_ts_patterns (string_view line, epochtime_t& timestamp, size_t& timestamp_begin_pos,
                                                                     size_t& timestamp_end_pos)
 {
-    for (size_t i = 0; i < m_known_ts_patterns_len; ++i) {
+    // Determine which patterns could match based on the character where their timestamp would begin
+    const size_t line_length = line.length();
+    uint64_t candidates = 0;
+    size_t ts_begin_ix = 0;
+    for (uint8_t num_spaces_before_ts = 0; ts_begin_ix < line_length; ++num_spaces_before_ts) {
+        candidates |= m_known_ts_pattern_candidate_masks[num_spaces_before_ts * cNumChars + (unsigned char)line[ts_begin_ix]];
+        if (m_known_ts_patterns_max_num_spaces_before_ts == num_spaces_before_ts) {
+            break;
+        }
+
+        // Skip past the next space
+        auto next_space = (const char*)memchr(line.data() + ts_begin_ix, ' ', line_length - ts_begin_ix);
+        if (nullptr == next_space) {
+            break;
+        }
+        ts_begin_ix = next_space - line.data() + 1;
+    }
+
+    // Try candidates in order of priority
+    for (size_t i = 0; 0 != candidates && i < m_known_ts_patterns_len; ++i) {
+        uint64_t pattern_bit = (uint64_t)1 << i;
+        if (0 == (candidates & pattern_bit)) {
+            continue;
+        }
+        candidates &= ~pattern_bit;
+
         if (m_known_ts_patterns[i].parse_timestamp(line, timestamp, timestamp_begin_pos, timestamp_end_pos)) {
             return &m_known_ts_patterns[i];
         }
@@ -171,9 +275,85 @@ bool TimestampPattern::is_empty () const {
 void TimestampPattern::clear () {
     m_num_spaces_before_ts = 0;
     m_format.clear();
+    m_formatted_ts_cache.is_valid = false;
 }
 
-bool TimestampPattern::parse_timestamp (const string& line, epochtime_t& timestamp, size_t& timestamp_begin_pos, size_t& timestamp_end_pos) const {
+void TimestampPattern::get_possible_first_chars (bool chars[cNumChars]) const {
+    for (size_t c = 0; c < cNumChars; ++c) {
+        chars[c] = false;
+    }
+    if (m_format.empty()) {
+        return;
+    }
+
+    if ('%' != m_format[0]) {
+        chars[(unsigned char)m_format[0]] = true;
+        return;
+    }
+    if (m_format.length() < 2) {
+        // Incomplete specifier can't match anything
+        return;
+    }
+    switch (m_format[1]) {
+        case '%':
+            chars['%'] = true;
+            break;
+
+        case 'y':
+        case 'Y':
+        case 'm':
+        case 'd':
+        case 'H':
+        case 'I':
+        case 'M':
+        case 'S':
+        case '3':
+            // Zero-padded numbers
+            for (char c = '0'; c <= '9'; ++c) {
+                chars[(unsigned char)c] = true;
+            }
+            break;
+
+        case 'e':
+        case 'k':
+        case 'l':
+            // Space-padded numbers
+            chars[' '] = true;
+            for (char c = '0'; c <= '9'; ++c) {
+                chars[(unsigned char)c] = true;
+            }
+            break;
+
+        case 'B':
+            for (auto month_name : cMonthNames) {
+                chars[(unsigned char)month_name[0]] = true;
+            }
+            break;
+
+        case 'b':
+            for (auto month_name : cAbbrevMonthNames) {
+                chars[(unsigned char)month_name[0]] = true;
+            }
+            break;
+
+        case 'a':
+            for (auto day_name : cAbbrevDaysOfWeek) {
+                chars[(unsigned char)day_name[0]] = true;
+            }
+            break;
+
+        case 'p':
+            chars['A'] = true;
+            chars['P'] = true;
+            break;
+
+        default:
+            // Unsupported specifiers can't match anything
+            break;
+    }
+}
+
+bool TimestampPattern::parse_timestamp (string_view line, epochtime_t& timestamp, size_t& timestamp_begin_pos, size_t& timestamp_end_pos) const {
     size_t line_ix = 0;
     const size_t line_length = line.length();
 
@@ -526,20 +706,23 @@ bool TimestampPattern::parse_timestamp (const string& line, epochtime_t& timesta
         }
     }
 
-    // Create complete date
-    auto year_month_date = date::year(year)/month/date;
-    if (!year_month_date.ok()) {
-        return false;
+    // Convert the date into the epoch time at the beginning of the day, unless it's the same as the last parsed date
+    if (date != cached_parsed_date || month != cached_parsed_month || year != cached_parsed_year) {
+        auto year_month_date = date::year(year)/month/date;
+        if (!year_month_date.ok()) {
+            return false;
+        }
+        auto days_since_epoch = date::sys_days(year_month_date) - date::sys_days(date::year(1970)/1/1);
+
+        cached_parsed_year = year;
+        cached_parsed_month = month;
+        cached_parsed_date = date;
+        cached_parsed_day_begin_ts = days_since_epoch.count() * cNumMillisecondsInDay;
     }
-    // Convert complete timestamp into a time point with millisecond resolution
-    auto timestamp_point = date::sys_days(year_month_date) + std::chrono::hours(hour) + std::chrono::minutes(minute) + std::chrono::seconds(second) +
-                           std::chrono::milliseconds(millisecond);
-    // Get time point since epoch
-    auto unix_epoch_point = date::sys_days(date::year(1970)/1/1);
-    // Get timestamp since epoch
-    auto duration_since_epoch = timestamp_point - unix_epoch_point;
-    // Convert to raw milliseconds
-    timestamp = duration_since_epoch.count();
+    // Add the time of day
+    // NOTE: None of the supported patterns contain a timezone, so there's no offset to apply
+    timestamp = cached_parsed_day_begin_ts + hour * cNumMillisecondsInHour + minute * cNumMillisecondsInMinute + second * cNumMillisecondsInSecond +
+                millisecond;
 
     timestamp_begin_pos = ts_begin_ix;
     timestamp_end_pos = line_ix;
@@ -550,10 +733,6 @@ bool TimestampPattern::parse_timestamp (const string& line, epochtime_t& timesta
 void TimestampPattern::insert_formatted_timestamp (const epochtime_t timestamp, string& msg) const {
     size_t msg_length = msg.length();
 
-    string new_msg;
-    // We add 50 as an estimate of the timestamp's length
-    new_msg.reserve(msg_length + 50);
-
     // Find where timestamp should go
     size_t ts_begin_ix = 0;
     int num_spaces_found;
@@ -567,24 +746,49 @@ void TimestampPattern::insert_formatted_timestamp (const epochtime_t timestamp,
         throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
     }
 
-    // Copy text before timestamp
-    new_msg.assign(msg, 0, ts_begin_ix);
-
-    // Separate parts of timestamp
-    auto timestamp_point = date::sys_days(date::year(1970)/1/1) + std::chrono::milliseconds(timestamp);
-    auto timestamp_date = date::floor<date::days>(timestamp_point);
-    int day_of_week_ix = (date::year_month_weekday(timestamp_date).weekday_indexed().weekday() - date::Sunday).count();
-    auto year_month_date = date::year_month_day(timestamp_date);
-    unsigned date = (unsigned)year_month_date.day();
-    unsigned month = (unsigned)year_month_date.month();
-    int year = (int)year_month_date.year();
-
-    auto time_of_day_duration = timestamp_point - timestamp_date;
-    auto time_of_day = date::make_time(time_of_day_duration);
-    int hour = time_of_day.hours().count();
-    int minute = time_of_day.minutes().count();
-    int second = time_of_day.seconds().count();
-    int millisecond = time_of_day.subseconds().count();
+    auto& cache = m_formatted_ts_cache;
+    if (cache.is_valid && timestamp >= cache.second_begin_ts && timestamp - cache.second_begin_ts < cNumMillisecondsInSecond) {
+        // Same second as the cached timestamp, so only the milliseconds (if any) need to be rewritten
+        int millisecond = (int)(timestamp - cache.second_begin_ts);
+        if (millisecond != cache.millisecond) {
+            for (auto pos : cache.millisecond_positions) {
+                write_padded_value(millisecond, '0', 3, &cache.formatted_ts[pos]);
+            }
+            cache.millisecond = millisecond;
+        }
+    } else {
+        format_timestamp_into_cache(timestamp);
+    }
+
+    msg.insert(ts_begin_ix, cache.formatted_ts);
+}
+
+void TimestampPattern::format_timestamp_into_cache (const epochtime_t timestamp) const {
+    auto& cache = m_formatted_ts_cache;
+
+    // Only break the timestamp into calendar fields if it falls on a different day than the cached timestamp
+    epochtime_t day_begin_ts = floor_to_multiple(timestamp, cNumMillisecondsInDay);
+    if (false == cache.is_valid || day_begin_ts != cache.day_begin_ts) {
+        auto timestamp_date = date::sys_days(date::year(1970)/1/1) + date::days(day_begin_ts / cNumMillisecondsInDay);
+        cache.day_of_week_ix = (date::year_month_weekday(timestamp_date).weekday_indexed().weekday() - date::Sunday).count();
+        auto year_month_date = date::year_month_day(timestamp_date);
+        cache.date = (unsigned)year_month_date.day();
+        cache.month = (unsigned)year_month_date.month();
+        cache.year = (int)year_month_date.year();
+        cache.day_begin_ts = day_begin_ts;
+    }
+    // Invalidate the cache until it's completely rebuilt, in case formatting fails
+    cache.is_valid = false;
+
+    epochtime_t time_of_day = timestamp - day_begin_ts;
+    int hour = (int)(time_of_day / cNumMillisecondsInHour);
+    int minute = (int)(time_of_day % cNumMillisecondsInHour / cNumMillisecondsInMinute);
+    int second = (int)(time_of_day % cNumMillisecondsInMinute / cNumMillisecondsInSecond);
+    int millisecond = (int)(time_of_day % cNumMillisecondsInSecond);
+
+    auto& new_ts = cache.formatted_ts;
+    new_ts.clear();
+    cache.millisecond_positions.clear();
 
     const size_t format_length = m_format.length();
     bool is_specifier = false;
@@ -593,71 +797,71 @@ void TimestampPattern::insert_formatted_timestamp (const epochtime_t timestamp,
             if ('%' == m_format[format_ix]) {
                 is_specifier = true;
             } else {
-                new_msg += m_format[format_ix];
+                new_ts += m_format[format_ix];
             }
         } else {
             // Parse fields
             switch (m_format[format_ix]) {
                 case '%':
-                    new_msg += m_format[format_ix];
+                    new_ts += m_format[format_ix];
                     break;
 
                 case 'y': { // Zero-padded year in century
-                    int value = year;
-                    if (year >= 2000) {
+                    int value = cache.year;
+                    if (cache.year >= 2000) {
                         // year must be in range [2000,2068]
                         value -= 2000;
                     } else {
                         // year must be in range [1969,1999]
                         value -= 1900;
                     }
-                    append_padded_value(value, '0', 2, new_msg);
+                    append_padded_value(value, '0', 2, new_ts);
                     break;
                 }
 
                 case 'Y': // Zero-padded year with century
-                    append_padded_value(year, '0', 4, new_msg);
+                    append_padded_value(cache.year, '0', 4, new_ts);
                     break;
 
                 case 'B': // Month name
-                    new_msg += cMonthNames[month - 1];
+                    new_ts += cMonthNames[cache.month - 1];
                     break;
 
                 case 'b': // Abbreviated month name
-                    new_msg += cAbbrevMonthNames[month - 1];
+                    new_ts += cAbbrevMonthNames[cache.month - 1];
                     break;
 
                 case 'm': // Zero-padded month
-                    append_padded_value(month, '0', 2, new_msg);
+                    append_padded_value(cache.month, '0', 2, new_ts);
                     break;
 
                 case 'd': // Zero-padded day in month
-                    append_padded_value(date, '0', 2, new_msg);
+                    append_padded_value(cache.date, '0', 2, new_ts);
                     break;
 
                 case 'e': // Space-padded day in month
-                    append_padded_value(date, ' ', 2, new_msg);
+                    append_padded_value(cache.date, ' ', 2, new_ts);
                     break;
 
                 case 'a': // Abbreviated day of week
-                    new_msg += cAbbrevDaysOfWeek[day_of_week_ix];
+                    new_ts += cAbbrevDaysOfWeek[cache.day_of_week_ix];
                     break;
 
                 case 'p': { // Part of day
                     if (hour > 11) {
-                        new_msg += "PM";
+                        new_ts += "PM";
                     } else {
-                        new_msg += "AM";
+                        new_ts += "AM";
                     }
                     break;
                 }
 
                 case 'H': // Zero-padded hour on 24-hour clock
-                    append_padded_value(hour, '0', 2, new_msg);
+                    append_padded_value(hour, '0', 2, new_ts);
                     break;
 
                 case 'k': // Space-padded hour on 24-hour clock
-                    append_padded_value(hour, ' ', 2, new_msg);
+                    append_padded_value(hour, ' ', 2, new_ts);
                     break;
 
                 case 'I': { // Zero-padded hour on 12-hour clock
@@ -667,7 +871,7 @@ void TimestampPattern::insert_formatted_timestamp (const epochtime_t timestamp,
                     } else if (value > 13) {
                         value -= 12;
                     }
-                    append_padded_value(value, '0', 2, new_msg);
+                    append_padded_value(value, '0', 2, new_ts);
                     break;
                 }
 
@@ -678,20 +882,21 @@ void TimestampPattern::insert_formatted_timestamp (const epochtime_t timestamp,
                     } else if (value > 13) {
                         value -= 12;
                     }
-                    append_padded_value(value, ' ', 2, new_msg);
+                    append_padded_value(value, ' ', 2, new_ts);
                     break;
                 }
 
                 case 'M': // Zero-padded minute
-                    append_padded_value(minute, '0', 2, new_msg);
+                    append_padded_value(minute, '0', 2, new_ts);
                     break;
 
                 case 'S': // Zero-padded second
-                    append_padded_value(second, '0', 2, new_msg);
+                    append_padded_value(second, '0', 2, new_ts);
                     break;
 
                 case '3': // Zero-padded millisecond
-                    append_padded_value(millisecond, '0', 3, new_msg);
+                    cache.millisecond_positions.push_back(new_ts.length());
+                    append_padded_value(millisecond, '0', 3, new_ts);
                     break;
 
                 default: {
@@ -702,10 +907,9 @@ void TimestampPattern::insert_formatted_timestamp (const epochtime_t timestamp,
         }
     }
 
-    // Copy text after timestamp
-    new_msg.append(msg, ts_begin_ix, string::npos);
-
-    msg = new_msg;
+    cache.second_begin_ts = timestamp - millisecond;
+    cache.millisecond = millisecond;
+    cache.is_valid = true;
 }
 
 bool operator== (const TimestampPattern& lhs, const TimestampPattern& rhs) {
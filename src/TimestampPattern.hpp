@@ -5,6 +5,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 // Project headers
 #include "Defs.h"
@@ -53,8 +56,9 @@ public:
     };
 
     // Constructors
-    TimestampPattern () : m_num_spaces_before_ts(0) {}
-    TimestampPattern (uint8_t num_spaces_before_ts, const std::string& format) : m_num_spaces_before_ts(num_spaces_before_ts), m_format(format) {}
+    TimestampPattern () : m_num_spaces_before_ts(0), m_formatted_ts_cache() {}
+    TimestampPattern (uint8_t num_spaces_before_ts, const std::string& format) : m_num_spaces_before_ts(num_spaces_before_ts), m_format(format),
+            m_formatted_ts_cache() {}
 
     // Methods
     /**
@@ -70,7 +74,7 @@ public:
      * @param timestamp_end_pos
      * @return pointer to the timestamp pattern if found, nullptr otherwise
      */
-    static const TimestampPattern* search_known_ts_patterns (const std::string& line, epochtime_t& timestamp, size_t& timestamp_begin_pos,
+    static const TimestampPattern* search_known_ts_patterns (std::string_view line, epochtime_t& timestamp, size_t& timestamp_begin_pos,
                                                              size_t& timestamp_end_pos);
 
     /**
@@ -102,9 +106,10 @@ public:
      * @param timestamp_end_pos
      * @return true if parsed successfully, false otherwise
      */
-    bool parse_timestamp (const std::string& line, epochtime_t& timestamp, size_t& timestamp_begin_pos, size_t& timestamp_end_pos) const;
+    bool parse_timestamp (std::string_view line, epochtime_t& timestamp, size_t& timestamp_begin_pos, size_t& timestamp_end_pos) const;
     /**
      * Inserts the timestamp into the given message using this pattern
+     * NOTE: The most recently formatted timestamp is cached within the pattern, so the same pattern shouldn't be used from multiple threads
      * @param timestamp
      * @param msg
      * @throw TimestampPattern::OperationFailed if the the pattern contains unsupported format specifiers or the message cannot fit the timestamp pattern
@@ -127,15 +132,62 @@ public:
     friend bool operator!= (const TimestampPattern& lhs, const TimestampPattern& rhs);
 
 private:
+    // Constants
+    static constexpr size_t cNumChars = 256;
+
+    // Types
+    /**
+     * Cache of the most recently formatted timestamp. Consecutive messages usually fall on the same day and often within the same second, so we only
+     * recompute the calendar fields when the day changes and only re-render the timestamp when the second changes. Within the same second, only the
+     * millisecond fields are rewritten.
+     */
+    struct FormattedTimestampCache {
+        FormattedTimestampCache () : is_valid(false), day_begin_ts(0), second_begin_ts(0), millisecond(0), year(1970), month(1), date(1),
+                                     day_of_week_ix(0) {}
+
+        bool is_valid;
+        epochtime_t day_begin_ts;
+        epochtime_t second_begin_ts;
+        int millisecond;
+        int year;
+        unsigned month;
+        unsigned date;
+        int day_of_week_ix;
+        std::string formatted_ts;
+        // Positions of the millisecond fields in formatted_ts
+        std::vector<size_t> millisecond_positions;
+    };
+
+    // Methods
+    /**
+     * Formats the given timestamp into the cache, reusing the cached calendar fields if the timestamp falls on the cached day
+     * @param timestamp
+     * @throw TimestampPattern::OperationFailed if the the pattern contains unsupported format specifiers
+     */
+    void format_timestamp_into_cache (epochtime_t timestamp) const;
+
+    /**
+     * Gets the set of characters which can begin a timestamp matching this pattern
+     * @param chars Set to true for each character that can begin the timestamp
+     */
+    void get_possible_first_chars (bool chars[cNumChars]) const;
+
     // Variables
     static std::unique_ptr<TimestampPattern[]> m_known_ts_patterns;
     static size_t m_known_ts_patterns_len;
+    // For each number of spaces before a timestamp and each character, a bitmask of the known patterns (bit i corresponds to
+    // m_known_ts_patterns[i]) whose timestamp can begin with that character. This allows us to skip patterns which can't possibly match a line
+    // (e.g., stack trace lines) without parsing the line with each pattern.
+    static std::unique_ptr<uint64_t[]> m_known_ts_pattern_candidate_masks;
+    static uint8_t m_known_ts_patterns_max_num_spaces_before_ts;
 
     // The number of spaces before the timestamp in a message
     // E.g. in "localhost - - [01/Jan/2016:15:50:17", there are 3 spaces before the timestamp
     //                   ^ ^ ^
     uint8_t m_num_spaces_before_ts;
     std::string m_format;
+
+    mutable FormattedTimestampCache m_formatted_ts_cache;
 };
 
 #endif // TIMESTAMPPATTERN_HPP
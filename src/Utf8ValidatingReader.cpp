@@ -0,0 +1,71 @@
+#include "Utf8ValidatingReader.hpp"
+
+ErrorCode Utf8ValidatingReader::try_get_pos (size_t& pos) {
+    if (nullptr == m_reader) {
+        return ErrorCode_NotInit;
+    }
+
+    pos = m_pos;
+    return ErrorCode_Success;
+}
+
+ErrorCode Utf8ValidatingReader::try_seek_from_begin (size_t pos) {
+    return ErrorCode_Unsupported;
+}
+
+ErrorCode Utf8ValidatingReader::try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) {
+    if (nullptr == m_reader) {
+        return ErrorCode_NotInit;
+    }
+    if (false == m_validator->is_valid()) {
+        return ErrorCode_EndOfFile;
+    }
+
+    auto error_code = m_reader->try_read(buf, num_bytes_to_read, num_bytes_read);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    if (false == m_validator->validate(buf, num_bytes_read)) {
+        num_bytes_read = 0;
+        return ErrorCode_EndOfFile;
+    }
+
+    m_pos += num_bytes_read;
+    return ErrorCode_Success;
+}
+
+ErrorCode Utf8ValidatingReader::try_read_view (size_t max_num_bytes_to_read, const char*& view, size_t& view_length) {
+    if (nullptr == m_reader) {
+        return ErrorCode_NotInit;
+    }
+    if (false == m_validator->is_valid()) {
+        return ErrorCode_EndOfFile;
+    }
+
+    auto error_code = m_reader->try_read_view(max_num_bytes_to_read, view, view_length);
+    if (ErrorCode_Success != error_code) {
+        return error_code;
+    }
+    if (false == m_validator->validate(view, view_length)) {
+        view_length = 0;
+        return ErrorCode_EndOfFile;
+    }
+
+    m_pos += view_length;
+    return ErrorCode_Success;
+}
+
+void Utf8ValidatingReader::open (ReaderInterface& reader, Utf8Validator& validator) {
+    if (nullptr != m_reader) {
+        throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
+    }
+
+    m_reader = &reader;
+    m_validator = &validator;
+    m_pos = 0;
+}
+
+void Utf8ValidatingReader::close () {
+    m_reader = nullptr;
+    m_validator = nullptr;
+}
@@ -0,0 +1,87 @@
+#ifndef UTF8VALIDATINGREADER_HPP
+#define UTF8VALIDATINGREADER_HPP
+
+// C++ standard libraries
+#include <cstddef>
+
+// Project headers
+#include "ErrorCode.hpp"
+#include "ReaderInterface.hpp"
+#include "TraceableException.hpp"
+#include "Utf8Validator.hpp"
+
+/**
+ * Class that validates content as it's read from another reader, so that content which isn't UTF-8 encoded is caught without a separate pass. Once
+ * invalid content is read, the reader ends early, i.e., it returns ErrorCode_EndOfFile without returning the content from the read that was invalid.
+ */
+class Utf8ValidatingReader : public ReaderInterface {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException (error_code, filename, line_number) {}
+
+        // Methods
+        const char* what () const noexcept override {
+            return "Utf8ValidatingReader operation failed";
+        }
+    };
+
+    // Constructors
+    Utf8ValidatingReader () : m_reader(nullptr), m_validator(nullptr), m_pos(0) {}
+
+    // Methods implementing the ReaderInterface
+    /**
+     * Tries to get the number of bytes returned by this reader so far
+     * @param pos
+     * @return ErrorCode_NotInit if the reader is not open
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_get_pos (size_t& pos) override;
+    /**
+     * Unsupported method
+     * @param pos
+     * @return ErrorCode_Unsupported
+     */
+    ErrorCode try_seek_from_begin (size_t pos) override;
+    /**
+     * Tries to read up to a given number of bytes from the underlying reader and validates them
+     * @param buf
+     * @param num_bytes_to_read The number of bytes to try and read
+     * @param num_bytes_read The actual number of bytes read
+     * @return ErrorCode_NotInit if the reader is not open
+     * @return ErrorCode_EndOfFile on EOF or if the content isn't UTF-8 encoded
+     * @return Same as the underlying reader's try_read on failure
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override;
+    /**
+     * Tries to read a view of up to a given number of bytes from the underlying reader and validates them
+     * @param max_num_bytes_to_read
+     * @param view
+     * @param view_length
+     * @return ErrorCode_NotInit if the reader is not open
+     * @return ErrorCode_EndOfFile on EOF or if the content isn't UTF-8 encoded
+     * @return Same as the underlying reader's try_read_view otherwise
+     */
+    ErrorCode try_read_view (size_t max_num_bytes_to_read, const char*& view, size_t& view_length) override;
+
+    // Methods
+    /**
+     * Starts validating content read from the given reader
+     * @param reader
+     * @param validator Validator containing the state of any content validated before, e.g., a prefix of the content read separately
+     * @throw Utf8ValidatingReader::OperationFailed if the reader is already open
+     */
+    void open (ReaderInterface& reader, Utf8Validator& validator);
+    void close ();
+
+private:
+    // Variables
+    ReaderInterface* m_reader;
+    Utf8Validator* m_validator;
+    size_t m_pos;
+};
+
+#endif // UTF8VALIDATINGREADER_HPP
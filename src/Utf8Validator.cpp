@@ -0,0 +1,120 @@
+#include "Utf8Validator.hpp"
+
+// C standard libraries
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+// C++ standard libraries
+#include <cstdint>
+
+#if defined(__SSE2__)
+// Constants
+constexpr size_t cNumVectorsPerBlock = 4;
+constexpr size_t cBlockSize = cNumVectorsPerBlock * sizeof(__m128i);
+
+/**
+ * Gets a mask of the bytes in the given block that equal the given value after being masked with the given bits. Bit i of the mask corresponds to byte i
+ * of the block.
+ * @param block
+ * @param bits
+ * @param value
+ * @return The mask
+ */
+static uint64_t get_mask_of_matching_bytes (const __m128i* block, uint8_t bits, uint8_t value) {
+    auto bits_vector = _mm_set1_epi8(static_cast<char>(bits));
+    auto value_vector = _mm_set1_epi8(static_cast<char>(value));
+    uint64_t mask = 0;
+    for (size_t i = 0; i < cNumVectorsPerBlock; ++i) {
+        auto matches = _mm_cmpeq_epi8(_mm_and_si128(block[i], bits_vector), value_vector);
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(matches))) << (i * sizeof(__m128i));
+    }
+    return mask;
+}
+#endif
+
+bool Utf8Validator::validate (const char* chunk, size_t chunk_length) {
+    if (false == m_is_valid) {
+        return false;
+    }
+
+    size_t chunk_pos = 0;
+#if defined(__SSE2__)
+    // Validate a block of bytes at a time by computing a bitmask of the bytes that must be continuation bytes (i.e., those within the length of a
+    // preceding length-indicator) and comparing it with the bitmask of the bytes that are continuation bytes
+    for (; chunk_pos + cBlockSize <= chunk_length; chunk_pos += cBlockSize) {
+        __m128i block[cNumVectorsPerBlock];
+        for (size_t i = 0; i < cNumVectorsPerBlock; ++i) {
+            block[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chunk + chunk_pos + i * sizeof(__m128i)));
+        }
+
+        // Fast path for blocks that are all ASCII
+        auto block_bits = _mm_or_si128(_mm_or_si128(block[0], block[1]), _mm_or_si128(block[2], block[3]));
+        if (0 == _mm_movemask_epi8(block_bits) && 0 == m_num_continuation_bytes_expected) {
+            continue;
+        }
+
+        // Matches 0b10xx_xxxx
+        auto continuation_bytes = get_mask_of_matching_bytes(block, 0xC0, 0x80);
+        // Matches 0b11xx_xxxx, i.e., length-indicators for 2 or more bytes
+        auto length_indicators = get_mask_of_matching_bytes(block, 0xC0, 0xC0);
+        // Matches 0b111x_xxxx, i.e., length-indicators for 3 or more bytes
+        auto long_length_indicators = get_mask_of_matching_bytes(block, 0xE0, 0xE0);
+        // Matches 0b1111_xxxx, i.e., length-indicators for 4 bytes
+        auto longest_length_indicators = get_mask_of_matching_bytes(block, 0xF0, 0xF0);
+        // Matches 0b1111_1xxx
+        auto invalid_bytes = get_mask_of_matching_bytes(block, 0xF8, 0xF8);
+
+        auto expected_continuation_bytes = ((uint64_t{1} << m_num_continuation_bytes_expected) - 1) | (length_indicators << 1)
+                                           | (long_length_indicators << 2) | (longest_length_indicators << 3);
+        if (0 != invalid_bytes || expected_continuation_bytes != continuation_bytes) {
+            m_is_valid = false;
+            return false;
+        }
+
+        // Count the continuation bytes expected at the start of the next block
+        auto next_block_continuation_bytes = (length_indicators >> 63) | (long_length_indicators >> 62) | (longest_length_indicators >> 61);
+        m_num_continuation_bytes_expected = (next_block_continuation_bytes & 1) + ((next_block_continuation_bytes >> 1) & 1)
+                                            + ((next_block_continuation_bytes >> 2) & 1);
+    }
+#endif
+
+    if (false == validate_bytes(chunk + chunk_pos, chunk_length - chunk_pos)) {
+        m_is_valid = false;
+        return false;
+    }
+    return true;
+}
+
+bool Utf8Validator::validate_bytes (const char* chunk, size_t chunk_length) {
+    for (size_t i = 0; i < chunk_length; ++i) {
+        auto byte = chunk[i];
+
+        if (m_num_continuation_bytes_expected > 0) {
+            // Validate that byte matches 0b10xx_xxxx
+            if ((byte & 0xC0) != 0x80) {
+                return false;
+            }
+            --m_num_continuation_bytes_expected;
+        } else {
+            if (byte & 0x80) {
+                // Check if byte is valid UTF-8 length-indicator
+                if ((byte & 0xF8) == 0xF0) {
+                    // Matches 0b1111_0xxx
+                    m_num_continuation_bytes_expected = 3;
+                } else if ((byte & 0xF0) == 0xE0) {
+                    // Matches 0b1110_xxxx
+                    m_num_continuation_bytes_expected = 2;
+                } else if ((byte & 0xE0) == 0xC0) {
+                    // Matches 0b110x_xxxx
+                    m_num_continuation_bytes_expected = 1;
+                } else {
+                    // Invalid UTF-8 length-indicator
+                    return false;
+                }
+            } // else byte is ASCII
+        }
+    }
+
+    return true;
+}
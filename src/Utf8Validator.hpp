@@ -0,0 +1,56 @@
+#ifndef UTF8VALIDATOR_HPP
+#define UTF8VALIDATOR_HPP
+
+// C++ standard libraries
+#include <cstddef>
+
+/**
+ * Class to validate that content is UTF-8 encoded, one chunk at a time, so that content can be validated as it's read. A multi-byte character may be
+ * split across chunks.
+ *
+ * NOTE: The validation is structural. I.e., each byte must either be ASCII, a valid length-indicator, or a continuation byte where one is expected. It
+ * doesn't reject overlong encodings or surrogates.
+ */
+class Utf8Validator {
+public:
+    // Constructors
+    Utf8Validator () : m_num_continuation_bytes_expected(0), m_is_valid(true) {}
+
+    // Methods
+    /**
+     * Validates the next chunk of content
+     * @param chunk
+     * @param chunk_length
+     * @return Whether all content validated so far is UTF-8
+     */
+    bool validate (const char* chunk, size_t chunk_length);
+
+    /**
+     * Resets the validator so it can validate new content
+     */
+    void reset () {
+        m_num_continuation_bytes_expected = 0;
+        m_is_valid = true;
+    }
+
+    /**
+     * @return Whether all content validated so far is UTF-8
+     */
+    bool is_valid () const { return m_is_valid; }
+
+private:
+    // Methods
+    /**
+     * Validates content one byte at a time
+     * @param chunk
+     * @param chunk_length
+     * @return Whether the content is valid
+     */
+    bool validate_bytes (const char* chunk, size_t chunk_length);
+
+    // Variables
+    size_t m_num_continuation_bytes_expected;
+    bool m_is_valid;
+};
+
+#endif // UTF8VALIDATOR_HPP
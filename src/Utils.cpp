@@ -7,6 +7,7 @@
 
 // C++ libraries
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <set>
 
@@ -19,13 +20,35 @@
 
 // Project headers
 #include "Profiler.hpp"
+#include "VariableTokenizer.hpp"
 
 using std::list;
 using std::string;
+using std::string_view;
 using std::vector;
 
 static const char cValidPrefixPunctuation[] = "+-";
 static const char* const cWildcards = "?*";
+// Capacity of the buffer used to null-terminate a numeric string before converting it (enough for any 64-bit integer and any double we encode)
+static constexpr size_t cNumericStringBufCapacity = 64;
+
+/**
+ * Gets a null-terminated copy of the given string, using the given buffer if the string fits, or the given std::string otherwise. This avoids a heap
+ * allocation when converting short numeric strings.
+ * @param str
+ * @param buf
+ * @param long_str
+ * @return Pointer to the null-terminated copy
+ */
+static const char* get_null_terminated_copy (string_view str, char (&buf)[cNumericStringBufCapacity], string& long_str) {
+    if (str.length() < cNumericStringBufCapacity) {
+        memcpy(buf, str.data(), str.length());
+        buf[str.length()] = '\0';
+        return buf;
+    }
+    long_str.assign(str);
+    return long_str.c_str();
+}
 
 /**
  * Checks if character is a delimiter
@@ -45,7 +68,7 @@ static inline bool is_delim (char c) {
  * @param end_pos
  * @return true if yes, false otherwise
  */
-static inline bool could_be_multi_digit_hex_value (const string& str, size_t begin_pos, size_t end_pos) {
+static inline bool could_be_multi_digit_hex_value (string_view str, size_t begin_pos, size_t end_pos) {
     if (end_pos - begin_pos < 2) {
         return false;
     }
@@ -142,13 +165,15 @@ string clean_up_wildcard_search_string (const string& str) {
     return cleaned_str;
 }
 
-bool convert_string_to_int64 (const std::string& raw, int64_t& converted) {
+bool convert_string_to_int64 (string_view raw, int64_t& converted) {
     if (raw.empty()) {
         // Can't convert an empty string
         return false;
     }
 
-    const char* c_str = raw.c_str();
+    char buf[cNumericStringBufCapacity];
+    string long_raw;
+    const char* c_str = get_null_terminated_copy(raw, buf, long_raw);
     char* endptr;
     // Reset errno so we can detect if it's been set
     errno = 0;
@@ -161,13 +186,15 @@ bool convert_string_to_int64 (const std::string& raw, int64_t& converted) {
     return true;
 }
 
-bool convert_string_to_double (const std::string& raw, double& converted) {
+bool convert_string_to_double (string_view raw, double& converted) {
     if (raw.empty()) {
         // Can't convert an empty string
         return false;
     }
 
-    const char* c_str = raw.c_str();
+    char buf[cNumericStringBufCapacity];
+    string long_raw;
+    const char* c_str = get_null_terminated_copy(raw, buf, long_raw);
     char* end_ptr;
     // Reset errno so we can detect a new error
     errno = 0;
@@ -353,57 +380,9 @@ bool get_bounds_of_next_potential_var (const string& value, size_t& begin_pos, s
     return (value_length != begin_pos);
 }
 
-bool get_bounds_of_next_var (const string& msg, size_t& token_end_pos, size_t& begin_pos, size_t& end_pos) {
-    const size_t msg_length = msg.length();
-    if (token_end_pos >= msg_length) {
-        return false;
-    }
-
-    bool is_var = false;
-    while (!is_var) {
-        begin_pos = token_end_pos;
-        // Find next non-delimiter
-        for (; begin_pos < msg_length; ++begin_pos) {
-            char c = msg[begin_pos];
-
-            if (!is_delim(c)) {
-                break;
-            }
-        }
-        if (msg_length == begin_pos) {
-            // Early exit for performance
-            return false;
-        }
-
-        bool contains_decimal_digit = false;
-
-        // Find next delimiter
-        token_end_pos = begin_pos;
-        for (; token_end_pos < msg_length; ++token_end_pos) {
-            char c = msg[token_end_pos];
-            if ('0' <= c && c <= '9') {
-                // Contains number, so treat as a variable
-                contains_decimal_digit = true;
-            } else if (is_delim(c)) {
-                break;
-            }
-        }
-
-        end_pos = token_end_pos;
-        if (trim_punctuation_of_variable(msg, begin_pos, end_pos)) {
-            // Treat token as variable if:
-            // - it contains a decimal digit, or
-            // - it's directly preceded by an equals sign, or
-            // - it could be a multi-digit hex value
-            if (contains_decimal_digit || (begin_pos > 0 && '=' == msg[begin_pos - 1]) ||
-                could_be_multi_digit_hex_value(msg, begin_pos, end_pos))
-            {
-                is_var = true;
-            }
-        }
-    }
-
-    return (msg_length != begin_pos);
+bool get_bounds_of_next_var (string_view msg, size_t& token_end_pos, size_t& begin_pos, size_t& end_pos) {
+    VariableTokenizer tokenizer(msg);
+    return tokenizer.get_bounds_of_next_var(token_end_pos, begin_pos, end_pos);
 }
 
 string get_parent_directory_path (const string& path) {
@@ -478,7 +457,7 @@ string replace_characters (const char* characters_to_replace, const char* replac
     return new_value;
 }
 
-bool trim_punctuation_of_variable (const string& str, size_t& begin_pos, size_t& end_pos) {
+bool trim_punctuation_of_variable (string_view str, size_t& begin_pos, size_t& end_pos) {
     if (begin_pos >= end_pos) {
         return false;
     }
@@ -5,6 +5,8 @@
 #include <list>
 #include <set>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
@@ -30,7 +32,7 @@ std::string clean_up_wildcard_search_string (const std::string& str);
  * @param converted
  * @return true if the conversion was successful, false otherwise
  */
-bool convert_string_to_int64 (const std::string& raw, int64_t& converted);
+bool convert_string_to_int64 (std::string_view raw, int64_t& converted);
 
 /**
  * Converts the given string to a double if possible
@@ -38,7 +40,7 @@ bool convert_string_to_int64 (const std::string& raw, int64_t& converted);
  * @param converted
  * @return true if the conversion was successful, false otherwise
  */
-bool convert_string_to_double (const std::string& raw, double& converted);
+bool convert_string_to_double (std::string_view raw, double& converted);
 
 /**
  * Creates a directory with the given path
@@ -98,6 +100,7 @@ bool get_bounds_of_next_potential_var (const std::string& value, size_t& begin_p
 /**
  * Returns bounds of next variable in given string
  * A variable is a token (word between two delimiters) that contains numbers or is directly preceded by an equals sign
+ * NOTE: To find every variable in a message, VariableTokenizer is more efficient
  * @param msg
  * @param token_end_pos End of the last token, changes to beginning of next variable
  *        (this is not necessarily the same as end_pos since the token may include punctuation after the variable)
@@ -105,7 +108,7 @@ bool get_bounds_of_next_potential_var (const std::string& value, size_t& begin_p
  * @param end_pos End position of last variable, changes to end position of next variable
  * @return true if a variable was found, false otherwise
  */
-bool get_bounds_of_next_var (const std::string& msg, size_t& token_end_pos, size_t& begin_pos, size_t& end_pos);
+bool get_bounds_of_next_var (std::string_view msg, size_t& token_end_pos, size_t& begin_pos, size_t& end_pos);
 
 /**
  * Removes ".", "..", and consecutive "/" from a given path and returns the result
@@ -132,7 +135,7 @@ std::string replace_characters (const char* characters_to_escape, const char* re
  * @return true if any text remains after trimming, false otherwise
  * @note begin_pos and end_pos may be changed even if the method returns false
  */
-bool trim_punctuation_of_variable (const std::string& str, size_t& begin_pos, size_t& end_pos);
+bool trim_punctuation_of_variable (std::string_view str, size_t& begin_pos, size_t& end_pos);
 
 /**
  * Perform wildcard match
@@ -28,14 +28,16 @@ public:
 
     // Constructors
     VariableDictionaryEntry () = default;
-    VariableDictionaryEntry (const std::string& value, variable_dictionary_id_t id) : DictionaryEntry<variable_dictionary_id_t>(value, id) {}
+    VariableDictionaryEntry (std::string_view value, variable_dictionary_id_t id) : DictionaryEntry<variable_dictionary_id_t>(value, id) {}
 
-    // Use default copy constructor
+    // Use default copy & move constructors
     VariableDictionaryEntry (const VariableDictionaryEntry&) = default;
+    VariableDictionaryEntry (VariableDictionaryEntry&&) = default;
 
     // Assignment operators
     // Use default
     VariableDictionaryEntry& operator= (const VariableDictionaryEntry&) = default;
+    VariableDictionaryEntry& operator= (VariableDictionaryEntry&&) = default;
 
     // Methods
     /**
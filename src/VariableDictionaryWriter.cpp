@@ -7,6 +7,7 @@
 #include "dictionary_utils.hpp"
 
 using std::string;
+using std::string_view;
 
 void VariableDictionaryWriter::open_and_preload (const string& dictionary_path, const string& segment_index_path, variable_dictionary_id_t max_id) {
     if (m_is_open) {
@@ -32,7 +33,10 @@ void VariableDictionaryWriter::open_and_preload (const string& dictionary_path,
         var_dict_entry.read_from_file(dictionary_decompressor);
         add_occurrence(var_dict_entry.get_value(), id);
     }
-    m_uncommitted_entries.clear();
+    mark_all_entries_committed();
+
+    // Continue the segment index after the segments already indexed
+    m_num_segments_in_index = read_segment_index_header(segment_index_file_reader);
 
     segment_index_decompressor.close();
     segment_index_file_reader.close();
@@ -50,36 +54,10 @@ void VariableDictionaryWriter::open_and_preload (const string& dictionary_path,
     m_is_open = true;
 }
 
-bool VariableDictionaryWriter::add_occurrence (const string& value, variable_dictionary_id_t& id) {
-    bool new_entry = false;
-
-    const auto ix = m_value_to_entry.find(value);
-    if (m_value_to_entry.end() != ix) {
-        id = ix->second->get_id();
-    } else {
-        // Entry doesn't exist so create it
-
-        if (m_next_id > m_max_id) {
-            SPDLOG_ERROR("VariableDictionaryWriter ran out of IDs.");
-            throw OperationFailed(ErrorCode_OutOfBounds, __FILENAME__, __LINE__);
-        }
-
-        // Assign ID
-        id = m_next_id;
-        ++m_next_id;
-
-        // Insert the ID obtained from the database into the dictionary
-        auto* entry = new VariableDictionaryEntry(value, id);
-        m_value_to_entry[value] = entry;
-        m_id_to_entry[id] = entry;
-
-        // Mark ID as dirty
-        m_uncommitted_entries.emplace_back(entry);
-
-        new_entry = true;
-
-        // TODO: This doesn't account for the segment index that's constantly updated
-        m_data_size += entry->get_data_size();
-    }
-    return new_entry;
+bool VariableDictionaryWriter::add_occurrence (string_view value, variable_dictionary_id_t& id) {
+    bool is_new_entry;
+    // NOTE: The value is only copied if the entry is new
+    auto entry = get_or_create_entry(value, [value] (variable_dictionary_id_t new_id) { return VariableDictionaryEntry(value, new_id); }, is_new_entry);
+    id = entry->get_id();
+    return is_new_entry;
 }
@@ -1,6 +1,10 @@
 #ifndef VARIABLEDICTIONARYWRITER_HPP
 #define VARIABLEDICTIONARYWRITER_HPP
 
+// C++ standard libraries
+#include <string>
+#include <string_view>
+
 // Project headers
 #include "Defs.h"
 #include "DictionaryWriter.hpp"
@@ -33,11 +37,14 @@ public:
     void open_and_preload (const std::string& dictionary_path, const std::string& segment_index_path, variable_dictionary_id_t max_id);
 
     /**
-     * Adds an entry to the dictionary if it doesn't exist, or increases its occurrence count if it does
+     * Adds an entry to the dictionary if it doesn't exist, or increases its occurrence count if it does. Can be called from multiple threads
+     * concurrently.
      * @param value
      * @param id
+     * @return true if the entry is new, false otherwise
+     * @throw DictionaryWriter::OperationFailed if the dictionary has run out of IDs
      */
-    bool add_occurrence (const std::string& value, variable_dictionary_id_t& id);
+    bool add_occurrence (std::string_view value, variable_dictionary_id_t& id);
 };
 
 #endif // VARIABLEDICTIONARYWRITER_HPP
@@ -0,0 +1,299 @@
+#include "VariableTokenizer.hpp"
+
+// C libraries
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// C++ standard libraries
+#include <cstring>
+
+// Project headers
+#include "Utils.hpp"
+
+#if defined(__AVX2__)
+/**
+ * Checks which of the given characters are in the range [lower_bound, upper_bound]
+ * @param chars
+ * @param lower_bound
+ * @param upper_bound
+ * @return A vector with 0xFF for each character in the range and 0 otherwise
+ */
+static inline __m256i chars_in_range (__m256i chars, char lower_bound, char upper_bound) {
+    // Unsigned comparison of (c - lower_bound) <= (upper_bound - lower_bound)
+    auto offset_chars = _mm256_sub_epi8(chars, _mm256_set1_epi8(lower_bound));
+    auto range = _mm256_set1_epi8(upper_bound - lower_bound);
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(offset_chars, range), offset_chars);
+}
+
+/**
+ * Converts the given comparison result into a bitmask
+ * @param comparison_result
+ * @return Bitmask with bit i set if byte i of the comparison result is set
+ */
+static inline uint64_t to_bitmask (__m256i comparison_result) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(comparison_result));
+}
+
+void VariableTokenizer::classify_chars (const char* chars, CharClassMasks& masks) {
+    masks = {};
+    for (size_t i = 0; i < cBlockSize; i += sizeof(__m256i)) {
+        auto chars_vector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chars + i));
+        // Setting bit 5 maps upper case letters to lower case letters and leaves digits unchanged
+        auto lower_case_chars_vector = _mm256_or_si256(chars_vector, _mm256_set1_epi8(0x20));
+
+        auto decimal_digits = chars_in_range(chars_vector, '0', '9');
+        auto hex_digits = _mm256_or_si256(decimal_digits, chars_in_range(lower_case_chars_vector, 'a', 'f'));
+        auto alphanumerics = _mm256_or_si256(decimal_digits, chars_in_range(lower_case_chars_vector, 'a', 'z'));
+        auto valid_var_begins = _mm256_or_si256(alphanumerics, _mm256_cmpeq_epi8(chars_vector, _mm256_set1_epi8('+')));
+        valid_var_begins = _mm256_or_si256(valid_var_begins, _mm256_cmpeq_epi8(chars_vector, _mm256_set1_epi8('-')));
+        // Non-delimiters are "+-./0-9A-Z\a-z" and '_'
+        auto non_delims = _mm256_or_si256(valid_var_begins, chars_in_range(chars_vector, '-', '/'));
+        non_delims = _mm256_or_si256(non_delims, _mm256_cmpeq_epi8(chars_vector, _mm256_set1_epi8('\\')));
+        non_delims = _mm256_or_si256(non_delims, _mm256_cmpeq_epi8(chars_vector, _mm256_set1_epi8('_')));
+
+        masks.delim |= (~to_bitmask(non_delims) & UINT32_MAX) << i;
+        masks.decimal_digit |= to_bitmask(decimal_digits) << i;
+        masks.non_hex_digit |= (~to_bitmask(hex_digits) & UINT32_MAX) << i;
+        masks.valid_var_begin |= to_bitmask(valid_var_begins) << i;
+        masks.valid_var_end |= to_bitmask(alphanumerics) << i;
+    }
+}
+#elif defined(__SSE2__)
+/**
+ * Checks which of the given characters are in the range [lower_bound, upper_bound]
+ * @param chars
+ * @param lower_bound
+ * @param upper_bound
+ * @return A vector with 0xFF for each character in the range and 0 otherwise
+ */
+static inline __m128i chars_in_range (__m128i chars, char lower_bound, char upper_bound) {
+    // Unsigned comparison of (c - lower_bound) <= (upper_bound - lower_bound)
+    auto offset_chars = _mm_sub_epi8(chars, _mm_set1_epi8(lower_bound));
+    auto range = _mm_set1_epi8(upper_bound - lower_bound);
+    return _mm_cmpeq_epi8(_mm_min_epu8(offset_chars, range), offset_chars);
+}
+
+/**
+ * Converts the given comparison result into a bitmask
+ * @param comparison_result
+ * @return Bitmask with bit i set if byte i of the comparison result is set
+ */
+static inline uint64_t to_bitmask (__m128i comparison_result) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(comparison_result));
+}
+
+void VariableTokenizer::classify_chars (const char* chars, CharClassMasks& masks) {
+    constexpr uint64_t cVectorMask = UINT16_MAX;
+
+    masks = {};
+    for (size_t i = 0; i < cBlockSize; i += sizeof(__m128i)) {
+        auto chars_vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+        // Setting bit 5 maps upper case letters to lower case letters and leaves digits unchanged
+        auto lower_case_chars_vector = _mm_or_si128(chars_vector, _mm_set1_epi8(0x20));
+
+        auto decimal_digits = chars_in_range(chars_vector, '0', '9');
+        auto hex_digits = _mm_or_si128(decimal_digits, chars_in_range(lower_case_chars_vector, 'a', 'f'));
+        auto alphanumerics = _mm_or_si128(decimal_digits, chars_in_range(lower_case_chars_vector, 'a', 'z'));
+        auto valid_var_begins = _mm_or_si128(alphanumerics, _mm_cmpeq_epi8(chars_vector, _mm_set1_epi8('+')));
+        valid_var_begins = _mm_or_si128(valid_var_begins, _mm_cmpeq_epi8(chars_vector, _mm_set1_epi8('-')));
+        // Non-delimiters are "+-./0-9A-Z\a-z" and '_'
+        auto non_delims = _mm_or_si128(valid_var_begins, chars_in_range(chars_vector, '-', '/'));
+        non_delims = _mm_or_si128(non_delims, _mm_cmpeq_epi8(chars_vector, _mm_set1_epi8('\\')));
+        non_delims = _mm_or_si128(non_delims, _mm_cmpeq_epi8(chars_vector, _mm_set1_epi8('_')));
+
+        masks.delim |= (~to_bitmask(non_delims) & cVectorMask) << i;
+        masks.decimal_digit |= to_bitmask(decimal_digits) << i;
+        masks.non_hex_digit |= (~to_bitmask(hex_digits) & cVectorMask) << i;
+        masks.valid_var_begin |= to_bitmask(valid_var_begins) << i;
+        masks.valid_var_end |= to_bitmask(alphanumerics) << i;
+    }
+}
+#else
+// Flags for each class of character
+static constexpr uint8_t cDelimFlag = 1U << 0;
+static constexpr uint8_t cDecimalDigitFlag = 1U << 1;
+static constexpr uint8_t cNonHexDigitFlag = 1U << 2;
+static constexpr uint8_t cValidVarBeginFlag = 1U << 3;
+static constexpr uint8_t cValidVarEndFlag = 1U << 4;
+
+/**
+ * Table of the class flags of each character
+ */
+struct CharClassTable {
+    constexpr CharClassTable () : flags() {
+        for (int i = 0; i < 256; ++i) {
+            auto c = static_cast<char>(i);
+
+            bool is_decimal_digit = ('0' <= c && c <= '9');
+            bool is_alphanumeric = is_decimal_digit || ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z');
+            bool is_valid_var_begin = is_alphanumeric || '+' == c || '-' == c;
+            // Non-delimiters are "+-./0-9A-Z\a-z" and '_'
+            if (!(is_valid_var_begin || '.' == c || '/' == c || '\\' == c || '_' == c)) {
+                flags[i] |= cDelimFlag;
+            }
+            if (is_decimal_digit) {
+                flags[i] |= cDecimalDigitFlag;
+            } else if (!(('a' <= c && c <= 'f') || ('A' <= c && c <= 'F'))) {
+                flags[i] |= cNonHexDigitFlag;
+            }
+            if (is_valid_var_begin) {
+                flags[i] |= cValidVarBeginFlag;
+            }
+            if (is_alphanumeric) {
+                flags[i] |= cValidVarEndFlag;
+            }
+        }
+    }
+
+    uint8_t flags[256];
+};
+static constexpr CharClassTable cCharClassTable;
+
+/**
+ * Gathers the given flag from each byte of the given flags into a bitmask
+ * @param flags The flags of 8 characters, one per byte
+ * @param flag
+ * @return Bitmask with bit i set if byte i of flags contains the flag
+ */
+static inline uint64_t gather_flag (uint64_t flags, uint8_t flag) {
+    // Isolate the flag's bit in each byte (so that each byte is 0 or 1), then use a multiplication to move byte i's bit into bit (56 + i)
+    uint64_t flag_bits = (flags & (0x0101010101010101ULL * flag)) / flag;
+    return (flag_bits * 0x0102040810204080ULL) >> 56;
+}
+
+void VariableTokenizer::classify_chars (const char* chars, CharClassMasks& masks) {
+    constexpr size_t cNumCharsPerWord = sizeof(uint64_t);
+
+    masks = {};
+    for (size_t i = 0; i < cBlockSize; i += cNumCharsPerWord) {
+        uint64_t flags = 0;
+        for (size_t j = 0; j < cNumCharsPerWord; ++j) {
+            flags |= static_cast<uint64_t>(cCharClassTable.flags[static_cast<unsigned char>(chars[i + j])]) << (j * 8);
+        }
+
+        masks.delim |= gather_flag(flags, cDelimFlag) << i;
+        masks.decimal_digit |= gather_flag(flags, cDecimalDigitFlag) << i;
+        masks.non_hex_digit |= gather_flag(flags, cNonHexDigitFlag) << i;
+        masks.valid_var_begin |= gather_flag(flags, cValidVarBeginFlag) << i;
+        masks.valid_var_end |= gather_flag(flags, cValidVarEndFlag) << i;
+    }
+}
+#endif
+
+bool VariableTokenizer::get_bounds_of_next_var (size_t& token_end_pos, size_t& begin_pos, size_t& end_pos) {
+    const size_t msg_length = m_msg.length();
+    if (token_end_pos >= msg_length) {
+        return false;
+    }
+
+    bool is_var = false;
+    while (!is_var) {
+        // Find next non-delimiter
+        begin_pos = token_end_pos;
+        while (true) {
+            if (begin_pos >= msg_length) {
+                // Early exit for performance
+                begin_pos = msg_length;
+                return false;
+            }
+
+            classify_block_containing(begin_pos);
+            uint64_t non_delims = ~m_masks.delim >> (begin_pos - m_block_begin_pos);
+            if (0 != non_delims) {
+                begin_pos += __builtin_ctzll(non_delims);
+                break;
+            }
+            begin_pos = m_block_begin_pos + cBlockSize;
+        }
+
+        bool contains_decimal_digit;
+        bool could_be_multi_digit_hex_value;
+        size_t offset = begin_pos - m_block_begin_pos;
+        uint64_t delims = m_masks.delim >> offset;
+        if (0 != delims) {
+            // The token ends in this block, so we can find the variable's bounds (i.e., trim the token's punctuation) using the block's bitmasks.
+            // Below, bit i of each mask corresponds to m_msg[begin_pos + i].
+            size_t token_length = __builtin_ctzll(delims);
+            token_end_pos = begin_pos + token_length;
+            uint64_t token_chars = (1ULL << token_length) - 1;
+
+            uint64_t var_begins = (m_masks.valid_var_begin >> offset) & token_chars;
+            if (0 == var_begins) {
+                // Nothing remains after trimming
+                begin_pos = token_end_pos;
+                end_pos = token_end_pos;
+                continue;
+            }
+            size_t var_begin_offset = __builtin_ctzll(var_begins);
+            // The variable ends after its last valid end character, excluding its first character
+            uint64_t var_ends = (m_masks.valid_var_end >> offset) & token_chars & ~((2ULL << var_begin_offset) - 1);
+            size_t var_end_offset = (0 != var_ends) ? 64 - __builtin_clzll(var_ends) : var_begin_offset + 1;
+            uint64_t var_chars = ((1ULL << var_end_offset) - 1) & ~((1ULL << var_begin_offset) - 1);
+
+            contains_decimal_digit = (0 != ((m_masks.decimal_digit >> offset) & token_chars));
+            could_be_multi_digit_hex_value = (var_end_offset - var_begin_offset >= 2) && 0 == ((m_masks.non_hex_digit >> offset) & var_chars);
+            end_pos = begin_pos + var_end_offset;
+            begin_pos += var_begin_offset;
+        } else {
+            contains_decimal_digit = false;
+            size_t num_non_hex_digits = 0;
+
+            // Find next delimiter
+            token_end_pos = begin_pos;
+            while (true) {
+                classify_block_containing(token_end_pos);
+                offset = token_end_pos - m_block_begin_pos;
+                delims = m_masks.delim >> offset;
+                uint64_t token_chars = (0 != delims) ? (1ULL << __builtin_ctzll(delims)) - 1 : UINT64_MAX >> offset;
+
+                if (0 != ((m_masks.decimal_digit >> offset) & token_chars)) {
+                    // Contains number, so treat as a variable
+                    contains_decimal_digit = true;
+                }
+                num_non_hex_digits += __builtin_popcountll((m_masks.non_hex_digit >> offset) & token_chars);
+                token_end_pos += __builtin_popcountll(token_chars);
+                if (0 != delims) {
+                    break;
+                }
+            }
+
+            const size_t untrimmed_begin_pos = begin_pos;
+            end_pos = token_end_pos;
+            if (false == trim_punctuation_of_variable(m_msg, begin_pos, end_pos)) {
+                continue;
+            }
+            // Trimmed characters are never hex digits, so the variable could be a multi-digit hex value iff all of the token's non-hex digits were
+            // trimmed
+            could_be_multi_digit_hex_value = (end_pos - begin_pos >= 2) &&
+                    (begin_pos - untrimmed_begin_pos) + (token_end_pos - end_pos) == num_non_hex_digits;
+        }
+
+        // Treat token as variable if:
+        // - it contains a decimal digit, or
+        // - it's directly preceded by an equals sign, or
+        // - it could be a multi-digit hex value
+        if (contains_decimal_digit || (begin_pos > 0 && '=' == m_msg[begin_pos - 1]) || could_be_multi_digit_hex_value) {
+            is_var = true;
+        }
+    }
+
+    return (msg_length != begin_pos);
+}
+
+void VariableTokenizer::classify_block (size_t block_begin_pos) {
+    m_block_begin_pos = block_begin_pos;
+
+    const size_t msg_length = m_msg.length();
+    if (block_begin_pos + cBlockSize <= msg_length) {
+        classify_chars(m_msg.data() + block_begin_pos, m_masks);
+    } else {
+        // Copy the end of the message so we don't read past it. Since '\0' is a delimiter, characters past the end of the message will be treated as
+        // delimiters.
+        char chars[cBlockSize] = {};
+        if (block_begin_pos < msg_length) {
+            memcpy(chars, m_msg.data() + block_begin_pos, msg_length - block_begin_pos);
+        }
+        classify_chars(chars, m_masks);
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef VARIABLETOKENIZER_HPP
+#define VARIABLETOKENIZER_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Class to find the variables in a message (see get_bounds_of_next_var in Utils.hpp for the definition of a variable).
+ *
+ * For performance, the message's characters are classified (as delimiters, decimal digits, and hex digits) a block at a time, using SIMD instructions
+ * when they're available (AVX2 or SSE2). Each block is only classified once, so finding a token's bounds, whether it contains a decimal digit, and
+ * whether it could be a hex value only requires scanning the block's bitmasks.
+ */
+class VariableTokenizer {
+public:
+    // Constants
+    static constexpr size_t cBlockSize = 64;
+
+    // Constructors
+    explicit VariableTokenizer (std::string_view msg) : m_msg(msg), m_block_begin_pos(0), m_masks() {
+        classify_block(0);
+    }
+
+    // Methods
+    std::string_view get_msg () const { return m_msg; }
+
+    /**
+     * Returns bounds of next variable in the message
+     * NOTE: This is most efficient when the message is tokenized from beginning to end
+     * @param token_end_pos End of the last token, changes to beginning of next variable
+     *        (this is not necessarily the same as end_pos since the token may include punctuation after the variable)
+     * @param begin_pos Begin position of last variable, changes to begin position of next variable
+     * @param end_pos End position of last variable, changes to end position of next variable
+     * @return true if a variable was found, false otherwise
+     */
+    bool get_bounds_of_next_var (size_t& token_end_pos, size_t& begin_pos, size_t& end_pos);
+
+private:
+    // Types
+    /**
+     * Bitmasks of the classes of a block of characters, where bit i corresponds to the i-th character in the block
+     */
+    struct CharClassMasks {
+        uint64_t delim;
+        uint64_t decimal_digit;
+        uint64_t non_hex_digit;
+        uint64_t valid_var_begin;
+        uint64_t valid_var_end;
+    };
+
+    // Methods
+    /**
+     * Classifies the block of characters containing the given position, unless it's already classified
+     * @param pos
+     */
+    void classify_block_containing (size_t pos) {
+        if (pos - m_block_begin_pos >= cBlockSize) {
+            classify_block(pos - pos % cBlockSize);
+        }
+    }
+    /**
+     * Classifies the block of characters beginning at the given position
+     * @param block_begin_pos
+     */
+    void classify_block (size_t block_begin_pos);
+    /**
+     * Classifies cBlockSize characters
+     * @param chars
+     * @param masks
+     */
+    static void classify_chars (const char* chars, CharClassMasks& masks);
+
+    // Variables
+    std::string_view m_msg;
+
+    // Bitmasks of the current block. Characters past the end of the message are treated as delimiters.
+    size_t m_block_begin_pos;
+    CharClassMasks m_masks;
+};
+
+#endif // VARIABLETOKENIZER_HPP
@@ -54,6 +54,9 @@ namespace clg {
         po::options_description options_input("Input Options");
         options_input.add_options()
                 ("file,f", po::value<string>(&m_search_strings_file_path)->value_name("FILE"), "Obtain wildcard strings from FILE, one per line")
+                ("follow", po::bool_switch(&m_follow), "After searching, keep searching data as it's committed to the archives")
+                ("follow-interval", po::value<unsigned int>(&m_follow_interval_ms)->value_name("MS")->default_value(m_follow_interval_ms),
+                        "With --follow, check for new data every MS milliseconds")
                 ;
 
         // Define output options
@@ -140,6 +143,10 @@ namespace clg {
                 cerr << "  " << get_program_name() << R"( archives-dir " ERROR ")" << endl;
                 cerr << endl;
 
+                cerr << R"(  # Search archives-dir for " ERROR " and keep reporting new matches as they're compressed)" << endl;
+                cerr << "  " << get_program_name() << R"( --follow archives-dir " ERROR ")" << endl;
+                cerr << endl;
+
                 cerr << "Options can be specified on the command line or through a configuration file." << endl;
                 cerr << visible_options << endl;
                 return ParsingResult::InfoCommand;
@@ -203,6 +210,10 @@ namespace clg {
                 }
             }
 
+            if (0 == m_follow_interval_ms) {
+                throw invalid_argument("--follow-interval must be non-zero.");
+            }
+
             switch (output_method_input) {
                 case (char)OutputMethod::StdoutText:
                 case (char)OutputMethod::StdoutBinary:
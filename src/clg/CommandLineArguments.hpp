@@ -23,7 +23,8 @@ namespace clg {
 
         // Constructors
         explicit CommandLineArguments (const std::string& program_name) : CommandLineArgumentsBase(program_name), m_ignore_case(false),
-                m_output_method(OutputMethod::StdoutText), m_search_begin_ts(cEpochTimeMin), m_search_end_ts(cEpochTimeMax) {}
+                m_output_method(OutputMethod::StdoutText), m_search_begin_ts(cEpochTimeMin), m_search_end_ts(cEpochTimeMax), m_follow(false),
+                m_follow_interval_ms(1000) {}
 
         // Methods
         ParsingResult parse_arguments (int argc, const char* argv[]) override;
@@ -36,6 +37,8 @@ namespace clg {
         OutputMethod get_output_method () const { return m_output_method; }
         epochtime_t get_search_begin_ts () const { return m_search_begin_ts; }
         epochtime_t get_search_end_ts () const { return m_search_end_ts; }
+        bool follow () const { return m_follow; }
+        unsigned int get_follow_interval_ms () const { return m_follow_interval_ms; }
 
     private:
         // Methods
@@ -49,6 +52,8 @@ namespace clg {
         std::string m_file_path;
         OutputMethod m_output_method;
         epochtime_t m_search_begin_ts, m_search_end_ts;
+        bool m_follow;
+        unsigned int m_follow_interval_ms;
     };
 }
 
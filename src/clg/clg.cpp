@@ -2,7 +2,13 @@
 #include <sys/stat.h>
 
 // C++ libraries
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <set>
+#include <thread>
+#include <unordered_map>
 
 // Boost libraries
 #include <boost/filesystem.hpp>
@@ -16,6 +22,7 @@
 #include "../Grep.hpp"
 #include "../GlobalMetadataDB.hpp"
 #include "../Profiler.hpp"
+#include "../SegmentIdSet.hpp"
 #include "../streaming_archive/Constants.hpp"
 #include "../Utils.hpp"
 #include "CommandLineArguments.hpp"
@@ -27,11 +34,33 @@ using std::endl;
 using std::string;
 using std::to_string;
 using std::vector;
-using streaming_archive::MetadataDB;
+using streaming_archive::FileMetadataIterator;
 using streaming_archive::reader::Archive;
 using streaming_archive::reader::File;
 using streaming_archive::reader::Message;
 
+// Constants
+// How long a followed archive can go without new data before we close it to free its resources
+constexpr std::chrono::minutes cFollowedArchiveIdleTimeout(5);
+
+/**
+ * An archive that's being searched as data is committed to it
+ */
+struct FollowedArchive {
+    // Constructors
+    FollowedArchive () : num_committed_segments(0), min_unsearched_segment_id(0) {}
+
+    // Variables
+    // nullptr while the archive is idle
+    std::unique_ptr<Archive> reader;
+    size_t num_committed_segments;
+    std::chrono::steady_clock::time_point last_change_time;
+    // All segments with IDs below this have been searched
+    segment_id_t min_unsearched_segment_id;
+    // Searched segments with IDs above min_unsearched_segment_id, since the writer may commit segments out of order
+    std::set<segment_id_t> ids_of_searched_segments;
+};
+
 /**
  * Opens the archive and reads the dictionaries
  * @param archive_path
@@ -39,6 +68,18 @@ using streaming_archive::reader::Message;
  * @return true on success, false otherwise
  */
 static bool open_archive (const string& archive_path, Archive& archive_reader);
+/**
+ * Generates queries for the given search strings using the archive's dictionaries
+ * @param search_strings
+ * @param command_line_args
+ * @param archive
+ * @param queries Returns the queries that may match
+ * @param is_superseding_query Returns whether a query matches every message, in which case it's the only query returned
+ * @param ids_of_segments_to_search Returns the IDs of the segments that may contain matches
+ * @return false if no query can match, true otherwise
+ */
+static bool generate_queries (const vector<string>& search_strings, CommandLineArguments& command_line_args, Archive& archive, vector<Query>& queries,
+                              bool& is_superseding_query, SegmentIdSet& ids_of_segments_to_search);
 /**
  * Searches the archive with the given parameters
  * @param search_strings
@@ -47,6 +88,23 @@ static bool open_archive (const string& archive_path, Archive& archive_reader);
  * @return true on success, false otherwise
  */
 static bool search (const vector<string>& search_strings, CommandLineArguments& command_line_args, Archive& archive);
+/**
+ * Searches the segments committed to a followed archive since it was last searched. Files that aren't in a segment are skipped since they may still change.
+ * @param search_strings
+ * @param command_line_args
+ * @param followed_archive
+ * @return true on success, false otherwise
+ */
+static bool search_new_segments (const vector<string>& search_strings, CommandLineArguments& command_line_args, FollowedArchive& followed_archive);
+/**
+ * Searches all archives and then keeps searching new data as it's committed to them, including to archives created later. Only returns on failure.
+ * @param search_strings
+ * @param command_line_args
+ * @param archives_dir
+ * @param global_metadata_db
+ */
+static void follow (const vector<string>& search_strings, CommandLineArguments& command_line_args, const boost::filesystem::path& archives_dir,
+                    GlobalMetadataDB& global_metadata_db);
 /**
  * Opens a compressed file or logs any errors if it couldn't be opened
  * @param file_metadata_ix
@@ -54,7 +112,7 @@ static bool search (const vector<string>& search_strings, CommandLineArguments&
  * @param compressed_file
  * @return true on success, false otherwise
  */
-static bool open_compressed_file (MetadataDB::FileIterator& file_metadata_ix, Archive& archive, File& compressed_file);
+static bool open_compressed_file (FileMetadataIterator& file_metadata_ix, Archive& archive, File& compressed_file);
 /**
  * Searches all files referenced by a given database cursor
  * @param queries
@@ -64,7 +122,7 @@ static bool open_compressed_file (MetadataDB::FileIterator& file_metadata_ix, Ar
  * @return The total number of matches found across all files
  */
 static size_t search_files (vector<Query>& queries, CommandLineArguments::OutputMethod output_method, Archive& archive,
-                            MetadataDB::FileIterator& file_metadata_ix);
+                            FileMetadataIterator& file_metadata_ix);
 /**
  * Prints search result to stdout in text format
  * @param orig_file_path
@@ -131,6 +189,41 @@ static bool open_archive (const string& archive_path, Archive& archive_reader) {
     return true;
 }
 
+static bool generate_queries (const vector<string>& search_strings, CommandLineArguments& command_line_args, Archive& archive, vector<Query>& queries,
+                              bool& is_superseding_query, SegmentIdSet& ids_of_segments_to_search)
+{
+    bool no_queries_match = true;
+    is_superseding_query = false;
+    for (const auto& search_string : search_strings) {
+        Query query;
+        if (Grep::process_raw_query(archive, search_string, command_line_args.get_search_begin_ts(), command_line_args.get_search_end_ts(),
+                                    command_line_args.ignore_case(), query))
+        {
+            no_queries_match = false;
+
+            if (query.contains_sub_queries() == false) {
+                // Search string supersedes all other possible search strings
+                is_superseding_query = true;
+                // Remove existing queries since they are superseded by this one
+                queries.clear();
+                // Add this query
+                queries.push_back(query);
+                // All other search strings will be superseded by this one, so break
+                break;
+            }
+
+            queries.push_back(query);
+
+            // Add query's matching segments to segments to search
+            for (auto& sub_query : query.get_sub_queries()) {
+                ids_of_segments_to_search.union_with(sub_query.get_ids_of_matching_segments());
+            }
+        }
+    }
+
+    return false == no_queries_match;
+}
+
 static bool search (const vector<string>& search_strings, CommandLineArguments& command_line_args, Archive& archive) {
     ErrorCode error_code;
     auto search_begin_ts = command_line_args.get_search_begin_ts();
@@ -138,46 +231,19 @@ static bool search (const vector<string>& search_strings, CommandLineArguments&
 
     try {
         vector<Query> queries;
-        bool no_queries_match = true;
-        std::set<segment_id_t> ids_of_segments_to_search;
-        bool is_superseding_query = false;
-        for (const auto& search_string : search_strings) {
-            Query query;
-            if (Grep::process_raw_query(archive, search_string, search_begin_ts, search_end_ts, command_line_args.ignore_case(), query)) {
-                no_queries_match = false;
-
-                if (query.contains_sub_queries() == false) {
-                    // Search string supersedes all other possible search strings
-                    is_superseding_query = true;
-                    // Remove existing queries since they are superseded by this one
-                    queries.clear();
-                    // Add this query
-                    queries.push_back(query);
-                    // All other search strings will be superseded by this one, so break
-                    break;
-                }
-
-                queries.push_back(query);
-
-                // Add query's matching segments to segments to search
-                for (auto& sub_query : query.get_sub_queries()) {
-                    auto& ids_of_matching_segments = sub_query.get_ids_of_matching_segments();
-                    ids_of_segments_to_search.insert(ids_of_matching_segments.cbegin(), ids_of_matching_segments.cend());
-                }
-            }
-        }
-
-        if (!no_queries_match) {
+        SegmentIdSet ids_of_segments_to_search;
+        bool is_superseding_query;
+        if (generate_queries(search_strings, command_line_args, archive, queries, is_superseding_query, ids_of_segments_to_search)) {
             size_t num_matches;
             if (is_superseding_query) {
                 auto file_metadata_ix = archive.get_file_iterator(search_begin_ts, search_end_ts, command_line_args.get_file_path());
-                num_matches = search_files(queries, command_line_args.get_output_method(), archive, file_metadata_ix);
+                num_matches = search_files(queries, command_line_args.get_output_method(), archive, *file_metadata_ix);
             } else {
                 auto file_metadata_ix = archive.get_file_iterator(search_begin_ts, search_end_ts, command_line_args.get_file_path(), cInvalidSegmentId);
-                num_matches = search_files(queries, command_line_args.get_output_method(), archive, file_metadata_ix);
+                num_matches = search_files(queries, command_line_args.get_output_method(), archive, *file_metadata_ix);
                 for (auto segment_id : ids_of_segments_to_search) {
-                    file_metadata_ix.set_segment_id(segment_id);
-                    num_matches += search_files(queries, command_line_args.get_output_method(), archive, file_metadata_ix);
+                    file_metadata_ix->set_segment_id(segment_id);
+                    num_matches += search_files(queries, command_line_args.get_output_method(), archive, *file_metadata_ix);
                 }
             }
             SPDLOG_DEBUG("# matches found: {}", num_matches);
@@ -196,7 +262,120 @@ static bool search (const vector<string>& search_strings, CommandLineArguments&
     return true;
 }
 
-static bool open_compressed_file (MetadataDB::FileIterator& file_metadata_ix, Archive& archive, File& compressed_file) {
+static bool search_new_segments (const vector<string>& search_strings, CommandLineArguments& command_line_args, FollowedArchive& followed_archive) {
+    ErrorCode error_code;
+    auto& archive = *followed_archive.reader;
+
+    try {
+        // Find the segments we haven't searched
+        // NOTE: We do this before refreshing the dictionaries since the writer indexes a segment before adding its files to the metadata database. So
+        // the refreshed dictionaries will contain every entry that the new segments refer to.
+        vector<segment_id_t> ids_of_new_segments;
+        archive.get_ids_of_segments_with_files(followed_archive.min_unsearched_segment_id, ids_of_new_segments);
+        auto& ids_of_searched_segments = followed_archive.ids_of_searched_segments;
+        ids_of_new_segments.erase(std::remove_if(ids_of_new_segments.begin(), ids_of_new_segments.end(), [&ids_of_searched_segments] (segment_id_t id) {
+            return ids_of_searched_segments.count(id) > 0;
+        }), ids_of_new_segments.end());
+        if (ids_of_new_segments.empty()) {
+            return true;
+        }
+
+        // NOTE: Refreshing the dictionaries invalidates the entries referenced by previously generated queries, so we regenerate them. This only
+        // rescans the dictionaries; segments we've already searched are never decompressed again.
+        archive.refresh_dictionaries();
+        vector<Query> queries;
+        SegmentIdSet ids_of_segments_to_search;
+        bool is_superseding_query;
+        if (generate_queries(search_strings, command_line_args, archive, queries, is_superseding_query, ids_of_segments_to_search)) {
+            size_t num_matches = 0;
+            auto file_metadata_ix = archive.get_file_iterator(command_line_args.get_search_begin_ts(), command_line_args.get_search_end_ts(),
+                                                              command_line_args.get_file_path(), cInvalidSegmentId);
+            for (auto segment_id : ids_of_new_segments) {
+                if (is_superseding_query || ids_of_segments_to_search.contains(segment_id)) {
+                    file_metadata_ix->set_segment_id(segment_id);
+                    num_matches += search_files(queries, command_line_args.get_output_method(), archive, *file_metadata_ix);
+                }
+            }
+            SPDLOG_DEBUG("# matches found: {}", num_matches);
+        }
+
+        // Mark the new segments as searched
+        ids_of_searched_segments.insert(ids_of_new_segments.cbegin(), ids_of_new_segments.cend());
+        while (ids_of_searched_segments.count(followed_archive.min_unsearched_segment_id) > 0) {
+            ids_of_searched_segments.erase(followed_archive.min_unsearched_segment_id);
+            ++followed_archive.min_unsearched_segment_id;
+        }
+    } catch (TraceableException& e) {
+        error_code = e.get_error_code();
+        if (ErrorCode_errno == error_code) {
+            SPDLOG_ERROR("Search failed: {}:{} {}, errno={}", e.get_filename(), e.get_line_number(), e.what(), errno);
+            return false;
+        } else {
+            SPDLOG_ERROR("Search failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(), error_code);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void follow (const vector<string>& search_strings, CommandLineArguments& command_line_args, const boost::filesystem::path& archives_dir,
+                    GlobalMetadataDB& global_metadata_db)
+{
+    std::unordered_map<string, FollowedArchive> followed_archives;
+    vector<std::pair<string, size_t>> archive_ids_and_num_committed_segments;
+    string archive_id;
+    auto follow_interval = std::chrono::milliseconds(command_line_args.get_follow_interval_ms());
+    while (true) {
+        auto poll_begin_time = std::chrono::steady_clock::now();
+
+        // Get the number of segments committed to each archive
+        // NOTE: We finish reading from the global metadata database before searching so that we don't block writers from updating it
+        archive_ids_and_num_committed_segments.clear();
+        for (auto archive_ix = get_archive_iterator(global_metadata_db, command_line_args.get_file_path()); archive_ix.has_next(); archive_ix.next()) {
+            archive_ix.get_id(archive_id);
+            archive_ids_and_num_committed_segments.emplace_back(archive_id, archive_ix.get_num_committed_segments());
+        }
+
+        for (const auto& archive_id_and_num_committed_segments : archive_ids_and_num_committed_segments) {
+            auto& followed_archive = followed_archives[archive_id_and_num_committed_segments.first];
+
+            // The writer updates an archive's number of committed segments whenever it commits segments, so if it hasn't changed, there's nothing new
+            // to search. This also skips archives that have no committed segments, which the writer may still be creating.
+            // NOTE: The archive's uncompressed size can't be used instead since it includes files in segments that are still open, so it may not
+            // change when they're committed.
+            auto num_committed_segments = archive_id_and_num_committed_segments.second;
+            if (num_committed_segments == followed_archive.num_committed_segments) {
+                if (nullptr != followed_archive.reader && poll_begin_time - followed_archive.last_change_time >= cFollowedArchiveIdleTimeout) {
+                    followed_archive.reader->close();
+                    followed_archive.reader.reset();
+                }
+                continue;
+            }
+            followed_archive.num_committed_segments = num_committed_segments;
+            followed_archive.last_change_time = poll_begin_time;
+
+            if (nullptr == followed_archive.reader) {
+                auto archive_reader = std::make_unique<Archive>();
+                auto archive_path = archives_dir / archive_id_and_num_committed_segments.first;
+                if (false == open_archive(archive_path.string(), *archive_reader)) {
+                    return;
+                }
+                followed_archive.reader = std::move(archive_reader);
+            }
+            if (false == search_new_segments(search_strings, command_line_args, followed_archive)) {
+                return;
+            }
+        }
+
+        // Flush the results so they reach the consumer before we sleep
+        fflush(stdout);
+
+        std::this_thread::sleep_until(poll_begin_time + follow_interval);
+    }
+}
+
+static bool open_compressed_file (FileMetadataIterator& file_metadata_ix, Archive& archive, File& compressed_file) {
     ErrorCode error_code = archive.open_file(compressed_file, file_metadata_ix, false);
     if (ErrorCode_Success == error_code) {
         return true;
@@ -214,7 +393,7 @@ static bool open_compressed_file (MetadataDB::FileIterator& file_metadata_ix, Ar
 }
 
 static size_t search_files (vector<Query>& queries, const CommandLineArguments::OutputMethod output_method, Archive& archive,
-                            MetadataDB::FileIterator& file_metadata_ix)
+                            FileMetadataIterator& file_metadata_ix)
 {
     size_t num_matches = 0;
 
@@ -238,6 +417,9 @@ static size_t search_files (vector<Query>& queries, const CommandLineArguments::
 
     // Run all queries on each file
     for (; file_metadata_ix.has_next(); file_metadata_ix.next()) {
+        if (false == archive.file_may_match_queries(file_metadata_ix, queries)) {
+            continue;
+        }
         if (open_compressed_file(file_metadata_ix, archive, compressed_file)) {
             Grep::calculate_sub_queries_relevant_to_file(compressed_file, queries);
 
@@ -363,7 +545,12 @@ int main (int argc, const char* argv[]) {
 
     auto global_metadata_db_path = archives_dir / streaming_archive::cMetadataDBFileName;
     GlobalMetadataDB global_metadata_db;
-    global_metadata_db.open(global_metadata_db_path.string());
+    global_metadata_db.open(global_metadata_db_path.string(), false);
+
+    if (command_line_args.follow()) {
+        follow(search_strings, command_line_args, archives_dir, global_metadata_db);
+        return -1;
+    }
 
     string archive_id;
     Archive archive_reader;
@@ -7,6 +7,8 @@
 // Boost libraries
 #include <boost/program_options.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/uuid/string_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
 
 // spdlog
 #include <spdlog/spdlog.h>
@@ -202,6 +204,7 @@ namespace clp {
                 compression_positional_options_description.add("input-paths", -1);
 
                 // Define compression-specific options
+                string durability_policy = "flush";
                 po::options_description options_compression("Compression Options");
                 options_compression.add_options()
                         ("storage-id", po::value<string>(&m_archive_storage_id)->value_name("ID")->default_value(m_archive_storage_id),
@@ -219,6 +222,42 @@ namespace clp {
                                 "Target size (B) for the dictionaries before a new archive is created")
                         ("compression-level", po::value<int>(&m_compression_level)->value_name("LEVEL")->default_value(m_compression_level),
                                 "1 (fast/low compression) to 9 (slow/high compression)")
+                        ("threads", po::value<size_t>(&m_num_threads)->value_name("N")->default_value(m_num_threads),
+                                "Number of threads to compress with. Each thread writes to its own archive(s).")
+                        ("discovery-threads", po::value<size_t>(&m_num_discovery_threads)->value_name("N")->default_value(m_num_discovery_threads),
+                                "Number of threads to search input directories with")
+                        ("append-to", po::value<string>(&m_archive_id_to_append_to)->value_name("ID"),
+                                "Append the files to the existing archive with the given ID (in output-dir) instead of starting a new archive")
+                        ("stdin-path", po::value<string>(&m_stdin_path)->value_name("PATH"),
+                                "Compress content streamed on stdin (instead of input paths), storing it under PATH. All of the content is validated as"
+                                " UTF-8.")
+                        ("commit-interval", po::value<size_t>(&m_commit_interval)->value_name("SECONDS")->default_value(m_commit_interval),
+                                "When compressing stdin, the longest time (s) content waits before it's committed and searchable (0 to disable)")
+                        ("commit-size", po::value<size_t>(&m_commit_size)->value_name("SIZE")->default_value(m_commit_size),
+                                "When compressing stdin, the uncompressed size (B) of content that triggers a commit")
+                        ("archive-rollover-interval",
+                         po::value<size_t>(&m_archive_rollover_interval)->value_name("SECONDS")->default_value(m_archive_rollover_interval),
+                                "When compressing stdin, the time (s) after which a new archive is created (0 to disable)")
+                        ("durability", po::value<string>(&durability_policy)->value_name("POLICY")->default_value(durability_policy),
+                                "When content is synced to disk: 'flush' (every file whenever it's flushed), 'segment' (once per segment), 'group' (once"
+                                " per group of segments), or 'none'. Under every policy, a segment is only searchable after its content is synced.")
+                        ("group-commit-interval",
+                         po::value<size_t>(&m_group_commit_interval)->value_name("MS")->default_value(m_group_commit_interval),
+                                "With the group durability policy, the time (ms) since the last sync after which the next segment to close triggers a"
+                                " sync. This is only checked when a segment closes, so an idle archive isn't synced until it's committed or closed.")
+                        ("group-commit-size", po::value<size_t>(&m_group_commit_size)->value_name("SIZE")->default_value(m_group_commit_size),
+                                "With the group durability policy, the compressed size (B) of segments that triggers a sync")
+                        ("mmap-input", po::bool_switch(&m_memory_map_input_files),
+                                "Read input files by mapping them into memory instead of through stdio. This avoids copying content but files must not be"
+                                " truncated while they're compressed.")
+                        ("group-by-logtype", po::bool_switch(&m_group_messages_by_logtype),
+                                "Group each file's messages by logtype within segments, so that searches only scan messages with matching logtypes. Messages"
+                                " are still decompressed and searched in their original order.")
+                        ("index-variables", po::bool_switch(&m_index_variables),
+                                "Index each dictionary variable (e.g., an ID) in each segment by the messages containing it, so that searches for a"
+                                " specific variable only scan those messages. The index's size grows with the number of distinct variables.")
+                        ("full-utf8-validation", po::bool_switch(&m_validate_all_content),
+                                "Validate that all of each file's content (rather than only its first 4 KiB) is UTF-8 encoded while compressing it")
                         ("print-archive-ids", po::bool_switch(&m_print_archive_ids), "Print ID of each new archive")
                         ("progress", po::bool_switch(&m_show_progress), "Show progress during compression")
                         ;
@@ -244,6 +283,12 @@ namespace clp {
                     cerr << "  # Compress file1.txt and dir1 into the output dir" << endl;
                     cerr << "  " << get_program_name() << " c output-dir file1.txt dir1" << endl;
                     cerr << endl;
+                    cerr << "  # Compress the output of a command as it's produced, storing it under /var/log/app.log" << endl;
+                    cerr << "  app | " << get_program_name() << " c --stdin-path /var/log/app.log output-dir" << endl;
+                    cerr << endl;
+                    cerr << "  # Compress file2.txt into an existing archive in the output dir" << endl;
+                    cerr << "  " << get_program_name() << " c --append-to 00000000-0000-0000-0000-000000000000 output-dir file2.txt" << endl;
+                    cerr << endl;
 
                     po::options_description visible_options;
                     visible_options.add(options_general);
@@ -252,9 +297,18 @@ namespace clp {
                     return ParsingResult::InfoCommand;
                 }
 
-                // Validate at least one input path should exist (we validate that the file isn't empty later)
-                if (m_input_paths.empty() && m_path_list_path.empty()) {
-                    throw invalid_argument("No input paths specified.");
+                if (m_stdin_path.empty()) {
+                    // Validate at least one input path should exist (we validate that the file isn't empty later)
+                    if (m_input_paths.empty() && m_path_list_path.empty()) {
+                        throw invalid_argument("No input paths specified.");
+                    }
+                } else {
+                    if (false == m_input_paths.empty() || false == m_path_list_path.empty()) {
+                        throw invalid_argument("Input paths cannot be specified when compressing stdin.");
+                    }
+                    if (m_commit_size < 1) {
+                        throw invalid_argument("commit-size must be non-zero.");
+                    }
                 }
 
                 // Validate storage_id is not empty
@@ -274,6 +328,35 @@ namespace clp {
                     throw invalid_argument("target-data-size-of-dictionaries must be non-zero.");
                 }
 
+                if (m_num_threads < 1) {
+                    throw invalid_argument("threads must be non-zero.");
+                }
+
+                if (m_num_discovery_threads < 1) {
+                    throw invalid_argument("discovery-threads must be non-zero.");
+                }
+
+                if ("flush" == durability_policy) {
+                    m_durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::Flush;
+                } else if ("segment" == durability_policy) {
+                    m_durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::Segment;
+                } else if ("group" == durability_policy) {
+                    m_durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::Group;
+                } else if ("none" == durability_policy) {
+                    m_durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::None;
+                } else {
+                    throw invalid_argument("durability must be one of 'flush', 'segment', 'group', or 'none'.");
+                }
+
+                if (false == m_archive_id_to_append_to.empty()) {
+                    // Normalize the ID so that it matches the archive's directory name
+                    try {
+                        m_archive_id_to_append_to = boost::uuids::to_string(boost::uuids::string_generator()(m_archive_id_to_append_to));
+                    } catch (std::runtime_error& e) {
+                        throw invalid_argument("append-to must be a valid archive ID.");
+                    }
+                }
+
                 if (false == m_path_prefix_to_remove.empty()) {
                     if (false == boost::filesystem::exists(m_path_prefix_to_remove)) {
                         throw invalid_argument("Specified prefix to remove does not exist.");
@@ -10,6 +10,7 @@
 
 // Project headers
 #include "../CommandLineArgumentsBase.hpp"
+#include "../streaming_archive/writer/Archive.hpp"
 
 namespace clp {
     class CommandLineArguments : public CommandLineArgumentsBase {
@@ -22,8 +23,12 @@ namespace clp {
 
         // Constructors
         explicit CommandLineArguments (const std::string& program_name) : CommandLineArgumentsBase(program_name), m_show_progress(false),
-                m_print_archive_ids(false), m_target_segment_uncompressed_size(1L * 1024 * 1024 * 1024), m_target_encoded_file_size(512L * 1024 * 1024),
-                m_target_data_size_of_dictionaries(100L * 1024 * 1024), m_compression_level(3), m_archive_storage_id(boost::asio::ip::host_name()){}
+                m_print_archive_ids(false), m_validate_all_content(false), m_memory_map_input_files(false), m_group_messages_by_logtype(false),
+                m_index_variables(false), m_target_segment_uncompressed_size(1L * 1024 * 1024 * 1024), m_target_encoded_file_size(512L * 1024 * 1024),
+                m_target_data_size_of_dictionaries(100L * 1024 * 1024), m_compression_level(3), m_num_threads(1), m_num_discovery_threads(8),
+                m_archive_storage_id(boost::asio::ip::host_name()), m_commit_interval(5), m_commit_size(16L * 1024 * 1024), m_archive_rollover_interval(0),
+                m_durability_policy(streaming_archive::writer::Archive::DurabilityPolicy::Flush), m_group_commit_interval(1000),
+                m_group_commit_size(64L * 1024 * 1024) {}
 
         // Methods
         ParsingResult parse_arguments (int argc, const char* argv[]) override;
@@ -33,11 +38,25 @@ namespace clp {
         const std::string& get_output_dir () const { return m_output_dir; }
         bool show_progress () const { return m_show_progress; }
         bool print_archive_ids () const { return m_print_archive_ids; }
+        bool validate_all_content () const { return m_validate_all_content; }
+        bool memory_map_input_files () const { return m_memory_map_input_files; }
+        bool group_messages_by_logtype () const { return m_group_messages_by_logtype; }
+        bool index_variables () const { return m_index_variables; }
         size_t get_target_encoded_file_size () const { return m_target_encoded_file_size; }
         size_t get_target_segment_uncompressed_size () const { return m_target_segment_uncompressed_size; }
         size_t get_target_data_size_of_dictionaries () const { return m_target_data_size_of_dictionaries; }
         int get_compression_level () const { return m_compression_level; }
+        size_t get_num_threads () const { return m_num_threads; }
+        size_t get_num_discovery_threads () const { return m_num_discovery_threads; }
         const std::string& get_archive_storage_id () const { return m_archive_storage_id; }
+        const std::string& get_archive_id_to_append_to () const { return m_archive_id_to_append_to; }
+        const std::string& get_stdin_path () const { return m_stdin_path; }
+        size_t get_commit_interval () const { return m_commit_interval; }
+        size_t get_commit_size () const { return m_commit_size; }
+        size_t get_archive_rollover_interval () const { return m_archive_rollover_interval; }
+        streaming_archive::writer::Archive::DurabilityPolicy get_durability_policy () const { return m_durability_policy; }
+        size_t get_group_commit_interval () const { return m_group_commit_interval; }
+        size_t get_group_commit_size () const { return m_group_commit_size; }
         Command get_command () const { return m_command; }
         const std::string& get_archives_dir () const { return m_archives_dir; }
         const std::vector<std::string>& get_input_paths () const { return m_input_paths; }
@@ -54,11 +73,25 @@ namespace clp {
         std::string m_output_dir;
         bool m_show_progress;
         bool m_print_archive_ids;
+        bool m_validate_all_content;
+        bool m_memory_map_input_files;
+        bool m_group_messages_by_logtype;
+        bool m_index_variables;
         size_t m_target_encoded_file_size;
         size_t m_target_segment_uncompressed_size;
         size_t m_target_data_size_of_dictionaries;
         int m_compression_level;
+        size_t m_num_threads;
+        size_t m_num_discovery_threads;
         std::string m_archive_storage_id;
+        std::string m_archive_id_to_append_to;
+        std::string m_stdin_path;
+        size_t m_commit_interval;
+        size_t m_commit_size;
+        size_t m_archive_rollover_interval;
+        streaming_archive::writer::Archive::DurabilityPolicy m_durability_policy;
+        size_t m_group_commit_interval;
+        size_t m_group_commit_size;
         Command m_command;
         std::string m_archives_dir;
         std::vector<std::string> m_input_paths;
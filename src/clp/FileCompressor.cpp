@@ -2,6 +2,7 @@
 
 // C++ standard libraries
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <set>
 
@@ -82,22 +83,42 @@ namespace clp {
                                         bool print_archive_ids, size_t target_encoded_file_size, const FileToCompress& file_to_compress,
                                         streaming_archive::writer::Archive& archive_writer)
     {
-        m_file_reader.open(file_to_compress.get_path());
+        ReaderInterface* reader;
+        if (m_memory_map_files) {
+            m_memory_mapped_file_reader.open(file_to_compress.get_path());
+            reader = &m_memory_mapped_file_reader;
+        } else {
+            m_file_reader.open(file_to_compress.get_path());
+            reader = &m_file_reader;
+        }
 
         // Check that file is UTF-8 encoded
-        auto error_code = m_file_reader.try_read(m_utf8_validation_buf, cUtf8ValidationBufCapacity, m_utf8_validation_buf_length);
+        auto error_code = reader->try_read(m_utf8_validation_buf, cUtf8ValidationBufCapacity, m_utf8_validation_buf_length);
         if (ErrorCode_Success != error_code) {
             if (ErrorCode_EndOfFile != error_code) {
                 SPDLOG_ERROR("Failed to read {}, errno={}", file_to_compress.get_path().c_str(), errno);
+                m_file_reader.close();
+                m_memory_mapped_file_reader.close();
                 return false;
             }
         }
 
         bool succeeded = true;
-        if (is_utf8_sequence(m_utf8_validation_buf_length, m_utf8_validation_buf)) {
-            parse_and_encode(target_data_size_of_dicts, archive_user_config, print_archive_ids, target_encoded_file_size,
-                             file_to_compress.get_path_for_compression(), file_to_compress.get_group_id(), archive_writer, m_file_reader);
+        m_utf8_validator.reset();
+        if (m_utf8_validator.validate(m_utf8_validation_buf, m_utf8_validation_buf_length)) {
+            if (false == parse_and_encode(target_data_size_of_dicts, archive_user_config, print_archive_ids, target_encoded_file_size,
+                                          file_to_compress.get_path_for_compression(), file_to_compress.get_group_id(), archive_writer, *reader,
+                                          false == m_memory_map_files))
+            {
+                succeeded = false;
+            }
         } else {
+            if (m_memory_map_files) {
+                // libarchive reads from a FileReader, so switch to one positioned after the validation buffer
+                m_memory_mapped_file_reader.close();
+                m_file_reader.open(file_to_compress.get_path());
+                m_file_reader.seek_from_begin(m_utf8_validation_buf_length);
+            }
             if (false == try_compressing_as_archive(target_data_size_of_dicts, archive_user_config, print_archive_ids, target_encoded_file_size,
                                                     file_to_compress, archive_writer))
             {
@@ -106,13 +127,14 @@ namespace clp {
         }
 
         m_file_reader.close();
+        m_memory_mapped_file_reader.close();
 
         return succeeded;
     }
 
-    void FileCompressor::parse_and_encode (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config,
+    bool FileCompressor::parse_and_encode (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config,
                                            bool print_archive_ids, size_t target_encoded_file_size, const string& path_for_compression, group_id_t group_id,
-                                           streaming_archive::writer::Archive& archive_writer, ReaderInterface& reader)
+                                           streaming_archive::writer::Archive& archive_writer, ReaderInterface& reader, bool read_ahead)
     {
         m_parsed_message.clear();
 
@@ -133,7 +155,19 @@ namespace clp {
         }
 
         // Parse remaining content from file
-        while (m_message_parser.parse_next_message(true, reader, m_parsed_message)) {
+        // NOTE: If the validation buffer wasn't filled, the reader is already at EOF, so we don't bother reading ahead or validating
+        ReaderInterface* remaining_content_reader = &reader;
+        if (cUtf8ValidationBufCapacity == m_utf8_validation_buf_length) {
+            if (m_validate_all_content) {
+                m_utf8_validating_reader.open(reader, m_utf8_validator);
+                remaining_content_reader = &m_utf8_validating_reader;
+            }
+            if (read_ahead) {
+                m_read_ahead_reader.open(*remaining_content_reader);
+                remaining_content_reader = &m_read_ahead_reader;
+            }
+        }
+        while (m_message_parser.parse_next_message(true, *remaining_content_reader, m_parsed_message)) {
             if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dicts) {
                 split_file_and_archive(archive_user_config, print_archive_ids, path_for_compression, group_id, m_parsed_message.get_ts_patt(), archive_writer,
                                        file);
@@ -143,8 +177,104 @@ namespace clp {
 
             write_message_to_encoded_file(m_parsed_message, archive_writer, file);
         }
+        m_read_ahead_reader.close();
+        bool is_utf8_encoded = m_utf8_validator.is_valid();
+        if (false == is_utf8_encoded) {
+            SPDLOG_ERROR("Cannot compress all of {} - content after the first {} bytes is not UTF-8 encoded.", path_for_compression.c_str(),
+                         m_utf8_validation_buf_length + m_utf8_validating_reader.get_pos());
+        }
+        m_utf8_validating_reader.close();
 
         close_file_and_mark_ready_for_segment(archive_writer, file);
+
+        return is_utf8_encoded;
+    }
+
+    bool FileCompressor::compress_stream (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config,
+                                          bool print_archive_ids, size_t target_encoded_file_size, const string& path_for_compression,
+                                          std::chrono::seconds commit_interval, size_t commit_size, std::chrono::seconds archive_rollover_interval,
+                                          FileDescriptorReader& reader, streaming_archive::writer::Archive& archive_writer)
+    {
+        constexpr group_id_t cGroupId = 0;
+
+        m_parsed_message.clear();
+
+        // NOTE: Unlike a file, a stream can't be checked before it's compressed since its content may arrive slowly, so we validate all of it as it's
+        // read
+        m_utf8_validator.reset();
+        m_utf8_validating_reader.open(reader, m_utf8_validator);
+
+        // Open compressed file
+        auto* file = create_and_open_in_memory_file(archive_writer, path_for_compression, cGroupId, m_uuid_generator(), 0);
+
+        bool succeeded = true;
+        auto archive_open_time = std::chrono::steady_clock::now();
+        auto oldest_uncommitted_msg_time = archive_open_time;
+        while (true) {
+            bool has_message;
+            try {
+                has_message = m_message_parser.parse_next_message(true, m_utf8_validating_reader, m_parsed_message);
+            } catch (MessageParser::OperationFailed& e) {
+                // Stop reading but still commit what was read
+                if (ErrorCode_errno == e.get_error_code()) {
+                    SPDLOG_ERROR("Failed to read {}, errno={}", path_for_compression.c_str(), errno);
+                } else {
+                    SPDLOG_ERROR("Failed to read {}, error_code={}", path_for_compression.c_str(), e.get_error_code());
+                }
+                succeeded = false;
+                break;
+            }
+            if (false == has_message) {
+                if (reader.is_at_eof()) {
+                    break;
+                }
+                if (false == m_utf8_validator.is_valid()) {
+                    SPDLOG_ERROR("Cannot compress all of {} - content after the first {} bytes is not UTF-8 encoded.", path_for_compression.c_str(),
+                                 m_utf8_validating_reader.get_pos());
+                    succeeded = false;
+                    break;
+                }
+                // The stream is idle, so write the buffered message rather than waiting to see if the next line continues it
+                has_message = m_message_parser.take_buffered_message(m_parsed_message);
+            }
+
+            if (has_message) {
+                if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dicts) {
+                    split_file_and_archive(archive_user_config, print_archive_ids, path_for_compression, cGroupId, m_parsed_message.get_ts_patt(),
+                                           archive_writer, file);
+                    archive_open_time = std::chrono::steady_clock::now();
+                } else if (file->get_encoded_size_in_bytes() >= target_encoded_file_size) {
+                    split_file(path_for_compression, cGroupId, m_parsed_message.get_ts_patt(), archive_writer, file);
+                }
+
+                if (0 == file->get_num_messages()) {
+                    oldest_uncommitted_msg_time = std::chrono::steady_clock::now();
+                }
+                write_message_to_encoded_file(m_parsed_message, archive_writer, file);
+            }
+
+            if (0 == file->get_num_messages()) {
+                // Nothing to commit
+                continue;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (archive_rollover_interval.count() > 0 && now - archive_open_time >= archive_rollover_interval) {
+                // Closing the archive commits everything in it
+                split_file_and_archive(archive_user_config, print_archive_ids, path_for_compression, cGroupId, m_parsed_message.get_ts_patt(),
+                                       archive_writer, file);
+                archive_open_time = now;
+            } else if (file->get_num_uncompressed_bytes() >= commit_size
+                       || (commit_interval.count() > 0 && now - oldest_uncommitted_msg_time >= commit_interval))
+            {
+                split_file(path_for_compression, cGroupId, m_parsed_message.get_ts_patt(), archive_writer, file);
+                archive_writer.commit();
+            }
+        }
+        m_utf8_validating_reader.close();
+
+        close_file_and_mark_ready_for_segment(archive_writer, file);
+
+        return succeeded;
     }
 
     bool FileCompressor::try_compressing_as_archive (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config,
@@ -222,10 +352,15 @@ namespace clp {
                     continue;
                 }
             }
-            if (is_utf8_sequence(m_utf8_validation_buf_length, m_utf8_validation_buf)) {
+            m_utf8_validator.reset();
+            if (m_utf8_validator.validate(m_utf8_validation_buf, m_utf8_validation_buf_length)) {
                 auto boost_path_for_compression = parent_boost_path / m_libarchive_reader.get_path();
-                parse_and_encode(target_data_size_of_dicts, archive_user_config, print_archive_ids, target_encoded_file_size,
-                                 boost_path_for_compression.string(), file_to_compress.get_group_id(), archive_writer, m_libarchive_file_reader);
+                if (false == parse_and_encode(target_data_size_of_dicts, archive_user_config, print_archive_ids, target_encoded_file_size,
+                                              boost_path_for_compression.string(), file_to_compress.get_group_id(), archive_writer,
+                                              m_libarchive_file_reader, true))
+                {
+                    succeeded = false;
+                }
             } else {
                 SPDLOG_ERROR("Cannot compress {} - not UTF-8 encoded.", m_libarchive_reader.get_path());
                 succeeded = false;
@@ -1,16 +1,25 @@
 #ifndef CLP_FILECOMPRESSOR_HPP
 #define CLP_FILECOMPRESSOR_HPP
 
+// C++ standard libraries
+#include <chrono>
+#include <string>
+
 // Boost libraries
 #include <boost/uuid/random_generator.hpp>
 
 // Project headers
+#include "../FileDescriptorReader.hpp"
 #include "../FileReader.hpp"
 #include "../LibarchiveFileReader.hpp"
 #include "../LibarchiveReader.hpp"
+#include "../MemoryMappedFileReader.hpp"
 #include "../MessageParser.hpp"
 #include "../ParsedMessage.hpp"
+#include "../ReadAheadReader.hpp"
 #include "../streaming_archive/writer/Archive.hpp"
+#include "../Utf8ValidatingReader.hpp"
+#include "../Utf8Validator.hpp"
 #include "FileToCompress.hpp"
 
 namespace clp {
@@ -22,7 +31,14 @@ namespace clp {
     class FileCompressor {
     public:
         // Constructors
-        FileCompressor (boost::uuids::random_generator& uuid_generator) : m_uuid_generator(uuid_generator) {}
+        /**
+         * @param uuid_generator
+         * @param validate_all_content Whether to validate that all of a file's content is UTF-8 encoded while compressing it, rather than only the
+         * content in the validation buffer
+         * @param memory_map_files Whether to read files by mapping them into memory rather than through stdio
+         */
+        FileCompressor (boost::uuids::random_generator& uuid_generator, bool validate_all_content, bool memory_map_files) :
+                m_uuid_generator(uuid_generator), m_validate_all_content(validate_all_content), m_memory_map_files(memory_map_files) {}
 
         // Methods
         /**
@@ -37,11 +53,34 @@ namespace clp {
          */
         bool compress_file (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config, bool print_archive_ids,
                             size_t target_encoded_file_size, const FileToCompress& file_to_compress, streaming_archive::writer::Archive& archive_writer);
+        /**
+         * Compresses content streamed from the given reader into the archive until the stream ends. The content is committed (as a split of the file
+         * with the given path) once its oldest message has waited for the commit interval or it reaches the commit size, so that it's searchable soon
+         * after it's read. All of the content is validated as it's read, and compression stops at the first content that isn't UTF-8 encoded.
+         * @param target_data_size_of_dicts
+         * @param archive_user_config
+         * @param print_archive_ids
+         * @param target_encoded_file_size
+         * @param path_for_compression
+         * @param commit_interval 0 to only commit by size
+         * @param commit_size Uncompressed size
+         * @param archive_rollover_interval How long to write to an archive before starting a new one, or 0 to only start new archives when the
+         * dictionaries reach their target size
+         * @param reader
+         * @param archive_writer
+         * @return false if the stream couldn't be read or content that isn't UTF-8 encoded was found (in which case the content before it was still
+         * compressed), true otherwise
+         */
+        bool compress_stream (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config, bool print_archive_ids,
+                              size_t target_encoded_file_size, const std::string& path_for_compression, std::chrono::seconds commit_interval,
+                              size_t commit_size, std::chrono::seconds archive_rollover_interval, FileDescriptorReader& reader,
+                              streaming_archive::writer::Archive& archive_writer);
 
     private:
         // Methods
         /**
-         * Parses and encodes content from the given reader into the given archive_writer
+         * Parses and encodes content from the given reader into the given archive_writer. Content beyond the UTF-8 validation buffer is optionally read
+         * ahead on a background thread while parsing and encoding, and if all content should be validated, it's validated on that thread too.
          * @param target_data_size_of_dicts
          * @param archive_user_config
          * @param print_archive_ids
@@ -50,10 +89,13 @@ namespace clp {
          * @param group_id
          * @param archive_writer
          * @param reader
+         * @param read_ahead Whether to read ahead on a background thread. This is unnecessary for readers that return views of memory-mapped content,
+         * since the kernel reads ahead for them.
+         * @return false if content that isn't UTF-8 encoded was found (in which case the content from there on wasn't compressed), true otherwise
          */
-        void parse_and_encode (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config, bool print_archive_ids,
+        bool parse_and_encode (size_t target_data_size_of_dicts, streaming_archive::writer::Archive::UserConfig& archive_user_config, bool print_archive_ids,
                                size_t target_encoded_file_size, const std::string& path_for_compression, group_id_t group_id,
-                               streaming_archive::writer::Archive& archive_writer, ReaderInterface& reader);
+                               streaming_archive::writer::Archive& archive_writer, ReaderInterface& reader, bool read_ahead);
 
         /**
          * Tries to compress the given file as if it were a generic archive_writer
@@ -71,13 +113,20 @@ namespace clp {
 
         // Variables
         boost::uuids::random_generator& m_uuid_generator;
+        bool m_validate_all_content;
+        bool m_memory_map_files;
         FileReader m_file_reader;
+        MemoryMappedFileReader m_memory_mapped_file_reader;
         LibarchiveReader m_libarchive_reader;
         LibarchiveFileReader m_libarchive_file_reader;
         char m_utf8_validation_buf[cUtf8ValidationBufCapacity];
         size_t m_utf8_validation_buf_length;
+        Utf8Validator m_utf8_validator;
+        Utf8ValidatingReader m_utf8_validating_reader;
         MessageParser m_message_parser;
         ParsedMessage m_parsed_message;
+        // NOTE: This must be declared after the readers it reads from, so that it's destroyed (stopping its background thread) before them
+        ReadAheadReader m_read_ahead_reader;
     };
 }
 
@@ -10,7 +10,7 @@
 using std::string;
 
 namespace clp {
-    bool FileDecompressor::decompress_file (streaming_archive::MetadataDB::FileIterator& file_metadata_ix, const string& output_dir,
+    bool FileDecompressor::decompress_file (streaming_archive::FileMetadataIterator& file_metadata_ix, const string& output_dir,
                                             streaming_archive::reader::Archive& archive_reader, std::unordered_map<string, string>& temp_path_to_final_path)
     {
         // Open compressed file
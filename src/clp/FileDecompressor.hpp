@@ -6,7 +6,7 @@
 
 // Project headers
 #include "../FileWriter.hpp"
-#include "../streaming_archive/MetadataDB.hpp"
+#include "../streaming_archive/FileMetadataIterator.hpp"
 #include "../streaming_archive/reader/Archive.hpp"
 #include "../streaming_archive/reader/File.hpp"
 #include "../streaming_archive/reader/Message.hpp"
@@ -19,7 +19,7 @@ namespace clp {
     class FileDecompressor {
     public:
         // Methods
-        bool decompress_file (streaming_archive::MetadataDB::FileIterator& file_metadata_ix, const std::string& output_dir,
+        bool decompress_file (streaming_archive::FileMetadataIterator& file_metadata_ix, const std::string& output_dir,
                               streaming_archive::reader::Archive& archive_reader, std::unordered_map<std::string, std::string>& temp_path_to_final_path);
 
     private:
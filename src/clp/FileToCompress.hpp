@@ -2,6 +2,7 @@
 #define CLP_FILETOCOMPRESS_HPP
 
 // C++ standard libraries
+#include <ctime>
 #include <string>
 
 // Project headers
@@ -15,18 +16,31 @@ namespace clp {
     public:
         // Constructors
         FileToCompress (const std::string& path, const std::string& path_for_compression, group_id_t group_id) : m_path(path), m_path_for_compression(
-                path_for_compression), m_group_id(group_id) {}
+                path_for_compression), m_group_id(group_id), m_size(0), m_last_write_time(0) {}
+        /**
+         * @param path
+         * @param path_for_compression
+         * @param group_id
+         * @param size The file's size, as of when it was found
+         * @param last_write_time The file's last write time, as of when it was found
+         */
+        FileToCompress (const std::string& path, const std::string& path_for_compression, group_id_t group_id, size_t size, std::time_t last_write_time) :
+                m_path(path), m_path_for_compression(path_for_compression), m_group_id(group_id), m_size(size), m_last_write_time(last_write_time) {}
 
         // Methods
         const std::string& get_path () const { return m_path; }
         const std::string& get_path_for_compression () const { return m_path_for_compression; }
         group_id_t get_group_id () const { return m_group_id; }
+        size_t get_size () const { return m_size; }
+        std::time_t get_last_write_time () const { return m_last_write_time; }
 
     private:
         // Variables
         std::string m_path;
         std::string m_path_for_compression;
         group_id_t m_group_id;
+        size_t m_size;
+        std::time_t m_last_write_time;
     };
 }
 
@@ -10,6 +10,7 @@
 #include <spdlog/spdlog.h>
 
 // Project headers
+#include "../FileWriter.hpp"
 #include "../Profiler.hpp"
 #include "../Utils.hpp"
 #include "CommandLineArguments.hpp"
@@ -25,7 +26,7 @@ using std::vector;
 int main (int argc, const char* argv[]) {
     // Program-wide initialization
     try {
-        auto stderr_logger = spdlog::stderr_logger_st("stderr");
+        auto stderr_logger = spdlog::stderr_logger_mt("stderr");
         spdlog::set_default_logger(stderr_logger);
         spdlog::set_pattern("%Y-%m-%d %H:%M:%S,%e [%l] %v");
     } catch (std::exception& e) {
@@ -57,6 +58,30 @@ int main (int argc, const char* argv[]) {
     }
 
     if (CommandLineArguments::Command::Compress == command_line_args.get_command()) {
+        // Unless each file is synced when it's flushed, the archive syncs everything it writes with a single barrier before committing it
+        FileWriter::set_sync_on_flush(streaming_archive::writer::Archive::DurabilityPolicy::Flush == command_line_args.get_durability_policy());
+    }
+
+    if (CommandLineArguments::Command::Compress == command_line_args.get_command() && false == command_line_args.get_stdin_path().empty()) {
+        bool compression_successful;
+        try {
+            compression_successful = compress_stdin(command_line_args);
+        } catch (TraceableException& e) {
+            ErrorCode error_code = e.get_error_code();
+            if (ErrorCode_errno == error_code) {
+                SPDLOG_ERROR("Compression failed: {}:{} {}, errno={}", e.get_filename(), e.get_line_number(), e.what(), errno);
+            } else {
+                SPDLOG_ERROR("Compression failed: {}:{} {}, error_code={}", e.get_filename(), e.get_line_number(), e.what(), error_code);
+            }
+            compression_successful = false;
+        } catch (std::exception& e) {
+            SPDLOG_ERROR("Compression failed: Unexpected exception - {}", e.what());
+            compression_successful = false;
+        }
+        if (!compression_successful) {
+            return -1;
+        }
+    } else if (CommandLineArguments::Command::Compress == command_line_args.get_command()) {
         boost::filesystem::path path_prefix_to_remove(command_line_args.get_path_prefix_to_remove());
 
         // Validate input paths exist
@@ -67,10 +92,10 @@ int main (int argc, const char* argv[]) {
         // Get paths of all files we need to compress
         vector<clp::FileToCompress> files_to_compress;
         vector<string> empty_directory_paths;
-        for (const auto& input_path : input_paths) {
-            if (false == find_all_files_and_empty_directories(path_prefix_to_remove, input_path, files_to_compress, empty_directory_paths)) {
-                return -1;
-            }
+        if (false == find_all_files_and_empty_directories(path_prefix_to_remove, input_paths, command_line_args.get_num_discovery_threads(),
+                                                          files_to_compress, empty_directory_paths))
+        {
+            return -1;
         }
 
         vector<clp::FileToCompress> grouped_files_to_compress;
@@ -107,5 +132,10 @@ int main (int argc, const char* argv[]) {
         }
     }
 
+    if (PROF_ENABLED && CommandLineArguments::Command::Compress == command_line_args.get_command()) {
+        SPDLOG_INFO("Time spent writing file metadata: {:.3f}s",
+                    Profiler::get_fragmented_measurement(Profiler::FragmentedMeasurementIndex::MetadataWrite) / 1e9);
+    }
+
     return 0;
 }
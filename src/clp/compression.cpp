@@ -1,11 +1,20 @@
 #include "compression.hpp"
 
+// C standard libraries
+#include <unistd.h>
+
 // C++ standard libraries
+#include <algorithm>
+#include <chrono>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 // Boost libraries
 #include <boost/filesystem/operations.hpp>
 #include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/string_generator.hpp>
 
 // libarchive
 #include <archive_entry.h>
@@ -14,6 +23,7 @@
 #include <spdlog/spdlog.h>
 
 // Project headers
+#include "../FileDescriptorReader.hpp"
 #include "../GlobalMetadataDB.hpp"
 #include "../streaming_archive/writer/Archive.hpp"
 #include "../Utils.hpp"
@@ -28,6 +38,122 @@ using std::string;
 using std::vector;
 
 namespace clp {
+    // Local types
+    /**
+     * Existing archive that a compression thread reopens and appends to before it creates any new archives
+     */
+    struct ArchiveToAppendTo {
+        boost::uuids::uuid id;
+        boost::uuids::uuid creator_id;
+        // Largest creation number among the archives from the same creator, so that new archives are ordered after all of them
+        size_t last_creation_num;
+    };
+
+    /**
+     * Queue of files to compress that's shared by the compression threads. Ungrouped files are handed out one at a time from the end of their list,
+     * followed by grouped files, which are handed out a group at a time so that a group isn't spread over multiple archives.
+     */
+    class FilesToCompressQueue {
+    public:
+        // Constructors
+        /**
+         * @param files_to_compress Ungrouped files, sorted so that the file to compress first is last
+         * @param grouped_files_to_compress Grouped files, sorted by group ID
+         */
+        FilesToCompressQueue (const vector<FileToCompress>& files_to_compress, const vector<FileToCompress>& grouped_files_to_compress) :
+                m_files_to_compress(files_to_compress), m_num_files_remaining(files_to_compress.size()),
+                m_grouped_files_to_compress(grouped_files_to_compress), m_next_grouped_file_ix(0), m_is_aborted(false) {}
+
+        // Methods
+        /**
+         * Gets the next file, or group of files, to compress
+         * @param files Returns the files
+         * @return false if there are no more files to compress or the queue was aborted, true otherwise
+         */
+        bool get_next_files (vector<const FileToCompress*>& files);
+
+        /**
+         * Stops handing out files, e.g., after a thread failed unrecoverably
+         */
+        void abort ();
+
+    private:
+        // Variables
+        std::mutex m_mutex;
+
+        const vector<FileToCompress>& m_files_to_compress;
+        size_t m_num_files_remaining;
+        const vector<FileToCompress>& m_grouped_files_to_compress;
+        size_t m_next_grouped_file_ix;
+        bool m_is_aborted;
+    };
+
+    /**
+     * Progress of all compression threads, reported on stderr
+     */
+    class CompressionProgress {
+    public:
+        // Constructors
+        CompressionProgress (bool show_progress, size_t num_files_to_compress) : m_show_progress(show_progress), m_num_files_compressed(0),
+                m_num_files_to_compress(num_files_to_compress) {}
+
+        // Methods
+        /**
+         * Records that a file was compressed
+         */
+        void increment ();
+
+    private:
+        // Variables
+        std::mutex m_mutex;
+
+        bool m_show_progress;
+        size_t m_num_files_compressed;
+        size_t m_num_files_to_compress;
+    };
+
+    bool FilesToCompressQueue::get_next_files (vector<const FileToCompress*>& files) {
+        files.clear();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_is_aborted) {
+            return false;
+        }
+
+        if (m_num_files_remaining > 0) {
+            --m_num_files_remaining;
+            files.push_back(&m_files_to_compress[m_num_files_remaining]);
+            return true;
+        }
+
+        if (m_next_grouped_file_ix < m_grouped_files_to_compress.size()) {
+            auto group_id = m_grouped_files_to_compress[m_next_grouped_file_ix].get_group_id();
+            do {
+                files.push_back(&m_grouped_files_to_compress[m_next_grouped_file_ix]);
+                ++m_next_grouped_file_ix;
+            } while (m_next_grouped_file_ix < m_grouped_files_to_compress.size()
+                     && m_grouped_files_to_compress[m_next_grouped_file_ix].get_group_id() == group_id);
+            return true;
+        }
+
+        return false;
+    }
+
+    void FilesToCompressQueue::abort () {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_aborted = true;
+    }
+
+    void CompressionProgress::increment () {
+        if (false == m_show_progress) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_num_files_compressed;
+        cerr << "Compressed " << m_num_files_compressed << '/' << m_num_files_to_compress << " files" << '\r';
+    }
+
     // Local prototypes
     /**
      * Comparator to sort files based on their group ID
@@ -43,20 +169,71 @@ namespace clp {
      * @return true if lhs' last write time is less than rhs' last write time, false otherwise
      */
     static bool file_lt_last_write_time_comparator (const FileToCompress& lhs, const FileToCompress& rhs);
+    /**
+     * Comparator to sort files based on their size
+     * @param lhs
+     * @param rhs
+     * @return true if lhs' size is less than rhs' size, false otherwise
+     */
+    static bool file_lt_size_comparator (const FileToCompress& lhs, const FileToCompress& rhs);
+    /**
+     * Creates the output directory if necessary and opens the global metadata database in it
+     * @param command_line_args
+     * @param global_metadata_db
+     * @return true on success, false otherwise
+     */
+    static bool open_global_metadata_db (const CommandLineArguments& command_line_args, GlobalMetadataDB& global_metadata_db);
+    /**
+     * Looks up the archive that the user asked to append to, if any
+     * @param command_line_args
+     * @param global_metadata_db
+     * @param archive_to_append_to
+     * @return false if the archive doesn't exist, true otherwise
+     */
+    static bool find_archive_to_append_to (const CommandLineArguments& command_line_args, GlobalMetadataDB& global_metadata_db,
+                                           ArchiveToAppendTo& archive_to_append_to);
+    /**
+     * Opens either the given existing archive or a new archive with a new creator ID
+     * @param command_line_args
+     * @param archive_to_append_to Existing archive to append to (in which case its creator ID is reused for subsequent archives), or nullptr
+     * @param uuid_generator
+     * @param global_metadata_db
+     * @param archive_user_config Returns the config the archive was opened with
+     * @param archive_writer
+     */
+    static void open_archive (const CommandLineArguments& command_line_args, const ArchiveToAppendTo* archive_to_append_to,
+                              boost::uuids::random_generator& uuid_generator, GlobalMetadataDB& global_metadata_db,
+                              streaming_archive::writer::Archive::UserConfig& archive_user_config, streaming_archive::writer::Archive& archive_writer);
+    /**
+     * Compresses files from the given queue until it's exhausted. The files are compressed into archives owned by the calling thread, which are split as
+     * they reach the target dictionaries size. Each thread uses its own creator ID, so the creation number orders the archives created by a thread.
+     * @param command_line_args
+     * @param archive_to_append_to Existing archive to append to first (in which case the thread continues with its creator ID), or nullptr
+     * @param empty_directory_paths Empty directories to add to the thread's first archive
+     * @param target_encoded_file_size
+     * @param always_create_archive Whether to create an archive even if the queue is already exhausted
+     * @param global_metadata_db
+     * @param files_queue
+     * @param progress
+     * @return true if all files were compressed successfully, false otherwise
+     */
+    static bool compress_files_from_queue (const CommandLineArguments& command_line_args, const ArchiveToAppendTo* archive_to_append_to,
+                                           const vector<string>& empty_directory_paths, size_t target_encoded_file_size, bool always_create_archive,
+                                           GlobalMetadataDB& global_metadata_db, FilesToCompressQueue& files_queue, CompressionProgress& progress);
 
     static bool file_group_id_comparator (const FileToCompress& lhs, const FileToCompress& rhs) {
         return lhs.get_group_id() < rhs.get_group_id();
     }
 
     static bool file_lt_last_write_time_comparator (const FileToCompress& lhs, const FileToCompress& rhs) {
-        return boost::filesystem::last_write_time(lhs.get_path()) < boost::filesystem::last_write_time(rhs.get_path());
+        return lhs.get_last_write_time() < rhs.get_last_write_time();
     }
 
-    bool compress (CommandLineArguments& command_line_args, vector<FileToCompress>& files_to_compress, const vector<string>& empty_directory_paths,
-                   vector<FileToCompress>& grouped_files_to_compress, size_t target_encoded_file_size)
-    {
-        GlobalMetadataDB global_metadata_db;
+    static bool file_lt_size_comparator (const FileToCompress& lhs, const FileToCompress& rhs) {
+        return lhs.get_size() < rhs.get_size();
+    }
 
+    static bool open_global_metadata_db (const CommandLineArguments& command_line_args, GlobalMetadataDB& global_metadata_db) {
         auto output_dir = boost::filesystem::path(command_line_args.get_output_dir());
 
         // Create output directory in case it doesn't exist
@@ -67,83 +244,217 @@ namespace clp {
         }
 
         auto db_path = output_dir / streaming_archive::cMetadataDBFileName;
-        global_metadata_db.open(db_path.string());
+        global_metadata_db.open(db_path.string(), true);
 
-        auto uuid_generator = boost::uuids::random_generator();
+        return true;
+    }
 
+    static bool find_archive_to_append_to (const CommandLineArguments& command_line_args, GlobalMetadataDB& global_metadata_db,
+                                           ArchiveToAppendTo& archive_to_append_to)
+    {
+        const auto& archive_id_to_append_to = command_line_args.get_archive_id_to_append_to();
+        if (archive_id_to_append_to.empty()) {
+            return true;
+        }
+
+        string creator_id;
+        if (false == global_metadata_db.get_archive_creator(archive_id_to_append_to, creator_id, archive_to_append_to.last_creation_num)) {
+            SPDLOG_ERROR("Archive {} doesn't exist in {}", archive_id_to_append_to.c_str(), command_line_args.get_output_dir().c_str());
+            return false;
+        }
+        boost::uuids::string_generator uuid_string_generator;
+        archive_to_append_to.id = uuid_string_generator(archive_id_to_append_to);
+        archive_to_append_to.creator_id = uuid_string_generator(creator_id);
+
+        return true;
+    }
+
+    static void open_archive (const CommandLineArguments& command_line_args, const ArchiveToAppendTo* archive_to_append_to,
+                              boost::uuids::random_generator& uuid_generator, GlobalMetadataDB& global_metadata_db,
+                              streaming_archive::writer::Archive::UserConfig& archive_user_config, streaming_archive::writer::Archive& archive_writer)
+    {
         // Setup config
-        streaming_archive::writer::Archive::UserConfig archive_user_config;
-        archive_user_config.id = uuid_generator();
-        archive_user_config.creator_id = uuid_generator();
-        archive_user_config.creation_num = 0;
         archive_user_config.storage_id = command_line_args.get_archive_storage_id();
         archive_user_config.target_segment_uncompressed_size = command_line_args.get_target_segment_uncompressed_size();
         archive_user_config.compression_level = command_line_args.get_compression_level();
         archive_user_config.output_dir = command_line_args.get_output_dir();
         archive_user_config.global_metadata_db = &global_metadata_db;
+        archive_user_config.durability_policy = command_line_args.get_durability_policy();
+        archive_user_config.group_commit_interval = std::chrono::milliseconds(command_line_args.get_group_commit_interval());
+        archive_user_config.group_commit_size = command_line_args.get_group_commit_size();
+        archive_user_config.group_messages_by_logtype = command_line_args.group_messages_by_logtype();
+        archive_user_config.index_variables = command_line_args.index_variables();
+
+        if (nullptr == archive_to_append_to) {
+            archive_user_config.id = uuid_generator();
+            archive_user_config.creator_id = uuid_generator();
+            archive_user_config.creation_num = 0;
+            archive_writer.open(archive_user_config);
+            if (command_line_args.print_archive_ids()) {
+                print_archive_id_of(archive_writer);
+            }
+        } else {
+            archive_user_config.id = archive_to_append_to->id;
+            archive_user_config.creator_id = archive_to_append_to->creator_id;
+            archive_user_config.creation_num = archive_to_append_to->last_creation_num;
+            archive_writer.open_existing(archive_user_config);
+        }
+    }
 
-        // Open archive
-        streaming_archive::writer::Archive archive_writer;
-        archive_writer.open(archive_user_config);
-        if (command_line_args.print_archive_ids()) {
-            cout << archive_writer.get_id_as_string() << endl;
+    static bool compress_files_from_queue (const CommandLineArguments& command_line_args, const ArchiveToAppendTo* archive_to_append_to,
+                                           const vector<string>& empty_directory_paths, size_t target_encoded_file_size, bool always_create_archive,
+                                           GlobalMetadataDB& global_metadata_db, FilesToCompressQueue& files_queue, CompressionProgress& progress)
+    {
+        vector<const FileToCompress*> files;
+        bool has_files = files_queue.get_next_files(files);
+        if (false == has_files && false == always_create_archive) {
+            // Avoid creating an empty archive
+            return true;
         }
 
+        // NOTE: boost::uuids::random_generator isn't thread-safe, so each thread uses its own
+        boost::uuids::random_generator uuid_generator;
+
+        streaming_archive::writer::Archive::UserConfig archive_user_config;
+        streaming_archive::writer::Archive archive_writer;
+        open_archive(command_line_args, archive_to_append_to, uuid_generator, global_metadata_db, archive_user_config, archive_writer);
+
         archive_writer.add_empty_directories(empty_directory_paths);
 
         bool all_files_compressed_successfully = true;
-        FileCompressor file_compressor(uuid_generator);
+        FileCompressor file_compressor(uuid_generator, command_line_args.validate_all_content(), command_line_args.memory_map_input_files());
         auto target_data_size_of_dictionaries = command_line_args.get_target_data_size_of_dictionaries();
 
-        // Compress all files
-        size_t num_files_compressed = 0;
-        size_t num_files_to_compress = 0;
-        if (command_line_args.show_progress()) {
-            num_files_to_compress = files_to_compress.size() + grouped_files_to_compress.size();
-        }
-        sort(files_to_compress.begin(), files_to_compress.end(), file_lt_last_write_time_comparator);
-        for (auto rit = files_to_compress.crbegin(); rit != files_to_compress.crend(); ++rit) {
-            if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dictionaries) {
-                split_archive(archive_user_config, command_line_args.print_archive_ids(), archive_writer);
-            }
+        for (; has_files; has_files = files_queue.get_next_files(files)) {
+            for (const auto* file_to_compress : files) {
+                if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dictionaries) {
+                    split_archive(archive_user_config, command_line_args.print_archive_ids(), archive_writer);
+                }
 
-            if (false == file_compressor.compress_file(target_data_size_of_dictionaries, archive_user_config, command_line_args.print_archive_ids(),
-                                                       target_encoded_file_size, *rit, archive_writer))
-            {
-                all_files_compressed_successfully = false;
-            }
-            if (command_line_args.show_progress()) {
-                ++num_files_compressed;
-                cerr << "Compressed " << num_files_compressed << '/' << num_files_to_compress << " files" << '\r';
+                if (false == file_compressor.compress_file(target_data_size_of_dictionaries, archive_user_config, command_line_args.print_archive_ids(),
+                                                           target_encoded_file_size, *file_to_compress, archive_writer))
+                {
+                    all_files_compressed_successfully = false;
+                }
+                progress.increment();
             }
         }
 
+        archive_writer.close();
+
+        return all_files_compressed_successfully;
+    }
+
+    bool compress (CommandLineArguments& command_line_args, vector<FileToCompress>& files_to_compress, const vector<string>& empty_directory_paths,
+                   vector<FileToCompress>& grouped_files_to_compress, size_t target_encoded_file_size)
+    {
+        GlobalMetadataDB global_metadata_db;
+        if (false == open_global_metadata_db(command_line_args, global_metadata_db)) {
+            return false;
+        }
+
+        ArchiveToAppendTo archive_to_append_to;
+        if (false == find_archive_to_append_to(command_line_args, global_metadata_db, archive_to_append_to)) {
+            global_metadata_db.close();
+            return false;
+        }
+        bool is_appending = (false == command_line_args.get_archive_id_to_append_to().empty());
+
+        // NOTE: Files are compressed starting from the end of the list. A single thread compresses the most recently modified files first. Multiple
+        // threads compress the largest files first, so that a large file isn't left to be compressed by one thread after the others have finished.
+        auto num_threads = command_line_args.get_num_threads();
+        if (num_threads > 1) {
+            stable_sort(files_to_compress.begin(), files_to_compress.end(), file_lt_size_comparator);
+        } else {
+            stable_sort(files_to_compress.begin(), files_to_compress.end(), file_lt_last_write_time_comparator);
+        }
         // Sort files by group ID to avoid spreading groups over multiple segments
         sort(grouped_files_to_compress.begin(), grouped_files_to_compress.end(), file_group_id_comparator);
-        // Compress grouped files
-        for (const auto& file_to_compress : grouped_files_to_compress) {
-            if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dictionaries) {
-                split_archive(archive_user_config, command_line_args.print_archive_ids(), archive_writer);
-            }
+        FilesToCompressQueue files_queue(files_to_compress, grouped_files_to_compress);
+
+        CompressionProgress progress(command_line_args.show_progress(), files_to_compress.size() + grouped_files_to_compress.size());
+
+        // Compress all files, each thread into its own archive(s)
+        struct ThreadResult {
+            bool all_files_compressed_successfully = true;
+            std::exception_ptr exception;
+        };
+        vector<ThreadResult> thread_results(num_threads);
+        vector<std::thread> threads;
+        threads.reserve(num_threads);
+        const vector<string> no_empty_directory_paths;
+        for (size_t thread_ix = 0; thread_ix < num_threads; ++thread_ix) {
+            threads.emplace_back([&, thread_ix] () {
+                // The first thread always creates (or appends to) an archive, so that empty directories are stored even if there are no files
+                bool is_first_thread = (0 == thread_ix);
+                auto& result = thread_results[thread_ix];
+                try {
+                    result.all_files_compressed_successfully = compress_files_from_queue(command_line_args,
+                            (is_first_thread && is_appending) ? &archive_to_append_to : nullptr, is_first_thread ? empty_directory_paths : no_empty_directory_paths,
+                            target_encoded_file_size, is_first_thread, global_metadata_db, files_queue, progress);
+                } catch (...) {
+                    result.exception = std::current_exception();
+                    // Stop the other threads early since compression has failed
+                    files_queue.abort();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
 
-            if (false == file_compressor.compress_file(target_data_size_of_dictionaries, archive_user_config, command_line_args.print_archive_ids(),
-                                                       target_encoded_file_size, file_to_compress, archive_writer))
-            {
-                all_files_compressed_successfully = false;
+        bool all_files_compressed_successfully = true;
+        for (const auto& result : thread_results) {
+            if (result.exception) {
+                std::rethrow_exception(result.exception);
             }
-            if (command_line_args.show_progress()) {
-                ++num_files_compressed;
-                cerr << "Compressed " << num_files_compressed << '/' << num_files_to_compress << " files" << '\r';
+            if (false == result.all_files_compressed_successfully) {
+                all_files_compressed_successfully = false;
             }
         }
 
-        archive_writer.close();
-
         global_metadata_db.close();
 
         return all_files_compressed_successfully;
     }
 
+    bool compress_stdin (CommandLineArguments& command_line_args) {
+        GlobalMetadataDB global_metadata_db;
+        if (false == open_global_metadata_db(command_line_args, global_metadata_db)) {
+            return false;
+        }
+
+        ArchiveToAppendTo archive_to_append_to;
+        if (false == find_archive_to_append_to(command_line_args, global_metadata_db, archive_to_append_to)) {
+            global_metadata_db.close();
+            return false;
+        }
+        bool is_appending = (false == command_line_args.get_archive_id_to_append_to().empty());
+
+        boost::uuids::random_generator uuid_generator;
+        streaming_archive::writer::Archive::UserConfig archive_user_config;
+        streaming_archive::writer::Archive archive_writer;
+        open_archive(command_line_args, is_appending ? &archive_to_append_to : nullptr, uuid_generator, global_metadata_db, archive_user_config,
+                     archive_writer);
+
+        // Wake up periodically while stdin is idle so that commits happen on schedule
+        constexpr int cStdinPollIntervalMs = 250;
+        FileDescriptorReader stdin_reader;
+        stdin_reader.open(STDIN_FILENO, cStdinPollIntervalMs);
+
+        FileCompressor file_compressor(uuid_generator, command_line_args.validate_all_content(), command_line_args.memory_map_input_files());
+        bool succeeded = file_compressor.compress_stream(command_line_args.get_target_data_size_of_dictionaries(), archive_user_config,
+                                                         command_line_args.print_archive_ids(), command_line_args.get_target_encoded_file_size(),
+                                                         command_line_args.get_stdin_path(), std::chrono::seconds(command_line_args.get_commit_interval()),
+                                                         command_line_args.get_commit_size(),
+                                                         std::chrono::seconds(command_line_args.get_archive_rollover_interval()), stdin_reader, archive_writer);
+
+        stdin_reader.close();
+        archive_writer.close();
+        global_metadata_db.close();
+
+        return succeeded;
+    }
 
     bool read_and_validate_grouped_file_list (const boost::filesystem::path& path_prefix_to_remove, const string& list_path,
                                               vector<FileToCompress>& grouped_files)
@@ -27,6 +27,14 @@ namespace clp {
                    const std::vector<std::string>& empty_directory_paths, std::vector<FileToCompress>& grouped_files_to_compress,
                    size_t target_encoded_file_size);
 
+    /**
+     * Compresses content streamed on stdin into an archive until stdin is closed. The content is committed periodically so that it can be searched
+     * while it's being compressed.
+     * @param command_line_args
+     * @return true if compression was successful, false otherwise
+     */
+    bool compress_stdin (CommandLineArguments& command_line_args);
+
     /**
      * Reads a list of grouped files and a list of their IDs
      * @param path_prefix_to_remove
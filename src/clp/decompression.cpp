@@ -43,7 +43,7 @@ namespace clp {
             auto archives_dir = boost::filesystem::path(command_line_args.get_archives_dir());
             auto global_metadata_db_path = archives_dir / streaming_archive::cMetadataDBFileName;
             GlobalMetadataDB global_metadata_db;
-            global_metadata_db.open(global_metadata_db_path.string());
+            global_metadata_db.open(global_metadata_db_path.string(), false);
 
             streaming_archive::reader::Archive archive_reader;
 
@@ -64,16 +64,16 @@ namespace clp {
                     archive_reader.decompress_empty_directories(command_line_args.get_output_dir());
 
                     // Decompress files
-                    for (auto file_metadata_ix = archive_reader.get_file_iterator(); file_metadata_ix.has_next(); file_metadata_ix.next()) {
-                        file_metadata_ix.get_path(orig_path);
+                    for (auto file_metadata_ix = archive_reader.get_file_iterator(); file_metadata_ix->has_next(); file_metadata_ix->next()) {
+                        file_metadata_ix->get_path(orig_path);
 
                         // Decompress file
-                        if (false == file_decompressor.decompress_file(file_metadata_ix, command_line_args.get_output_dir(), archive_reader,
+                        if (false == file_decompressor.decompress_file(*file_metadata_ix, command_line_args.get_output_dir(), archive_reader,
                                                                        temp_path_to_final_path))
                         {
                             return false;
                         }
-                        file_metadata_ix.get_path(orig_path);
+                        file_metadata_ix->get_path(orig_path);
                         decompressed_files.insert(orig_path);
                     }
 
@@ -88,11 +88,11 @@ namespace clp {
                     archive_reader.refresh_dictionaries();
 
                     // Decompress all splits with the given path
-                    for (auto file_metadata_ix = archive_reader.get_file_iterator(file_path); file_metadata_ix.has_next(); file_metadata_ix.next()) {
-                        file_metadata_ix.get_path(orig_path);
+                    for (auto file_metadata_ix = archive_reader.get_file_iterator(file_path); file_metadata_ix->has_next(); file_metadata_ix->next()) {
+                        file_metadata_ix->get_path(orig_path);
 
                         // Decompress file
-                        if (false == file_decompressor.decompress_file(file_metadata_ix, command_line_args.get_output_dir(), archive_reader,
+                        if (false == file_decompressor.decompress_file(*file_metadata_ix, command_line_args.get_output_dir(), archive_reader,
                                                                        temp_path_to_final_path))
                         {
                             return false;
@@ -110,20 +110,20 @@ namespace clp {
                     archive_reader.refresh_dictionaries();
 
                     // Decompress files
-                    for (auto file_metadata_ix = archive_reader.get_file_iterator(); file_metadata_ix.has_next(); file_metadata_ix.next()) {
-                        file_metadata_ix.get_path(orig_path);
+                    for (auto file_metadata_ix = archive_reader.get_file_iterator(); file_metadata_ix->has_next(); file_metadata_ix->next()) {
+                        file_metadata_ix->get_path(orig_path);
                         if (files_to_decompress.count(orig_path) == 0) {
                             // Skip files that aren't in the list of files to decompress
                             continue;
                         }
 
                         // Decompress file
-                        if (false == file_decompressor.decompress_file(file_metadata_ix, command_line_args.get_output_dir(), archive_reader,
+                        if (false == file_decompressor.decompress_file(*file_metadata_ix, command_line_args.get_output_dir(), archive_reader,
                                                                        temp_path_to_final_path))
                         {
                             return false;
                         }
-                        file_metadata_ix.get_path(orig_path);
+                        file_metadata_ix->get_path(orig_path);
                         decompressed_files.insert(orig_path);
                     }
 
@@ -1,7 +1,17 @@
 #include "utils.hpp"
 
+// C standard libraries
+#include <sys/stat.h>
+
 // C++ standard libraries
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <thread>
 
 // Boost libraries
 #include <boost/filesystem/operations.hpp>
@@ -12,50 +22,191 @@
 
 // Project headers
 #include "../ErrorCode.hpp"
+#include "../Utf8Validator.hpp"
 #include "../Utils.hpp"
 
 using std::string;
 using std::vector;
 
 namespace clp {
-    bool find_all_files_and_empty_directories (boost::filesystem::path& path_prefix_to_remove, const string& path, vector<FileToCompress>& file_paths,
-                                               vector<string>& empty_directory_paths)
-    {
+    // Local types
+    /**
+     * Class to find files and empty directories by searching directories in parallel. Each file is stat-ed once, while it's found, and its size and last
+     * write time are recorded so they don't need to be queried again.
+     */
+    class ParallelFileFinder {
+    public:
+        // Constructors
+        explicit ParallelFileFinder (const boost::filesystem::path& path_prefix_to_remove) : m_path_prefix_to_remove(path_prefix_to_remove),
+                m_num_directories_being_searched(0), m_failed(false) {}
+
+        // Methods
+        /**
+         * Adds the given path to those being searched
+         * @param path
+         * @return true on success, false otherwise
+         */
+        bool add_path (const string& path);
+
+        /**
+         * Searches all directories added, including any subdirectories found within them
+         * @param num_threads
+         * @param files Returns the files found
+         * @param empty_directory_paths Returns the empty directories found
+         * @return true on success, false otherwise
+         */
+        bool find (size_t num_threads, vector<FileToCompress>& files, vector<string>& empty_directory_paths);
+
+    private:
+        // Methods
+        /**
+         * Searches directories from the queue until there are none left to search and no thread is still searching (and so could add more)
+         */
+        void search_directories ();
+        /**
+         * Searches the given directory, without recursing into its subdirectories
+         * @param path
+         * @param subdirectory_paths Returns the directory's subdirectories
+         * @param files Returns the directory's files
+         * @param empty_directory_paths Returns the directory itself if it's empty
+         * @return true on success, false otherwise
+         */
+        bool search_directory (const boost::filesystem::path& path, vector<string>& subdirectory_paths, vector<FileToCompress>& files,
+                               vector<string>& empty_directory_paths) const;
+
+        // Variables
+        const boost::filesystem::path& m_path_prefix_to_remove;
+
+        std::mutex m_mutex;
+        std::condition_variable m_directory_added_or_searched;
+        std::deque<string> m_directories_to_search;
+        size_t m_num_directories_being_searched;
+        bool m_failed;
+        vector<FileToCompress> m_files;
+        vector<string> m_empty_directory_paths;
+    };
+
+    bool ParallelFileFinder::add_path (const string& path) {
         string path_without_prefix;
-        if (false == remove_prefix_and_clean_up_path(path_prefix_to_remove, path, path_without_prefix)) {
-            SPDLOG_ERROR("'{}' does not contain prefix '{}'.", path.c_str(), path_prefix_to_remove.c_str());
+        if (false == remove_prefix_and_clean_up_path(m_path_prefix_to_remove, path, path_without_prefix)) {
+            SPDLOG_ERROR("'{}' does not contain prefix '{}'.", path.c_str(), m_path_prefix_to_remove.c_str());
             return false;
         }
 
-        try {
-            if (false == boost::filesystem::is_directory(path)) {
-                // path is a file
-                file_paths.emplace_back(path, path_without_prefix, 0);
-                return true;
-            }
+        struct stat path_stat = {};
+        if (0 != stat(path.c_str(), &path_stat)) {
+            SPDLOG_ERROR("Failed to stat '{}', errno={}", path.c_str(), errno);
+            return false;
+        }
+        if (S_ISDIR(path_stat.st_mode)) {
+            m_directories_to_search.push_back(path);
+        } else {
+            m_files.emplace_back(path, path_without_prefix, 0, path_stat.st_size, path_stat.st_mtime);
+        }
+        return true;
+    }
 
-            if (boost::filesystem::is_empty(path)) {
-                // path is an empty directory
-                empty_directory_paths.push_back(path_without_prefix);
-                return true;
+    bool ParallelFileFinder::find (size_t num_threads, vector<FileToCompress>& files, vector<string>& empty_directory_paths) {
+        vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i) {
+            threads.emplace_back(&ParallelFileFinder::search_directories, this);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (m_failed) {
+            return false;
+        }
+
+        // Sort the results since the order they were found in depends on how the threads were scheduled
+        std::sort(m_files.begin(), m_files.end(), [] (const FileToCompress& lhs, const FileToCompress& rhs) {
+            return lhs.get_path() < rhs.get_path();
+        });
+        std::sort(m_empty_directory_paths.begin(), m_empty_directory_paths.end());
+
+        files.insert(files.end(), std::make_move_iterator(m_files.begin()), std::make_move_iterator(m_files.end()));
+        empty_directory_paths.insert(empty_directory_paths.end(), std::make_move_iterator(m_empty_directory_paths.begin()),
+                                     std::make_move_iterator(m_empty_directory_paths.end()));
+        m_files.clear();
+        m_empty_directory_paths.clear();
+        return true;
+    }
+
+    void ParallelFileFinder::search_directories () {
+        vector<string> subdirectory_paths;
+        vector<FileToCompress> files;
+        vector<string> empty_directory_paths;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_directory_added_or_searched.wait(lock, [this] () {
+                return m_failed || false == m_directories_to_search.empty() || 0 == m_num_directories_being_searched;
+            });
+            if (m_failed || m_directories_to_search.empty()) {
+                // Either the search failed, or there's nothing left to search and no thread that could add more
+                break;
+            }
+            auto path = std::move(m_directories_to_search.front());
+            m_directories_to_search.pop_front();
+            ++m_num_directories_being_searched;
+            lock.unlock();
+
+            subdirectory_paths.clear();
+            files.clear();
+            empty_directory_paths.clear();
+            bool succeeded = search_directory(path, subdirectory_paths, files, empty_directory_paths);
+
+            lock.lock();
+            --m_num_directories_being_searched;
+            if (false == succeeded) {
+                m_failed = true;
+            }
+            for (auto& subdirectory_path : subdirectory_paths) {
+                m_directories_to_search.push_back(std::move(subdirectory_path));
             }
+            m_files.insert(m_files.end(), std::make_move_iterator(files.begin()), std::make_move_iterator(files.end()));
+            m_empty_directory_paths.insert(m_empty_directory_paths.end(), std::make_move_iterator(empty_directory_paths.begin()),
+                                           std::make_move_iterator(empty_directory_paths.end()));
+            m_directory_added_or_searched.notify_all();
+        }
+    }
 
-            // Iterate directory
-            boost::filesystem::recursive_directory_iterator iter(path, boost::filesystem::symlink_option::recurse);
-            boost::filesystem::recursive_directory_iterator end;
-            for (; iter != end; ++iter) {
-                // Check if current entry is an empty directory or a file
-                if (boost::filesystem::is_directory(iter->path())) {
-                    if (boost::filesystem::is_empty(iter->path())) {
-                        remove_prefix_and_clean_up_path(path_prefix_to_remove, iter->path(), path_without_prefix);
-                        empty_directory_paths.push_back(path_without_prefix);
-                        iter.no_push();
+    bool ParallelFileFinder::search_directory (const boost::filesystem::path& path, vector<string>& subdirectory_paths, vector<FileToCompress>& files,
+                                               vector<string>& empty_directory_paths) const
+    {
+        string path_without_prefix;
+        try {
+            bool is_empty = true;
+            boost::filesystem::directory_iterator end;
+            for (boost::filesystem::directory_iterator iter(path); iter != end; ++iter) {
+                is_empty = false;
+
+                // NOTE: Like boost::filesystem::is_directory, stat follows symlinks, so symlinked directories are searched too
+                const auto& entry_path = iter->path();
+                struct stat entry_stat = {};
+                if (0 != stat(entry_path.c_str(), &entry_stat)) {
+                    if (ENOENT != errno) {
+                        SPDLOG_ERROR("Failed to stat '{}', errno={}", entry_path.c_str(), errno);
+                        return false;
                     }
+                    // Entry is a dangling symlink or was deleted since the directory was listed, so we leave it to compression to report that it's
+                    // missing
+                    entry_stat = {};
+                }
+
+                if (S_ISDIR(entry_stat.st_mode)) {
+                    subdirectory_paths.push_back(entry_path.string());
                 } else {
-                    remove_prefix_and_clean_up_path(path_prefix_to_remove, iter->path(), path_without_prefix);
-                    file_paths.emplace_back(iter->path().string(), path_without_prefix, 0);
+                    remove_prefix_and_clean_up_path(m_path_prefix_to_remove, entry_path, path_without_prefix);
+                    files.emplace_back(entry_path.string(), path_without_prefix, 0, entry_stat.st_size, entry_stat.st_mtime);
                 }
             }
+
+            if (is_empty) {
+                remove_prefix_and_clean_up_path(m_path_prefix_to_remove, path, path_without_prefix);
+                empty_directory_paths.push_back(path_without_prefix);
+            }
         } catch (boost::filesystem::filesystem_error& exception) {
             SPDLOG_ERROR("Failed to find files/directories at '{}' - {}.", path.c_str(), exception.what());
             return false;
@@ -64,38 +215,21 @@ namespace clp {
         return true;
     }
 
-    bool is_utf8_sequence (size_t sequence_length, const char* sequence) {
-        size_t num_utf8_bytes_to_read = 0;
-        for (size_t i = 0; i < sequence_length; ++i) {
-            auto byte = sequence[i];
-
-            if (num_utf8_bytes_to_read > 0) {
-                // Validate that byte matches 0b10xx_xxxx
-                if ((byte & 0xC0) != 0x80) {
-                    return false;
-                }
-                --num_utf8_bytes_to_read;
-            } else {
-                if (byte & 0x80) {
-                    // Check if byte is valid UTF-8 length-indicator
-                    if ((byte & 0xF8) == 0xF0) {
-                        // Matches 0b1111_0xxx
-                        num_utf8_bytes_to_read = 3;
-                    } else if ((byte & 0xF0) == 0xE0) {
-                        // Matches 0b1110_xxxx
-                        num_utf8_bytes_to_read = 2;
-                    } else if ((byte & 0xE0) == 0xC0) {
-                        // Matches 0b110x_xxxx
-                        num_utf8_bytes_to_read = 1;
-                    } else {
-                        // Invalid UTF-8 length-indicator
-                        return false;
-                    }
-                } // else byte is ASCII
+    bool find_all_files_and_empty_directories (const boost::filesystem::path& path_prefix_to_remove, const vector<string>& paths, size_t num_threads,
+                                               vector<FileToCompress>& files, vector<string>& empty_directory_paths)
+    {
+        ParallelFileFinder file_finder(path_prefix_to_remove);
+        for (const auto& path : paths) {
+            if (false == file_finder.add_path(path)) {
+                return false;
             }
         }
+        return file_finder.find(num_threads, files, empty_directory_paths);
+    }
 
-        return true;
+    bool is_utf8_sequence (size_t sequence_length, const char* sequence) {
+        Utf8Validator utf8_validator;
+        return utf8_validator.validate(sequence, sequence_length);
     }
 
     bool read_input_paths (const string& list_path, vector<string>& paths) {
@@ -202,11 +336,17 @@ namespace clp {
         archive_writer.open(archive_user_config);
 
         if (print_archive_id) {
-            // Output archive_writer ID
-            std::cout << archive_writer.get_id_as_string() << std::endl;
+            print_archive_id_of(archive_writer);
         }
     }
 
+    void print_archive_id_of (const streaming_archive::writer::Archive& archive_writer) {
+        // Archives may be split concurrently by multiple compression threads, so we serialize the output to avoid interleaving IDs
+        static std::mutex stdout_mutex;
+        std::lock_guard<std::mutex> lock(stdout_mutex);
+        std::cout << archive_writer.get_id_as_string() << std::endl;
+    }
+
     void split_file (const string& path_for_compression, group_id_t group_id, const TimestampPattern* last_timestamp_pattern,
                      streaming_archive::writer::Archive& archive_writer, streaming_archive::writer::File*& file)
     {
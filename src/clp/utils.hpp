@@ -14,15 +14,18 @@
 
 namespace clp {
     /**
-     * Recursively finds all files and empty directories at the given path
+     * Recursively finds all files and empty directories at the given paths. Directories are searched in parallel since listing and stat-ing them is
+     * dominated by I/O latency (e.g., on network file systems). Each file is stat-ed once and its size and last write time are stored in its
+     * FileToCompress.
      * @param path_prefix_to_remove
-     * @param path
-     * @param file_paths
+     * @param paths
+     * @param num_threads Number of threads to search directories with
+     * @param files
      * @param empty_directory_paths
      * @return true on success, false otherwise
      */
-    bool find_all_files_and_empty_directories (boost::filesystem::path& path_prefix_to_remove, const std::string& path, std::vector<FileToCompress>& file_paths,
-                                               std::vector<std::string>& empty_directory_paths);
+    bool find_all_files_and_empty_directories (const boost::filesystem::path& path_prefix_to_remove, const std::vector<std::string>& paths,
+                                               size_t num_threads, std::vector<FileToCompress>& files, std::vector<std::string>& empty_directory_paths);
 
     /**
      * Checks if the given sequence is valid UTF-8
@@ -87,6 +90,12 @@ namespace clp {
     void split_archive (streaming_archive::writer::Archive::UserConfig& archive_user_config, bool print_archive_id,
                         streaming_archive::writer::Archive& archive_writer);
 
+    /**
+     * Prints the ID of the given archive to stdout. This is safe to call from multiple threads.
+     * @param archive_writer
+     */
+    void print_archive_id_of (const streaming_archive::writer::Archive& archive_writer);
+
     /**
      * Closes the current encoded file and starts a new one
      * @param path_for_compression
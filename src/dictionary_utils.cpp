@@ -17,21 +17,30 @@ void open_dictionary_for_reading (const std::string& dictionary_path, const std:
     segment_index_decompressor.open(segment_index_file_reader, decompressor_file_read_buffer_capacity);
 }
 
+/**
+ * Reads the header at the beginning of a dictionary or segment index file
+ * @param file_reader
+ * @return The header's value
+ * @throw FileReader::OperationFailed on failure
+ */
+static uint64_t read_header (FileReader& file_reader) {
+    // NOTE: We bypass the reader's buffer since a writer may have updated the header after the reader buffered it
+    uint64_t value;
+    size_t num_bytes_read;
+    auto error_code = file_reader.try_read_at(0, reinterpret_cast<char*>(&value), sizeof(value), num_bytes_read);
+    if (ErrorCode_Success != error_code) {
+        throw FileReader::OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+    if (num_bytes_read < sizeof(value)) {
+        throw FileReader::OperationFailed(ErrorCode_Truncated, __FILENAME__, __LINE__);
+    }
+    return value;
+}
+
 uint64_t read_dictionary_header (FileReader& file_reader) {
-    auto dictionary_file_reader_pos = file_reader.get_pos();
-    file_reader.seek_from_begin(0);
-    uint64_t num_dictionary_entries;
-    file_reader.read_numeric_value(num_dictionary_entries, false);
-    file_reader.seek_from_begin(dictionary_file_reader_pos);
-    return num_dictionary_entries;
+    return read_header(file_reader);
 }
 
 uint64_t read_segment_index_header (FileReader& file_reader) {
-    // Read segment index header
-    auto segment_index_file_reader_pos = file_reader.get_pos();
-    file_reader.seek_from_begin(0);
-    uint64_t num_segments;
-    file_reader.read_numeric_value(num_segments, false);
-    file_reader.seek_from_begin(segment_index_file_reader_pos);
-    return num_segments;
+    return read_header(file_reader);
 }
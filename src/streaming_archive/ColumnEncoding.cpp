@@ -0,0 +1,214 @@
+#include "ColumnEncoding.hpp"
+
+// C++ standard libraries
+#include <cstring>
+
+namespace streaming_archive { namespace column_encoding {
+    size_t encode_delta_varints (const int64_t* values, size_t num_values, char* encoded_buf) {
+        auto encoded_buf_begin = encoded_buf;
+        uint64_t previous_value = 0;
+        for (size_t i = 0; i < num_values; ++i) {
+            // NOTE: The difference is computed with unsigned arithmetic so that it wraps rather than overflowing
+            auto value = (uint64_t)values[i];
+            auto delta = (int64_t)(value - previous_value);
+            previous_value = value;
+
+            auto zigzag_delta = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+            while (zigzag_delta >= 0x80) {
+                *encoded_buf++ = (char)(zigzag_delta | 0x80);
+                zigzag_delta >>= 7;
+            }
+            *encoded_buf++ = (char)zigzag_delta;
+        }
+        return encoded_buf - encoded_buf_begin;
+    }
+
+    ErrorCode try_decode_delta_varints (const char* encoded_buf, size_t encoded_buf_length, size_t num_values, int64_t* values) {
+        auto encoded_buf_end = encoded_buf + encoded_buf_length;
+        uint64_t previous_value = 0;
+        for (size_t i = 0; i < num_values; ++i) {
+            uint64_t zigzag_delta = 0;
+            for (size_t shift = 0; ; shift += 7) {
+                if (encoded_buf_end == encoded_buf) {
+                    return ErrorCode_Truncated;
+                }
+                if (shift >= 64) {
+                    return ErrorCode_Corrupt;
+                }
+                auto byte = (uint8_t)*encoded_buf++;
+                zigzag_delta |= (uint64_t)(byte & 0x7F) << shift;
+                if (byte < 0x80) {
+                    break;
+                }
+            }
+
+            auto delta = (zigzag_delta >> 1) ^ (0 - (zigzag_delta & 1));
+            previous_value += delta;
+            values[i] = (int64_t)previous_value;
+        }
+        return ErrorCode_Success;
+    }
+
+    size_t bit_pack (const int64_t* values, size_t num_values, char* encoded_buf) {
+        // Determine the width from the bits set in any value
+        uint64_t all_bits = 0;
+        for (size_t i = 0; i < num_values; ++i) {
+            all_bits |= (uint64_t)values[i];
+        }
+        uint8_t width = 0;
+        for (; width < 64 && (all_bits >> width) > 0; ++width) {}
+        if (width > cMaxBitPackedWidth) {
+            width = 64;
+        }
+
+        auto encoded_buf_begin = encoded_buf;
+        *encoded_buf++ = (char)width;
+        if (64 == width) {
+            memcpy(encoded_buf, values, num_values * sizeof(uint64_t));
+            return sizeof(width) + num_values * sizeof(uint64_t);
+        }
+
+        // NOTE: Fewer than 8 bits are ever pending before a value is added, and width <= cMaxBitPackedWidth, so the pending bits fit in 64 bits
+        uint64_t pending_bits = 0;
+        size_t num_pending_bits = 0;
+        for (size_t i = 0; i < num_values; ++i) {
+            pending_bits |= (uint64_t)values[i] << num_pending_bits;
+            num_pending_bits += width;
+            while (num_pending_bits >= 8) {
+                *encoded_buf++ = (char)pending_bits;
+                pending_bits >>= 8;
+                num_pending_bits -= 8;
+            }
+        }
+        if (num_pending_bits > 0) {
+            *encoded_buf++ = (char)pending_bits;
+        }
+        return encoded_buf - encoded_buf_begin;
+    }
+
+    ErrorCode try_bit_unpack (const char* encoded_buf, size_t encoded_buf_length, size_t num_values, int64_t* values) {
+        if (encoded_buf_length < sizeof(uint8_t)) {
+            return ErrorCode_Truncated;
+        }
+        auto width = (uint8_t)encoded_buf[0];
+        auto packed_bits = encoded_buf + sizeof(width);
+        size_t packed_bits_length = encoded_buf_length - sizeof(width);
+
+        if (64 == width) {
+            if (packed_bits_length < num_values * sizeof(uint64_t)) {
+                return ErrorCode_Truncated;
+            }
+            memcpy(values, packed_bits, num_values * sizeof(uint64_t));
+            return ErrorCode_Success;
+        }
+        if (width > cMaxBitPackedWidth) {
+            return ErrorCode_Corrupt;
+        }
+        if (packed_bits_length < (num_values * width + 7) / 8) {
+            return ErrorCode_Truncated;
+        }
+
+        uint64_t mask = (1ULL << width) - 1;
+        for (size_t i = 0, bit_pos = 0; i < num_values; ++i, bit_pos += width) {
+            // Load the 64-bit word containing the value, except near the end where fewer than 8 bytes remain
+            auto byte_pos = bit_pos / 8;
+            uint64_t word = 0;
+            if (byte_pos + sizeof(word) <= packed_bits_length) {
+                memcpy(&word, packed_bits + byte_pos, sizeof(word));
+            } else {
+                memcpy(&word, packed_bits + byte_pos, packed_bits_length - byte_pos);
+            }
+            values[i] = (int64_t)((word >> (bit_pos % 8)) & mask);
+        }
+        return ErrorCode_Success;
+    }
+
+    size_t encode_variables (const encoded_variable_t* variables, const VariableType* variable_types, size_t num_variables, int64_t* scratch_buf,
+                             char* encoded_buf)
+    {
+        // Write the types and count the variables of each type
+        size_t num_variables_of_type[cNumVariableTypes] = {};
+        size_t types_length = get_variable_types_length(num_variables);
+        memset(encoded_buf, 0, types_length);
+        for (size_t i = 0; i < num_variables; ++i) {
+            auto variable_type = (uint8_t)variable_types[i];
+            encoded_buf[i / 4] |= (char)(variable_type << (i % 4 * 2));
+            ++num_variables_of_type[variable_type];
+        }
+
+        // Write the dictionary IDs and doubles into their streams, and gather the integers so they can be encoded together
+        auto dictionary_ids = encoded_buf + types_length;
+        auto doubles = dictionary_ids + num_variables_of_type[(uint8_t)VariableType::DictionaryId] * sizeof(encoded_variable_t);
+        auto integers = doubles + num_variables_of_type[(uint8_t)VariableType::Double] * sizeof(encoded_variable_t);
+        size_t num_integers = 0;
+        for (size_t i = 0; i < num_variables; ++i) {
+            switch (variable_types[i]) {
+                case VariableType::DictionaryId:
+                    memcpy(dictionary_ids, &variables[i], sizeof(encoded_variable_t));
+                    dictionary_ids += sizeof(encoded_variable_t);
+                    break;
+                case VariableType::Integer:
+                    scratch_buf[num_integers++] = variables[i];
+                    break;
+                case VariableType::Double:
+                    memcpy(doubles, &variables[i], sizeof(encoded_variable_t));
+                    doubles += sizeof(encoded_variable_t);
+                    break;
+            }
+        }
+        auto integers_length = encode_delta_varints(scratch_buf, num_integers, integers);
+
+        return integers + integers_length - encoded_buf;
+    }
+
+    ErrorCode try_decode_variables (const char* encoded_buf, size_t encoded_buf_length, size_t num_variables, int64_t* scratch_buf,
+                                    encoded_variable_t* variables)
+    {
+        // Count the variables of each type
+        size_t types_length = get_variable_types_length(num_variables);
+        if (encoded_buf_length < types_length) {
+            return ErrorCode_Truncated;
+        }
+        size_t num_variables_of_type[cNumVariableTypes] = {};
+        for (size_t i = 0; i < num_variables; ++i) {
+            size_t variable_type = ((uint8_t)encoded_buf[i / 4] >> (i % 4 * 2)) & 0x3;
+            if (variable_type >= cNumVariableTypes) {
+                return ErrorCode_Corrupt;
+            }
+            ++num_variables_of_type[variable_type];
+        }
+
+        // Decode the integers
+        auto dictionary_ids = encoded_buf + types_length;
+        auto doubles = dictionary_ids + num_variables_of_type[(uint8_t)VariableType::DictionaryId] * sizeof(encoded_variable_t);
+        auto integers = doubles + num_variables_of_type[(uint8_t)VariableType::Double] * sizeof(encoded_variable_t);
+        auto encoded_buf_end = encoded_buf + encoded_buf_length;
+        if (integers > encoded_buf_end) {
+            return ErrorCode_Truncated;
+        }
+        auto error_code = try_decode_delta_varints(integers, encoded_buf_end - integers, num_variables_of_type[(uint8_t)VariableType::Integer],
+                                                   scratch_buf);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+
+        // Interleave the streams back into the original order
+        auto integer = scratch_buf;
+        for (size_t i = 0; i < num_variables; ++i) {
+            switch ((VariableType)(((uint8_t)encoded_buf[i / 4] >> (i % 4 * 2)) & 0x3)) {
+                case VariableType::DictionaryId:
+                    memcpy(&variables[i], dictionary_ids, sizeof(encoded_variable_t));
+                    dictionary_ids += sizeof(encoded_variable_t);
+                    break;
+                case VariableType::Integer:
+                    variables[i] = *integer++;
+                    break;
+                case VariableType::Double:
+                    memcpy(&variables[i], doubles, sizeof(encoded_variable_t));
+                    doubles += sizeof(encoded_variable_t);
+                    break;
+            }
+        }
+        return ErrorCode_Success;
+    }
+} }
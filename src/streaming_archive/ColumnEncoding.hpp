@@ -0,0 +1,152 @@
+#ifndef STREAMING_ARCHIVE_COLUMNENCODING_HPP
+#define STREAMING_ARCHIVE_COLUMNENCODING_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <cstdint>
+
+// Project headers
+#include "../Defs.h"
+#include "../ErrorCode.hpp"
+
+/**
+ * Encodings applied to a segment's columns before they're compressed, so that the compressor gets a smaller input and readers decompress fewer bytes
+ * per message
+ */
+namespace streaming_archive { namespace column_encoding {
+    // Constants
+    // Maximum length of an unsigned LEB128 varint encoding a 64-bit value
+    constexpr size_t cMaxVarintLength = 10;
+    // Widths above this are stored as whole 64-bit values, so that a value and its bit offset always fit in one 64-bit word
+    constexpr uint8_t cMaxBitPackedWidth = 56;
+
+    // Types
+    /**
+     * How an encoded variable should be interpreted, which determines the stream it's written to by encode_variables
+     */
+    enum class VariableType : uint8_t {
+        DictionaryId = 0,
+        Integer,
+        Double,
+    };
+    constexpr size_t cNumVariableTypes = 3;
+
+    /**
+     * Order of a file's messages in a segment, which is recorded at the start of the file's logtype IDs column
+     */
+    enum class MessageOrder : uint8_t {
+        // The order in which the messages were appended to the file
+        Arrival = 0,
+        // Grouped by logtype (in order of logtype ID), with messages in arrival order within each group. The column records each message's
+        // original message number after the logtype IDs.
+        GroupedByLogtype,
+    };
+
+    /**
+     * Gets the maximum length of the encoding of the given number of values by encode_delta_varints
+     * @param num_values
+     * @return The length in bytes
+     */
+    inline size_t get_max_delta_varints_length (size_t num_values) {
+        return num_values * cMaxVarintLength;
+    }
+    /**
+     * Encodes each value as the difference from the previous value (starting from 0), zigzag-encoded so small negative differences stay small, and
+     * then written as a varint. This suits columns like timestamps where consecutive values are close.
+     * @param values
+     * @param num_values
+     * @param encoded_buf Buffer of at least get_max_delta_varints_length(num_values) bytes
+     * @return The length of the encoding
+     */
+    size_t encode_delta_varints (const int64_t* values, size_t num_values, char* encoded_buf);
+    /**
+     * Decodes values encoded by encode_delta_varints
+     * @param encoded_buf
+     * @param encoded_buf_length
+     * @param num_values
+     * @param values
+     * @return ErrorCode_Truncated if the encoding contains fewer than num_values values
+     * @return ErrorCode_Corrupt if a varint is too long
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_decode_delta_varints (const char* encoded_buf, size_t encoded_buf_length, size_t num_values, int64_t* values);
+
+    /**
+     * Gets the maximum length of the encoding of the given number of values by bit_pack
+     * @param num_values
+     * @return The length in bytes
+     */
+    inline size_t get_max_bit_packed_length (size_t num_values) {
+        return sizeof(uint8_t) + num_values * sizeof(uint64_t);
+    }
+    /**
+     * Encodes the values using only as many bits per value as the largest value needs. The encoding starts with the width, followed by the values'
+     * bits, least-significant first. This suits columns of dictionary IDs, which are small relative to their type.
+     * @param values
+     * @param num_values
+     * @param encoded_buf Buffer of at least get_max_bit_packed_length(num_values) bytes
+     * @return The length of the encoding
+     */
+    size_t bit_pack (const int64_t* values, size_t num_values, char* encoded_buf);
+    /**
+     * Decodes values encoded by bit_pack
+     * @param encoded_buf
+     * @param encoded_buf_length
+     * @param num_values
+     * @param values
+     * @return ErrorCode_Truncated if the encoding contains fewer than num_values values
+     * @return ErrorCode_Corrupt if the width is invalid
+     * @return ErrorCode_Success on success
+     */
+    ErrorCode try_bit_unpack (const char* encoded_buf, size_t encoded_buf_length, size_t num_values, int64_t* values);
+
+    /**
+     * Gets the length of the variable types at the start of the encoding of the given number of variables by encode_variables
+     * @param num_variables
+     * @return The length in bytes
+     */
+    inline size_t get_variable_types_length (size_t num_variables) {
+        return (num_variables + 3) / 4;
+    }
+    /**
+     * Gets the maximum length of the encoding of the given number of variables by encode_variables
+     * @param num_variables
+     * @return The length in bytes
+     */
+    inline size_t get_max_variables_length (size_t num_variables) {
+        return get_variable_types_length(num_variables) + get_max_delta_varints_length(num_variables);
+    }
+    /**
+     * Encodes the variables as separate streams by type, rather than interleaved in message order, so that the compressor sees runs of similar
+     * values. The encoding starts with each variable's type (2 bits per variable), which the decoder uses to interleave the streams back into their
+     * original order, followed by:
+     * - the dictionary variable IDs, as is;
+     * - the doubles' bit patterns, as is;
+     * - the integers, encoded with encode_delta_varints.
+     * NOTE: Dictionary IDs and doubles are left whole since the compressor matches repeated 8-byte values better than it matches them after
+     * bit-packing or XOR-encoding, which scatters them across bit offsets.
+     * @param variables
+     * @param variable_types
+     * @param num_variables
+     * @param scratch_buf Buffer of at least num_variables values, used to gather the integers
+     * @param encoded_buf Buffer of at least get_max_variables_length(num_variables) bytes
+     * @return The length of the encoding
+     */
+    size_t encode_variables (const encoded_variable_t* variables, const VariableType* variable_types, size_t num_variables, int64_t* scratch_buf,
+                             char* encoded_buf);
+    /**
+     * Decodes variables encoded by encode_variables
+     * @param encoded_buf
+     * @param encoded_buf_length
+     * @param num_variables
+     * @param scratch_buf Buffer of at least num_variables values, used to decode the integers
+     * @param variables
+     * @return ErrorCode_Truncated if the encoding contains fewer than num_variables variables
+     * @return ErrorCode_Corrupt if a variable's type is invalid
+     * @return Same as try_decode_delta_varints otherwise
+     */
+    ErrorCode try_decode_variables (const char* encoded_buf, size_t encoded_buf_length, size_t num_variables, int64_t* scratch_buf,
+                                    encoded_variable_t* variables);
+} }
+
+#endif // STREAMING_ARCHIVE_COLUMNENCODING_HPP
@@ -14,6 +14,7 @@
 #define STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_SIZE "size"
 #define STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATOR_ID "creator_id"
 #define STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_CREATION_IX "creation_ix"
+#define STREAMING_ARCHIVE_METADATA_DB_ARCHIVE_NUM_COMMITTED_SEGMENTS "num_committed_segments"
 
 #define STREAMING_ARCHIVE_METADATA_DB_FILE_ID "id"
 #define STREAMING_ARCHIVE_METADATA_DB_FILE_ORIG_FILE_ID "orig_file_id"
@@ -35,7 +36,7 @@
 #define STREAMING_ARCHIVE_METADATA_DB_EMPTY_DIRECTORY_PATH "path"
 
 namespace streaming_archive {
-    constexpr archive_format_version_t cArchiveFormatVersion = 1;
+    constexpr archive_format_version_t cArchiveFormatVersion = 7;
     constexpr char cLogsDirname[] = "l";
     constexpr char cSegmentsDirname[] = "s";
     constexpr char cSegmentListFilename[] = "segment_list.txt";
@@ -45,9 +46,12 @@ namespace streaming_archive {
     constexpr char cVarSegmentIndexFilename[] = "var.segindex";
     constexpr char cMetadataFileName[] = "metadata";
     constexpr char cMetadataDBFileName[] = "metadata.db";
+    constexpr char cFileTableFileName[] = "files.table";
     constexpr char cTimestampsFileExtension[] = ".tme";
     constexpr char cLogTypeIdsFileExtension[] = ".lid";
     constexpr char cVariablesFileExtension[] = ".var";
+    constexpr char cLogTypePostingsFileExtension[] = ".postings";
+    constexpr char cVariablePostingsFileExtension[] = ".varpostings";
 }
 
 #endif // STREAMING_ARCHIVE_CONSTANTS_HPP
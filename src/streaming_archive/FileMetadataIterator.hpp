@@ -0,0 +1,54 @@
+#ifndef STREAMING_ARCHIVE_FILEMETADATAITERATOR_HPP
+#define STREAMING_ARCHIVE_FILEMETADATAITERATOR_HPP
+
+// C++ standard libraries
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project headers
+#include "../Defs.h"
+#include "../TimestampPattern.hpp"
+
+namespace streaming_archive {
+    /**
+     * Interface for iterating over the metadata of an archive's files, in order of segment ID and then position in the segment, regardless of whether
+     * the metadata is read from the metadata database or from the file table
+     */
+    class FileMetadataIterator {
+    public:
+        // Destructor
+        virtual ~FileMetadataIterator () = default;
+
+        // Methods
+        virtual bool has_next () = 0;
+        virtual void next () = 0;
+        /**
+         * Restarts the iteration over the files in the given segment. Only valid for iterators over a specific segment.
+         * @param segment_id
+         */
+        virtual void set_segment_id (segment_id_t segment_id) = 0;
+
+        virtual void get_id (std::string& id) const = 0;
+        virtual void get_orig_file_id (std::string& id) const = 0;
+        virtual void get_path (std::string& path) const = 0;
+        virtual epochtime_t get_begin_ts () const = 0;
+        virtual epochtime_t get_end_ts () const = 0;
+        /**
+         * Gets the file's timestamp patterns
+         * @param timestamp_patterns Returns the patterns, each paired with the number of the first message that uses it
+         */
+        virtual void get_timestamp_patterns (std::vector<std::pair<uint64_t, TimestampPattern>>& timestamp_patterns) const = 0;
+        virtual size_t get_num_uncompressed_bytes () const = 0;
+        virtual size_t get_num_messages () const = 0;
+        virtual size_t get_num_variables () const = 0;
+        virtual bool is_split () const = 0;
+        virtual size_t get_split_ix () const = 0;
+        virtual segment_id_t get_segment_id () const = 0;
+        virtual size_t get_segment_timestamps_pos () const = 0;
+        virtual size_t get_segment_logtypes_pos () const = 0;
+        virtual size_t get_segment_variables_pos () const = 0;
+    };
+}
+
+#endif // STREAMING_ARCHIVE_FILEMETADATAITERATOR_HPP
@@ -0,0 +1,340 @@
+#include "FileTable.hpp"
+
+// C standard libraries
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+// spdlog
+#include <spdlog/spdlog.h>
+
+// Project headers
+#include "../FileWriter.hpp"
+#include "../Utils.hpp"
+
+using std::string;
+using std::vector;
+
+namespace streaming_archive {
+    FileTable::FileIterator::FileIterator (const FileTable& table, epochtime_t begin_timestamp, epochtime_t end_timestamp, const string& file_path,
+                                           bool in_specific_segment, segment_id_t segment_id) :
+                                           m_table(table), m_begin_timestamp(begin_timestamp), m_end_timestamp(end_timestamp),
+                                           m_file_path(file_path), m_record_ix(0), m_end_record_ix(table.m_num_records)
+    {
+        if (in_specific_segment) {
+            set_segment_id(segment_id);
+        } else {
+            skip_unmatched_records();
+        }
+    }
+
+    void FileTable::FileIterator::next () {
+        ++m_record_ix;
+        skip_unmatched_records();
+    }
+
+    void FileTable::FileIterator::set_segment_id (segment_id_t segment_id) {
+        // Records are sorted by segment ID, so the segment's records are contiguous
+        auto records_begin = m_table.m_records;
+        auto records_end = m_table.m_records + m_table.m_num_records;
+        auto segment_records_begin = std::lower_bound(records_begin, records_end, (int64_t)segment_id, [] (const Record& record, int64_t id) {
+            return record.segment_id < id;
+        });
+        auto segment_records_end = std::upper_bound(segment_records_begin, records_end, (int64_t)segment_id, [] (int64_t id, const Record& record) {
+            return id < record.segment_id;
+        });
+        m_record_ix = segment_records_begin - records_begin;
+        m_end_record_ix = segment_records_end - records_begin;
+        skip_unmatched_records();
+    }
+
+    void FileTable::FileIterator::skip_unmatched_records () {
+        for (; m_record_ix < m_end_record_ix; ++m_record_ix) {
+            const auto& record = m_table.m_records[m_record_ix];
+            if (record.begin_ts < m_begin_timestamp || record.end_ts > m_end_timestamp) {
+                continue;
+            }
+            if (false == m_file_path.empty() && (record.path_length != m_file_path.length() ||
+                                                 0 != memcmp(m_table.m_strings + record.path_offset, m_file_path.data(), record.path_length)))
+            {
+                continue;
+            }
+            break;
+        }
+    }
+
+    void FileTable::FileIterator::get_id (string& id) const {
+        id.assign(m_table.m_records[m_record_ix].id, cIdLength);
+    }
+
+    void FileTable::FileIterator::get_orig_file_id (string& id) const {
+        id.assign(m_table.m_records[m_record_ix].orig_file_id, cIdLength);
+    }
+
+    void FileTable::FileIterator::get_path (string& path) const {
+        const auto& record = m_table.m_records[m_record_ix];
+        path.assign(m_table.m_strings + record.path_offset, record.path_length);
+    }
+
+    epochtime_t FileTable::FileIterator::get_begin_ts () const {
+        return m_table.m_records[m_record_ix].begin_ts;
+    }
+
+    epochtime_t FileTable::FileIterator::get_end_ts () const {
+        return m_table.m_records[m_record_ix].end_ts;
+    }
+
+    void FileTable::FileIterator::get_timestamp_patterns (vector<std::pair<uint64_t, TimestampPattern>>& timestamp_patterns) const {
+        timestamp_patterns.clear();
+
+        const auto& record = m_table.m_records[m_record_ix];
+        auto refs = m_table.m_timestamp_pattern_refs + record.timestamp_pattern_refs_begin_ix;
+        for (size_t i = 0; i < record.num_timestamp_pattern_refs; ++i) {
+            timestamp_patterns.emplace_back(refs[i].msg_num, m_table.m_timestamp_patterns[refs[i].timestamp_pattern_ix]);
+        }
+    }
+
+    size_t FileTable::FileIterator::get_num_uncompressed_bytes () const {
+        return m_table.m_records[m_record_ix].num_uncompressed_bytes;
+    }
+
+    size_t FileTable::FileIterator::get_num_messages () const {
+        return m_table.m_records[m_record_ix].num_messages;
+    }
+
+    size_t FileTable::FileIterator::get_num_variables () const {
+        return m_table.m_records[m_record_ix].num_variables;
+    }
+
+    bool FileTable::FileIterator::is_split () const {
+        return m_table.m_records[m_record_ix].is_split;
+    }
+
+    size_t FileTable::FileIterator::get_split_ix () const {
+        return m_table.m_records[m_record_ix].split_ix;
+    }
+
+    segment_id_t FileTable::FileIterator::get_segment_id () const {
+        return (segment_id_t)m_table.m_records[m_record_ix].segment_id;
+    }
+
+    size_t FileTable::FileIterator::get_segment_timestamps_pos () const {
+        return m_table.m_records[m_record_ix].segment_timestamps_pos;
+    }
+
+    size_t FileTable::FileIterator::get_segment_logtypes_pos () const {
+        return m_table.m_records[m_record_ix].segment_logtypes_pos;
+    }
+
+    size_t FileTable::FileIterator::get_segment_variables_pos () const {
+        return m_table.m_records[m_record_ix].segment_variables_pos;
+    }
+
+    FileTable::~FileTable () {
+        close();
+    }
+
+    void FileTable::write (MetadataDB& metadata_db, const string& path) {
+        vector<Record> records;
+        vector<TimestampPatternRecord> timestamp_pattern_records;
+        vector<TimestampPatternRef> timestamp_pattern_refs;
+        string strings;
+
+        std::map<std::pair<uint8_t, string>, uint64_t> timestamp_pattern_to_ix;
+        string id;
+        string file_path;
+        vector<std::pair<uint64_t, TimestampPattern>> timestamp_patterns;
+        for (auto ix = metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId); ix.has_next(); ix.next()) {
+            Record record = {};
+
+            ix.get_id(id);
+            if (cIdLength != id.length()) {
+                SPDLOG_ERROR("File ID {} has an unexpected length", id.c_str());
+                throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+            }
+            memcpy(record.id, id.data(), cIdLength);
+            ix.get_orig_file_id(id);
+            if (cIdLength != id.length()) {
+                SPDLOG_ERROR("Original file ID {} has an unexpected length", id.c_str());
+                throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+            }
+            memcpy(record.orig_file_id, id.data(), cIdLength);
+
+            ix.get_path(file_path);
+            record.path_offset = strings.length();
+            record.path_length = file_path.length();
+            strings += file_path;
+
+            record.begin_ts = ix.get_begin_ts();
+            record.end_ts = ix.get_end_ts();
+            record.num_uncompressed_bytes = ix.get_num_uncompressed_bytes();
+            record.num_messages = ix.get_num_messages();
+            record.num_variables = ix.get_num_variables();
+            record.segment_id = (int64_t)ix.get_segment_id();
+            record.segment_timestamps_pos = ix.get_segment_timestamps_pos();
+            record.segment_logtypes_pos = ix.get_segment_logtypes_pos();
+            record.segment_variables_pos = ix.get_segment_variables_pos();
+            record.is_split = ix.is_split();
+            record.split_ix = ix.get_split_ix();
+
+            ix.get_timestamp_patterns(timestamp_patterns);
+            record.timestamp_pattern_refs_begin_ix = timestamp_pattern_refs.size();
+            record.num_timestamp_pattern_refs = timestamp_patterns.size();
+            for (const auto& timestamp_pattern : timestamp_patterns) {
+                const auto& pattern = timestamp_pattern.second;
+                auto key = std::make_pair(pattern.get_num_spaces_before_ts(), pattern.get_format());
+                auto result = timestamp_pattern_to_ix.emplace(key, timestamp_pattern_records.size());
+                if (result.second) {
+                    TimestampPatternRecord timestamp_pattern_record = {};
+                    timestamp_pattern_record.num_spaces_before_ts = pattern.get_num_spaces_before_ts();
+                    timestamp_pattern_record.format_offset = strings.length();
+                    timestamp_pattern_record.format_length = pattern.get_format().length();
+                    strings += pattern.get_format();
+                    timestamp_pattern_records.push_back(timestamp_pattern_record);
+                }
+                timestamp_pattern_refs.push_back({timestamp_pattern.first, result.first->second});
+            }
+
+            records.push_back(record);
+        }
+
+        Header header = {};
+        header.format_version = cFormatVersion;
+        header.num_records = records.size();
+        header.num_timestamp_patterns = timestamp_pattern_records.size();
+        header.num_timestamp_pattern_refs = timestamp_pattern_refs.size();
+        header.strings_size = strings.length();
+
+        string temp_path = path + ".tmp";
+        FileWriter file_writer;
+        file_writer.open(temp_path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+        file_writer.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        // NOTE: Empty sections are skipped since an empty vector's data may be null, which FileWriter::write rejects
+        if (false == records.empty()) {
+            file_writer.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record));
+        }
+        if (false == timestamp_pattern_records.empty()) {
+            file_writer.write(reinterpret_cast<const char*>(timestamp_pattern_records.data()),
+                              timestamp_pattern_records.size() * sizeof(TimestampPatternRecord));
+        }
+        if (false == timestamp_pattern_refs.empty()) {
+            file_writer.write(reinterpret_cast<const char*>(timestamp_pattern_refs.data()),
+                              timestamp_pattern_refs.size() * sizeof(TimestampPatternRef));
+        }
+        file_writer.write(strings.data(), strings.length());
+        file_writer.flush();
+        file_writer.close();
+
+        if (0 != rename(temp_path.c_str(), path.c_str())) {
+            SPDLOG_ERROR("Failed to rename {} to {}, errno={}", temp_path.c_str(), path.c_str(), errno);
+            throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+        }
+    }
+
+    void FileTable::remove (const string& path) {
+        if (0 != unlink(path.c_str()) && ENOENT != errno) {
+            SPDLOG_ERROR("Failed to delete {}, errno={}", path.c_str(), errno);
+            throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+        }
+    }
+
+    ErrorCode FileTable::try_open (const string& path) {
+        // Cleanup in case caller forgot to call close before calling this function
+        close();
+
+        struct stat path_stat = {};
+        if (0 != stat(path.c_str(), &path_stat)) {
+            return (ENOENT == errno) ? ErrorCode_FileNotFound : ErrorCode_errno;
+        }
+
+        void* file_content = nullptr;
+        auto error_code = memory_map_file(path, false, m_fd, m_file_size, file_content);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        m_file_content = static_cast<const char*>(file_content);
+        m_is_open = true;
+
+        // Validate the header against the file's size
+        if (m_file_size < sizeof(Header)) {
+            close();
+            return ErrorCode_Corrupt;
+        }
+        const auto& header = *reinterpret_cast<const Header*>(m_file_content);
+        if (cFormatVersion != header.format_version) {
+            close();
+            return ErrorCode_Corrupt;
+        }
+        size_t records_offset = sizeof(Header);
+        size_t timestamp_patterns_offset = records_offset + header.num_records * sizeof(Record);
+        size_t timestamp_pattern_refs_offset = timestamp_patterns_offset + header.num_timestamp_patterns * sizeof(TimestampPatternRecord);
+        size_t strings_offset = timestamp_pattern_refs_offset + header.num_timestamp_pattern_refs * sizeof(TimestampPatternRef);
+        if (strings_offset + header.strings_size != m_file_size) {
+            close();
+            return ErrorCode_Corrupt;
+        }
+
+        struct stat fd_stat = {};
+        if (0 != fstat(m_fd, &fd_stat)) {
+            close();
+            return ErrorCode_errno;
+        }
+        m_inode = fd_stat.st_ino;
+        m_path = path;
+
+        m_records = reinterpret_cast<const Record*>(m_file_content + records_offset);
+        m_num_records = header.num_records;
+        m_timestamp_pattern_refs = reinterpret_cast<const TimestampPatternRef*>(m_file_content + timestamp_pattern_refs_offset);
+        m_strings = m_file_content + strings_offset;
+
+        auto timestamp_pattern_records = reinterpret_cast<const TimestampPatternRecord*>(m_file_content + timestamp_patterns_offset);
+        m_timestamp_patterns.reserve(header.num_timestamp_patterns);
+        for (size_t i = 0; i < header.num_timestamp_patterns; ++i) {
+            const auto& record = timestamp_pattern_records[i];
+            m_timestamp_patterns.emplace_back(record.num_spaces_before_ts, string(m_strings + record.format_offset, record.format_length));
+        }
+
+        // NOTE: This is only advice, so we ignore any failure
+        madvise(const_cast<char*>(m_file_content), m_file_size, MADV_WILLNEED);
+
+        return ErrorCode_Success;
+    }
+
+    void FileTable::close () {
+        if (false == m_is_open) {
+            return;
+        }
+
+        memory_unmap_file(m_fd, m_file_size, const_cast<char*>(m_file_content));
+        m_is_open = false;
+        m_path.clear();
+        m_fd = -1;
+        m_file_size = 0;
+        m_file_content = nullptr;
+        m_inode = 0;
+        m_records = nullptr;
+        m_num_records = 0;
+        m_timestamp_pattern_refs = nullptr;
+        m_strings = nullptr;
+        m_timestamp_patterns.clear();
+    }
+
+    bool FileTable::is_current () const {
+        if (false == m_is_open) {
+            return false;
+        }
+
+        struct stat path_stat = {};
+        if (0 != stat(m_path.c_str(), &path_stat)) {
+            return false;
+        }
+        return m_inode == path_stat.st_ino;
+    }
+}
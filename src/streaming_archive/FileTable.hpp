@@ -0,0 +1,208 @@
+#ifndef STREAMING_ARCHIVE_FILETABLE_HPP
+#define STREAMING_ARCHIVE_FILETABLE_HPP
+
+// C++ standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project headers
+#include "../Defs.h"
+#include "../ErrorCode.hpp"
+#include "../TimestampPattern.hpp"
+#include "../TraceableException.hpp"
+#include "FileMetadataIterator.hpp"
+#include "MetadataDB.hpp"
+
+namespace streaming_archive {
+    /**
+     * Class representing an archive's file table: an immutable, fixed-width copy of the metadata database's files table which can be mapped into memory
+     * and iterated without any SQL or string parsing. Each file's record contains its segment positions, time bounds, message and variable counts, and
+     * references to its timestamp patterns, which are deduplicated and stored once in the table.
+     *
+     * The table is written when an archive is closed and deleted when the archive is reopened for appending, so it only exists while it matches the
+     * metadata database. Readers should fall back to the metadata database when it doesn't exist.
+     */
+    class FileTable {
+    public:
+        // Types
+        class OperationFailed : public TraceableException {
+        public:
+            // Constructors
+            OperationFailed (ErrorCode error_code, const char* const filename, int line_number) : TraceableException (error_code, filename, line_number) {}
+
+            // Methods
+            const char* what () const noexcept override {
+                return "streaming_archive::FileTable operation failed";
+            }
+        };
+
+        class FileIterator : public FileMetadataIterator {
+        public:
+            // Constructors
+            FileIterator (const FileTable& table, epochtime_t begin_timestamp, epochtime_t end_timestamp, const std::string& file_path,
+                          bool in_specific_segment, segment_id_t segment_id);
+
+            // Methods
+            bool has_next () override { return m_record_ix < m_end_record_ix; }
+            void next () override;
+            void set_segment_id (segment_id_t segment_id) override;
+
+            void get_id (std::string& id) const override;
+            void get_orig_file_id (std::string& id) const override;
+            void get_path (std::string& path) const override;
+            epochtime_t get_begin_ts () const override;
+            epochtime_t get_end_ts () const override;
+            void get_timestamp_patterns (std::vector<std::pair<uint64_t, TimestampPattern>>& timestamp_patterns) const override;
+            size_t get_num_uncompressed_bytes () const override;
+            size_t get_num_messages () const override;
+            size_t get_num_variables () const override;
+            bool is_split () const override;
+            size_t get_split_ix () const override;
+            segment_id_t get_segment_id () const override;
+            size_t get_segment_timestamps_pos () const override;
+            size_t get_segment_logtypes_pos () const override;
+            size_t get_segment_variables_pos () const override;
+
+        private:
+            // Methods
+            /**
+             * Advances to the first record at or after the current one which matches the iterator's filters
+             */
+            void skip_unmatched_records ();
+
+            // Variables
+            const FileTable& m_table;
+            epochtime_t m_begin_timestamp;
+            epochtime_t m_end_timestamp;
+            std::string m_file_path;
+            size_t m_record_ix;
+            size_t m_end_record_ix;
+        };
+
+        // Constructors
+        FileTable () : m_is_open(false), m_fd(-1), m_file_size(0), m_file_content(nullptr), m_inode(0), m_records(nullptr), m_num_records(0),
+                       m_timestamp_pattern_refs(nullptr), m_strings(nullptr) {}
+
+        // Destructor
+        ~FileTable ();
+
+        // Delete copy constructor and assignment operator
+        FileTable (const FileTable&) = delete;
+        FileTable& operator= (const FileTable&) = delete;
+
+        // Methods
+        /**
+         * Writes the metadata of every file in the given database to a new file table at the given path. The table is written to a temporary file
+         * and then renamed, so readers never see a partially written table.
+         * @param metadata_db
+         * @param path
+         * @throw FileTable::OperationFailed if a file's ID is malformed or the table couldn't be renamed into place
+         * @throw Same as FileWriter::open, FileWriter::write, and MetadataDB::FileIterator::get_timestamp_patterns
+         */
+        static void write (MetadataDB& metadata_db, const std::string& path);
+        /**
+         * Deletes the file table at the given path, if any
+         * @param path
+         * @throw FileTable::OperationFailed if the table exists but couldn't be deleted
+         */
+        static void remove (const std::string& path);
+
+        /**
+         * Tries to open and map the file table at the given path
+         * @param path
+         * @return ErrorCode_FileNotFound if the table doesn't exist
+         * @return ErrorCode_Corrupt if the table's header doesn't match its size or it uses an unsupported format
+         * @return Same as memory_map_file otherwise
+         */
+        ErrorCode try_open (const std::string& path);
+        /**
+         * Unmaps and closes the table if it's open
+         */
+        void close ();
+        bool is_open () const { return m_is_open; }
+
+        /**
+         * Checks whether the table still exists at the path it was opened from, i.e., it hasn't been deleted because the archive was reopened for
+         * appending
+         * @return true if the table is open and current, false otherwise
+         */
+        bool is_current () const;
+
+        std::unique_ptr<FileMetadataIterator> get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path,
+                                                                 bool in_specific_segment, segment_id_t segment_id) const
+        {
+            return std::make_unique<FileIterator>(*this, begin_ts, end_ts, file_path, in_specific_segment, segment_id);
+        }
+
+    private:
+        // Types
+        static constexpr size_t cIdLength = 36;
+
+        struct Header {
+            uint64_t format_version;
+            uint64_t num_records;
+            uint64_t num_timestamp_patterns;
+            uint64_t num_timestamp_pattern_refs;
+            uint64_t strings_size;
+        };
+
+        /**
+         * Fixed-width record of a file's metadata. Variable-length fields are stored as offsets into the table's other sections.
+         */
+        struct Record {
+            char id[cIdLength];
+            char orig_file_id[cIdLength];
+            epochtime_t begin_ts;
+            epochtime_t end_ts;
+            uint64_t num_uncompressed_bytes;
+            uint64_t num_messages;
+            uint64_t num_variables;
+            // Stored as a signed value so that files not in a segment sort first, as they do in the metadata database
+            int64_t segment_id;
+            uint64_t segment_timestamps_pos;
+            uint64_t segment_logtypes_pos;
+            uint64_t segment_variables_pos;
+            uint64_t is_split;
+            uint64_t split_ix;
+            uint64_t path_offset;
+            uint64_t path_length;
+            uint64_t timestamp_pattern_refs_begin_ix;
+            uint64_t num_timestamp_pattern_refs;
+        };
+
+        struct TimestampPatternRecord {
+            uint64_t num_spaces_before_ts;
+            uint64_t format_offset;
+            uint64_t format_length;
+        };
+
+        struct TimestampPatternRef {
+            uint64_t msg_num;
+            uint64_t timestamp_pattern_ix;
+        };
+
+        // Constants
+        static constexpr uint64_t cFormatVersion = 1;
+
+        // Variables
+        bool m_is_open;
+        std::string m_path;
+        int m_fd;
+        size_t m_file_size;
+        const char* m_file_content;
+        uint64_t m_inode;
+
+        const Record* m_records;
+        size_t m_num_records;
+        const TimestampPatternRef* m_timestamp_pattern_refs;
+        const char* m_strings;
+        // Parsed once when the table is opened, so that opening a file only copies its patterns
+        std::vector<TimestampPattern> m_timestamp_patterns;
+    };
+}
+
+#endif // STREAMING_ARCHIVE_FILETABLE_HPP
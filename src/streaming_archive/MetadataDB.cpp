@@ -1,6 +1,8 @@
 #include "MetadataDB.hpp"
 
 // C++ standard libraries
+#include <cstdlib>
+#include <tuple>
 #include <vector>
 
 // Project headers
@@ -211,8 +213,42 @@ namespace streaming_archive {
         return m_statement.column_int64(enum_to_underlying_type(FilesTableFieldIndexes::EndTimestamp));
     }
 
-    void MetadataDB::FileIterator::get_timestamp_patterns (string& timestamp_patterns) const {
-        m_statement.column_string(enum_to_underlying_type(FilesTableFieldIndexes::TimestampPatterns), timestamp_patterns);
+    void MetadataDB::FileIterator::get_timestamp_patterns (vector<std::pair<uint64_t, TimestampPattern>>& timestamp_patterns) const {
+        timestamp_patterns.clear();
+
+        string encoded_timestamp_patterns;
+        m_statement.column_string(enum_to_underlying_type(FilesTableFieldIndexes::TimestampPatterns), encoded_timestamp_patterns);
+        size_t begin_pos = 0;
+        size_t end_pos;
+        string timestamp_format;
+        while (true) {
+            end_pos = encoded_timestamp_patterns.find_first_of(':', begin_pos);
+            if (string::npos == end_pos) {
+                // Done
+                break;
+            }
+            size_t msg_num = strtoull(&encoded_timestamp_patterns[begin_pos], nullptr, 10);
+            begin_pos = end_pos + 1;
+
+            end_pos = encoded_timestamp_patterns.find_first_of(':', begin_pos);
+            if (string::npos == end_pos) {
+                // Unexpected truncation
+                throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+            }
+            uint8_t num_spaces_before_ts = strtol(&encoded_timestamp_patterns[begin_pos], nullptr, 10);
+            begin_pos = end_pos + 1;
+
+            end_pos = encoded_timestamp_patterns.find_first_of('\n', begin_pos);
+            if (string::npos == end_pos) {
+                // Unexpected truncation
+                throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+            }
+            timestamp_format.assign(encoded_timestamp_patterns, begin_pos, end_pos - begin_pos);
+            begin_pos = end_pos + 1;
+
+            timestamp_patterns.emplace_back(std::piecewise_construct, std::forward_as_tuple(msg_num),
+                                            std::forward_as_tuple(num_spaces_before_ts, timestamp_format));
+        }
     }
 
     size_t MetadataDB::FileIterator::get_num_uncompressed_bytes () const {
@@ -251,12 +287,15 @@ namespace streaming_archive {
         return m_statement.column_int64(enum_to_underlying_type(FilesTableFieldIndexes::SegmentVariablesPosition));
     }
 
-    void MetadataDB::open (const string& path) {
+    void MetadataDB::open (const string& path, bool is_writer) {
         if (m_is_open) {
             throw OperationFailed(ErrorCode_NotReady, __FILENAME__, __LINE__);
         }
 
         m_db.open(path);
+        if (is_writer) {
+            m_db.enable_write_ahead_logging();
+        }
 
         vector<std::pair<string, string>> file_field_names_and_types(enum_to_underlying_type(FilesTableFieldIndexes::Length));
         file_field_names_and_types[enum_to_underlying_type(FilesTableFieldIndexes::Id)].first = STREAMING_ARCHIVE_METADATA_DB_FILE_ID;
@@ -353,6 +392,7 @@ namespace streaming_archive {
         m_transaction_end_statement.reset(nullptr);
         m_upsert_file_statement.reset(nullptr);
         m_insert_empty_directories_statement.reset(nullptr);
+        m_db.disable_write_ahead_logging();
         if (false == m_db.close()) {
             SPDLOG_ERROR("streaming_archive::MetadataDB: Failed to close database - {}", m_db.get_error_message());
             throw OperationFailed(ErrorCode_Failure, __FILENAME__, __LINE__);
@@ -393,11 +433,28 @@ namespace streaming_archive {
         m_transaction_end_statement->reset();
     }
 
+    void MetadataDB::get_ids_of_segments_with_files (segment_id_t min_segment_id, vector<segment_id_t>& segment_ids) {
+        // NOTE: Files that aren't in a segment have cInvalidSegmentId, which is stored as -1, so they're excluded by the lower bound
+        auto statement = m_db.prepare_statement("SELECT DISTINCT " STREAMING_ARCHIVE_METADATA_DB_FILE_SEGMENT_ID
+                                                " FROM " STREAMING_ARCHIVE_METADATA_DB_FILES_TABLE_NAME
+                                                " WHERE " STREAMING_ARCHIVE_METADATA_DB_FILE_SEGMENT_ID " >= ?1"
+                                                " ORDER BY " STREAMING_ARCHIVE_METADATA_DB_FILE_SEGMENT_ID " ASC");
+        statement.bind_int64(1, (int64_t)min_segment_id);
+        while (statement.step()) {
+            segment_ids.push_back(statement.column_int64(0));
+        }
+    }
+
     void MetadataDB::add_empty_directories (const vector<string>& empty_directory_paths) {
+        m_transaction_begin_statement->step();
         for (const auto& path : empty_directory_paths) {
             m_insert_empty_directories_statement->bind_text(1, path, false);
             m_insert_empty_directories_statement->step();
             m_insert_empty_directories_statement->reset();
         }
+        m_transaction_end_statement->step();
+
+        m_transaction_begin_statement->reset();
+        m_transaction_end_statement->reset();
     }
 }
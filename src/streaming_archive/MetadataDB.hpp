@@ -10,6 +10,7 @@
 
 // Project headers
 #include "../SQLiteDB.hpp"
+#include "FileMetadataIterator.hpp"
 #include "writer/File.hpp"
 
 namespace streaming_archive {
@@ -54,7 +55,7 @@ namespace streaming_archive {
             SQLitePreparedStatement m_statement;
         };
 
-        class FileIterator : public Iterator {
+        class FileIterator : public Iterator, public FileMetadataIterator {
         public:
             // Types
             class OperationFailed : public TraceableException {
@@ -73,23 +74,30 @@ namespace streaming_archive {
                                    segment_id_t segment_id);
 
             // Methods
-            void set_segment_id (segment_id_t segment_id);
-
-            void get_id (std::string& id) const;
-            void get_orig_file_id (std::string& id) const;
-            void get_path (std::string& path) const;
-            epochtime_t get_begin_ts () const;
-            epochtime_t get_end_ts () const;
-            void get_timestamp_patterns (std::string& timestamp_patterns) const;
-            size_t get_num_uncompressed_bytes () const;
-            size_t get_num_messages () const;
-            size_t get_num_variables () const;
-            bool is_split () const;
-            size_t get_split_ix () const;
-            segment_id_t get_segment_id () const;
-            size_t get_segment_timestamps_pos () const;
-            size_t get_segment_logtypes_pos () const;
-            size_t get_segment_variables_pos () const;
+            bool has_next () override { return Iterator::has_next(); }
+            void next () override { Iterator::next(); }
+            void set_segment_id (segment_id_t segment_id) override;
+
+            void get_id (std::string& id) const override;
+            void get_orig_file_id (std::string& id) const override;
+            void get_path (std::string& path) const override;
+            epochtime_t get_begin_ts () const override;
+            epochtime_t get_end_ts () const override;
+            /**
+             * Gets the file's timestamp patterns by parsing their encoded form in the database
+             * @param timestamp_patterns
+             * @throw MetadataDB::FileIterator::OperationFailed if the encoded patterns are truncated
+             */
+            void get_timestamp_patterns (std::vector<std::pair<uint64_t, TimestampPattern>>& timestamp_patterns) const override;
+            size_t get_num_uncompressed_bytes () const override;
+            size_t get_num_messages () const override;
+            size_t get_num_variables () const override;
+            bool is_split () const override;
+            size_t get_split_ix () const override;
+            segment_id_t get_segment_id () const override;
+            size_t get_segment_timestamps_pos () const override;
+            size_t get_segment_logtypes_pos () const override;
+            size_t get_segment_variables_pos () const override;
         };
 
         class EmptyDirectoryIterator : public Iterator {
@@ -119,12 +127,25 @@ namespace streaming_archive {
         MetadataDB () : m_is_open(false) {}
 
         // Methods
-        void open (const std::string& path);
+        /**
+         * Opens the database
+         * @param path
+         * @param is_writer Whether files' metadata will be written through this connection, in which case the database uses write-ahead logging
+         * until the last connection to it is closed
+         */
+        void open (const std::string& path, bool is_writer);
         void close ();
 
         void update_files (const std::vector<writer::File*>& files);
         void add_empty_directories (const std::vector<std::string>& empty_directory_paths);
 
+        /**
+         * Gets the IDs of the segments that contain files, starting from the given segment ID
+         * @param min_segment_id
+         * @param segment_ids Returns the IDs in ascending order
+         */
+        void get_ids_of_segments_with_files (segment_id_t min_segment_id, std::vector<segment_id_t>& segment_ids);
+
         FileIterator get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path, bool in_specific_segment,
                                         segment_id_t segment_id)
         {
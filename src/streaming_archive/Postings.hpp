@@ -0,0 +1,472 @@
+#ifndef STREAMING_ARCHIVE_POSTINGS_HPP
+#define STREAMING_ARCHIVE_POSTINGS_HPP
+
+// C standard libraries
+#include <sys/stat.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Project headers
+#include "../Defs.h"
+#include "../ErrorCode.hpp"
+#include "../FileWriter.hpp"
+#include "../streaming_compression/zstd/Compressor.hpp"
+#include "../streaming_compression/zstd/Decompressor.hpp"
+#include "ColumnEncoding.hpp"
+
+namespace streaming_archive {
+    /**
+     * A run of consecutive messages containing the same dictionary ID in a file
+     */
+    struct Posting {
+        // Position of the file's logtype IDs column in the segment, which identifies the file
+        uint64_t file_logtypes_pos;
+        uint64_t begin_msg_ix;
+        uint64_t end_msg_ix;
+        // Index of the run's first variable in the file's variables column
+        uint64_t begin_variable_ix;
+    };
+
+    /**
+     * Template class representing a segment's posting lists for a type of dictionary ID: for each ID in the segment, the runs of consecutive messages
+     * containing that ID in each of the segment's files. A search can use them to skip the files and messages that can't contain the IDs it's looking
+     * for, rather than scanning every message in the segment.
+     *
+     * An ID whose messages are scattered across many short runs is cheaper to find by scanning, so only the IDs with the fewest runs are indexed, up to a
+     * limit given when the postings are written. The remaining IDs are recorded as unindexed.
+     *
+     * The postings are built with add_posting and written with write, while a search reads them with try_read and looks them up with try_get_postings.
+     * Since a segment may contain millions of IDs (e.g., request IDs), the postings are stored in blocks of cNumIdsPerBlock IDs that are only decoded
+     * when they're looked up.
+     * @tparam DictionaryIdType
+     */
+    template <typename DictionaryIdType>
+    class Postings {
+    public:
+        // Constants
+        static constexpr size_t cMinMessagesPerPosting = 8;
+
+        // Constructors
+        Postings () : m_num_messages(0) {}
+
+        // Methods
+        /**
+         * Adds a run of messages containing the given ID, merging it with the ID's previous run if they overlap or are adjacent
+         * @param id
+         * @param posting
+         */
+        void add_posting (DictionaryIdType id, const Posting& posting);
+        /**
+         * Adds the given number of messages to the number of messages in the segment
+         * @param num_messages
+         */
+        void increment_num_messages (uint64_t num_messages) { m_num_messages += num_messages; }
+        /**
+         * Removes all postings
+         */
+        void clear ();
+        uint64_t get_num_messages () const { return m_num_messages; }
+
+        /**
+         * Writes the added postings to a new file at the given path. IDs with more than one posting per cMinMessagesPerPosting messages are never
+         * indexed.
+         * @param path
+         * @param max_num_indexed_postings The maximum total number of postings to index
+         * @return The size of the file
+         * @throw Same as FileWriter::open, FileWriter::close, and streaming_compression::zstd::Compressor::write
+         */
+        size_t write (const std::string& path, size_t max_num_indexed_postings) const;
+        /**
+         * Replaces the postings with those in the file at the given path
+         * @param path
+         * @return ErrorCode_FileNotFound if the file doesn't exist
+         * @return ErrorCode_Truncated if the file ends before all its postings
+         * @return ErrorCode_Corrupt if the IDs or the size of their postings are invalid
+         * @return Same as streaming_compression::zstd::Decompressor::open and column_encoding::try_decode_delta_varints otherwise
+         */
+        ErrorCode try_read (const std::string& path);
+
+        /**
+         * Gets the read postings of the given IDs in the given file, in order of their first message and with overlapping postings merged, if that's
+         * cheaper than scanning the segment
+         * @param ids
+         * @param file_logtypes_pos
+         * @param postings Returns the postings
+         * @return false if one of the IDs is unindexed, the IDs have too many postings, or their postings are corrupt, true otherwise
+         */
+        bool try_get_postings (const std::vector<DictionaryIdType>& ids, uint64_t file_logtypes_pos, std::vector<Posting>& postings) const;
+
+    private:
+        // Constants
+        static constexpr size_t cNumIdsPerBlock = 64;
+        // Number of columns that a block's postings are stored as
+        static constexpr size_t cNumPostingColumns = 4;
+
+        // Methods
+        /**
+         * Writes the given values as a length-prefixed run of delta varints
+         * @param values
+         * @param encoded_buf
+         * @param compressor
+         */
+        static void write_delta_varints (const std::vector<int64_t>& values, std::vector<char>& encoded_buf,
+                                         streaming_compression::zstd::Compressor& compressor);
+        /**
+         * Reads a run of delta varints written by write_delta_varints
+         * @param decompressor
+         * @param num_values
+         * @param encoded_buf
+         * @param values Returns the values
+         * @return ErrorCode_Truncated if the file ends before the values
+         * @return ErrorCode_Corrupt if the encoding is too long for the number of values
+         * @return Same as column_encoding::try_decode_delta_varints otherwise
+         */
+        static ErrorCode try_read_delta_varints (streaming_compression::zstd::Decompressor& decompressor, size_t num_values,
+                                                 std::vector<char>& encoded_buf, std::vector<int64_t>& values);
+
+        // Variables
+        uint64_t m_num_messages;
+
+        // Postings being built, for each ID, in order of file and then first message
+        std::unordered_map<DictionaryIdType, std::vector<Posting>> m_id_to_postings;
+
+        // Postings read from a file. Each block contains the postings of consecutive indexed IDs, as separate runs of delta varints for each field of
+        // the postings. Within a run, each ID's postings are in order of file and then first message.
+        std::vector<DictionaryIdType> m_indexed_ids;
+        // Index of each indexed ID's first posting among all postings, followed by the total number of postings
+        std::vector<size_t> m_indexed_id_postings_begin_ixs;
+        std::vector<char> m_encoded_posting_blocks;
+        std::vector<size_t> m_posting_block_begin_offsets;
+        std::vector<DictionaryIdType> m_unindexed_ids;
+    };
+
+    typedef Postings<logtype_dictionary_id_t> LogTypePostings;
+    typedef Postings<variable_dictionary_id_t> VariablePostings;
+
+    template <typename DictionaryIdType>
+    void Postings<DictionaryIdType>::add_posting (DictionaryIdType id, const Posting& posting) {
+        auto& postings = m_id_to_postings[id];
+        if (false == postings.empty()) {
+            auto& last_posting = postings.back();
+            if (last_posting.file_logtypes_pos == posting.file_logtypes_pos && posting.begin_msg_ix <= last_posting.end_msg_ix) {
+                last_posting.end_msg_ix = std::max(last_posting.end_msg_ix, posting.end_msg_ix);
+                return;
+            }
+        }
+        postings.push_back(posting);
+    }
+
+    template <typename DictionaryIdType>
+    void Postings<DictionaryIdType>::clear () {
+        m_num_messages = 0;
+        m_id_to_postings.clear();
+        m_indexed_ids.clear();
+        m_indexed_id_postings_begin_ixs.clear();
+        m_encoded_posting_blocks.clear();
+        m_posting_block_begin_offsets.clear();
+        m_unindexed_ids.clear();
+    }
+
+    template <typename DictionaryIdType>
+    size_t Postings<DictionaryIdType>::write (const std::string& path, size_t max_num_indexed_postings) const {
+        // Index the IDs with the fewest postings, until the index's budget is used up
+        std::vector<std::pair<size_t, DictionaryIdType>> num_postings_and_ids;
+        for (const auto& id_and_postings : m_id_to_postings) {
+            num_postings_and_ids.emplace_back(id_and_postings.second.size(), id_and_postings.first);
+        }
+        std::sort(num_postings_and_ids.begin(), num_postings_and_ids.end());
+        size_t num_indexed_postings = 0;
+        std::vector<DictionaryIdType> indexed_ids;
+        std::vector<DictionaryIdType> unindexed_ids;
+        for (const auto& num_postings_and_id : num_postings_and_ids) {
+            auto num_postings = num_postings_and_id.first;
+            if (num_postings * cMinMessagesPerPosting <= m_num_messages && num_postings <= max_num_indexed_postings - num_indexed_postings) {
+                num_indexed_postings += num_postings;
+                indexed_ids.push_back(num_postings_and_id.second);
+            } else {
+                unindexed_ids.push_back(num_postings_and_id.second);
+            }
+        }
+        // NOTE: Sorting the IDs makes both them and their postings (since IDs are assigned in order of first occurrence) change slowly
+        std::sort(indexed_ids.begin(), indexed_ids.end());
+        std::sort(unindexed_ids.begin(), unindexed_ids.end());
+
+        // Encode each block's postings
+        std::vector<int64_t> values;
+        std::vector<char> encoded_buf;
+        std::vector<char> encoded_posting_blocks;
+        std::vector<int64_t> posting_block_lengths;
+        for (size_t block_begin_ix = 0; block_begin_ix < indexed_ids.size(); block_begin_ix += cNumIdsPerBlock) {
+            auto block_end_ix = std::min(block_begin_ix + cNumIdsPerBlock, indexed_ids.size());
+            values.clear();
+            auto append_column = [&] (uint64_t (*get_value)(const Posting&)) {
+                for (auto i = block_begin_ix; i < block_end_ix; ++i) {
+                    for (const auto& posting : m_id_to_postings.at(indexed_ids[i])) {
+                        values.push_back((int64_t)get_value(posting));
+                    }
+                }
+            };
+            append_column([] (const Posting& posting) { return posting.file_logtypes_pos; });
+            append_column([] (const Posting& posting) { return posting.begin_msg_ix; });
+            append_column([] (const Posting& posting) { return posting.end_msg_ix - posting.begin_msg_ix; });
+            append_column([] (const Posting& posting) { return posting.begin_variable_ix; });
+
+            encoded_buf.resize(column_encoding::get_max_delta_varints_length(values.size()));
+            auto encoded_length = column_encoding::encode_delta_varints(values.data(), values.size(), encoded_buf.data());
+            encoded_posting_blocks.insert(encoded_posting_blocks.end(), encoded_buf.cbegin(), encoded_buf.cbegin() + encoded_length);
+            posting_block_lengths.push_back((int64_t)encoded_length);
+        }
+
+        FileWriter file_writer;
+        file_writer.open(path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+        streaming_compression::zstd::Compressor compressor;
+        compressor.open(file_writer);
+
+        compressor.write_numeric_value<uint64_t>(m_num_messages);
+        compressor.write_numeric_value<uint64_t>(indexed_ids.size());
+        compressor.write_numeric_value<uint64_t>(unindexed_ids.size());
+
+        values.assign(indexed_ids.cbegin(), indexed_ids.cend());
+        write_delta_varints(values, encoded_buf, compressor);
+        values.clear();
+        for (auto id : indexed_ids) {
+            values.push_back((int64_t)m_id_to_postings.at(id).size());
+        }
+        write_delta_varints(values, encoded_buf, compressor);
+        values.assign(unindexed_ids.cbegin(), unindexed_ids.cend());
+        write_delta_varints(values, encoded_buf, compressor);
+        write_delta_varints(posting_block_lengths, encoded_buf, compressor);
+        compressor.write(encoded_posting_blocks.data(), encoded_posting_blocks.size());
+
+        compressor.close();
+        auto file_size = file_writer.get_pos();
+        file_writer.close();
+        return file_size;
+    }
+
+    template <typename DictionaryIdType>
+    ErrorCode Postings<DictionaryIdType>::try_read (const std::string& path) {
+        clear();
+
+        struct stat file_stat = {};
+        if (0 != stat(path.c_str(), &file_stat)) {
+            return (ENOENT == errno) ? ErrorCode_FileNotFound : ErrorCode_errno;
+        }
+        streaming_compression::zstd::Decompressor decompressor;
+        auto error_code = decompressor.open(path);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+
+        // NOTE: Since the file is written whole when its segment is closed, ending early means the file is damaged
+        uint64_t num_messages;
+        uint64_t num_indexed_ids;
+        uint64_t num_unindexed_ids;
+        for (auto value : {&num_messages, &num_indexed_ids, &num_unindexed_ids}) {
+            error_code = decompressor.try_read_numeric_value(*value);
+            if (ErrorCode_Success != error_code) {
+                return (ErrorCode_EndOfFile == error_code) ? ErrorCode_Truncated : error_code;
+            }
+        }
+
+        std::vector<char> encoded_buf;
+        std::vector<int64_t> values;
+        auto read_ids = [&] (size_t num_ids, std::vector<DictionaryIdType>& ids) {
+            auto error_code = try_read_delta_varints(decompressor, num_ids, encoded_buf, values);
+            if (ErrorCode_Success != error_code) {
+                return error_code;
+            }
+            ids.resize(num_ids);
+            for (size_t i = 0; i < num_ids; ++i) {
+                ids[i] = (DictionaryIdType)values[i];
+                if (i > 0 && ids[i] <= ids[i - 1]) {
+                    return ErrorCode_Corrupt;
+                }
+            }
+            return ErrorCode_Success;
+        };
+        if (ErrorCode_Success != (error_code = read_ids(num_indexed_ids, m_indexed_ids))) {
+            clear();
+            return error_code;
+        }
+
+        if (ErrorCode_Success != (error_code = try_read_delta_varints(decompressor, num_indexed_ids, encoded_buf, values))) {
+            clear();
+            return error_code;
+        }
+        m_indexed_id_postings_begin_ixs.resize(num_indexed_ids + 1);
+        m_indexed_id_postings_begin_ixs[0] = 0;
+        for (size_t i = 0; i < num_indexed_ids; ++i) {
+            // Each of an ID's postings contains at least one message
+            auto id_num_postings = (uint64_t)values[i];
+            if (0 == id_num_postings || id_num_postings > num_messages) {
+                clear();
+                return ErrorCode_Corrupt;
+            }
+            m_indexed_id_postings_begin_ixs[i + 1] = m_indexed_id_postings_begin_ixs[i] + id_num_postings;
+        }
+
+        if (ErrorCode_Success != (error_code = read_ids(num_unindexed_ids, m_unindexed_ids))) {
+            clear();
+            return error_code;
+        }
+
+        auto num_blocks = (num_indexed_ids + cNumIdsPerBlock - 1) / cNumIdsPerBlock;
+        if (ErrorCode_Success != (error_code = try_read_delta_varints(decompressor, num_blocks, encoded_buf, values))) {
+            clear();
+            return error_code;
+        }
+        m_posting_block_begin_offsets.resize(num_blocks + 1);
+        m_posting_block_begin_offsets[0] = 0;
+        for (size_t block_ix = 0; block_ix < num_blocks; ++block_ix) {
+            auto block_num_postings = m_indexed_id_postings_begin_ixs[std::min((block_ix + 1) * cNumIdsPerBlock, (size_t)num_indexed_ids)] -
+                                      m_indexed_id_postings_begin_ixs[block_ix * cNumIdsPerBlock];
+            auto block_length = (uint64_t)values[block_ix];
+            if (block_length > column_encoding::get_max_delta_varints_length(cNumPostingColumns * block_num_postings)) {
+                clear();
+                return ErrorCode_Corrupt;
+            }
+            m_posting_block_begin_offsets[block_ix + 1] = m_posting_block_begin_offsets[block_ix] + block_length;
+        }
+        m_encoded_posting_blocks.resize(m_posting_block_begin_offsets[num_blocks]);
+        if (false == m_encoded_posting_blocks.empty()) {
+            error_code = decompressor.try_read_exact_length(m_encoded_posting_blocks.data(), m_encoded_posting_blocks.size());
+            if (ErrorCode_Success != error_code) {
+                clear();
+                return (ErrorCode_EndOfFile == error_code) ? ErrorCode_Truncated : error_code;
+            }
+        }
+        m_num_messages = num_messages;
+
+        return ErrorCode_Success;
+    }
+
+    template <typename DictionaryIdType>
+    bool Postings<DictionaryIdType>::try_get_postings (const std::vector<DictionaryIdType>& ids, uint64_t file_logtypes_pos,
+                                                       std::vector<Posting>& postings) const
+    {
+        postings.clear();
+
+        // Estimate whether iterating over the postings is cheaper than scanning the segment's messages
+        size_t num_postings = 0;
+        std::vector<size_t> id_ixs;
+        for (auto id : ids) {
+            if (std::binary_search(m_unindexed_ids.cbegin(), m_unindexed_ids.cend(), id)) {
+                return false;
+            }
+            auto id_it = std::lower_bound(m_indexed_ids.cbegin(), m_indexed_ids.cend(), id);
+            if (m_indexed_ids.cend() != id_it && *id_it == id) {
+                size_t id_ix = id_it - m_indexed_ids.cbegin();
+                id_ixs.push_back(id_ix);
+                num_postings += m_indexed_id_postings_begin_ixs[id_ix + 1] - m_indexed_id_postings_begin_ixs[id_ix];
+            }
+        }
+        if (num_postings * cMinMessagesPerPosting > m_num_messages) {
+            return false;
+        }
+
+        std::vector<int64_t> values;
+        for (auto id_ix : id_ixs) {
+            // Decode the ID's block
+            auto block_ix = id_ix / cNumIdsPerBlock;
+            auto block_postings_begin_ix = m_indexed_id_postings_begin_ixs[block_ix * cNumIdsPerBlock];
+            auto block_num_postings = m_indexed_id_postings_begin_ixs[std::min((block_ix + 1) * cNumIdsPerBlock, m_indexed_ids.size())] -
+                                      block_postings_begin_ix;
+            values.resize(cNumPostingColumns * block_num_postings);
+            auto block_begin_offset = m_posting_block_begin_offsets[block_ix];
+            if (ErrorCode_Success != column_encoding::try_decode_delta_varints(m_encoded_posting_blocks.data() + block_begin_offset,
+                                                                               m_posting_block_begin_offsets[block_ix + 1] - block_begin_offset,
+                                                                               values.size(), values.data()))
+            {
+                postings.clear();
+                return false;
+            }
+
+            // Get the ID's postings in the file
+            uint64_t previous_file_logtypes_pos = 0;
+            for (auto i = m_indexed_id_postings_begin_ixs[id_ix] - block_postings_begin_ix;
+                 i < m_indexed_id_postings_begin_ixs[id_ix + 1] - block_postings_begin_ix; ++i)
+            {
+                Posting posting;
+                posting.file_logtypes_pos = (uint64_t)values[i];
+                posting.begin_msg_ix = (uint64_t)values[block_num_postings + i];
+                auto num_posting_messages = (uint64_t)values[2 * block_num_postings + i];
+                posting.begin_variable_ix = (uint64_t)values[3 * block_num_postings + i];
+                if (posting.begin_msg_ix > m_num_messages || 0 == num_posting_messages || num_posting_messages > m_num_messages - posting.begin_msg_ix ||
+                    posting.file_logtypes_pos < previous_file_logtypes_pos)
+                {
+                    postings.clear();
+                    return false;
+                }
+                posting.end_msg_ix = posting.begin_msg_ix + num_posting_messages;
+                if (posting.file_logtypes_pos > file_logtypes_pos) {
+                    break;
+                }
+                if (posting.file_logtypes_pos == file_logtypes_pos) {
+                    postings.push_back(posting);
+                }
+                previous_file_logtypes_pos = posting.file_logtypes_pos;
+            }
+        }
+        std::sort(postings.begin(), postings.end(), [] (const Posting& lhs, const Posting& rhs) { return lhs.begin_msg_ix < rhs.begin_msg_ix; });
+
+        // Merge overlapping postings, which occur when a message contains more than one of the IDs
+        size_t num_merged_postings = 0;
+        for (size_t i = 0; i < postings.size(); ++i) {
+            if (num_merged_postings > 0 && postings[i].begin_msg_ix < postings[num_merged_postings - 1].end_msg_ix) {
+                auto& merged_posting = postings[num_merged_postings - 1];
+                merged_posting.end_msg_ix = std::max(merged_posting.end_msg_ix, postings[i].end_msg_ix);
+            } else {
+                postings[num_merged_postings++] = postings[i];
+            }
+        }
+        postings.resize(num_merged_postings);
+
+        return true;
+    }
+
+    template <typename DictionaryIdType>
+    void Postings<DictionaryIdType>::write_delta_varints (const std::vector<int64_t>& values, std::vector<char>& encoded_buf,
+                                                          streaming_compression::zstd::Compressor& compressor)
+    {
+        encoded_buf.resize(column_encoding::get_max_delta_varints_length(values.size()));
+        auto encoded_length = column_encoding::encode_delta_varints(values.data(), values.size(), encoded_buf.data());
+        compressor.write_numeric_value<uint64_t>(encoded_length);
+        compressor.write(encoded_buf.data(), encoded_length);
+    }
+
+    template <typename DictionaryIdType>
+    ErrorCode Postings<DictionaryIdType>::try_read_delta_varints (streaming_compression::zstd::Decompressor& decompressor, size_t num_values,
+                                                                  std::vector<char>& encoded_buf, std::vector<int64_t>& values)
+    {
+        uint64_t encoded_length;
+        auto error_code = decompressor.try_read_numeric_value(encoded_length);
+        if (ErrorCode_Success != error_code) {
+            return (ErrorCode_EndOfFile == error_code) ? ErrorCode_Truncated : error_code;
+        }
+        if (encoded_length > column_encoding::get_max_delta_varints_length(num_values)) {
+            return ErrorCode_Corrupt;
+        }
+        encoded_buf.resize(encoded_length);
+        if (encoded_length > 0) {
+            error_code = decompressor.try_read_exact_length(encoded_buf.data(), encoded_length);
+            if (ErrorCode_Success != error_code) {
+                return (ErrorCode_EndOfFile == error_code) ? ErrorCode_Truncated : error_code;
+            }
+        }
+        values.resize(num_values);
+        return column_encoding::try_decode_delta_varints(encoded_buf.data(), encoded_length, num_values, values.data());
+    }
+}
+
+#endif // STREAMING_ARCHIVE_POSTINGS_HPP
@@ -75,7 +75,15 @@ namespace streaming_archive { namespace reader {
         }
 
         auto metadata_db_path = boost::filesystem::path(path) / cMetadataDBFileName;
-        m_metadata_db.open(metadata_db_path.string());
+        m_metadata_db.open(metadata_db_path.string(), false);
+
+        // Open the file table if the archive has one, so files can be iterated without querying the metadata database
+        auto file_table_path = boost::filesystem::path(path) / cFileTableFileName;
+        auto error_code = m_file_table.try_open(file_table_path.string());
+        if (ErrorCode_Success != error_code && ErrorCode_FileNotFound != error_code) {
+            SPDLOG_WARN("streaming_archive::reader::Archive: Failed to open file table {}, error={}, so falling back to the metadata database",
+                        file_table_path.c_str(), error_code);
+        }
 
         // Assemble logs directory path
         m_logs_dir_path = m_path;
@@ -119,6 +127,7 @@ namespace streaming_archive { namespace reader {
         m_segment_manager.close();
         m_segments_dir_path.clear();
         m_logs_dir_path.clear();
+        m_file_table.close();
         m_metadata_db.close();
         m_path.clear();
     }
@@ -132,10 +141,65 @@ namespace streaming_archive { namespace reader {
         PROFILER_FRAGMENTED_MEASUREMENT_STOP(VarDictRead)
     }
 
-    ErrorCode Archive::open_file (File& file, MetadataDB::FileIterator& file_metadata_ix, bool read_ahead) {
+    ErrorCode Archive::open_file (File& file, FileMetadataIterator& file_metadata_ix, bool read_ahead) {
         return file.open_me(m_logtype_dictionary, file_metadata_ix, read_ahead, m_logs_dir_path, m_segment_manager);
     }
 
+    bool Archive::file_may_match_queries (FileMetadataIterator& file_metadata_ix, vector<Query>& queries) {
+        auto segment_id = file_metadata_ix.get_segment_id();
+        if (cInvalidSegmentId == segment_id) {
+            return true;
+        }
+        const LogTypePostings* logtype_postings;
+        if (ErrorCode_Success != m_segment_manager.try_get_logtype_postings(segment_id, logtype_postings)) {
+            logtype_postings = nullptr;
+        }
+        const VariablePostings* variable_postings;
+        if (ErrorCode_Success != m_segment_manager.try_get_variable_postings(segment_id, variable_postings)) {
+            variable_postings = nullptr;
+        }
+        if (nullptr == logtype_postings && nullptr == variable_postings) {
+            return true;
+        }
+
+        auto file_logtypes_pos = file_metadata_ix.get_segment_logtypes_pos();
+        vector<logtype_dictionary_id_t> logtype_ids;
+        vector<variable_dictionary_id_t> var_ids;
+        vector<Posting> postings;
+        for (auto& query : queries) {
+            // Queries without sub-queries are matched by timestamp or decompressed content instead of by logtype
+            if (false == query.contains_sub_queries()) {
+                return true;
+            }
+            query.make_sub_queries_relevant_to_segment(segment_id);
+
+            // The query can't match if either kind of postings shows that the file has no messages it may match
+            if (nullptr != logtype_postings) {
+                query.get_relevant_possible_logtype_ids(logtype_ids);
+                if (logtype_postings->try_get_postings(logtype_ids, file_logtypes_pos, postings) && postings.empty()) {
+                    continue;
+                }
+            }
+            if (nullptr != variable_postings && query.get_relevant_dict_var_ids(var_ids) &&
+                variable_postings->try_get_postings(var_ids, file_logtypes_pos, postings) && postings.empty())
+            {
+                continue;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    std::unique_ptr<FileMetadataIterator> Archive::get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const string& file_path,
+                                                                      bool in_specific_segment, segment_id_t segment_id)
+    {
+        // NOTE: The table is deleted if the archive is reopened for appending after we opened it, in which case it's missing the appended files
+        if (m_file_table.is_current()) {
+            return m_file_table.get_file_iterator(begin_ts, end_ts, file_path, in_specific_segment, segment_id);
+        }
+        return std::make_unique<MetadataDB::FileIterator>(m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, in_specific_segment, segment_id));
+    }
+
     void Archive::close_file (File& file) {
         file.close_me();
     }
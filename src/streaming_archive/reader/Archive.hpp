@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 // Project headers
 #include "../../ErrorCode.hpp"
@@ -14,6 +15,8 @@
 #include "../../Query.hpp"
 #include "../../SQLiteDB.hpp"
 #include "../../VariableDictionaryReader.hpp"
+#include "../FileMetadataIterator.hpp"
+#include "../FileTable.hpp"
 #include "../MetadataDB.hpp"
 #include "File.hpp"
 #include "Message.hpp"
@@ -67,7 +70,16 @@ namespace streaming_archive { namespace reader {
          * @return Same as streaming_archive::reader::File::open_me
          * @throw Same as streaming_archive::reader::File::open_me
          */
-        ErrorCode open_file (File& file, MetadataDB::FileIterator& file_metadata_ix, bool read_ahead);
+        ErrorCode open_file (File& file, FileMetadataIterator& file_metadata_ix, bool read_ahead);
+        /**
+         * Checks whether any of the given queries may match a message in the file at the iterator's position, so that files which can't match don't
+         * need to be opened. The queries' relevant sub-queries are updated for the file's segment.
+         * @param file_metadata_ix
+         * @param queries
+         * @return false if the postings of the file's segment show that none of the file's messages has a logtype or dictionary variable the
+         * queries may match, true otherwise (including if the file isn't in a segment or its segment's postings can't be used)
+         */
+        bool file_may_match_queries (FileMetadataIterator& file_metadata_ix, std::vector<Query>& queries);
         /**
          * Wrapper for streaming_archive::reader::File::close_me
          * @param file
@@ -104,20 +116,42 @@ namespace streaming_archive { namespace reader {
 
         void decompress_empty_directories (const std::string& output_dir);
 
-        MetadataDB::FileIterator get_file_iterator () {
-            return m_metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId);
+        /**
+         * Wrapper for streaming_archive::MetadataDB::get_ids_of_segments_with_files
+         */
+        void get_ids_of_segments_with_files (segment_id_t min_segment_id, std::vector<segment_id_t>& segment_ids) {
+            m_metadata_db.get_ids_of_segments_with_files(min_segment_id, segment_ids);
         }
-        MetadataDB::FileIterator get_file_iterator (const std::string& file_path) {
-            return m_metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, file_path, false, cInvalidSegmentId);
+
+        std::unique_ptr<FileMetadataIterator> get_file_iterator () {
+            return get_file_iterator(cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId);
         }
-        MetadataDB::FileIterator get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path) {
-            return m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, false, cInvalidSegmentId);
+        std::unique_ptr<FileMetadataIterator> get_file_iterator (const std::string& file_path) {
+            return get_file_iterator(cEpochTimeMin, cEpochTimeMax, file_path, false, cInvalidSegmentId);
         }
-        MetadataDB::FileIterator get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path, segment_id_t segment_id) {
-            return m_metadata_db.get_file_iterator(begin_ts, end_ts, file_path, true, segment_id);
+        std::unique_ptr<FileMetadataIterator> get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path) {
+            return get_file_iterator(begin_ts, end_ts, file_path, false, cInvalidSegmentId);
+        }
+        std::unique_ptr<FileMetadataIterator> get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path,
+                                                                 segment_id_t segment_id)
+        {
+            return get_file_iterator(begin_ts, end_ts, file_path, true, segment_id);
         }
 
     private:
+        // Methods
+        /**
+         * Gets an iterator over the files matching the given filters from the file table if it's current, or from the metadata database otherwise
+         * @param begin_ts
+         * @param end_ts
+         * @param file_path
+         * @param in_specific_segment
+         * @param segment_id
+         * @return The iterator
+         */
+        std::unique_ptr<FileMetadataIterator> get_file_iterator (epochtime_t begin_ts, epochtime_t end_ts, const std::string& file_path,
+                                                                 bool in_specific_segment, segment_id_t segment_id);
+
         // Variables
         std::string m_id;
         std::string m_path;
@@ -129,6 +163,7 @@ namespace streaming_archive { namespace reader {
         SegmentManager m_segment_manager;
 
         MetadataDB m_metadata_db;
+        FileTable m_file_table;
     };
 } }
 
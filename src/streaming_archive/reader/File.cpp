@@ -6,6 +6,7 @@
 #include <unistd.h>
 
 // C++ libraries
+#include <algorithm>
 #include <cassert>
 
 // spdlog
@@ -29,53 +30,20 @@ namespace streaming_archive { namespace reader {
         return m_end_ts;
     }
 
-    ErrorCode File::open_me (const LogTypeDictionaryReader& archive_logtype_dict, MetadataDB::FileIterator& file_metadata_ix, bool read_ahead,
+    ErrorCode File::open_me (const LogTypeDictionaryReader& archive_logtype_dict, FileMetadataIterator& file_metadata_ix, bool read_ahead,
             const string& archive_logs_dir_path, SegmentManager& segment_manager)
     {
         m_archive_logtype_dict = &archive_logtype_dict;
+        m_segment_manager = &segment_manager;
 
-        // Populate metadata from database document
+        // Populate metadata
         file_metadata_ix.get_id(m_id_as_string);
         file_metadata_ix.get_orig_file_id(m_orig_file_id_as_string);
         file_metadata_ix.get_path(m_orig_path);
         m_begin_ts = file_metadata_ix.get_begin_ts();
         m_end_ts = file_metadata_ix.get_end_ts();
 
-        string encoded_timestamp_patterns;
-        file_metadata_ix.get_timestamp_patterns(encoded_timestamp_patterns);
-        size_t begin_pos = 0;
-        size_t end_pos;
-        string timestamp_format;
-        while (true) {
-            end_pos = encoded_timestamp_patterns.find_first_of(':', begin_pos);
-            if (string::npos == end_pos) {
-                // Done
-                break;
-            }
-            size_t msg_num = strtoull(&encoded_timestamp_patterns[begin_pos], nullptr, 10);
-            begin_pos = end_pos + 1;
-
-            end_pos = encoded_timestamp_patterns.find_first_of(':', begin_pos);
-            if (string::npos == end_pos) {
-                // Unexpected truncation
-                throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
-            }
-            uint8_t num_spaces_before_ts = strtol(&encoded_timestamp_patterns[begin_pos], nullptr, 10);
-            begin_pos = end_pos + 1;
-
-            end_pos = encoded_timestamp_patterns.find_first_of('\n', begin_pos);
-            if (string::npos == end_pos) {
-                // Unexpected truncation
-                throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
-            }
-            timestamp_format.assign(encoded_timestamp_patterns, begin_pos, end_pos - begin_pos);
-            begin_pos = end_pos + 1;
-
-            m_timestamp_patterns.emplace_back(
-                    std::piecewise_construct,
-                    std::forward_as_tuple(msg_num),
-                    forward_as_tuple(num_spaces_before_ts, timestamp_format));
-        }
+        file_metadata_ix.get_timestamp_patterns(m_timestamp_patterns);
 
         m_num_messages = file_metadata_ix.get_num_messages();
         m_num_variables = file_metadata_ix.get_num_variables();
@@ -94,7 +62,6 @@ namespace streaming_archive { namespace reader {
         ErrorCode error_code;
 
         if (m_is_in_segment) {
-            uint64_t num_bytes_to_read;
             Stopwatch segment_read_stopwatch;
             Stopwatch columns_alloc_stopwatch;
 
@@ -108,10 +75,9 @@ namespace streaming_archive { namespace reader {
                     m_num_segment_msgs = m_num_messages;
                 }
 
-                num_bytes_to_read = m_num_messages*sizeof(epochtime_t);
                 PROFILER_START_STOPWATCH(segment_read_stopwatch)
-                error_code = segment_manager.try_read(m_segment_id, m_segment_timestamps_decompressed_stream_pos,
-                                                      reinterpret_cast<char*>(m_segment_timestamps.get()), num_bytes_to_read);
+                error_code = segment_manager.try_read_timestamps(m_segment_id, m_segment_timestamps_decompressed_stream_pos, m_segment_timestamps.get(),
+                                                                 m_num_messages);
                 PROFILER_STOP_STOPWATCH(segment_read_stopwatch)
                 if (ErrorCode_Success != error_code) {
                     close_me();
@@ -119,10 +85,9 @@ namespace streaming_archive { namespace reader {
                 }
                 m_timestamps = m_segment_timestamps.get();
 
-                num_bytes_to_read = m_num_messages*sizeof(logtype_dictionary_id_t);
                 PROFILER_START_STOPWATCH(segment_read_stopwatch)
-                error_code = segment_manager.try_read(m_segment_id, m_segment_logtypes_decompressed_stream_pos,
-                                                      reinterpret_cast<char*>(m_segment_logtypes.get()), num_bytes_to_read);
+                error_code = segment_manager.try_read_logtype_ids(m_segment_id, m_segment_logtypes_decompressed_stream_pos, m_segment_logtypes.get(),
+                                                                  m_num_messages, m_message_numbers);
                 PROFILER_STOP_STOPWATCH(segment_read_stopwatch)
                 if (ErrorCode_Success != error_code) {
                     close_me();
@@ -139,10 +104,9 @@ namespace streaming_archive { namespace reader {
                     PROFILER_STOP_STOPWATCH(columns_alloc_stopwatch)
                     m_num_segment_vars = m_num_variables;
                 }
-                num_bytes_to_read = m_num_variables*sizeof(encoded_variable_t);
                 PROFILER_START_STOPWATCH(segment_read_stopwatch)
-                error_code = segment_manager.try_read(m_segment_id, m_segment_variables_decompressed_stream_pos,
-                                                      reinterpret_cast<char*>(m_segment_variables.get()), num_bytes_to_read);
+                error_code = segment_manager.try_read_variables(m_segment_id, m_segment_variables_decompressed_stream_pos, m_segment_variables.get(),
+                                                                m_num_variables);
                 PROFILER_STOP_STOPWATCH(segment_read_stopwatch)
                 if (ErrorCode_Success != error_code) {
                     close_me();
@@ -151,6 +115,14 @@ namespace streaming_archive { namespace reader {
                 m_variables = m_segment_variables.get();
             }
 
+            if (false == m_message_numbers.empty()) {
+                error_code = find_logtype_groups();
+                if (ErrorCode_Success != error_code) {
+                    close_me();
+                    return error_code;
+                }
+            }
+
             PROFILER_FRAGMENTED_MEASUREMENT_INCREMENT(SegmentRead, segment_read_stopwatch.get_time_taken_in_nanoseconds())
             PROFILER_FRAGMENTED_MEASUREMENT_INCREMENT(ColumnsAlloc, columns_alloc_stopwatch.get_time_taken_in_nanoseconds())
         } else {
@@ -277,12 +249,26 @@ namespace streaming_archive { namespace reader {
         m_end_ts = cEpochTimeMin;
         m_orig_path.clear();
 
+        m_message_numbers.clear();
+        m_logtype_groups.clear();
+        m_logtype_group_cursors.clear();
+        m_logtype_group_cursors_are_initialized = false;
+
+        m_postings.clear();
+        m_postings_ix = 0;
+        m_postings_are_initialized = false;
+        m_search_postings = false;
+
         m_archive_logtype_dict = nullptr;
+        m_segment_manager = nullptr;
     }
 
     void File::reset_indices () {
         m_msgs_ix = 0;
         m_variables_ix = 0;
+        m_logtype_group_cursors.clear();
+        m_logtype_group_cursors_are_initialized = false;
+        m_postings_are_initialized = false;
     }
 
     const string& File::get_orig_path () const {
@@ -305,6 +291,10 @@ namespace streaming_archive { namespace reader {
     }
 
     bool File::find_message_in_time_range (epochtime_t search_begin_timestamp, epochtime_t search_end_timestamp, Message& msg) {
+        if (false == m_message_numbers.empty() && false == restore_original_message_order()) {
+            return false;
+        }
+
         bool found_msg = false;
         while (m_msgs_ix < m_num_messages && !found_msg) {
             // Get logtype
@@ -349,8 +339,28 @@ namespace streaming_archive { namespace reader {
     }
 
     const SubQuery* File::find_message_matching_query (const Query& query, Message& msg) {
+        if (false == m_message_numbers.empty()) {
+            return find_message_matching_query_in_logtype_groups(query, msg);
+        }
+        if (false == m_postings_are_initialized) {
+            find_postings_matching_query(query);
+        }
+
         const SubQuery* matching_sub_query = nullptr;
         while (m_msgs_ix < m_num_messages && nullptr == matching_sub_query) {
+            if (m_search_postings) {
+                // Skip to the next posting that contains unsearched messages
+                for (; m_postings_ix < m_postings.size() && m_postings[m_postings_ix].end_msg_ix <= m_msgs_ix; ++m_postings_ix) {}
+                if (m_postings.size() == m_postings_ix) {
+                    break;
+                }
+                const auto& posting = m_postings[m_postings_ix];
+                if (m_msgs_ix < posting.begin_msg_ix) {
+                    m_msgs_ix = posting.begin_msg_ix;
+                    m_variables_ix = posting.begin_variable_ix;
+                }
+            }
+
             auto logtype_id = m_logtypes[m_msgs_ix];
 
             // Get number of variables in logtype
@@ -400,6 +410,9 @@ namespace streaming_archive { namespace reader {
     }
 
     bool File::get_next_message (Message& msg) {
+        if (false == m_message_numbers.empty() && false == restore_original_message_order()) {
+            return false;
+        }
         if (m_msgs_ix >= m_num_messages) {
             return false;
         }
@@ -431,4 +444,178 @@ namespace streaming_archive { namespace reader {
 
         return true;
     }
-} }
\ No newline at end of file
+
+    void File::find_postings_matching_query (const Query& query) {
+        m_postings.clear();
+        m_postings_ix = 0;
+        m_postings_are_initialized = true;
+        m_search_postings = false;
+
+        if (false == m_is_in_segment) {
+            return;
+        }
+
+        // Use whichever of the logtype and variable postings leaves fewer runs to search
+        const LogTypePostings* logtype_postings;
+        if (ErrorCode_Success == m_segment_manager->try_get_logtype_postings(m_segment_id, logtype_postings)) {
+            vector<logtype_dictionary_id_t> logtype_ids;
+            query.get_relevant_possible_logtype_ids(logtype_ids);
+            m_search_postings = logtype_postings->try_get_postings(logtype_ids, m_segment_logtypes_decompressed_stream_pos, m_postings);
+        }
+        const VariablePostings* variable_postings;
+        vector<variable_dictionary_id_t> var_ids;
+        vector<Posting> var_postings;
+        if (ErrorCode_Success == m_segment_manager->try_get_variable_postings(m_segment_id, variable_postings) &&
+            query.get_relevant_dict_var_ids(var_ids) &&
+            variable_postings->try_get_postings(var_ids, m_segment_logtypes_decompressed_stream_pos, var_postings) &&
+            (false == m_search_postings || var_postings.size() < m_postings.size()))
+        {
+            m_postings = std::move(var_postings);
+            m_search_postings = true;
+        }
+        if (false == m_search_postings) {
+            m_postings.clear();
+            return;
+        }
+
+        for (const auto& posting : m_postings) {
+            if (posting.end_msg_ix > m_num_messages || posting.begin_variable_ix > m_num_variables) {
+                SPDLOG_WARN("streaming_archive::reader::File: Ignoring postings of {} that don't match its metadata.", m_orig_path.c_str());
+                m_postings.clear();
+                m_search_postings = false;
+                return;
+            }
+        }
+    }
+
+    ErrorCode File::find_logtype_groups () {
+        m_logtype_groups.clear();
+        size_t variables_ix = 0;
+        for (size_t msgs_ix = 0; msgs_ix < m_num_messages;) {
+            LogtypeGroup group;
+            group.logtype_id = m_logtypes[msgs_ix];
+            group.num_vars = m_archive_logtype_dict->get_entry(group.logtype_id).get_num_vars();
+            group.begin_msg_ix = msgs_ix;
+            group.begin_variable_ix = variables_ix;
+            for (; msgs_ix < m_num_messages && m_logtypes[msgs_ix] == group.logtype_id; ++msgs_ix) {}
+            group.end_msg_ix = msgs_ix;
+
+            variables_ix += (group.end_msg_ix - group.begin_msg_ix) * group.num_vars;
+            if (variables_ix > m_num_variables) {
+                SPDLOG_ERROR("streaming_archive::reader::File: Logtype groups need more variables than the metadata ({}) indicates.", m_num_variables);
+                return ErrorCode_Truncated;
+            }
+            m_logtype_groups.push_back(group);
+        }
+        return ErrorCode_Success;
+    }
+
+    const SubQuery* File::find_message_matching_query_in_logtype_groups (const Query& query, Message& msg) {
+        // Orders cursors so that the heap's front is the cursor whose next message came first
+        auto cursor_is_later = [this] (const LogtypeGroup& lhs, const LogtypeGroup& rhs) {
+            return m_message_numbers[lhs.begin_msg_ix] > m_message_numbers[rhs.begin_msg_ix];
+        };
+
+        if (false == m_logtype_group_cursors_are_initialized) {
+            m_logtype_group_cursors.clear();
+            for (const auto& group : m_logtype_groups) {
+                for (auto sub_query : query.get_relevant_sub_queries()) {
+                    if (sub_query->matches_logtype(group.logtype_id)) {
+                        m_logtype_group_cursors.push_back(group);
+                        break;
+                    }
+                }
+            }
+            std::make_heap(m_logtype_group_cursors.begin(), m_logtype_group_cursors.end(), cursor_is_later);
+            m_logtype_group_cursors_are_initialized = true;
+        }
+
+        while (false == m_logtype_group_cursors.empty()) {
+            // Take the next message from the earliest cursor and advance the cursor
+            std::pop_heap(m_logtype_group_cursors.begin(), m_logtype_group_cursors.end(), cursor_is_later);
+            auto& cursor = m_logtype_group_cursors.back();
+            auto logtype_id = cursor.logtype_id;
+            auto num_vars = cursor.num_vars;
+            auto msgs_ix = cursor.begin_msg_ix;
+            auto variables_ix = cursor.begin_variable_ix;
+            ++cursor.begin_msg_ix;
+            cursor.begin_variable_ix += num_vars;
+            if (cursor.begin_msg_ix < cursor.end_msg_ix) {
+                std::push_heap(m_logtype_group_cursors.begin(), m_logtype_group_cursors.end(), cursor_is_later);
+            } else {
+                m_logtype_group_cursors.pop_back();
+            }
+
+            auto timestamp = m_timestamps[msgs_ix];
+            if (false == query.timestamp_is_in_search_time_range(timestamp)) {
+                continue;
+            }
+
+            msg.clear_vars();
+            for (size_t i = 0; i < num_vars; ++i) {
+                msg.add_var(m_variables[variables_ix + i]);
+            }
+            for (auto sub_query : query.get_relevant_sub_queries()) {
+                if (sub_query->matches_logtype(logtype_id) && sub_query->matches_vars(msg.get_vars())) {
+                    // Message matches completely, so set remaining properties
+                    msg.set_logtype_id(logtype_id);
+                    msg.set_timestamp(timestamp);
+                    msg.set_message_number(m_message_numbers[msgs_ix]);
+                    return sub_query;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool File::restore_original_message_order () {
+        auto timestamps = make_unique<epochtime_t[]>(m_num_messages);
+        auto logtypes = make_unique<logtype_dictionary_id_t[]>(m_num_messages);
+        for (size_t msgs_ix = 0; msgs_ix < m_num_messages; ++msgs_ix) {
+            auto message_number = m_message_numbers[msgs_ix];
+            if (message_number >= m_num_messages) {
+                return false;
+            }
+            timestamps[message_number] = m_timestamps[msgs_ix];
+            logtypes[message_number] = m_logtypes[msgs_ix];
+        }
+
+        // Find where each message's variables begin in the original order, and then move each group's variables there
+        vector<size_t> variable_begin_ixs(m_num_messages);
+        size_t num_variables = 0;
+        for (size_t message_number = 0; message_number < m_num_messages; ++message_number) {
+            variable_begin_ixs[message_number] = num_variables;
+            num_variables += m_archive_logtype_dict->get_entry(logtypes[message_number]).get_num_vars();
+        }
+        if (num_variables > m_num_variables) {
+            return false;
+        }
+        auto variables = make_unique<encoded_variable_t[]>(m_num_variables);
+        for (const auto& group : m_logtype_groups) {
+            auto variables_ix = group.begin_variable_ix;
+            for (auto msgs_ix = group.begin_msg_ix; msgs_ix < group.end_msg_ix; ++msgs_ix, variables_ix += group.num_vars) {
+                auto variable_begin_ix = variable_begin_ixs[m_message_numbers[msgs_ix]];
+                if (variable_begin_ix + group.num_vars > m_num_variables) {
+                    return false;
+                }
+                std::copy(m_variables + variables_ix, m_variables + variables_ix + group.num_vars, variables.get() + variable_begin_ix);
+            }
+        }
+
+        m_segment_timestamps = std::move(timestamps);
+        m_segment_logtypes = std::move(logtypes);
+        m_num_segment_msgs = m_num_messages;
+        m_timestamps = m_segment_timestamps.get();
+        m_logtypes = m_segment_logtypes.get();
+        m_segment_variables = std::move(variables);
+        m_num_segment_vars = m_num_variables;
+        m_variables = m_segment_variables.get();
+
+        m_message_numbers.clear();
+        m_logtype_groups.clear();
+        m_logtype_group_cursors.clear();
+        m_logtype_group_cursors_are_initialized = false;
+        return true;
+    }
+} }
@@ -12,7 +12,7 @@
 #include "../../LogTypeDictionaryReader.hpp"
 #include "../../Query.hpp"
 #include "../../TimestampPattern.hpp"
-#include "../MetadataDB.hpp"
+#include "../FileMetadataIterator.hpp"
 #include "Message.hpp"
 #include "SegmentManager.hpp"
 
@@ -34,6 +34,7 @@ namespace streaming_archive { namespace reader {
         // Constructors
         File () :
             m_archive_logtype_dict(nullptr),
+            m_segment_manager(nullptr),
             m_begin_ts(cEpochTimeMax),
             m_end_ts(cEpochTimeMin),
             m_is_in_segment(false),
@@ -56,7 +57,11 @@ namespace streaming_archive { namespace reader {
             m_variables_file_size(0),
             m_variables(nullptr),
             m_current_ts_pattern_ix(0),
-            m_current_ts_in_milli(0)
+            m_current_ts_in_milli(0),
+            m_logtype_group_cursors_are_initialized(false),
+            m_postings_ix(0),
+            m_postings_are_initialized(false),
+            m_search_postings(false)
         {}
 
         // Methods
@@ -73,6 +78,18 @@ namespace streaming_archive { namespace reader {
     private:
         friend class Archive;
 
+        // Types
+        /**
+         * A run of consecutive messages with the same logtype, in a file whose messages are grouped by logtype
+         */
+        struct LogtypeGroup {
+            logtype_dictionary_id_t logtype_id;
+            size_t num_vars;
+            size_t begin_msg_ix;
+            size_t end_msg_ix;
+            size_t begin_variable_ix;
+        };
+
         // Methods
         /**
          * Opens file
@@ -90,7 +107,7 @@ namespace streaming_archive { namespace reader {
          * @throw FileReader::OperationFailed on any read failure
          * @throw Same as streaming_archive::reader::SegmentManager::read
          */
-        ErrorCode open_me (const LogTypeDictionaryReader& archive_logtype_dict, MetadataDB::FileIterator& file_metadata_ix, bool read_ahead,
+        ErrorCode open_me (const LogTypeDictionaryReader& archive_logtype_dict, FileMetadataIterator& file_metadata_ix, bool read_ahead,
                 const std::string& archive_logs_dir_path, SegmentManager& segment_manager);
         /**
          * Closes the file
@@ -116,7 +133,8 @@ namespace streaming_archive { namespace reader {
          */
         bool find_message_in_time_range (epochtime_t search_begin_timestamp, epochtime_t search_end_timestamp, Message& msg);
         /**
-         * Finds message matching the given query
+         * Finds message matching the given query. If the postings of the file's segment show that it's cheaper, only the runs of messages whose
+         * logtypes match the query are scanned.
          * @param query
          * @param msg
          * @return nullptr if no message matched
@@ -130,8 +148,36 @@ namespace streaming_archive { namespace reader {
          */
         bool get_next_message (Message& msg);
 
+        /**
+         * Finds the postings of the logtypes or dictionary variables that the given query's relevant sub-queries may match (whichever are more
+         * selective), if the file's segment has postings and using them is cheaper than scanning the file
+         * @param query
+         */
+        void find_postings_matching_query (const Query& query);
+        /**
+         * Finds the runs of messages with the same logtype in a file whose messages are grouped by logtype
+         * @return ErrorCode_Truncated if the groups need more variables than the file has
+         * @return ErrorCode_Success on success
+         */
+        ErrorCode find_logtype_groups ();
+        /**
+         * Finds message matching the given query in a file whose messages are grouped by logtype. Only the groups whose logtypes match the query are
+         * scanned, and they're merged so that messages are still found in their original order.
+         * @param query
+         * @param msg
+         * @return nullptr if no message matched
+         * @return pointer to matching subquery otherwise
+         */
+        const SubQuery* find_message_matching_query_in_logtype_groups (const Query& query, Message& msg);
+        /**
+         * Reorders the columns of a file whose messages are grouped by logtype into the messages' original order, so they can be read sequentially
+         * @return false if the original message numbers are inconsistent with the columns, true otherwise
+         */
+        bool restore_original_message_order ();
+
         // Variables
         const LogTypeDictionaryReader* m_archive_logtype_dict;
+        SegmentManager* m_segment_manager;
 
         epochtime_t m_begin_ts;
         epochtime_t m_end_ts;
@@ -171,6 +217,19 @@ namespace streaming_archive { namespace reader {
         size_t m_current_ts_pattern_ix;
         epochtime_t m_current_ts_in_milli;
 
+        // Original message number of each message, if the file's messages are grouped by logtype
+        std::vector<uint64_t> m_message_numbers;
+        std::vector<LogtypeGroup> m_logtype_groups;
+        // Remaining messages of each group being searched, kept as a heap ordered by the original message number of the group's next message
+        std::vector<LogtypeGroup> m_logtype_group_cursors;
+        bool m_logtype_group_cursors_are_initialized;
+
+        // Runs of messages whose logtypes match the current query, if they're searched instead of scanning every message
+        std::vector<Posting> m_postings;
+        size_t m_postings_ix;
+        bool m_postings_are_initialized;
+        bool m_search_postings;
+
         size_t m_split_ix;
         bool m_is_split;
     };
@@ -6,6 +6,7 @@
 
 // C++ standard libraries
 #include <climits>
+#include <cstring>
 
 // Boost libraries
 #include <boost/filesystem.hpp>
@@ -15,11 +16,13 @@
 
 // Project headers
 #include "../../FileReader.hpp"
+#include "../ColumnEncoding.hpp"
 
 using std::make_unique;
 using std::string;
 using std::to_string;
 using std::unique_ptr;
+using std::vector;
 
 namespace streaming_archive { namespace reader {
     Segment::~Segment () {
@@ -75,6 +78,10 @@ namespace streaming_archive { namespace reader {
             m_decompressor.close();
             m_memory_mapped_segment_file.close();
             m_segment_path.clear();
+            m_logtype_postings.clear();
+            m_logtype_postings_error_code = ErrorCode_NotReady;
+            m_variable_postings.clear();
+            m_variable_postings_error_code = ErrorCode_NotReady;
         }
     }
 
@@ -86,4 +93,111 @@ namespace streaming_archive { namespace reader {
         }
         return m_decompressor.get_decompressed_stream_region(decompressed_stream_pos, extraction_buf, extraction_len);
     }
+
+    ErrorCode Segment::try_read_timestamps (uint64_t decompressed_stream_pos, epochtime_t* timestamps, size_t num_timestamps) {
+        uint64_t encoded_length;
+        auto error_code = try_read_encoded_column(decompressed_stream_pos, encoded_length);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        return column_encoding::try_decode_delta_varints(m_decoding_buf.get(), encoded_length, num_timestamps, timestamps);
+    }
+
+    ErrorCode Segment::try_read_logtype_ids (uint64_t decompressed_stream_pos, logtype_dictionary_id_t* logtype_ids, size_t num_logtype_ids,
+                                             vector<uint64_t>& message_numbers)
+    {
+        message_numbers.clear();
+
+        uint64_t encoded_length;
+        auto error_code = try_read_encoded_column(decompressed_stream_pos, encoded_length);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        if (encoded_length < sizeof(column_encoding::MessageOrder)) {
+            return ErrorCode_Truncated;
+        }
+        auto encoded_buf = m_decoding_buf.get();
+        auto message_order = (column_encoding::MessageOrder)encoded_buf[0];
+        encoded_buf += sizeof(column_encoding::MessageOrder);
+        encoded_length -= sizeof(column_encoding::MessageOrder);
+
+        if (column_encoding::MessageOrder::Arrival == message_order) {
+            return column_encoding::try_bit_unpack(encoded_buf, encoded_length, num_logtype_ids, logtype_ids);
+        }
+        if (column_encoding::MessageOrder::GroupedByLogtype != message_order) {
+            return ErrorCode_Corrupt;
+        }
+
+        uint64_t logtype_ids_length;
+        if (encoded_length < sizeof(logtype_ids_length)) {
+            return ErrorCode_Truncated;
+        }
+        memcpy(&logtype_ids_length, encoded_buf, sizeof(logtype_ids_length));
+        encoded_buf += sizeof(logtype_ids_length);
+        encoded_length -= sizeof(logtype_ids_length);
+        if (encoded_length < logtype_ids_length) {
+            return ErrorCode_Truncated;
+        }
+        error_code = column_encoding::try_bit_unpack(encoded_buf, logtype_ids_length, num_logtype_ids, logtype_ids);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+
+        message_numbers.resize(num_logtype_ids);
+        error_code = column_encoding::try_decode_delta_varints(encoded_buf + logtype_ids_length, encoded_length - logtype_ids_length, num_logtype_ids,
+                                                               reinterpret_cast<int64_t*>(message_numbers.data()));
+        if (ErrorCode_Success != error_code) {
+            message_numbers.clear();
+        }
+        return error_code;
+    }
+
+    ErrorCode Segment::try_read_variables (uint64_t decompressed_stream_pos, encoded_variable_t* variables, size_t num_variables) {
+        uint64_t encoded_length;
+        auto error_code = try_read_encoded_column(decompressed_stream_pos, encoded_length);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        if (num_variables > m_scratch_buf_size) {
+            m_scratch_buf = unique_ptr<int64_t[]>(new int64_t[num_variables]);
+            m_scratch_buf_size = num_variables;
+        }
+        return column_encoding::try_decode_variables(m_decoding_buf.get(), encoded_length, num_variables, m_scratch_buf.get(), variables);
+    }
+
+    ErrorCode Segment::try_get_logtype_postings (const LogTypePostings*& logtype_postings) {
+        read_postings_if_necessary(cLogTypePostingsFileExtension, m_logtype_postings, m_logtype_postings_error_code);
+        logtype_postings = &m_logtype_postings;
+        return m_logtype_postings_error_code;
+    }
+
+    ErrorCode Segment::try_get_variable_postings (const VariablePostings*& variable_postings) {
+        read_postings_if_necessary(cVariablePostingsFileExtension, m_variable_postings, m_variable_postings_error_code);
+        variable_postings = &m_variable_postings;
+        return m_variable_postings_error_code;
+    }
+
+    template <typename PostingsType>
+    void Segment::read_postings_if_necessary (const char* file_extension, PostingsType& postings, ErrorCode& error_code) {
+        if (ErrorCode_NotReady != error_code) {
+            return;
+        }
+        error_code = postings.try_read(m_segment_path + file_extension);
+        // NOTE: Postings are optional, so it's only worth warning if they exist but can't be read
+        if (ErrorCode_Success != error_code && ErrorCode_FileNotFound != error_code) {
+            SPDLOG_WARN("streaming_archive::reader::Segment: Failed to read {} of {}, error={}", file_extension, m_segment_path.c_str(), error_code);
+        }
+    }
+
+    ErrorCode Segment::try_read_encoded_column (uint64_t decompressed_stream_pos, uint64_t& encoded_length) {
+        auto error_code = try_read(decompressed_stream_pos, reinterpret_cast<char*>(&encoded_length), sizeof(encoded_length));
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        if (encoded_length > m_decoding_buf_size) {
+            m_decoding_buf = unique_ptr<char[]>(new char[encoded_length]);
+            m_decoding_buf_size = encoded_length;
+        }
+        return try_read(decompressed_stream_pos + sizeof(encoded_length), m_decoding_buf.get(), encoded_length);
+    }
 } }
@@ -4,6 +4,7 @@
 // C++ standard libraries
 #include <memory>
 #include <string>
+#include <vector>
 
 // Boost libraries
 #include <boost/iostreams/device/mapped_file.hpp>
@@ -14,6 +15,7 @@
 #include "../../streaming_compression/passthrough/Decompressor.hpp"
 #include "../../streaming_compression/zstd/Decompressor.hpp"
 #include "../Constants.hpp"
+#include "../Postings.hpp"
 
 namespace streaming_archive { namespace reader {
     /**
@@ -22,7 +24,8 @@ namespace streaming_archive { namespace reader {
     class Segment {
     public:
         // Constructor
-        Segment () : m_segment_path({}) {};
+        Segment () : m_segment_path({}), m_decoding_buf_size(0), m_scratch_buf_size(0), m_logtype_postings_error_code(ErrorCode_NotReady),
+                m_variable_postings_error_code(ErrorCode_NotReady) {};
 
         // Destructor
         ~Segment ();
@@ -51,8 +54,75 @@ namespace streaming_archive { namespace reader {
          * @return ErrorCode_Success on success
          */
         ErrorCode try_read (uint64_t decompressed_stream_pos, char* extraction_buf, uint64_t extraction_len);
+        /**
+         * Reads and decodes a timestamps column appended by streaming_archive::writer::Segment::append_timestamps
+         * @param decompressed_stream_pos Offset of the column in the segment
+         * @param timestamps
+         * @param num_timestamps
+         * @return Same as streaming_archive::reader::Segment::try_read_encoded_column
+         * @return Same as column_encoding::try_decode_delta_varints
+         */
+        ErrorCode try_read_timestamps (uint64_t decompressed_stream_pos, epochtime_t* timestamps, size_t num_timestamps);
+        /**
+         * Reads and decodes a logtype IDs column appended by streaming_archive::writer::Segment::append_logtype_ids or
+         * streaming_archive::writer::Segment::append_grouped_logtype_ids
+         * @param decompressed_stream_pos Offset of the column in the segment
+         * @param logtype_ids
+         * @param num_logtype_ids
+         * @param message_numbers Returns the original message number of each logtype ID if the messages are grouped by logtype, or is cleared if
+         * they're in arrival order
+         * @return ErrorCode_Truncated if the column is truncated
+         * @return ErrorCode_Corrupt if the column's message order is invalid
+         * @return Same as streaming_archive::reader::Segment::try_read_encoded_column
+         * @return Same as column_encoding::try_bit_unpack and column_encoding::try_decode_delta_varints
+         */
+        ErrorCode try_read_logtype_ids (uint64_t decompressed_stream_pos, logtype_dictionary_id_t* logtype_ids, size_t num_logtype_ids,
+                                        std::vector<uint64_t>& message_numbers);
+        /**
+         * Reads a variables column appended by streaming_archive::writer::Segment::append_variables and reassembles its type-split streams
+         * @param decompressed_stream_pos Offset of the column in the segment
+         * @param variables
+         * @param num_variables
+         * @return Same as streaming_archive::reader::Segment::try_read_encoded_column
+         * @return Same as column_encoding::try_decode_variables
+         */
+        ErrorCode try_read_variables (uint64_t decompressed_stream_pos, encoded_variable_t* variables, size_t num_variables);
+        /**
+         * Gets the segment's logtype postings, reading them the first time they're needed
+         * @param logtype_postings Returns the postings, which remain valid until the segment is closed
+         * @return Same as streaming_archive::Postings::try_read
+         */
+        ErrorCode try_get_logtype_postings (const LogTypePostings*& logtype_postings);
+        /**
+         * Gets the segment's variable postings, reading them the first time they're needed
+         * @param variable_postings Returns the postings, which remain valid until the segment is closed
+         * @return Same as streaming_archive::Postings::try_read
+         */
+        ErrorCode try_get_variable_postings (const VariablePostings*& variable_postings);
 
     private:
+        // Methods
+        /**
+         * Reads the segment's postings with the given file extension, if they haven't been read yet
+         * @tparam PostingsType
+         * @param file_extension
+         * @param postings
+         * @param error_code The result of reading the postings, or ErrorCode_NotReady if they haven't been read yet
+         */
+        template <typename PostingsType>
+        void read_postings_if_necessary (const char* file_extension, PostingsType& postings, ErrorCode& error_code);
+
+        // Variables
+        // Methods
+        /**
+         * Reads an encoded column, which is prefixed with its length, into the decoding buffer
+         * @param decompressed_stream_pos
+         * @param encoded_length
+         * @return Same as streaming_archive::reader::Segment::try_read
+         */
+        ErrorCode try_read_encoded_column (uint64_t decompressed_stream_pos, uint64_t& encoded_length);
+
+        // Variables
         std::string m_segment_path;
         boost::iostreams::mapped_file_source m_memory_mapped_segment_file;
 
@@ -62,6 +132,17 @@ namespace streaming_archive { namespace reader {
         streaming_compression::zstd::Decompressor m_decompressor;
 #endif
 
+        std::unique_ptr<char[]> m_decoding_buf;
+        size_t m_decoding_buf_size;
+        std::unique_ptr<int64_t[]> m_scratch_buf;
+        size_t m_scratch_buf_size;
+
+        LogTypePostings m_logtype_postings;
+        // Result of reading the logtype postings, or ErrorCode_NotReady if they haven't been read yet
+        ErrorCode m_logtype_postings_error_code;
+        VariablePostings m_variable_postings;
+        ErrorCode m_variable_postings_error_code;
+
     };
 } }
 
@@ -1,6 +1,7 @@
 #include "SegmentManager.hpp"
 
 using std::string;
+using std::vector;
 
 namespace streaming_archive { namespace reader {
     void SegmentManager::open (const string& segment_dir_path) {
@@ -18,6 +19,68 @@ namespace streaming_archive { namespace reader {
     }
 
     ErrorCode SegmentManager::try_read (segment_id_t segment_id, const uint64_t decompressed_stream_pos, char* extraction_buf, const uint64_t extraction_len) {
+        Segment* segment;
+        ErrorCode error_code = try_get_segment(segment_id, segment);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+
+        // Extract data from compressed segment
+        return segment->try_read(decompressed_stream_pos, extraction_buf, extraction_len);
+    }
+
+    ErrorCode SegmentManager::try_read_timestamps (segment_id_t segment_id, uint64_t decompressed_stream_pos, epochtime_t* timestamps,
+                                                   size_t num_timestamps)
+    {
+        Segment* segment;
+        ErrorCode error_code = try_get_segment(segment_id, segment);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        return segment->try_read_timestamps(decompressed_stream_pos, timestamps, num_timestamps);
+    }
+
+    ErrorCode SegmentManager::try_read_logtype_ids (segment_id_t segment_id, uint64_t decompressed_stream_pos, logtype_dictionary_id_t* logtype_ids,
+                                                    size_t num_logtype_ids, vector<uint64_t>& message_numbers)
+    {
+        Segment* segment;
+        ErrorCode error_code = try_get_segment(segment_id, segment);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        return segment->try_read_logtype_ids(decompressed_stream_pos, logtype_ids, num_logtype_ids, message_numbers);
+    }
+
+    ErrorCode SegmentManager::try_read_variables (segment_id_t segment_id, uint64_t decompressed_stream_pos, encoded_variable_t* variables,
+                                                  size_t num_variables)
+    {
+        Segment* segment;
+        ErrorCode error_code = try_get_segment(segment_id, segment);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        return segment->try_read_variables(decompressed_stream_pos, variables, num_variables);
+    }
+
+    ErrorCode SegmentManager::try_get_logtype_postings (segment_id_t segment_id, const LogTypePostings*& logtype_postings) {
+        Segment* segment;
+        ErrorCode error_code = try_get_segment(segment_id, segment);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        return segment->try_get_logtype_postings(logtype_postings);
+    }
+
+    ErrorCode SegmentManager::try_get_variable_postings (segment_id_t segment_id, const VariablePostings*& variable_postings) {
+        Segment* segment;
+        ErrorCode error_code = try_get_segment(segment_id, segment);
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+        return segment->try_get_variable_postings(variable_postings);
+    }
+
+    ErrorCode SegmentManager::try_get_segment (segment_id_t segment_id, Segment*& segment) {
         static const size_t cMaxLRUSegments = 2;
 
         // Check that segment exists or insert it if not
@@ -39,8 +102,7 @@ namespace streaming_archive { namespace reader {
             }
         }
 
-        // Extract data from compressed segment
-        auto& segment = m_id_to_open_segment.at(segment_id);
-        return segment.try_read(decompressed_stream_pos, extraction_buf, extraction_len);
+        segment = &m_id_to_open_segment.at(segment_id);
+        return ErrorCode_Success;
     }
-} }
\ No newline at end of file
+} }
@@ -6,6 +6,7 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // Project headers
 #include "../../Defs.h"
@@ -40,8 +41,71 @@ namespace streaming_archive { namespace reader {
          * @throw std::out_of_range if a segment ID cannot be found unexpectedly
          */
         ErrorCode try_read (segment_id_t segment_id, const uint64_t decompressed_stream_pos, char* extraction_buf, const uint64_t extraction_len);
+        /**
+         * Tries to read and decode a timestamps column from a segment with the given ID
+         * @param segment_id
+         * @param decompressed_stream_pos
+         * @param timestamps
+         * @param num_timestamps
+         * @return Same as streaming_archive::reader::Segment::try_open
+         * @return Same as streaming_archive::reader::Segment::try_read_timestamps
+         * @throw std::out_of_range if a segment ID cannot be found unexpectedly
+         */
+        ErrorCode try_read_timestamps (segment_id_t segment_id, uint64_t decompressed_stream_pos, epochtime_t* timestamps, size_t num_timestamps);
+        /**
+         * Tries to read and decode a logtype IDs column from a segment with the given ID
+         * @param segment_id
+         * @param decompressed_stream_pos
+         * @param logtype_ids
+         * @param num_logtype_ids
+         * @param message_numbers
+         * @return Same as streaming_archive::reader::Segment::try_open
+         * @return Same as streaming_archive::reader::Segment::try_read_logtype_ids
+         * @throw std::out_of_range if a segment ID cannot be found unexpectedly
+         */
+        ErrorCode try_read_logtype_ids (segment_id_t segment_id, uint64_t decompressed_stream_pos, logtype_dictionary_id_t* logtype_ids,
+                                        size_t num_logtype_ids, std::vector<uint64_t>& message_numbers);
+        /**
+         * Tries to read and decode a variables column from a segment with the given ID
+         * @param segment_id
+         * @param decompressed_stream_pos
+         * @param variables
+         * @param num_variables
+         * @return Same as streaming_archive::reader::Segment::try_open
+         * @return Same as streaming_archive::reader::Segment::try_read_variables
+         * @throw std::out_of_range if a segment ID cannot be found unexpectedly
+         */
+        ErrorCode try_read_variables (segment_id_t segment_id, uint64_t decompressed_stream_pos, encoded_variable_t* variables, size_t num_variables);
+        /**
+         * Tries to get the logtype postings of the segment with the given ID
+         * @param segment_id
+         * @param logtype_postings Returns the postings, which remain valid until the segment is evicted
+         * @return Same as streaming_archive::reader::Segment::try_open
+         * @return Same as streaming_archive::reader::Segment::try_get_logtype_postings
+         * @throw std::out_of_range if a segment ID cannot be found unexpectedly
+         */
+        ErrorCode try_get_logtype_postings (segment_id_t segment_id, const LogTypePostings*& logtype_postings);
+        /**
+         * Tries to get the variable postings of the segment with the given ID
+         * @param segment_id
+         * @param variable_postings Returns the postings, which remain valid until the segment is evicted
+         * @return Same as streaming_archive::reader::Segment::try_open
+         * @return Same as streaming_archive::reader::Segment::try_get_variable_postings
+         * @throw std::out_of_range if a segment ID cannot be found unexpectedly
+         */
+        ErrorCode try_get_variable_postings (segment_id_t segment_id, const VariablePostings*& variable_postings);
 
     private:
+        // Methods
+        /**
+         * Gets the segment with the given ID, opening it (and evicting the least recently opened segment) if it's not already open
+         * @param segment_id
+         * @param segment
+         * @return Same as streaming_archive::reader::Segment::try_open
+         */
+        ErrorCode try_get_segment (segment_id_t segment_id, Segment*& segment);
+
+        // Variables
         std::string m_segment_dir_path;
 
         std::unordered_map<segment_id_t, Segment> m_id_to_open_segment;
@@ -2,6 +2,7 @@
 
 // C libraries
 #include <sys/stat.h>
+#include <unistd.h>
 
 // C++ libraries
 #include <iostream>
@@ -18,20 +19,23 @@
 
 // Project headers
 #include "../../EncodedVariableInterpreter.hpp"
+#include "../../FileReader.hpp"
 #include "../../Profiler.hpp"
 #include "../../Utils.hpp"
 #include "../Constants.hpp"
+#include "../FileTable.hpp"
 
 using std::list;
-using std::make_unique;
 using std::string;
+using std::string_view;
 using std::unordered_set;
 using std::vector;
 
 namespace streaming_archive { namespace writer {
     Archive::~Archive () {
         if (m_path.empty() == false || m_mutable_files.empty() == false || m_files_with_timestamps_in_segment.empty() == false ||
-                m_files_without_timestamps_in_segment.empty() == false)
+                m_files_without_timestamps_in_segment.empty() == false ||
+                m_files_in_closed_segments.empty() == false)
         {
             SPDLOG_ERROR("Archive not closed before being destroyed - data loss may occur");
             for (auto file : m_mutable_files) {
@@ -43,6 +47,9 @@ namespace streaming_archive { namespace writer {
             for (auto file : m_files_without_timestamps_in_segment) {
                 delete file;
             }
+            for (auto file : m_files_in_closed_segments) {
+                delete file;
+            }
         }
     }
 
@@ -120,13 +127,20 @@ namespace streaming_archive { namespace writer {
 
         // Create metadata database
         auto metadata_db_path = archive_path / cMetadataDBFileName;
-        m_metadata_db.open(metadata_db_path.string());
-
-        m_next_file_id = 0;
+        m_metadata_db.open(metadata_db_path.string(), true);
 
         m_target_segment_uncompressed_size = user_config.target_segment_uncompressed_size;
         m_next_segment_id = 0;
+        m_num_closed_segments = 0;
         m_compression_level = user_config.compression_level;
+        m_group_messages_by_logtype = user_config.group_messages_by_logtype;
+        m_index_variables = user_config.index_variables;
+
+        m_durability_policy = user_config.durability_policy;
+        m_group_commit_interval = user_config.group_commit_interval;
+        m_group_commit_size = user_config.group_commit_size;
+        m_last_sync_time = std::chrono::steady_clock::now();
+        m_size_written_since_last_sync = 0;
 
         // Save metadata to disk
         auto metadata_file_path = archive_path / cMetadataFileName;
@@ -154,22 +168,23 @@ namespace streaming_archive { namespace writer {
         string logtype_dict_segment_index_path = archive_path_string + '/' + cLogTypeSegmentIndexFilename;
         m_logtype_dict.open(logtype_dict_path, logtype_dict_segment_index_path, cLogtypeDictionaryIdMax);
 
-        // Preallocate logtype dictionary entry
-        m_logtype_dict_entry_wrapper = make_unique<LogTypeDictionaryEntry>();
-
         // Open variable dictionary
         string var_dict_path = archive_path_string + '/' + cVarDictFilename;
         string var_dict_segment_index_path = archive_path_string + '/' + cVarSegmentIndexFilename;
         m_var_dict.open(var_dict_path, var_dict_segment_index_path,
                         EncodedVariableInterpreter::get_var_dict_id_range_end() - EncodedVariableInterpreter::get_var_dict_id_range_begin());
 
-        #if FLUSH_TO_DISK_ENABLED
-            // fsync archive directory now that everything in the archive directory has been created
-            if (fsync(archive_dir_fd) != 0) {
-                SPDLOG_ERROR("Failed to fsync {}, errno={}", archive_path_string.c_str(), errno);
-                throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
-            }
-        #endif
+        if (DurabilityPolicy::Flush == m_durability_policy) {
+            #if FLUSH_TO_DISK_ENABLED
+                // fsync archive directory now that everything in the archive directory has been created
+                if (fsync(archive_dir_fd) != 0) {
+                    SPDLOG_ERROR("Failed to fsync {}, errno={}", archive_path_string.c_str(), errno);
+                    throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+                }
+            #endif
+        } else if (DurabilityPolicy::None != m_durability_policy) {
+            sync_to_disk();
+        }
         if (::close(archive_dir_fd) != 0) {
             // We've already fsynced, so this error shouldn't affect us. Therefore, just log it.
             SPDLOG_WARN("Error when closing file descriptor for {}, errno={}", archive_path_string.c_str(), errno);
@@ -178,6 +193,137 @@ namespace streaming_archive { namespace writer {
         m_path = archive_path_string;
     }
 
+    void Archive::open_existing (const UserConfig& user_config) {
+        m_id = user_config.id;
+        m_id_as_string = boost::uuids::to_string(m_id);
+        m_creator_id = user_config.creator_id;
+        m_creator_id_as_string = boost::uuids::to_string(m_creator_id);
+        m_creation_num = user_config.creation_num;
+
+        boost::system::error_code boost_error_code;
+
+        // Ensure archive exists
+        auto archive_path = boost::filesystem::path(user_config.output_dir) / m_id_as_string;
+        bool path_is_directory = boost::filesystem::is_directory(archive_path, boost_error_code);
+        if (false == path_is_directory) {
+            SPDLOG_ERROR("Archive doesn't exist: {}", archive_path.c_str());
+            throw OperationFailed(ErrorCode_FileNotFound, __FILENAME__, __LINE__);
+        }
+        const auto& archive_path_string = archive_path.string();
+
+        // Read metadata
+        auto metadata_file_path = archive_path / cMetadataFileName;
+        uint16_t format_version;
+        size_t stable_size;
+        try {
+            FileReader metadata_file_reader;
+            metadata_file_reader.open(metadata_file_path.string());
+            metadata_file_reader.read_numeric_value(format_version, false);
+            metadata_file_reader.read_numeric_value(m_stable_uncompressed_size, false);
+            metadata_file_reader.read_numeric_value(stable_size, false);
+            metadata_file_reader.close();
+        } catch (TraceableException& e) {
+            SPDLOG_CRITICAL("Failed to read archive metadata file: {}", metadata_file_path.c_str());
+            throw;
+        }
+        if (cArchiveFormatVersion != format_version) {
+            SPDLOG_ERROR("Archive uses an unsupported format: {}", archive_path.c_str());
+            throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
+        }
+        // NOTE: The stored size includes the dictionaries, which get_stable_size adds separately, so we recompute the size of everything else
+        m_stable_size = sizeof(cArchiveFormatVersion) + sizeof(m_stable_uncompressed_size) + sizeof(m_stable_size);
+
+        // Open logs directory
+        m_logs_dir_path = archive_path_string;
+        m_logs_dir_path += '/';
+        m_logs_dir_path += cLogsDirname;
+        m_logs_dir_path += '/';
+        m_logs_dir_fd = ::open(m_logs_dir_path.c_str(), O_RDONLY);
+        if (-1 == m_logs_dir_fd) {
+            SPDLOG_ERROR("Failed to open file descriptor for {}, errno={}", m_logs_dir_path.c_str(), errno);
+            throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+        }
+        for (const auto& entry : boost::filesystem::directory_iterator(m_logs_dir_path)) {
+            m_stable_size += boost::filesystem::file_size(entry.path());
+        }
+
+        // Open segments directory
+        m_segments_dir_path = archive_path_string;
+        m_segments_dir_path += '/';
+        m_segments_dir_path += cSegmentsDirname;
+        m_segments_dir_path += '/';
+        m_segments_dir_fd = ::open(m_segments_dir_path.c_str(), O_RDONLY);
+        if (-1 == m_segments_dir_fd) {
+            SPDLOG_ERROR("Failed to open file descriptor for {}, errno={}", m_segments_dir_path.c_str(), errno);
+            throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+        }
+
+        // Continue numbering segments after the existing ones
+        m_next_segment_id = 0;
+        for (const auto& entry : boost::filesystem::directory_iterator(m_segments_dir_path)) {
+            const auto& segment_path = entry.path();
+            if (segment_path.extension() == cLogTypePostingsFileExtension || segment_path.extension() == cVariablePostingsFileExtension) {
+                m_stable_size += boost::filesystem::file_size(segment_path);
+                continue;
+            }
+            int64_t segment_id;
+            if (false == convert_string_to_int64(segment_path.filename().string(), segment_id) || segment_id < 0) {
+                SPDLOG_ERROR("Unexpected file in segments directory: {}", segment_path.c_str());
+                throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
+            }
+            if ((segment_id_t)segment_id >= m_next_segment_id) {
+                m_next_segment_id = segment_id + 1;
+            }
+            m_stable_size += boost::filesystem::file_size(segment_path);
+        }
+
+        // Delete the file table, since it won't contain the files we append. It's rewritten when the archive is closed.
+        FileTable::remove((archive_path / cFileTableFileName).string());
+
+        // Open metadata database
+        auto metadata_db_path = archive_path / cMetadataDBFileName;
+        m_metadata_db.open(metadata_db_path.string(), true);
+
+        // Continue counting the segments whose files were committed
+        vector<segment_id_t> ids_of_committed_segments;
+        m_metadata_db.get_ids_of_segments_with_files(0, ids_of_committed_segments);
+        m_num_closed_segments = ids_of_committed_segments.size();
+
+        m_target_segment_uncompressed_size = user_config.target_segment_uncompressed_size;
+        m_compression_level = user_config.compression_level;
+        m_group_messages_by_logtype = user_config.group_messages_by_logtype;
+        m_index_variables = user_config.index_variables;
+
+        m_durability_policy = user_config.durability_policy;
+        m_group_commit_interval = user_config.group_commit_interval;
+        m_group_commit_size = user_config.group_commit_size;
+        m_last_sync_time = std::chrono::steady_clock::now();
+        m_size_written_since_last_sync = 0;
+
+        // Reopen metadata file at its end, since update_metadata overwrites the sizes at the end of the file
+        try {
+            m_metadata_file_writer.open(metadata_file_path.string(), FileWriter::OpenMode::CREATE_IF_NONEXISTENT_FOR_SEEKABLE_WRITING);
+        } catch (FileWriter::OperationFailed& e) {
+            SPDLOG_CRITICAL("Failed to open archive metadata file: {}", metadata_file_path.c_str());
+            throw;
+        }
+
+        m_global_metadata_db = user_config.global_metadata_db;
+
+        // Preload log-type dictionary
+        string logtype_dict_path = archive_path_string + '/' + cLogTypeDictFilename;
+        string logtype_dict_segment_index_path = archive_path_string + '/' + cLogTypeSegmentIndexFilename;
+        m_logtype_dict.open_and_preload(logtype_dict_path, logtype_dict_segment_index_path, cLogtypeDictionaryIdMax);
+
+        // Preload variable dictionary
+        string var_dict_path = archive_path_string + '/' + cVarDictFilename;
+        string var_dict_segment_index_path = archive_path_string + '/' + cVarSegmentIndexFilename;
+        m_var_dict.open_and_preload(var_dict_path, var_dict_segment_index_path,
+                                    EncodedVariableInterpreter::get_var_dict_id_range_end() - EncodedVariableInterpreter::get_var_dict_id_range_begin());
+
+        m_path = archive_path_string;
+    }
+
     void Archive::close () {
         // Any mutable files should have been closed and persisted before closing the archive.
         if (!m_mutable_files.empty()) {
@@ -185,25 +331,12 @@ namespace streaming_archive { namespace writer {
             throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
         }
 
-        // Close segments if necessary
-        if (m_segment_for_files_with_timestamps.is_open()) {
-            close_segment_and_persist_file_metadata(m_segment_for_files_with_timestamps, m_files_with_timestamps_in_segment,
-                                                    m_logtype_ids_in_segment_for_files_with_timestamps, m_var_ids_in_segment_for_files_with_timestamps);
-            m_logtype_ids_in_segment_for_files_with_timestamps.clear();
-            m_var_ids_in_segment_for_files_with_timestamps.clear();
-        }
-        if (m_segment_for_files_without_timestamps.is_open()) {
-            close_segment_and_persist_file_metadata(m_segment_for_files_without_timestamps, m_files_without_timestamps_in_segment,
-                                                    m_logtype_ids_in_segment_for_files_without_timestamps, m_var_ids_in_segment_for_files_without_timestamps);
-            m_logtype_ids_in_segment_for_files_without_timestamps.clear();
-            m_var_ids_in_segment_for_files_without_timestamps.clear();
-        }
+        commit();
 
-        // Persist all metadata including dictionaries
-        write_dir_snapshot();
+        // Write the file table for readers now that the archive's files won't change
+        FileTable::write(m_metadata_db, m_path + '/' + cFileTableFileName);
 
         m_logtype_dict.close();
-        m_logtype_dict_entry_wrapper.reset(nullptr);
         m_var_dict.close();
 
         if (::close(m_segments_dir_fd) != 0) {
@@ -234,6 +367,33 @@ namespace streaming_archive { namespace writer {
         m_path.clear();
     }
 
+    void Archive::commit () {
+        // Close segments if necessary
+        if (m_segment_for_files_with_timestamps.is_open()) {
+            close_segment_and_persist_file_metadata(m_segment_for_files_with_timestamps, m_files_with_timestamps_in_segment,
+                                                    m_logtype_ids_in_segment_for_files_with_timestamps, m_var_ids_in_segment_for_files_with_timestamps,
+                                                    m_logtype_postings_for_files_with_timestamps, m_variable_postings_for_files_with_timestamps);
+            m_logtype_ids_in_segment_for_files_with_timestamps.clear();
+            m_var_ids_in_segment_for_files_with_timestamps.clear();
+            m_logtype_postings_for_files_with_timestamps.clear();
+            m_variable_postings_for_files_with_timestamps.clear();
+        }
+        if (m_segment_for_files_without_timestamps.is_open()) {
+            close_segment_and_persist_file_metadata(m_segment_for_files_without_timestamps, m_files_without_timestamps_in_segment,
+                                                    m_logtype_ids_in_segment_for_files_without_timestamps, m_var_ids_in_segment_for_files_without_timestamps,
+                                                    m_logtype_postings_for_files_without_timestamps, m_variable_postings_for_files_without_timestamps);
+            m_logtype_ids_in_segment_for_files_without_timestamps.clear();
+            m_var_ids_in_segment_for_files_without_timestamps.clear();
+            m_logtype_postings_for_files_without_timestamps.clear();
+            m_variable_postings_for_files_without_timestamps.clear();
+        }
+        // Commit any segments still waiting for a group commit
+        commit_files_in_closed_segments();
+
+        // Persist all metadata including dictionaries
+        write_dir_snapshot();
+    }
+
     File* Archive::create_in_memory_file (const string& path, const group_id_t group_id, const boost::uuids::uuid& orig_file_id, size_t split_ix) {
         auto file = new InMemoryFile(m_uuid_generator(), orig_file_id, path, m_logs_dir_path, group_id, split_ix);
         m_mutable_files.insert(file);
@@ -265,15 +425,12 @@ namespace streaming_archive { namespace writer {
         file.change_ts_pattern(pattern);
     }
 
-    void Archive::write_msg (File& file, epochtime_t timestamp, const string& message, size_t num_uncompressed_bytes) {
-        vector<encoded_variable_t> encoded_vars;
-        EncodedVariableInterpreter::encode_and_add_to_dictionary(message, *m_logtype_dict_entry_wrapper, m_var_dict, encoded_vars);
+    void Archive::write_msg (File& file, epochtime_t timestamp, string_view message, size_t num_uncompressed_bytes) {
+        EncodedVariableInterpreter::encode_and_add_to_dictionary(message, m_logtype_dict_entry, m_var_dict, m_encoded_vars);
         logtype_dictionary_id_t logtype_id;
-        if (m_logtype_dict.add_occurrence(m_logtype_dict_entry_wrapper, logtype_id)) {
-            m_logtype_dict_entry_wrapper = make_unique<LogTypeDictionaryEntry>();
-        }
+        m_logtype_dict.add_occurrence(m_logtype_dict_entry, logtype_id);
 
-        file.write_encoded_msg(timestamp, logtype_id, encoded_vars, num_uncompressed_bytes);
+        file.write_encoded_msg(timestamp, logtype_id, m_encoded_vars, num_uncompressed_bytes);
     }
 
     void Archive::write_dir_snapshot () {
@@ -291,18 +448,25 @@ namespace streaming_archive { namespace writer {
             files_with_dirty_metadata.emplace_back(file);
         }
 
-        #if FLUSH_TO_DISK_ENABLED
-            // fsync logs directory to flush new files' directory entries
-            if (0 != fsync(m_logs_dir_fd)) {
-                SPDLOG_ERROR("Failed to fsync {}, errno={}", m_logs_dir_path.c_str(), errno);
-                throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
-            }
-        #endif
+        if (DurabilityPolicy::Flush == m_durability_policy) {
+            #if FLUSH_TO_DISK_ENABLED
+                // fsync logs directory to flush new files' directory entries
+                if (0 != fsync(m_logs_dir_fd)) {
+                    SPDLOG_ERROR("Failed to fsync {}, errno={}", m_logs_dir_path.c_str(), errno);
+                    throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+                }
+            #endif
+        }
 
         // Flush dictionaries
         m_logtype_dict.write_uncommitted_entries_to_disk();
         m_var_dict.write_uncommitted_entries_to_disk();
 
+        if (DurabilityPolicy::Segment == m_durability_policy || DurabilityPolicy::Group == m_durability_policy) {
+            // Sync the files' content, their directory entries, and the dictionaries before their metadata is persisted
+            sync_to_disk();
+        }
+
         // Persist files with dirty metadata
         persist_file_metadata(files_with_dirty_metadata);
 
@@ -380,20 +544,25 @@ namespace streaming_archive { namespace writer {
     }
 
     void Archive::append_file_to_segment (File*& file, Segment& segment, unordered_set<logtype_dictionary_id_t>& logtype_ids_in_segment,
-                                          unordered_set<variable_dictionary_id_t>& var_ids_in_segment, vector<File*>& files_in_segment)
+                                          unordered_set<variable_dictionary_id_t>& var_ids_in_segment, LogTypePostings& logtype_postings_in_segment,
+                                          VariablePostings& variable_postings_in_segment, vector<File*>& files_in_segment)
     {
         if (!segment.is_open()) {
             segment.open(m_segments_dir_path, m_next_segment_id++, m_compression_level);
         }
 
-        file->append_to_segment(m_logtype_dict, segment, logtype_ids_in_segment, var_ids_in_segment);
+        file->append_to_segment(m_logtype_dict, segment, m_group_messages_by_logtype, logtype_ids_in_segment, var_ids_in_segment,
+                                logtype_postings_in_segment, m_index_variables ? &variable_postings_in_segment : nullptr);
         files_in_segment.emplace_back(file);
 
         // Close current segment if its uncompressed size is greater than the target
         if (segment.get_uncompressed_size() >= m_target_segment_uncompressed_size) {
-            close_segment_and_persist_file_metadata(segment, files_in_segment, logtype_ids_in_segment, var_ids_in_segment);
+            close_segment_and_persist_file_metadata(segment, files_in_segment, logtype_ids_in_segment, var_ids_in_segment, logtype_postings_in_segment,
+                                                    variable_postings_in_segment);
             logtype_ids_in_segment.clear();
             var_ids_in_segment.clear();
+            logtype_postings_in_segment.clear();
+            variable_postings_in_segment.clear();
         }
     }
 
@@ -414,10 +583,12 @@ namespace streaming_archive { namespace writer {
 
         if (file->has_ts_pattern()) {
             append_file_to_segment(file, m_segment_for_files_with_timestamps, m_logtype_ids_in_segment_for_files_with_timestamps,
-                                   m_var_ids_in_segment_for_files_with_timestamps, m_files_with_timestamps_in_segment);
+                                   m_var_ids_in_segment_for_files_with_timestamps, m_logtype_postings_for_files_with_timestamps,
+                                   m_variable_postings_for_files_with_timestamps, m_files_with_timestamps_in_segment);
         } else {
             append_file_to_segment(file, m_segment_for_files_without_timestamps, m_logtype_ids_in_segment_for_files_without_timestamps,
-                                   m_var_ids_in_segment_for_files_without_timestamps, m_files_without_timestamps_in_segment);
+                                   m_var_ids_in_segment_for_files_without_timestamps, m_logtype_postings_for_files_without_timestamps,
+                                   m_variable_postings_for_files_without_timestamps, m_files_without_timestamps_in_segment);
         }
 
         // Make sure file pointer is nulled and cannot be accessed outside
@@ -429,9 +600,14 @@ namespace streaming_archive { namespace writer {
             return;
         }
 
+        // NOTE: We time this with a stopwatch rather than a fragmented measurement since archives may be written concurrently
+        Stopwatch metadata_write_stopwatch;
+        PROFILER_START_STOPWATCH(metadata_write_stopwatch)
         m_metadata_db.update_files(files);
 
         m_global_metadata_db->update_files(m_id_as_string, files);
+        PROFILER_STOP_STOPWATCH(metadata_write_stopwatch)
+        PROFILER_FRAGMENTED_MEASUREMENT_INCREMENT(MetadataWrite, metadata_write_stopwatch.get_time_taken_in_nanoseconds())
 
         // Mark files' metadata as clean
         for (auto file : files) {
@@ -441,44 +617,96 @@ namespace streaming_archive { namespace writer {
 
     void Archive::close_segment_and_persist_file_metadata (Segment& segment, std::vector<File*>& files,
                                                            const unordered_set<logtype_dictionary_id_t>& segment_logtype_ids,
-                                                           const unordered_set<variable_dictionary_id_t>& segment_var_ids)
+                                                           const unordered_set<variable_dictionary_id_t>& segment_var_ids,
+                                                           const LogTypePostings& segment_logtype_postings,
+                                                           const VariablePostings& segment_variable_postings)
     {
+        // Flush dictionaries
+        // NOTE: We do this before indexing the segment so that readers of an archive that's still being written never see a segment which refers to
+        // entries that aren't in the dictionaries yet
+        m_logtype_dict.write_uncommitted_entries_to_disk();
+        m_var_dict.write_uncommitted_entries_to_disk();
+
         auto segment_id = segment.get_id();
         m_logtype_dict.index_segment(segment_id, segment_logtype_ids);
         m_var_dict.index_segment(segment_id, segment_var_ids);
 
-        m_stable_size += segment.get_compressed_size();
+        // Write the segment's postings alongside it
+        // NOTE: Like the segment itself, they're only read once the segment's files are committed
+        string postings_path_prefix = m_segments_dir_path;
+        postings_path_prefix += std::to_string(segment_id);
+        auto postings_size = segment_logtype_postings.write(postings_path_prefix + cLogTypePostingsFileExtension,
+                                                            segment_logtype_postings.get_num_messages() / LogTypePostings::cMinMessagesPerPosting);
+        if (m_index_variables) {
+            // NOTE: Since the index is optional, its size isn't bounded beyond each variable being selective enough to be worth indexing
+            postings_size += segment_variable_postings.write(postings_path_prefix + cVariablePostingsFileExtension, SIZE_MAX);
+        }
 
+        // NOTE: We get the compressed size after closing the segment since the segment is compressed in the background
         segment.close();
 
-        #if FLUSH_TO_DISK_ENABLED
-            // fsync segments directory to flush segment's directory entry
-            if (fsync(m_segments_dir_fd) != 0) {
-                SPDLOG_ERROR("Failed to fsync {}, errno={}", m_segments_dir_path.c_str(), errno);
-                throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
-            }
-        #endif
+        m_stable_size += segment.get_compressed_size() + postings_size;
+        ++m_num_closed_segments;
 
-        // Flush dictionaries
-        m_logtype_dict.write_uncommitted_entries_to_disk();
-        m_var_dict.write_uncommitted_entries_to_disk();
+        if (DurabilityPolicy::Flush == m_durability_policy) {
+            #if FLUSH_TO_DISK_ENABLED
+                // fsync segments directory to flush segment's directory entry
+                if (fsync(m_segments_dir_fd) != 0) {
+                    SPDLOG_ERROR("Failed to fsync {}, errno={}", m_segments_dir_path.c_str(), errno);
+                    throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+                }
+            #endif
+        }
 
         for (auto file : files) {
             file->mark_as_in_committed_segment();
             m_stable_uncompressed_size += file->get_num_uncompressed_bytes();
         }
+        m_files_in_closed_segments.insert(m_files_in_closed_segments.end(), files.cbegin(), files.cend());
+        files.clear();
+        m_size_written_since_last_sync += segment.get_compressed_size() + postings_size;
 
-        persist_file_metadata(files);
+        if (DurabilityPolicy::Group != m_durability_policy || m_size_written_since_last_sync >= m_group_commit_size ||
+            std::chrono::steady_clock::now() - m_last_sync_time >= m_group_commit_interval)
+        {
+            commit_files_in_closed_segments();
+        }
+    }
 
-        for (auto file : files) {
+    void Archive::commit_files_in_closed_segments () {
+        if (m_files_in_closed_segments.empty()) {
+            return;
+        }
+
+        if (DurabilityPolicy::Segment == m_durability_policy || DurabilityPolicy::Group == m_durability_policy) {
+            // Sync the segments and the dictionary entries they refer to before the segments are indexed in the metadata
+            sync_to_disk();
+        }
+
+        persist_file_metadata(m_files_in_closed_segments);
+
+        for (auto file : m_files_in_closed_segments) {
             file->cleanup_after_segment_insertion();
             delete file;
         }
-        files.clear();
+        m_files_in_closed_segments.clear();
 
         update_metadata();
     }
 
+    void Archive::sync_to_disk () {
+        #if FLUSH_TO_DISK_ENABLED
+            // NOTE: syncfs syncs every file and directory entry on the file system containing the archive, so a single call replaces fsyncing each
+            // file and directory that was written since the last sync
+            if (0 != syncfs(m_segments_dir_fd)) {
+                SPDLOG_ERROR("Failed to sync file system containing {}, errno={}", m_segments_dir_path.c_str(), errno);
+                throw OperationFailed(ErrorCode_errno, __FILENAME__, __LINE__);
+            }
+        #endif
+        m_last_sync_time = std::chrono::steady_clock::now();
+        m_size_written_since_last_sync = 0;
+    }
+
     void Archive::add_empty_directories (const vector<string>& empty_directory_paths) {
         if (empty_directory_paths.empty()) {
             return;
@@ -530,6 +758,7 @@ namespace streaming_archive { namespace writer {
         m_metadata_file_writer.write_numeric_value(stable_uncompressed_size);
         m_metadata_file_writer.write_numeric_value(stable_size);
 
-        m_global_metadata_db->update_archive_size(m_id_as_string, stable_uncompressed_size, stable_size);
+        // NOTE: This is only called after committing the files in every closed segment
+        m_global_metadata_db->update_archive_metadata(m_id_as_string, stable_uncompressed_size, stable_size, m_num_closed_segments);
     }
 } }
@@ -2,9 +2,11 @@
 #define STREAMING_ARCHIVE_WRITER_ARCHIVE_HPP
 
 // C++ libraries
+#include <chrono>
 #include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
@@ -17,6 +19,7 @@
 #include "../../GlobalMetadataDB.hpp"
 #include "../../LogTypeDictionaryWriter.hpp"
 #include "../../VariableDictionaryWriter.hpp"
+#include "../Postings.hpp"
 #include "../MetadataDB.hpp"
 #include "InMemoryFile.hpp"
 #include "OnDiskFile.hpp"
@@ -25,6 +28,24 @@ namespace streaming_archive { namespace writer {
     class Archive {
     public:
         // Types
+        /**
+         * Policy for when the archive's content is synced to disk. Whichever policy is used, the metadata that makes a segment searchable is only
+         * written after the segment (and the dictionary entries it refers to) is synced, so a crash can't leave the archive referring to lost content.
+         * - Flush: Each file is synced whenever it's flushed, and new directory entries are synced separately
+         * - Segment: FileWriters don't sync, and instead everything written is synced with a single barrier before each segment is committed
+         * - Group: Like Segment, except segments are committed in groups that share a barrier, once the group commit interval has elapsed or the group
+         *   commit size has been written since the last barrier, or when the archive is committed. The interval and size are only checked when a
+         *   segment closes.
+         * - None: Nothing is explicitly synced
+         * NOTE: All policies except Flush require FileWriter::set_sync_on_flush(false)
+         */
+        enum class DurabilityPolicy {
+            Flush,
+            Segment,
+            Group,
+            None,
+        };
+
         /**
          * Structure used to pass settings when opening a new archive
          * @param id
@@ -35,6 +56,11 @@ namespace streaming_archive { namespace writer {
          * @param compression_level Compression level of the compressor being opened
          * @param output_dir Output directory
          * @param global_metadata_db
+         * @param durability_policy
+         * @param group_commit_interval Time since the last barrier after which closing a segment triggers a barrier with the Group durability policy
+         * @param group_commit_size Compressed size of the segments that triggers a barrier with the Group durability policy
+         * @param group_messages_by_logtype Whether to group each file's messages by logtype in segments
+         * @param index_variables Whether to write an index from each dictionary variable to the messages containing it in each segment
          */
         struct UserConfig {
             boost::uuids::uuid id;
@@ -45,6 +71,11 @@ namespace streaming_archive { namespace writer {
             int compression_level;
             std::string output_dir;
             GlobalMetadataDB* global_metadata_db;
+            DurabilityPolicy durability_policy;
+            std::chrono::milliseconds group_commit_interval;
+            size_t group_commit_size;
+            bool group_messages_by_logtype;
+            bool index_variables;
         };
 
         class OperationFailed : public TraceableException {
@@ -59,7 +90,9 @@ namespace streaming_archive { namespace writer {
         };
 
         // Constructors
-        Archive () : m_logs_dir_fd(-1), m_segments_dir_fd(-1), m_compression_level(0), m_global_metadata_db(nullptr) {}
+        Archive () : m_logs_dir_fd(-1), m_segments_dir_fd(-1), m_compression_level(0), m_group_messages_by_logtype(false), m_index_variables(false),
+                m_global_metadata_db(nullptr),
+                m_durability_policy(DurabilityPolicy::Flush), m_group_commit_interval(0), m_group_commit_size(0), m_size_written_since_last_sync(0) {}
 
         // Destructor
         ~Archive ();
@@ -73,6 +106,18 @@ namespace streaming_archive { namespace writer {
                   not be created or problems with medatadata.
          */
         void open (const UserConfig& user_config);
+        /**
+         * Reopens an existing archive so that more files can be appended to it. The archive's dictionaries are preloaded so that existing entries keep
+         * their IDs, and new segments are numbered after the existing ones.
+         * @param user_config Settings configurable by the user. The ID selects the archive to reopen. Since the archive is already registered in the
+         * global metadata database, its storage ID, creator ID and creation number aren't stored again.
+         * @throw FileReader::OperationFailed if the archive's metadata file could not be read
+         * @throw FileWriter::OperationFailed if any dictionary writer could not be opened
+         * @throw streaming_archive::writer::Archive::OperationFailed if the archive doesn't exist, uses an unsupported format, or its directories could
+         * not be opened
+         * @throw Same as LogTypeDictionaryWriter::open_and_preload and VariableDictionaryWriter::open_and_preload
+         */
+        void open_existing (const UserConfig& user_config);
         /**
          * Writes a final snapshot of the archive, closes all open files, and closes the dictionaries
          * @throw FileWriter::OperationFailed if any writer could not be closed
@@ -129,7 +174,7 @@ namespace streaming_archive { namespace writer {
          * @param num_uncompressed_bytes
          * @throw FileWriter::OperationFailed if any write fails
          */
-        void write_msg (File& file, epochtime_t timestamp, const std::string& message, size_t num_uncompressed_bytes);
+        void write_msg (File& file, epochtime_t timestamp, std::string_view message, size_t num_uncompressed_bytes);
 
         /**
          * Writes snapshot of archive to disk including metadata of all files and new dictionary entries
@@ -138,6 +183,12 @@ namespace streaming_archive { namespace writer {
          * @throw Same as streaming_archive::writer::Archive::persist_file_metadata
          */
         void write_dir_snapshot ();
+        /**
+         * Closes any open segments and writes a snapshot of the archive, so that all files marked ready for a segment become searchable
+         * @throw Same as streaming_archive::writer::Archive::close_segment_and_persist_file_metadata
+         * @throw Same as streaming_archive::writer::Archive::write_dir_snapshot
+         */
+        void commit ();
 
         /**
          * Releases and writes the given streaming_archive::writer::InMemoryFile to disk
@@ -209,10 +260,13 @@ namespace streaming_archive { namespace writer {
          * @param segment
          * @param logtype_ids_in_segment
          * @param var_ids_in_segment
+         * @param logtype_postings_in_segment
+         * @param variable_postings_in_segment
          * @param files_in_segment
          */
         void append_file_to_segment (File*& file, Segment& segment, std::unordered_set<logtype_dictionary_id_t>& logtype_ids_in_segment,
-                std::unordered_set<variable_dictionary_id_t>& var_ids_in_segment, std::vector<File*>& files_in_segment);
+                std::unordered_set<variable_dictionary_id_t>& var_ids_in_segment, LogTypePostings& logtype_postings_in_segment,
+                VariablePostings& variable_postings_in_segment, std::vector<File*>& files_in_segment);
         /**
          * Writes the given files' metadata to the database using bulk writes
          * @param files
@@ -221,18 +275,37 @@ namespace streaming_archive { namespace writer {
          */
         void persist_file_metadata (const std::vector<File*>& files);
         /**
-         * Closes a given segment, persists the metadata of the files in the segment, and cleans up any data remaining outside the segment
+         * Closes a given segment and writes its postings, persists the metadata of the files in the segment, and cleans up any data remaining
+         * outside the segment
          * @param segment
          * @param files
          * @param segment_logtype_ids
          * @param segment_var_ids
+         * @param segment_logtype_postings
+         * @param segment_variable_postings Only written if variables are indexed
          * @throw Same as streaming_archive::writer::Segment::close
+         * @throw Same as streaming_archive::Postings::write
          * @throw Same as streaming_archive::writer::Archive::persist_file_metadata
          * @throw Same as streaming_archive::writer::File::cleanup_after_segment_insertion
          */
         void close_segment_and_persist_file_metadata (Segment& segment, std::vector<File*>& files,
                                                       const std::unordered_set<logtype_dictionary_id_t>& segment_logtype_ids,
-                                                      const std::unordered_set<variable_dictionary_id_t>& segment_var_ids);
+                                                      const std::unordered_set<variable_dictionary_id_t>& segment_var_ids,
+                                                      const LogTypePostings& segment_logtype_postings,
+                                                      const VariablePostings& segment_variable_postings);
+        /**
+         * Syncs the files in closed segments whose metadata hasn't been persisted yet (if the durability policy requires a barrier), and then persists
+         * their metadata, making them searchable
+         * @throw Same as streaming_archive::writer::Archive::sync_to_disk
+         * @throw Same as streaming_archive::writer::Archive::persist_file_metadata
+         * @throw Same as streaming_archive::writer::File::cleanup_after_segment_insertion
+         */
+        void commit_files_in_closed_segments ();
+        /**
+         * Syncs everything written to the archive's file system with a single barrier
+         * @throw streaming_archive::writer::Archive::OperationFailed if the sync fails
+         */
+        void sync_to_disk ();
 
         /**
          * Gets the size of uncompressed data that has been compressed into the archive and will not be changed
@@ -266,13 +339,14 @@ namespace streaming_archive { namespace writer {
         int m_segments_dir_fd;
 
         LogTypeDictionaryWriter m_logtype_dict;
-        // Wrapper to hold logtype dictionary entry that's preallocated for performance
-        std::unique_ptr<LogTypeDictionaryEntry> m_logtype_dict_entry_wrapper;
+        // Logtype dictionary entry that's reused across messages for performance
+        LogTypeDictionaryEntry m_logtype_dict_entry;
         VariableDictionaryWriter m_var_dict;
+        // Buffer for a message's encoded variables that's reused across messages for performance
+        std::vector<encoded_variable_t> m_encoded_vars;
 
         boost::uuids::random_generator m_uuid_generator;
 
-        file_id_t m_next_file_id;
         std::unordered_set<File*> m_mutable_files;
         // Since we batch metadata persistence operations, we need to keep track of files whose metadata should be persisted
         // Accordingly:
@@ -285,6 +359,7 @@ namespace streaming_archive { namespace writer {
         std::vector<File*> m_released_but_dirty_files;
 
         segment_id_t m_next_segment_id;
+        size_t m_num_closed_segments;
         std::vector<File*> m_files_with_timestamps_in_segment;
         std::vector<File*> m_files_without_timestamps_in_segment;
 
@@ -292,20 +367,34 @@ namespace streaming_archive { namespace writer {
         Segment m_segment_for_files_with_timestamps;
         std::unordered_set<logtype_dictionary_id_t> m_logtype_ids_in_segment_for_files_with_timestamps;
         std::unordered_set<variable_dictionary_id_t> m_var_ids_in_segment_for_files_with_timestamps;
+        LogTypePostings m_logtype_postings_for_files_with_timestamps;
+        VariablePostings m_variable_postings_for_files_with_timestamps;
         Segment m_segment_for_files_without_timestamps;
         std::unordered_set<logtype_dictionary_id_t> m_logtype_ids_in_segment_for_files_without_timestamps;
         std::unordered_set<variable_dictionary_id_t> m_var_ids_in_segment_for_files_without_timestamps;
+        LogTypePostings m_logtype_postings_for_files_without_timestamps;
+        VariablePostings m_variable_postings_for_files_without_timestamps;
 
         size_t m_stable_uncompressed_size;
         size_t m_stable_size;
 
         int m_compression_level;
+        bool m_group_messages_by_logtype;
+        bool m_index_variables;
 
         MetadataDB m_metadata_db;
 
         FileWriter m_metadata_file_writer;
 
         GlobalMetadataDB* m_global_metadata_db;
+
+        DurabilityPolicy m_durability_policy;
+        std::chrono::milliseconds m_group_commit_interval;
+        size_t m_group_commit_size;
+        std::chrono::steady_clock::time_point m_last_sync_time;
+        size_t m_size_written_since_last_sync;
+        // Files in closed segments whose metadata will be persisted after the next barrier
+        std::vector<File*> m_files_in_closed_segments;
     };
 } }
 
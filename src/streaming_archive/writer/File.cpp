@@ -1,11 +1,16 @@
 #include "File.hpp"
 
+// C++ standard libraries
+#include <algorithm>
+#include <numeric>
+
 // Project headers
 #include "../../EncodedVariableInterpreter.hpp"
 
 using std::string;
 using std::to_string;
 using std::unordered_set;
+using std::vector;
 
 namespace streaming_archive { namespace writer {
     void File::change_ts_pattern (const TimestampPattern* pattern) {
@@ -55,13 +60,18 @@ namespace streaming_archive { namespace writer {
     void File::append_logtype_and_var_ids_to_segment_sets (const LogTypeDictionaryWriter& logtype_dict, const logtype_dictionary_id_t* logtype_ids,
                                                            size_t num_logtypes, const encoded_variable_t* vars, size_t num_vars,
                                                            unordered_set<logtype_dictionary_id_t>& segment_logtype_ids,
-                                                           unordered_set<variable_dictionary_id_t>& segment_var_ids)
+                                                           unordered_set<variable_dictionary_id_t>& segment_var_ids,
+                                                           vector<column_encoding::VariableType>& var_types)
     {
+        // NOTE: Any variables beyond those used by the logtypes are treated as integers
+        var_types.assign(num_vars, column_encoding::VariableType::Integer);
+
         size_t var_ix = 0;
         for (size_t i = 0; i < num_logtypes; ++i) {
             // Add logtype to set
+            // NOTE: We use insert rather than emplace since emplace allocates a node even if the ID is already in the set
             auto logtype_id = logtype_ids[i];
-            segment_logtype_ids.emplace(logtype_id);
+            segment_logtype_ids.insert(logtype_id);
 
             // Get logtype dictionary entry
             auto logtype_dict_entry_ptr = logtype_dict.get_entry(logtype_id);
@@ -73,16 +83,130 @@ namespace streaming_archive { namespace writer {
                 throw OperationFailed(ErrorCode_Corrupt, __FILENAME__, __LINE__);
             }
 
-            // If variable is a variable dictionary ID, decode it and add it to the set
+            // Get each variable's type and if it's a variable dictionary ID, decode it and add it to the set
             for (size_t msg_var_ix = 0; msg_var_ix < msg_num_vars; ++msg_var_ix, ++var_ix) {
                 if (LogTypeDictionaryEntry::VarDelim::NonDouble == logtype_dict_entry.get_var_delim(msg_var_ix)) {
                     auto var = vars[var_ix];
                     if (EncodedVariableInterpreter::is_var_dict_id(var)) {
-                        segment_var_ids.emplace(EncodedVariableInterpreter::decode_var_dict_id(var));
+                        segment_var_ids.insert(EncodedVariableInterpreter::decode_var_dict_id(var));
+                        var_types[var_ix] = column_encoding::VariableType::DictionaryId;
                     }
+                } else {
+                    var_types[var_ix] = column_encoding::VariableType::Double;
+                }
+            }
+        }
+    }
+
+    void File::append_columns_to_segment (const LogTypeDictionaryWriter& logtype_dict, const epochtime_t* timestamps, size_t num_timestamps,
+                                          const logtype_dictionary_id_t* logtype_ids, size_t num_logtypes, const encoded_variable_t* vars,
+                                          const column_encoding::VariableType* var_types, size_t num_vars, bool group_messages_by_logtype,
+                                          Segment& segment, LogTypePostings& segment_logtype_postings, VariablePostings* segment_variable_postings)
+    {
+        uint64_t segment_timestamps_uncompressed_pos;
+        uint64_t segment_logtypes_uncompressed_pos;
+        uint64_t segment_variables_uncompressed_pos;
+
+        // NOTE: Grouping only helps if the messages aren't already in logtype order, and requires every message to have a timestamp and its
+        // variables, which may not hold for a file that wasn't closed cleanly
+        bool group = group_messages_by_logtype && num_timestamps == num_logtypes && false == std::is_sorted(logtype_ids, logtype_ids + num_logtypes);
+        vector<size_t> message_var_begin_ixs;
+        if (group) {
+            message_var_begin_ixs.resize(num_logtypes + 1);
+            message_var_begin_ixs[0] = 0;
+            for (size_t i = 0; i < num_logtypes; ++i) {
+                message_var_begin_ixs[i + 1] = message_var_begin_ixs[i] + logtype_dict.get_entry(logtype_ids[i])->get_num_vars();
+            }
+            group = (message_var_begin_ixs[num_logtypes] == num_vars);
+        }
+        if (false == group) {
+            segment.append_timestamps(timestamps, num_timestamps, segment_timestamps_uncompressed_pos);
+            segment.append_logtype_ids(logtype_ids, num_logtypes, segment_logtypes_uncompressed_pos);
+            segment.append_variables(vars, var_types, num_vars, segment_variables_uncompressed_pos);
+            set_segment_metadata(segment.get_id(), segment_timestamps_uncompressed_pos, segment_logtypes_uncompressed_pos,
+                                 segment_variables_uncompressed_pos);
+            add_logtype_postings(logtype_dict, logtype_ids, num_logtypes, segment_logtypes_uncompressed_pos, segment_logtype_postings);
+            if (nullptr != segment_variable_postings) {
+                add_variable_postings(logtype_dict, logtype_ids, num_logtypes, vars, var_types, num_vars, segment_logtypes_uncompressed_pos,
+                                      *segment_variable_postings);
+            }
+            return;
+        }
+
+        // Order the messages by logtype, keeping them in arrival order within each logtype
+        vector<uint64_t> message_numbers(num_logtypes);
+        std::iota(message_numbers.begin(), message_numbers.end(), 0);
+        std::stable_sort(message_numbers.begin(), message_numbers.end(), [logtype_ids] (uint64_t lhs, uint64_t rhs) {
+            return logtype_ids[lhs] < logtype_ids[rhs];
+        });
+
+        // Gather the columns in that order
+        vector<epochtime_t> grouped_timestamps(num_timestamps);
+        vector<logtype_dictionary_id_t> grouped_logtype_ids(num_logtypes);
+        vector<encoded_variable_t> grouped_vars;
+        grouped_vars.reserve(num_vars);
+        vector<column_encoding::VariableType> grouped_var_types;
+        grouped_var_types.reserve(num_vars);
+        for (size_t i = 0; i < num_logtypes; ++i) {
+            auto message_number = message_numbers[i];
+            grouped_timestamps[i] = timestamps[message_number];
+            grouped_logtype_ids[i] = logtype_ids[message_number];
+            auto var_begin_ix = message_var_begin_ixs[message_number];
+            auto var_end_ix = message_var_begin_ixs[message_number + 1];
+            grouped_vars.insert(grouped_vars.end(), vars + var_begin_ix, vars + var_end_ix);
+            grouped_var_types.insert(grouped_var_types.end(), var_types + var_begin_ix, var_types + var_end_ix);
+        }
+
+        segment.append_timestamps(grouped_timestamps.data(), num_timestamps, segment_timestamps_uncompressed_pos);
+        segment.append_grouped_logtype_ids(grouped_logtype_ids.data(), message_numbers.data(), num_logtypes, segment_logtypes_uncompressed_pos);
+        segment.append_variables(grouped_vars.data(), grouped_var_types.data(), num_vars, segment_variables_uncompressed_pos);
+        set_segment_metadata(segment.get_id(), segment_timestamps_uncompressed_pos, segment_logtypes_uncompressed_pos, segment_variables_uncompressed_pos);
+        add_logtype_postings(logtype_dict, grouped_logtype_ids.data(), num_logtypes, segment_logtypes_uncompressed_pos, segment_logtype_postings);
+        if (nullptr != segment_variable_postings) {
+            add_variable_postings(logtype_dict, grouped_logtype_ids.data(), num_logtypes, grouped_vars.data(), grouped_var_types.data(), num_vars,
+                                  segment_logtypes_uncompressed_pos, *segment_variable_postings);
+        }
+    }
+
+    void File::add_logtype_postings (const LogTypeDictionaryWriter& logtype_dict, const logtype_dictionary_id_t* logtype_ids, size_t num_logtypes,
+                                     uint64_t segment_logtypes_pos, LogTypePostings& segment_logtype_postings)
+    {
+        Posting posting;
+        posting.file_logtypes_pos = segment_logtypes_pos;
+        posting.begin_variable_ix = 0;
+        for (size_t msg_ix = 0; msg_ix < num_logtypes;) {
+            auto logtype_id = logtype_ids[msg_ix];
+            posting.begin_msg_ix = msg_ix;
+            for (; msg_ix < num_logtypes && logtype_ids[msg_ix] == logtype_id; ++msg_ix) {}
+            posting.end_msg_ix = msg_ix;
+            segment_logtype_postings.add_posting(logtype_id, posting);
+
+            posting.begin_variable_ix += (posting.end_msg_ix - posting.begin_msg_ix) * logtype_dict.get_entry(logtype_id)->get_num_vars();
+        }
+        segment_logtype_postings.increment_num_messages(num_logtypes);
+    }
+
+    void File::add_variable_postings (const LogTypeDictionaryWriter& logtype_dict, const logtype_dictionary_id_t* logtype_ids, size_t num_logtypes,
+                                      const encoded_variable_t* vars, const column_encoding::VariableType* var_types, size_t num_vars,
+                                      uint64_t segment_logtypes_pos, VariablePostings& segment_variable_postings)
+    {
+        Posting posting;
+        posting.file_logtypes_pos = segment_logtypes_pos;
+        size_t var_ix = 0;
+        for (size_t msg_ix = 0; msg_ix < num_logtypes; ++msg_ix) {
+            posting.begin_msg_ix = msg_ix;
+            posting.end_msg_ix = msg_ix + 1;
+            posting.begin_variable_ix = var_ix;
+
+            // NOTE: The postings merge consecutive messages containing the same variable, as well as repeats of a variable within a message
+            auto msg_var_end_ix = std::min(var_ix + logtype_dict.get_entry(logtype_ids[msg_ix])->get_num_vars(), num_vars);
+            for (; var_ix < msg_var_end_ix; ++var_ix) {
+                if (column_encoding::VariableType::DictionaryId == var_types[var_ix]) {
+                    segment_variable_postings.add_posting(EncodedVariableInterpreter::decode_var_dict_id(vars[var_ix]), posting);
                 }
             }
         }
+        segment_variable_postings.increment_num_messages(num_logtypes);
     }
 
     void File::increment_num_uncompressed_bytes (size_t num_bytes) {
@@ -14,6 +14,7 @@
 #include "../../ErrorCode.hpp"
 #include "../../LogTypeDictionaryWriter.hpp"
 #include "../../TimestampPattern.hpp"
+#include "../Postings.hpp"
 #include "Segment.hpp"
 
 namespace streaming_archive { namespace writer {
@@ -65,9 +66,10 @@ namespace streaming_archive { namespace writer {
         virtual bool is_open () const = 0;
         virtual void open () = 0;
         virtual void close () = 0;
-        virtual void append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment,
+        virtual void append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment, bool group_messages_by_logtype,
                                         std::unordered_set<logtype_dictionary_id_t>& segment_logtype_ids,
-                                        std::unordered_set<variable_dictionary_id_t>& segment_var_ids) = 0;
+                                        std::unordered_set<variable_dictionary_id_t>& segment_var_ids, LogTypePostings& segment_logtype_postings,
+                                        VariablePostings* segment_variable_postings) = 0;
         virtual void cleanup_after_segment_insertion () = 0;
         virtual void write_encoded_msg (epochtime_t timestamp, logtype_dictionary_id_t logtype_id, const std::vector<encoded_variable_t>& encoded_vars,
                 size_t num_uncompressed_bytes) = 0;
@@ -159,7 +161,8 @@ namespace streaming_archive { namespace writer {
 
         // Methods
         /**
-         * Takes logtype and variable IDs from a file's logtype and variable columns and appends them to the given sets
+         * Takes logtype and variable IDs from a file's logtype and variable columns and appends them to the given sets. Since this requires
+         * interpreting each variable using its logtype, it also returns the variables' types for the segment's variables column.
          * @param logtype_dict
          * @param logtype_ids
          * @param num_logtypes
@@ -167,12 +170,60 @@ namespace streaming_archive { namespace writer {
          * @param num_vars
          * @param segment_logtype_ids
          * @param segment_var_ids
+         * @param var_types Returns the type of each variable
          */
         static void append_logtype_and_var_ids_to_segment_sets (const LogTypeDictionaryWriter& logtype_dict, const logtype_dictionary_id_t* logtype_ids,
                                                                 size_t num_logtypes, const encoded_variable_t* vars, size_t num_vars,
                                                                 std::unordered_set<logtype_dictionary_id_t>& segment_logtype_ids,
-                                                                std::unordered_set<variable_dictionary_id_t>& segment_var_ids);
-
+                                                                std::unordered_set<variable_dictionary_id_t>& segment_var_ids,
+                                                                std::vector<column_encoding::VariableType>& var_types);
+        /**
+         * Appends a file's columns to the given segment and records their positions in the file's metadata. If requested, the messages are grouped
+         * by logtype (see column_encoding::MessageOrder::GroupedByLogtype) so that searches only need to scan the groups with matching logtypes.
+         * Each run of messages with the same logtype (in the order they're appended) is added to the segment's logtype postings, and each run of
+         * messages containing the same dictionary variable is added to the segment's variable postings, if given.
+         * @param logtype_dict
+         * @param timestamps
+         * @param num_timestamps
+         * @param logtype_ids
+         * @param num_logtypes
+         * @param vars
+         * @param var_types
+         * @param num_vars
+         * @param group_messages_by_logtype
+         * @param segment
+         * @param segment_logtype_postings
+         * @param segment_variable_postings Postings to add the file's dictionary variables to, or nullptr if variables aren't indexed
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
+         */
+        void append_columns_to_segment (const LogTypeDictionaryWriter& logtype_dict, const epochtime_t* timestamps, size_t num_timestamps,
+                                        const logtype_dictionary_id_t* logtype_ids, size_t num_logtypes, const encoded_variable_t* vars,
+                                        const column_encoding::VariableType* var_types, size_t num_vars, bool group_messages_by_logtype,
+                                        Segment& segment, LogTypePostings& segment_logtype_postings, VariablePostings* segment_variable_postings);
+        /**
+         * Adds each run of messages with the same logtype in a file's logtype IDs column to the given postings
+         * @param logtype_dict
+         * @param logtype_ids
+         * @param num_logtypes
+         * @param segment_logtypes_pos Position of the column in the segment
+         * @param segment_logtype_postings
+         */
+        static void add_logtype_postings (const LogTypeDictionaryWriter& logtype_dict, const logtype_dictionary_id_t* logtype_ids, size_t num_logtypes,
+                                          uint64_t segment_logtypes_pos, LogTypePostings& segment_logtype_postings);
+        /**
+         * Adds each run of messages containing the same dictionary variable in a file's columns to the given postings
+         * @param logtype_dict
+         * @param logtype_ids
+         * @param num_logtypes
+         * @param vars
+         * @param var_types
+         * @param num_vars
+         * @param segment_logtypes_pos Position of the file's logtype IDs column in the segment
+         * @param segment_variable_postings
+         */
+        static void add_variable_postings (const LogTypeDictionaryWriter& logtype_dict, const logtype_dictionary_id_t* logtype_ids, size_t num_logtypes,
+                                           const encoded_variable_t* vars, const column_encoding::VariableType* var_types, size_t num_vars,
+                                           uint64_t segment_logtypes_pos, VariablePostings& segment_variable_postings);
 
         void increment_num_uncompressed_bytes (size_t num_bytes);
         /**
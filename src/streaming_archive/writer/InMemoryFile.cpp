@@ -45,8 +45,9 @@ namespace streaming_archive { namespace writer {
         increment_num_uncompressed_bytes(num_uncompressed_bytes);
     }
 
-    void InMemoryFile::append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment,
-                                          unordered_set<logtype_dictionary_id_t>& segment_logtype_ids, unordered_set<variable_dictionary_id_t>& segment_var_ids)
+    void InMemoryFile::append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment, bool group_messages_by_logtype,
+                                          unordered_set<logtype_dictionary_id_t>& segment_logtype_ids, unordered_set<variable_dictionary_id_t>& segment_var_ids,
+                                          LogTypePostings& segment_logtype_postings, VariablePostings* segment_variable_postings)
     {
         if (m_is_open) {
             throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
@@ -55,24 +56,22 @@ namespace streaming_archive { namespace writer {
         // Add file's logtype and variable IDs to respective segment sets
         auto logtype_ids = m_logtypes.data();
         auto variables = m_variables.data();
+        vector<column_encoding::VariableType> variable_types;
         append_logtype_and_var_ids_to_segment_sets(logtype_dict, logtype_ids, m_logtypes.size(), variables, m_variables.size(), segment_logtype_ids,
-                                                   segment_var_ids);
+                                                   segment_var_ids, variable_types);
 
         // Append files to segment
-        uint64_t segment_timestamps_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(m_timestamps.data()), m_timestamps.size_in_bytes(), segment_timestamps_uncompressed_pos);
-        uint64_t segment_logtypes_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(m_logtypes.data()), m_logtypes.size_in_bytes(), segment_logtypes_uncompressed_pos);
-        uint64_t segment_variables_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(m_variables.data()), m_variables.size_in_bytes(), segment_variables_uncompressed_pos);
-        set_segment_metadata(segment.get_id(), segment_timestamps_uncompressed_pos, segment_logtypes_uncompressed_pos, segment_variables_uncompressed_pos);
-        m_segmentation_state = SegmentationState_MovingToSegment;
-
-        // Mark file as written out and clear in-memory columns
-        m_is_written_out = true;
+        // NOTE: The segment copies the columns as it encodes them, so we free them right away
+        append_columns_to_segment(logtype_dict, m_timestamps.data(), m_timestamps.size(), logtype_ids, m_logtypes.size(), variables, variable_types.data(),
+                                  m_variables.size(), group_messages_by_logtype, segment, segment_logtype_postings,
+                                  segment_variable_postings);
         m_timestamps.clear();
         m_logtypes.clear();
         m_variables.clear();
+        m_segmentation_state = SegmentationState_MovingToSegment;
+
+        // Mark file as written out
+        m_is_written_out = true;
     }
 
     void InMemoryFile::cleanup_after_segment_insertion () {
@@ -63,12 +63,17 @@ namespace streaming_archive { namespace writer {
          * Appends file's columns to the given segment
          * @param logtype_dict
          * @param segment
+         * @param group_messages_by_logtype
          * @param segment_logtype_ids
          * @param segment_var_ids
+         * @param segment_logtype_postings
+         * @param segment_variable_postings
          * @throw streaming_archive::writer::InMemoryFile::OperationFailed if file is still open or any column fails to be appended
          */
-        void append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment, std::unordered_set<logtype_dictionary_id_t>& segment_logtype_ids,
-                                std::unordered_set<variable_dictionary_id_t>& segment_var_ids) override;
+        void append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment, bool group_messages_by_logtype,
+                                std::unordered_set<logtype_dictionary_id_t>& segment_logtype_ids,
+                                std::unordered_set<variable_dictionary_id_t>& segment_var_ids, LogTypePostings& segment_logtype_postings,
+                                VariablePostings* segment_variable_postings) override;
         /**
          * Cleans up any data after inserting the file into the segment
          */
@@ -75,8 +75,9 @@ namespace streaming_archive { namespace writer {
         increment_num_uncompressed_bytes(num_uncompressed_bytes);
     }
 
-    void OnDiskFile::append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment,
-                                        unordered_set<logtype_dictionary_id_t>& segment_logtype_ids, unordered_set<variable_dictionary_id_t>& segment_var_ids)
+    void OnDiskFile::append_to_segment (const LogTypeDictionaryWriter& logtype_dict, Segment& segment, bool group_messages_by_logtype,
+                                        unordered_set<logtype_dictionary_id_t>& segment_logtype_ids, unordered_set<variable_dictionary_id_t>& segment_var_ids,
+                                        LogTypePostings& segment_logtype_postings, VariablePostings* segment_variable_postings)
     {
         if (m_is_open) {
             throw OperationFailed(ErrorCode_Unsupported, __FILENAME__, __LINE__);
@@ -152,16 +153,14 @@ namespace streaming_archive { namespace writer {
         size_t num_logtypes = logtypes_file_size / sizeof(logtype_dictionary_id_t);
         auto variables = reinterpret_cast<encoded_variable_t*>(variables_ptr);
         size_t num_vars = variables_file_size / sizeof(encoded_variable_t);
-        append_logtype_and_var_ids_to_segment_sets(logtype_dict, logtype_ids, num_logtypes, variables, num_vars, segment_logtype_ids, segment_var_ids);
+        vector<column_encoding::VariableType> variable_types;
+        append_logtype_and_var_ids_to_segment_sets(logtype_dict, logtype_ids, num_logtypes, variables, num_vars, segment_logtype_ids, segment_var_ids,
+                                                   variable_types);
 
         // Append files to segment
-        uint64_t segment_timestamps_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(timestamps_ptr), timestamps_file_size, segment_timestamps_uncompressed_pos);
-        uint64_t segment_logtypes_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(logtypes_ptr), logtypes_file_size, segment_logtypes_uncompressed_pos);
-        uint64_t segment_variables_uncompressed_pos;
-        segment.append(reinterpret_cast<const char*>(variables_ptr), variables_file_size, segment_variables_uncompressed_pos);
-        set_segment_metadata(segment.get_id(), segment_timestamps_uncompressed_pos, segment_logtypes_uncompressed_pos, segment_variables_uncompressed_pos);
+        append_columns_to_segment(logtype_dict, reinterpret_cast<const epochtime_t*>(timestamps_ptr), num_read_timestamps, logtype_ids, num_logtypes,
+                                  variables, variable_types.data(), num_vars, group_messages_by_logtype, segment,
+                                  segment_logtype_postings, segment_variable_postings);
         m_segmentation_state = SegmentationState_MovingToSegment;
 
         // Unmap timestamps file
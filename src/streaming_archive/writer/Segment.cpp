@@ -1,6 +1,7 @@
 #include "Segment.hpp"
 
 // C standard libraries
+#include <sys/mman.h>
 #include <sys/stat.h>
 
 // C++ standard libraries
@@ -14,6 +15,7 @@
 // Project headers
 #include "../../ErrorCode.hpp"
 #include "../../FileWriter.hpp"
+#include "../ColumnEncoding.hpp"
 
 using std::make_unique;
 using std::string;
@@ -21,10 +23,55 @@ using std::to_string;
 using std::unique_ptr;
 
 namespace streaming_archive { namespace writer {
+    Segment::PendingBuffer::PendingBuffer (PendingBuffer&& other) noexcept : m_copy(std::move(other.m_copy)), m_buf(other.m_buf),
+            m_buf_len(other.m_buf_len), m_region(other.m_region), m_region_size(other.m_region_size)
+    {
+        other.m_buf = nullptr;
+        other.m_buf_len = 0;
+        other.m_region = nullptr;
+        other.m_region_size = 0;
+    }
+
+    Segment::PendingBuffer& Segment::PendingBuffer::operator= (PendingBuffer&& other) noexcept {
+        if (this != &other) {
+            free();
+
+            m_copy = std::move(other.m_copy);
+            m_buf = other.m_buf;
+            m_buf_len = other.m_buf_len;
+            m_region = other.m_region;
+            m_region_size = other.m_region_size;
+
+            other.m_buf = nullptr;
+            other.m_buf_len = 0;
+            other.m_region = nullptr;
+            other.m_region_size = 0;
+        }
+        return *this;
+    }
+
+    Segment::PendingBuffer::~PendingBuffer () {
+        free();
+    }
+
+    void Segment::PendingBuffer::free () {
+        m_copy.reset();
+        if (nullptr != m_region) {
+            if (0 != munmap(m_region, m_region_size)) {
+                SPDLOG_ERROR("streaming_archive::writer::Segment: munmap failed with errno={}", errno);
+            }
+            m_region = nullptr;
+            m_region_size = 0;
+        }
+        m_buf = nullptr;
+        m_buf_len = 0;
+    }
+
     Segment::~Segment () {
         if (!m_segment_path.empty()) {
             SPDLOG_ERROR("streaming_archive::writer::Segment: Segment {} not closed before being destroyed causing possible data loss", m_segment_path.c_str());
         }
+        stop_compression_thread();
     }
 
     void Segment::open (const string& segments_dir_path, segment_id_t id, int compression_level) {
@@ -45,25 +92,83 @@ namespace streaming_archive { namespace writer {
         // Configure a zstd streaming compressor
         m_compressor.open(m_file_writer, compression_level);
 #endif
+        m_compressed_size = 0;
+
+        m_compression_exception = nullptr;
+        m_pending_buffers = make_unique<BoundedSPSCQueue<PendingBuffer>>(cMaxNumPendingBuffers);
+        m_compression_thread = std::thread(&Segment::compress_pending_buffers, this);
     }
 
     void Segment::close () {
+        stop_compression_thread();
+        if (nullptr != m_compression_exception) {
+            std::rethrow_exception(m_compression_exception);
+        }
+
         m_compressor.close();
         m_file_writer.flush();
+        m_compressed_size = m_file_writer.get_pos();
         m_file_writer.close();
 
         // Clear Segment
         m_offset = 0;
         m_segment_path.clear();
+        m_encoding_buf.reset();
+        m_encoding_buf_size = 0;
+        m_scratch_buf.reset();
+        m_scratch_buf_size = 0;
     }
 
     void Segment::append (const char* buf, const uint64_t buf_len, uint64_t& offset) {
-        // Compress
-        m_compressor.write(buf, buf_len);
+        auto copy = unique_ptr<char[]>(new char[buf_len]);
+        memcpy(copy.get(), buf, buf_len);
+        append_pending_buffer(PendingBuffer(std::move(copy), buf_len), offset);
+    }
 
-        // Return offset and update it
-        offset = m_offset;
-        m_offset += buf_len;
+    void Segment::append_timestamps (const epochtime_t* timestamps, size_t num_timestamps, uint64_t& offset) {
+        auto encoding_buf = get_encoding_buf(column_encoding::get_max_delta_varints_length(num_timestamps));
+        auto encoded_length = column_encoding::encode_delta_varints(timestamps, num_timestamps, encoding_buf);
+        append_encoded_column(encoded_length, offset);
+    }
+
+    void Segment::append_logtype_ids (const logtype_dictionary_id_t* logtype_ids, size_t num_logtype_ids, uint64_t& offset) {
+        auto encoding_buf = get_encoding_buf(sizeof(column_encoding::MessageOrder) + column_encoding::get_max_bit_packed_length(num_logtype_ids));
+        encoding_buf[0] = (char)column_encoding::MessageOrder::Arrival;
+        auto encoded_length = sizeof(column_encoding::MessageOrder);
+        encoded_length += column_encoding::bit_pack(logtype_ids, num_logtype_ids, encoding_buf + encoded_length);
+        append_encoded_column(encoded_length, offset);
+    }
+
+    void Segment::append_grouped_logtype_ids (const logtype_dictionary_id_t* logtype_ids, const uint64_t* message_numbers, size_t num_logtype_ids,
+                                              uint64_t& offset)
+    {
+        uint64_t logtype_ids_length;
+        auto encoding_buf = get_encoding_buf(sizeof(column_encoding::MessageOrder) + sizeof(logtype_ids_length)
+                                             + column_encoding::get_max_bit_packed_length(num_logtype_ids)
+                                             + column_encoding::get_max_delta_varints_length(num_logtype_ids));
+        encoding_buf[0] = (char)column_encoding::MessageOrder::GroupedByLogtype;
+        auto encoded_length = sizeof(column_encoding::MessageOrder);
+
+        // The logtype IDs are prefixed with their length so the message numbers can be found
+        logtype_ids_length = column_encoding::bit_pack(logtype_ids, num_logtype_ids, encoding_buf + encoded_length + sizeof(logtype_ids_length));
+        memcpy(encoding_buf + encoded_length, &logtype_ids_length, sizeof(logtype_ids_length));
+        encoded_length += sizeof(logtype_ids_length) + logtype_ids_length;
+
+        encoded_length += column_encoding::encode_delta_varints(reinterpret_cast<const int64_t*>(message_numbers), num_logtype_ids,
+                                                                encoding_buf + encoded_length);
+        append_encoded_column(encoded_length, offset);
+    }
+
+    void Segment::append_variables (const encoded_variable_t* variables, const column_encoding::VariableType* variable_types, size_t num_variables,
+                                    uint64_t& offset)
+    {
+        if (num_variables > m_scratch_buf_size) {
+            m_scratch_buf = unique_ptr<int64_t[]>(new int64_t[num_variables]);
+            m_scratch_buf_size = num_variables;
+        }
+        auto encoding_buf = get_encoding_buf(column_encoding::get_max_variables_length(num_variables));
+        auto encoded_length = column_encoding::encode_variables(variables, variable_types, num_variables, m_scratch_buf.get(), encoding_buf);
+        append_encoded_column(encoded_length, offset);
     }
 
     uint64_t Segment::get_uncompressed_size () {
@@ -73,4 +178,59 @@ namespace streaming_archive { namespace writer {
     bool Segment::is_open () const {
         return !m_segment_path.empty();
     }
-} }
\ No newline at end of file
+
+    char* Segment::get_encoding_buf (size_t max_encoded_length) {
+        auto required_size = sizeof(uint64_t) + max_encoded_length;
+        if (required_size > m_encoding_buf_size) {
+            m_encoding_buf = unique_ptr<char[]>(new char[required_size]);
+            m_encoding_buf_size = required_size;
+        }
+        return m_encoding_buf.get() + sizeof(uint64_t);
+    }
+
+    void Segment::append_encoded_column (uint64_t encoded_length, uint64_t& offset) {
+        memcpy(m_encoding_buf.get(), &encoded_length, sizeof(encoded_length));
+        // NOTE: We copy the encoded column rather than handing over the encoding buffer, since the buffer is sized for the worst case
+        append(m_encoding_buf.get(), sizeof(encoded_length) + encoded_length, offset);
+    }
+
+    void Segment::append_pending_buffer (PendingBuffer&& pending_buffer, uint64_t& offset) {
+        auto buf_len = pending_buffer.size();
+        if (false == m_pending_buffers->push(std::move(pending_buffer))) {
+            // The compression thread only closes the queue if it failed
+            std::rethrow_exception(m_compression_exception);
+        }
+
+        // Return offset and update it
+        offset = m_offset;
+        m_offset += buf_len;
+    }
+
+    void Segment::compress_pending_buffers () {
+        try {
+            PendingBuffer pending_buffer;
+            while (m_pending_buffers->pop(pending_buffer)) {
+                if (pending_buffer.size() > 0) {
+                    m_compressor.write(pending_buffer.data(), pending_buffer.size());
+                    m_compressed_size = m_file_writer.get_pos();
+                }
+                // Free the buffer's memory as soon as it's compressed
+                pending_buffer = PendingBuffer();
+            }
+        } catch (...) {
+            m_compression_exception = std::current_exception();
+            m_pending_buffers->close();
+        }
+    }
+
+    void Segment::stop_compression_thread () {
+        if (false == m_compression_thread.joinable()) {
+            return;
+        }
+
+        // Closing the queue lets the compression thread exit once it has compressed all pending buffers
+        m_pending_buffers->close();
+        m_compression_thread.join();
+        m_pending_buffers.reset();
+    }
+} }
@@ -2,20 +2,27 @@
 #define STREAMING_ARCHIVE_WRITER_SEGMENT_HPP
 
 // C++ standard libraries
+#include <atomic>
+#include <exception>
 #include <memory>
 #include <string>
+#include <thread>
 
 // Project headers
+#include "../../BoundedSPSCQueue.hpp"
 #include "../../Defs.h"
 #include "../../ErrorCode.hpp"
+#include "../../PageAllocatedVector.hpp"
 #include "../../streaming_compression/passthrough/Compressor.hpp"
 #include "../../streaming_compression/zstd/Compressor.hpp"
 #include "../../TraceableException.hpp"
+#include "../ColumnEncoding.hpp"
 #include "../Constants.hpp"
 
 namespace streaming_archive { namespace writer {
     /**
      * Class for writing segments. A segment is a container for multiple compressed buffers that itself may be further compressed and then stored on disk.
+     * Appended buffers are compressed on a background thread, so that the caller can continue encoding while the segment is compressed.
      */
     class Segment {
     public:
@@ -32,7 +39,7 @@ namespace streaming_archive { namespace writer {
         };
 
         // Constructors
-        Segment () : m_id(cInvalidSegmentId), m_offset(0) {}
+        Segment () : m_id(cInvalidSegmentId), m_offset(0), m_compressed_size(0), m_encoding_buf_size(0), m_scratch_buf_size(0) {}
 
         // Destructor
         ~Segment ();
@@ -47,33 +54,167 @@ namespace streaming_archive { namespace writer {
          */
         void open (const std::string& segments_dir_path, segment_id_t id, int compression_level);
         /**
-         * Closes the segment
+         * Waits for all appended buffers to be compressed and then closes the segment
          * @throw streaming_archive::writer::Segment::OperationFailed if compression fails
          * @throw FileWriter::OperationFailed on open, write, or close failure
          */
         void close ();
 
         /**
-         * Appends the given buffer to the segment
+         * Appends a copy of the given buffer to the segment
          * @param buf Buffer to append
          * @param buf_len
          * @param offset Offset of the buffer in the segment
-         * @throw streaming_archive::writer::Segment::OperationFailed if compression fails
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
          */
         void append (const char* buf, uint64_t buf_len, uint64_t& offset);
+        /**
+         * Appends the given values to the segment, taking ownership of their memory rather than copying it. The vector is left empty.
+         * @tparam ValueType
+         * @param values
+         * @param offset Offset of the values in the segment
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
+         */
+        template <typename ValueType>
+        void append (PageAllocatedVector<ValueType>& values, uint64_t& offset);
+        /**
+         * Appends the given timestamps to the segment as a column encoded with column_encoding::encode_delta_varints
+         * @param timestamps
+         * @param num_timestamps
+         * @param offset Offset of the column in the segment
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
+         */
+        void append_timestamps (const epochtime_t* timestamps, size_t num_timestamps, uint64_t& offset);
+        /**
+         * Appends the given logtype IDs, for messages in arrival order, to the segment as a column encoded with column_encoding::bit_pack
+         * @param logtype_ids
+         * @param num_logtype_ids
+         * @param offset Offset of the column in the segment
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
+         */
+        void append_logtype_ids (const logtype_dictionary_id_t* logtype_ids, size_t num_logtype_ids, uint64_t& offset);
+        /**
+         * Appends the given logtype IDs, for messages grouped by logtype, to the segment as a column encoded with column_encoding::bit_pack and
+         * followed by the messages' original message numbers, encoded with column_encoding::encode_delta_varints
+         * @param logtype_ids
+         * @param message_numbers
+         * @param num_logtype_ids
+         * @param offset Offset of the column in the segment
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
+         */
+        void append_grouped_logtype_ids (const logtype_dictionary_id_t* logtype_ids, const uint64_t* message_numbers, size_t num_logtype_ids,
+                                         uint64_t& offset);
+        /**
+         * Appends the given variables to the segment as a column encoded with column_encoding::encode_variables
+         * @param variables
+         * @param variable_types
+         * @param num_variables
+         * @param offset Offset of the column in the segment
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
+         */
+        void append_variables (const encoded_variable_t* variables, const column_encoding::VariableType* variable_types, size_t num_variables,
+                               uint64_t& offset);
 
         segment_id_t get_id () const { return m_id; }
         bool is_open () const;
         uint64_t get_uncompressed_size ();
-        size_t get_compressed_size () const { return m_file_writer.get_pos(); }
+        /**
+         * Gets the size of the segment on disk. While the segment is open, this only includes buffers which have been compressed so far.
+         * @return Size in bytes
+         */
+        size_t get_compressed_size () const { return m_compressed_size; }
 
     private:
+        // Types
+        /**
+         * A buffer waiting to be compressed, which owns either a copy of the appended data or the page-allocated region containing it
+         */
+        class PendingBuffer {
+        public:
+            // Constructors
+            PendingBuffer () : m_buf(nullptr), m_buf_len(0), m_region(nullptr), m_region_size(0) {}
+            PendingBuffer (std::unique_ptr<char[]> copy, uint64_t buf_len) : m_copy(std::move(copy)), m_buf(m_copy.get()), m_buf_len(buf_len),
+                    m_region(nullptr), m_region_size(0) {}
+            PendingBuffer (void* region, size_t region_size, uint64_t buf_len) : m_buf(static_cast<const char*>(region)), m_buf_len(buf_len),
+                    m_region(region), m_region_size(region_size) {}
+
+            // Move constructor and assignment operator
+            PendingBuffer (PendingBuffer&& other) noexcept;
+            PendingBuffer& operator= (PendingBuffer&& other) noexcept;
+
+            // Destructor
+            ~PendingBuffer ();
+
+            // Methods
+            const char* data () const { return m_buf; }
+            uint64_t size () const { return m_buf_len; }
+
+        private:
+            // Methods
+            /**
+             * Frees the owned memory
+             */
+            void free ();
+
+            // Variables
+            std::unique_ptr<char[]> m_copy;
+            const char* m_buf;
+            uint64_t m_buf_len;
+            void* m_region;
+            size_t m_region_size;
+        };
+
+        // Constants
+        // Maximum number of buffers waiting to be compressed before append blocks (i.e., three files' worth of columns)
+        static constexpr size_t cMaxNumPendingBuffers = 9;
+
+        // Methods
+        /**
+         * Gets the buffer used to encode columns, growing it if necessary. An encoded column is prefixed with its length, so the buffer has room for
+         * the prefix before the returned position.
+         * @param max_encoded_length
+         * @return Position in the buffer at which to encode the column
+         */
+        char* get_encoding_buf (size_t max_encoded_length);
+        /**
+         * Appends a copy of the column encoded in the encoding buffer, prefixed with its length
+         * @param encoded_length
+         * @param offset Offset of the column in the segment
+         * @throw Same as streaming_archive::writer::Segment::append_pending_buffer
+         */
+        void append_encoded_column (uint64_t encoded_length, uint64_t& offset);
+        /**
+         * Queues the given buffer to be compressed
+         * @param pending_buffer
+         * @param offset Offset of the buffer in the segment
+         * @throw Any exception thrown while compressing a previously appended buffer
+         */
+        void append_pending_buffer (PendingBuffer&& pending_buffer, uint64_t& offset);
+        /**
+         * Compresses pending buffers until the queue is closed and drained. This runs on the compression thread.
+         */
+        void compress_pending_buffers ();
+        /**
+         * Stops the compression thread and waits for it to exit
+         */
+        void stop_compression_thread ();
+
         // Variables
         std::string m_segment_path;
         segment_id_t m_id;
 
         uint64_t m_offset;      // total input bytes processed
 
+        std::unique_ptr<BoundedSPSCQueue<PendingBuffer>> m_pending_buffers;
+        std::thread m_compression_thread;
+        std::exception_ptr m_compression_exception;
+        std::atomic_size_t m_compressed_size;
+
+        std::unique_ptr<char[]> m_encoding_buf;
+        size_t m_encoding_buf_size;
+        std::unique_ptr<int64_t[]> m_scratch_buf;
+        size_t m_scratch_buf_size;
+
         FileWriter m_file_writer;
 #if USE_PASSTHROUGH_COMPRESSION
         streaming_compression::passthrough::Compressor m_compressor;
@@ -81,6 +222,14 @@ namespace streaming_archive { namespace writer {
         streaming_compression::zstd::Compressor m_compressor;
 #endif
     };
+
+    template <typename ValueType>
+    void Segment::append (PageAllocatedVector<ValueType>& values, uint64_t& offset) {
+        auto buf_len = values.size_in_bytes();
+        size_t region_size;
+        auto region = values.release(region_size);
+        append_pending_buffer(PendingBuffer(region, region_size, buf_len), offset);
+    }
 } }
 
 #endif // STREAMING_ARCHIVE_WRITER_SEGMENT_HPP
@@ -0,0 +1,305 @@
+// C++ standard libraries
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/GlobalMetadataDB.hpp"
+#include "../src/streaming_archive/Constants.hpp"
+#include "../src/streaming_archive/MetadataDB.hpp"
+#include "../src/streaming_archive/reader/Archive.hpp"
+#include "../src/streaming_archive/reader/File.hpp"
+#include "../src/streaming_archive/reader/Message.hpp"
+#include "../src/streaming_archive/writer/Archive.hpp"
+#include "../src/TimestampPattern.hpp"
+
+using std::map;
+using std::string;
+using std::vector;
+
+/**
+ * @param output_dir
+ * @param global_metadata_db
+ * @return Settings for a new archive in the given directory
+ */
+static streaming_archive::writer::Archive::UserConfig get_archive_user_config (const string& output_dir, GlobalMetadataDB& global_metadata_db) {
+    streaming_archive::writer::Archive::UserConfig user_config = {};
+    user_config.id = boost::uuids::random_generator()();
+    user_config.creator_id = boost::uuids::random_generator()();
+    user_config.creation_num = 0;
+    user_config.target_segment_uncompressed_size = 1L * 1024 * 1024 * 1024;
+    user_config.compression_level = 3;
+    user_config.output_dir = output_dir;
+    user_config.global_metadata_db = &global_metadata_db;
+    user_config.durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::None;
+    return user_config;
+}
+
+/**
+ * Writes a file without timestamps containing the given messages
+ * @param archive
+ * @param path
+ * @param messages
+ */
+static void write_file (streaming_archive::writer::Archive& archive, const string& path, const vector<string>& messages) {
+    boost::uuids::random_generator uuid_generator;
+    auto file = archive.create_in_memory_file(path, 0, uuid_generator(), 0);
+    archive.open_file(*file);
+    for (const auto& message : messages) {
+        archive.write_msg(*file, 0, message, message.length());
+    }
+    archive.close_file(*file);
+    archive.mark_file_ready_for_segment(file);
+}
+
+/**
+ * Writes a file whose messages all have the given timestamp pattern
+ * @param archive
+ * @param path
+ * @param timestamp_pattern
+ * @param messages
+ */
+static void write_file_with_timestamps (streaming_archive::writer::Archive& archive, const string& path, const TimestampPattern& timestamp_pattern,
+                                        const vector<string>& messages)
+{
+    boost::uuids::random_generator uuid_generator;
+    auto file = archive.create_in_memory_file(path, 0, uuid_generator(), 0);
+    archive.open_file(*file);
+    archive.change_ts_pattern(*file, &timestamp_pattern);
+    epochtime_t timestamp = 0;
+    for (const auto& message : messages) {
+        archive.write_msg(*file, ++timestamp, message, message.length());
+    }
+    archive.close_file(*file);
+    archive.mark_file_ready_for_segment(file);
+}
+
+/**
+ * Decompresses every file in the given archive
+ * @param archive
+ * @param file_contents Returns the content of each file, by path
+ * @param file_segment_ids Returns the segment of each file, by path
+ */
+static void decompress_files (streaming_archive::reader::Archive& archive, map<string, string>& file_contents,
+                              map<string, segment_id_t>& file_segment_ids)
+{
+    streaming_archive::reader::File file;
+    streaming_archive::reader::Message message;
+    string path;
+    string decompressed_message;
+    for (auto ix = archive.get_file_iterator(); ix->has_next(); ix->next()) {
+        ix->get_path(path);
+        file_segment_ids[path] = ix->get_segment_id();
+        REQUIRE(ErrorCode_Success == archive.open_file(file, *ix, false));
+        auto& content = file_contents[path];
+        while (archive.get_next_message(file, message)) {
+            REQUIRE(archive.decompress_message(file, message, decompressed_message));
+            content += decompressed_message;
+        }
+        archive.close_file(file);
+    }
+}
+
+/**
+ * @param archive_path
+ * @return The number of files whose metadata has been persisted in the archive's metadata database
+ */
+static size_t get_num_persisted_files (const string& archive_path) {
+    streaming_archive::MetadataDB metadata_db;
+    metadata_db.open(archive_path + '/' + streaming_archive::cMetadataDBFileName, false);
+    size_t num_files = 0;
+    for (auto ix = metadata_db.get_file_iterator(cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId); ix.has_next(); ix.next()) {
+        ++num_files;
+    }
+    metadata_db.close();
+    return num_files;
+}
+
+/**
+ * @param global_metadata_db
+ * @param archive_id
+ * @return The number of segments committed to the given archive, according to the global metadata database
+ */
+static size_t get_num_committed_segments (GlobalMetadataDB& global_metadata_db, const string& archive_id) {
+    string id;
+    for (auto archive_ix = global_metadata_db.get_archive_iterator(); archive_ix.has_next(); archive_ix.next()) {
+        archive_ix.get_id(id);
+        if (id == archive_id) {
+            return archive_ix.get_num_committed_segments();
+        }
+    }
+    REQUIRE(false);
+    return 0;
+}
+
+/**
+ * @param archive_path
+ * @return The IDs of the segments that contain committed files
+ */
+static vector<segment_id_t> get_ids_of_committed_segments (const string& archive_path) {
+    streaming_archive::MetadataDB metadata_db;
+    metadata_db.open(archive_path + '/' + streaming_archive::cMetadataDBFileName, false);
+    vector<segment_id_t> segment_ids;
+    metadata_db.get_ids_of_segments_with_files(0, segment_ids);
+    metadata_db.close();
+    return segment_ids;
+}
+
+TEST_CASE("Test appending to an existing archive", "[Archive]") {
+    string output_dir = "unit-test-archive/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    GlobalMetadataDB global_metadata_db;
+    global_metadata_db.open(output_dir + streaming_archive::cMetadataDBFileName, true);
+
+    auto user_config = get_archive_user_config(output_dir, global_metadata_db);
+
+    // Write two segments in the archive and close it
+    streaming_archive::writer::Archive writer_archive;
+    writer_archive.open(user_config);
+    auto archive_path = output_dir + writer_archive.get_id_as_string();
+    write_file(writer_archive, "/logs/a.log", {"connected to node-a1 in 5 ms\n", "task t-1a failed\n"});
+    writer_archive.commit();
+    write_file(writer_archive, "/logs/b.log", {"connected to node-b1 in 7 ms\n"});
+    writer_archive.close();
+
+    streaming_archive::reader::Archive reader_archive;
+    reader_archive.open(archive_path);
+    reader_archive.refresh_dictionaries();
+    auto num_logtypes = reader_archive.get_logtype_dictionary().get_entries().size();
+    auto num_vars = reader_archive.get_var_dictionary().get_entries().size();
+    REQUIRE(3 == num_vars);
+    reader_archive.close();
+
+    // Append a file whose messages reuse the archive's logtypes and one of its variables
+    writer_archive.open_existing(user_config);
+    write_file(writer_archive, "/logs/c.log", {"connected to node-a1 in 9 ms\n", "task t-1c failed\n"});
+    writer_archive.close();
+    global_metadata_db.close();
+
+    reader_archive.open(archive_path);
+    reader_archive.refresh_dictionaries();
+    const auto& logtype_dictionary = reader_archive.get_logtype_dictionary();
+    REQUIRE(num_logtypes == logtype_dictionary.get_entries().size());
+    const auto& var_dictionary = reader_archive.get_var_dictionary();
+    REQUIRE(num_vars + 1 == var_dictionary.get_entries().size());
+    auto reused_var_entry = var_dictionary.get_entry_matching_value("node-a1", false);
+    REQUIRE(nullptr != reused_var_entry);
+    const auto& reused_var_segment_ids = reused_var_entry->get_ids_of_segments_containing_entry();
+    REQUIRE(2 == reused_var_segment_ids.size());
+    REQUIRE(reused_var_segment_ids.contains(0));
+    REQUIRE(reused_var_segment_ids.contains(2));
+
+    // The appended file should be in a new segment after the existing ones, and all files should be readable
+    map<string, string> file_contents;
+    map<string, segment_id_t> file_segment_ids;
+    decompress_files(reader_archive, file_contents, file_segment_ids);
+    reader_archive.close();
+    REQUIRE(map<string, segment_id_t>({{"/logs/a.log", 0}, {"/logs/b.log", 1}, {"/logs/c.log", 2}}) == file_segment_ids);
+    REQUIRE(map<string, string>({{"/logs/a.log", "connected to node-a1 in 5 ms\ntask t-1a failed\n"},
+                                 {"/logs/b.log", "connected to node-b1 in 7 ms\n"},
+                                 {"/logs/c.log", "connected to node-a1 in 9 ms\ntask t-1c failed\n"}}) == file_contents);
+
+    boost::filesystem::remove_all(output_dir);
+}
+
+TEST_CASE("Test group commits", "[Archive]") {
+    string output_dir = "unit-test-archive/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    GlobalMetadataDB global_metadata_db;
+    global_metadata_db.open(output_dir + streaming_archive::cMetadataDBFileName, true);
+
+    // Close a segment for every file
+    auto user_config = get_archive_user_config(output_dir, global_metadata_db);
+    user_config.target_segment_uncompressed_size = 1;
+    user_config.durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::Group;
+    user_config.group_commit_interval = std::chrono::hours(1);
+    user_config.group_commit_size = SIZE_MAX;
+    streaming_archive::writer::Archive archive;
+
+    // Files in closed segments should only be persisted once the archive is closed
+    archive.open(user_config);
+    auto archive_path = output_dir + archive.get_id_as_string();
+    write_file(archive, "/logs/a.log", {"task t-1a failed\n"});
+    write_file(archive, "/logs/b.log", {"task t-1b failed\n"});
+    REQUIRE(0 == get_num_persisted_files(archive_path));
+    archive.close();
+    REQUIRE(2 == get_num_persisted_files(archive_path));
+
+    // Files in closed segments should be persisted once the group commit size is reached
+    user_config.id = boost::uuids::random_generator()();
+    user_config.group_commit_size = 1;
+    archive.open(user_config);
+    archive_path = output_dir + archive.get_id_as_string();
+    write_file(archive, "/logs/a.log", {"task t-1a failed\n"});
+    REQUIRE(1 == get_num_persisted_files(archive_path));
+    archive.close();
+
+    // Files in closed segments should be persisted once a segment closes after the group commit interval
+    user_config.id = boost::uuids::random_generator()();
+    user_config.group_commit_interval = std::chrono::milliseconds(1000);
+    user_config.group_commit_size = SIZE_MAX;
+    archive.open(user_config);
+    archive_path = output_dir + archive.get_id_as_string();
+    write_file(archive, "/logs/a.log", {"task t-1a failed\n"});
+    REQUIRE(0 == get_num_persisted_files(archive_path));
+    std::this_thread::sleep_for(user_config.group_commit_interval);
+    REQUIRE(0 == get_num_persisted_files(archive_path));
+    write_file(archive, "/logs/b.log", {"task t-1b failed\n"});
+    REQUIRE(2 == get_num_persisted_files(archive_path));
+    archive.close();
+    global_metadata_db.close();
+
+    boost::filesystem::remove_all(output_dir);
+}
+
+TEST_CASE("Test counting committed segments", "[Archive]") {
+    TimestampPattern::init();
+
+    string output_dir = "unit-test-archive/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    GlobalMetadataDB global_metadata_db;
+    global_metadata_db.open(output_dir + streaming_archive::cMetadataDBFileName, true);
+
+    auto user_config = get_archive_user_config(output_dir, global_metadata_db);
+    user_config.target_segment_uncompressed_size = 1024;
+    streaming_archive::writer::Archive archive;
+    archive.open(user_config);
+    auto archive_id = archive.get_id_as_string();
+    auto archive_path = output_dir + archive_id;
+    REQUIRE(0 == get_num_committed_segments(global_metadata_db, archive_id));
+
+    // Leave a file in the open segment for files without timestamps, and then fill the segment for files with timestamps so that it's committed
+    write_file(archive, "/logs/a.log", {"task t-1a failed\n"});
+    TimestampPattern timestamp_pattern(0, "%Y-%m-%d %H:%M:%S,%3");
+    vector<string> messages;
+    for (size_t i = 0; i < 1000; ++i) {
+        messages.push_back(" task t-1b took " + std::to_string(i) + " ms\n");
+    }
+    write_file_with_timestamps(archive, "/logs/b.log", timestamp_pattern, messages);
+    REQUIRE(1 == get_num_committed_segments(global_metadata_db, archive_id));
+    REQUIRE(vector<segment_id_t>({1}) == get_ids_of_committed_segments(archive_path));
+
+    // The open segment's file was already counted in the archive's size, but committing its segment should still be visible (e.g., to clg --follow)
+    archive.close();
+    REQUIRE(2 == get_num_committed_segments(global_metadata_db, archive_id));
+    REQUIRE(vector<segment_id_t>({0, 1}) == get_ids_of_committed_segments(archive_path));
+
+    // Appending should continue the count
+    archive.open_existing(user_config);
+    write_file(archive, "/logs/c.log", {"task t-1c failed\n"});
+    archive.close();
+    REQUIRE(3 == get_num_committed_segments(global_metadata_db, archive_id));
+    REQUIRE(vector<segment_id_t>({0, 1, 2}) == get_ids_of_committed_segments(archive_path));
+    global_metadata_db.close();
+
+    boost::filesystem::remove_all(output_dir);
+}
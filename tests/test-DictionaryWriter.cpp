@@ -0,0 +1,134 @@
+// C++ standard libraries
+#include <string>
+#include <thread>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/Utils.hpp"
+#include "../src/VariableDictionaryReader.hpp"
+#include "../src/VariableDictionaryWriter.hpp"
+
+using std::string;
+using std::thread;
+using std::vector;
+
+TEST_CASE("Add entries to a dictionary from multiple threads", "[DictionaryWriter]") {
+    constexpr size_t cNumThreads = 4;
+    constexpr size_t cNumValues = 10000;
+
+    string dictionary_dir_path = "unit-test-dictionary/";
+    REQUIRE(ErrorCode_Success == create_directory_structure(dictionary_dir_path, 0700));
+    string dictionary_path = dictionary_dir_path + "var.dict";
+    string segment_index_path = dictionary_dir_path + "var.segindex";
+
+    vector<string> values;
+    for (size_t i = 0; i < cNumValues; ++i) {
+        values.emplace_back("value-" + std::to_string(i));
+    }
+
+    VariableDictionaryWriter dictionary_writer;
+    dictionary_writer.open(dictionary_path, segment_index_path, cVariableDictionaryIdMax);
+
+    // Each thread adds every value twice, in its own order, and records the IDs it got
+    vector<vector<variable_dictionary_id_t>> ids_per_thread(cNumThreads, vector<variable_dictionary_id_t>(cNumValues));
+    vector<size_t> num_new_entries_per_thread(cNumThreads, 0);
+    vector<thread> threads;
+    for (size_t thread_ix = 0; thread_ix < cNumThreads; ++thread_ix) {
+        threads.emplace_back([&, thread_ix] () {
+            for (size_t pass = 0; pass < 2; ++pass) {
+                for (size_t i = 0; i < cNumValues; ++i) {
+                    // 7919 is prime, so this visits every value
+                    auto value_ix = (i * 7919 + thread_ix * cNumValues / cNumThreads) % cNumValues;
+                    variable_dictionary_id_t id;
+                    if (dictionary_writer.add_occurrence(values[value_ix], id)) {
+                        ++num_new_entries_per_thread[thread_ix];
+                    }
+                    ids_per_thread[thread_ix][value_ix] = id;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // Each value should have been added exactly once and every thread should have gotten the same ID for it
+    size_t num_new_entries = 0;
+    for (auto n : num_new_entries_per_thread) {
+        num_new_entries += n;
+    }
+    REQUIRE(cNumValues == num_new_entries);
+    vector<bool> id_used(cNumValues, false);
+    for (size_t i = 0; i < cNumValues; ++i) {
+        auto id = ids_per_thread[0][i];
+        REQUIRE(id < cNumValues);
+        REQUIRE(false == id_used[id]);
+        id_used[id] = true;
+        for (size_t thread_ix = 1; thread_ix < cNumThreads; ++thread_ix) {
+            REQUIRE(id == ids_per_thread[thread_ix][i]);
+        }
+        REQUIRE(values[i] == dictionary_writer.get_entry(id)->get_value());
+    }
+    dictionary_writer.close();
+
+    // Entries should have been written in ID order
+    VariableDictionaryReader dictionary_reader;
+    dictionary_reader.open(dictionary_path, segment_index_path);
+    dictionary_reader.read_new_entries();
+    for (size_t i = 0; i < cNumValues; ++i) {
+        REQUIRE(values[i] == dictionary_reader.get_value(ids_per_thread[0][i]));
+    }
+    dictionary_reader.close();
+
+    boost::system::error_code boost_error_code;
+    boost::filesystem::remove_all(dictionary_dir_path, boost_error_code);
+}
+
+TEST_CASE("Read new entries from a dictionary that's still being written", "[DictionaryWriter]") {
+    string dictionary_dir_path = "unit-test-dictionary/";
+    REQUIRE(ErrorCode_Success == create_directory_structure(dictionary_dir_path, 0700));
+    string dictionary_path = dictionary_dir_path + "var.dict";
+    string segment_index_path = dictionary_dir_path + "var.segindex";
+
+    VariableDictionaryWriter dictionary_writer;
+    dictionary_writer.open(dictionary_path, segment_index_path, cVariableDictionaryIdMax);
+    VariableDictionaryReader dictionary_reader;
+    dictionary_reader.open(dictionary_path, segment_index_path);
+
+    // Commit one segment at a time and check that the reader sees each one exactly once
+    constexpr size_t cNumSegments = 4;
+    variable_dictionary_id_t first_id;
+    dictionary_writer.add_occurrence("value-in-every-segment", first_id);
+    for (segment_id_t segment_id = 0; segment_id < cNumSegments; ++segment_id) {
+        variable_dictionary_id_t id;
+        dictionary_writer.add_occurrence("value-" + std::to_string(segment_id), id);
+        dictionary_writer.write_uncommitted_entries_to_disk();
+        dictionary_writer.index_segment(segment_id, {first_id, id});
+
+        dictionary_reader.read_new_entries();
+        REQUIRE(segment_id + 2 == dictionary_reader.get_entries().size());
+        REQUIRE("value-" + std::to_string(segment_id) == dictionary_reader.get_value(id));
+        auto& ids_of_segments_containing_entry = dictionary_reader.get_entry(id).get_ids_of_segments_containing_entry();
+        REQUIRE(1 == ids_of_segments_containing_entry.size());
+        REQUIRE(ids_of_segments_containing_entry.contains(segment_id));
+        REQUIRE(segment_id + 1 == dictionary_reader.get_entry(first_id).get_ids_of_segments_containing_entry().size());
+    }
+    REQUIRE(1 == dictionary_reader.get_entry(first_id).get_ids_of_segments_containing_entry().get_num_runs());
+
+    // A segment which contains no entries
+    dictionary_writer.index_segment(cNumSegments, {});
+    dictionary_reader.read_new_entries();
+    REQUIRE(false == dictionary_reader.get_entry(first_id).get_ids_of_segments_containing_entry().contains(cNumSegments));
+
+    dictionary_reader.close();
+    dictionary_writer.close();
+
+    boost::system::error_code boost_error_code;
+    boost::filesystem::remove_all(dictionary_dir_path, boost_error_code);
+}
@@ -0,0 +1,187 @@
+// C standard libraries
+#include <unistd.h>
+
+// C++ standard libraries
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <thread>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/clp/FileCompressor.hpp"
+#include "../src/FileDescriptorReader.hpp"
+#include "../src/GlobalMetadataDB.hpp"
+#include "../src/streaming_archive/Constants.hpp"
+#include "../src/streaming_archive/reader/Archive.hpp"
+#include "../src/streaming_archive/reader/File.hpp"
+#include "../src/streaming_archive/reader/Message.hpp"
+#include "../src/streaming_archive/writer/Archive.hpp"
+#include "../src/TimestampPattern.hpp"
+
+using std::string;
+
+/**
+ * Decompresses the committed content of every file in the given archive
+ * @param archive_path
+ * @return The content of the files, concatenated in the order they were committed
+ */
+static string decompress_archive (const string& archive_path) {
+    streaming_archive::reader::Archive archive;
+    archive.open(archive_path);
+    archive.refresh_dictionaries();
+
+    string content;
+    streaming_archive::reader::File file;
+    streaming_archive::reader::Message message;
+    string decompressed_message;
+    for (auto ix = archive.get_file_iterator(); ix->has_next(); ix->next()) {
+        REQUIRE(ErrorCode_Success == archive.open_file(file, *ix, false));
+        while (archive.get_next_message(file, message)) {
+            REQUIRE(archive.decompress_message(file, message, decompressed_message));
+            content += decompressed_message;
+        }
+        archive.close_file(file);
+    }
+    archive.close();
+    return content;
+}
+
+TEST_CASE("Compress an idle stream", "[FileCompressor]") {
+    TimestampPattern::init();
+
+    string output_dir = "unit-test-file-compressor/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    GlobalMetadataDB global_metadata_db;
+    global_metadata_db.open(output_dir + streaming_archive::cMetadataDBFileName, true);
+
+    boost::uuids::random_generator uuid_generator;
+    streaming_archive::writer::Archive::UserConfig user_config = {};
+    user_config.id = uuid_generator();
+    user_config.creator_id = uuid_generator();
+    user_config.creation_num = 0;
+    user_config.target_segment_uncompressed_size = 1L * 1024 * 1024 * 1024;
+    user_config.compression_level = 3;
+    user_config.output_dir = output_dir;
+    user_config.global_metadata_db = &global_metadata_db;
+    user_config.durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::None;
+    streaming_archive::writer::Archive archive;
+    archive.open(user_config);
+    auto archive_path = output_dir + archive.get_id_as_string();
+
+    int pipe_fds[2];
+    REQUIRE(0 == pipe(pipe_fds));
+    auto write_to_pipe = [&pipe_fds] (const string& str) {
+        REQUIRE((ssize_t)str.length() == write(pipe_fds[1], str.data(), str.length()));
+    };
+    FileDescriptorReader reader;
+    reader.open(pipe_fds[0], 10);
+
+    // Compress the stream on another thread, committing each message as soon as it's written, by size, but never by time
+    clp::FileCompressor file_compressor(uuid_generator, false, false);
+    std::atomic_bool is_stream_compressed(false);
+    bool compression_succeeded = false;
+    std::exception_ptr compression_exception;
+    std::thread compression_thread([&] () {
+        try {
+            compression_succeeded = file_compressor.compress_stream(SIZE_MAX, user_config, false, SIZE_MAX, "/logs/stdin.log", std::chrono::seconds(0), 1,
+                                                                    std::chrono::seconds(0), reader, archive);
+        } catch (...) {
+            compression_exception = std::current_exception();
+        }
+        is_stream_compressed = true;
+    });
+
+    // The parser buffers a message until it sees the start of the next one, so the message should only be committed because the stream is idle
+    string message_0 = "2015-02-28 23:59:59,999 message 0 from host-1a\n";
+    write_to_pipe(message_0);
+    string committed_content;
+    auto wait_begin_time = std::chrono::steady_clock::now();
+    while (committed_content != message_0 && std::chrono::steady_clock::now() - wait_begin_time < std::chrono::seconds(30)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        committed_content = decompress_archive(archive_path);
+    }
+    REQUIRE(committed_content == message_0);
+    REQUIRE(false == is_stream_compressed);
+
+    // A partial line should be kept until the stream ends
+    string message_1 = "2015-02-28 23:59:59,999 message 1 from host-1b";
+    write_to_pipe(message_1);
+    REQUIRE(0 == close(pipe_fds[1]));
+    compression_thread.join();
+    if (nullptr != compression_exception) {
+        std::rethrow_exception(compression_exception);
+    }
+    REQUIRE(compression_succeeded);
+    REQUIRE(reader.is_at_eof());
+    reader.close();
+    REQUIRE(0 == close(pipe_fds[0]));
+    archive.close();
+    global_metadata_db.close();
+
+    REQUIRE(decompress_archive(archive_path) == message_0 + message_1);
+
+    boost::filesystem::remove_all(output_dir);
+}
+
+TEST_CASE("Compress a stream that isn't UTF-8 encoded", "[FileCompressor]") {
+    TimestampPattern::init();
+
+    string output_dir = "unit-test-file-compressor/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    GlobalMetadataDB global_metadata_db;
+    global_metadata_db.open(output_dir + streaming_archive::cMetadataDBFileName, true);
+
+    boost::uuids::random_generator uuid_generator;
+    streaming_archive::writer::Archive::UserConfig user_config = {};
+    user_config.id = uuid_generator();
+    user_config.creator_id = uuid_generator();
+    user_config.creation_num = 0;
+    user_config.target_segment_uncompressed_size = 1L * 1024 * 1024 * 1024;
+    user_config.compression_level = 3;
+    user_config.output_dir = output_dir;
+    user_config.global_metadata_db = &global_metadata_db;
+    user_config.durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::None;
+    streaming_archive::writer::Archive archive;
+    archive.open(user_config);
+    auto archive_path = output_dir + archive.get_id_as_string();
+
+    // Write content that isn't UTF-8 encoded after the first message has been read
+    int pipe_fds[2];
+    REQUIRE(0 == pipe(pipe_fds));
+    string message_0 = "2015-02-28 23:59:59,999 message 0 from host-1a\n";
+    REQUIRE((ssize_t)message_0.length() == write(pipe_fds[1], message_0.data(), message_0.length()));
+    FileDescriptorReader reader;
+    reader.open(pipe_fds[0], 10);
+    clp::FileCompressor file_compressor(uuid_generator, false, false);
+    string remaining_content = "2015-02-28 23:59:59,999 message 1 from \xff\xfe\n2015-02-28 23:59:59,999 message 2 from host-1c\n";
+    ssize_t num_remaining_bytes_written = 0;
+    std::thread writer_thread([&] () {
+        // NOTE: Catch's assertions aren't thread-safe, so the write is checked on the main thread
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        num_remaining_bytes_written = write(pipe_fds[1], remaining_content.data(), remaining_content.length());
+        close(pipe_fds[1]);
+    });
+
+    // Compression should stop at the content that isn't UTF-8 encoded, but still commit the content before it
+    auto compression_succeeded = file_compressor.compress_stream(SIZE_MAX, user_config, false, SIZE_MAX, "/logs/stdin.log", std::chrono::seconds(0),
+                                                                 SIZE_MAX, std::chrono::seconds(0), reader, archive);
+    writer_thread.join();
+    REQUIRE((ssize_t)remaining_content.length() == num_remaining_bytes_written);
+    REQUIRE(false == compression_succeeded);
+    reader.close();
+    REQUIRE(0 == close(pipe_fds[0]));
+    archive.close();
+    global_metadata_db.close();
+
+    REQUIRE(decompress_archive(archive_path) == message_0);
+
+    boost::filesystem::remove_all(output_dir);
+}
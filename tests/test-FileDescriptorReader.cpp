@@ -0,0 +1,65 @@
+// C standard libraries
+#include <unistd.h>
+
+// C++ standard libraries
+#include <chrono>
+#include <string>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/FileDescriptorReader.hpp"
+
+using std::string;
+
+TEST_CASE("Read from an idle stream", "[FileDescriptorReader]") {
+    int pipe_fds[2];
+    REQUIRE(0 == pipe(pipe_fds));
+    auto write_to_pipe = [&pipe_fds] (const string& str) {
+        REQUIRE((ssize_t)str.length() == write(pipe_fds[1], str.data(), str.length()));
+    };
+
+    constexpr int cReadTimeoutMs = 20;
+    FileDescriptorReader reader;
+    reader.open(pipe_fds[0], cReadTimeoutMs);
+    REQUIRE_THROWS_AS(reader.open(pipe_fds[0], cReadTimeoutMs), FileDescriptorReader::OperationFailed);
+
+    char buf[16];
+    size_t num_bytes_read;
+    size_t pos;
+
+    // Reads should time out while the writer is idle
+    auto read_begin_time = std::chrono::steady_clock::now();
+    REQUIRE(ErrorCode_NotReady == reader.try_read(buf, sizeof(buf), num_bytes_read));
+    REQUIRE(std::chrono::steady_clock::now() - read_begin_time >= std::chrono::milliseconds(cReadTimeoutMs));
+    REQUIRE(false == reader.is_at_eof());
+
+    // A read should return whatever is available rather than waiting to fill the buffer
+    write_to_pipe("abc");
+    REQUIRE(ErrorCode_Success == reader.try_read(buf, sizeof(buf), num_bytes_read));
+    REQUIRE(string(buf, num_bytes_read) == "abc");
+    REQUIRE(ErrorCode_Success == reader.try_get_pos(pos));
+    REQUIRE(3 == pos);
+    REQUIRE(ErrorCode_NotReady == reader.try_read(buf, sizeof(buf), num_bytes_read));
+    REQUIRE(ErrorCode_Unsupported == reader.try_seek_from_begin(0));
+
+    // Content written before the writer closes should be read before EOF
+    write_to_pipe("de");
+    REQUIRE(0 == close(pipe_fds[1]));
+    REQUIRE(ErrorCode_Success == reader.try_read(buf, sizeof(buf), num_bytes_read));
+    REQUIRE(string(buf, num_bytes_read) == "de");
+    REQUIRE(false == reader.is_at_eof());
+    REQUIRE(ErrorCode_EndOfFile == reader.try_read(buf, sizeof(buf), num_bytes_read));
+    REQUIRE(reader.is_at_eof());
+    REQUIRE(ErrorCode_EndOfFile == reader.try_read(buf, sizeof(buf), num_bytes_read));
+    REQUIRE(ErrorCode_Success == reader.try_get_pos(pos));
+    REQUIRE(5 == pos);
+
+    reader.close();
+    REQUIRE(ErrorCode_NotInit == reader.try_read(buf, sizeof(buf), num_bytes_read));
+    REQUIRE(0 == close(pipe_fds[0]));
+
+    // Opening a closed file descriptor should fail
+    REQUIRE_THROWS_AS(reader.open(pipe_fds[0], cReadTimeoutMs), FileDescriptorReader::OperationFailed);
+}
@@ -0,0 +1,259 @@
+// C++ standard libraries
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+#include <boost/uuid/random_generator.hpp>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/FileReader.hpp"
+#include "../src/FileWriter.hpp"
+#include "../src/GlobalMetadataDB.hpp"
+#include "../src/streaming_archive/Constants.hpp"
+#include "../src/streaming_archive/FileTable.hpp"
+#include "../src/streaming_archive/MetadataDB.hpp"
+#include "../src/streaming_archive/writer/Archive.hpp"
+#include "../src/TimestampPattern.hpp"
+
+using std::string;
+using std::to_string;
+using std::vector;
+using streaming_archive::FileMetadataIterator;
+using streaming_archive::FileTable;
+using streaming_archive::MetadataDB;
+
+/**
+ * @param output_dir
+ * @param global_metadata_db
+ * @return Settings for a new archive in the given directory
+ */
+static streaming_archive::writer::Archive::UserConfig get_archive_user_config (const string& output_dir, GlobalMetadataDB& global_metadata_db) {
+    streaming_archive::writer::Archive::UserConfig user_config = {};
+    user_config.id = boost::uuids::random_generator()();
+    user_config.creator_id = boost::uuids::random_generator()();
+    user_config.creation_num = 0;
+    user_config.target_segment_uncompressed_size = 1L * 1024 * 1024 * 1024;
+    user_config.compression_level = 3;
+    user_config.output_dir = output_dir;
+    user_config.global_metadata_db = &global_metadata_db;
+    user_config.durability_policy = streaming_archive::writer::Archive::DurabilityPolicy::None;
+    return user_config;
+}
+
+/**
+ * Writes a file containing a message per timestamp from begin_ts, with the given timestamp pattern
+ * @param archive
+ * @param path
+ * @param begin_ts
+ * @param num_messages
+ * @param timestamp_pattern
+ */
+static void write_file (streaming_archive::writer::Archive& archive, const string& path, epochtime_t begin_ts, size_t num_messages,
+                        const TimestampPattern* timestamp_pattern)
+{
+    boost::uuids::random_generator uuid_generator;
+    auto file = archive.create_in_memory_file(path, 0, uuid_generator(), 0);
+    archive.open_file(*file);
+    archive.change_ts_pattern(*file, timestamp_pattern);
+    for (size_t i = 0; i < num_messages; ++i) {
+        string message = " message " + to_string(i) + " from " + path + " took " + to_string(i * 10) + " ms\n";
+        archive.write_msg(*file, begin_ts + i, message, message.length() + 24);
+    }
+    archive.close_file(*file);
+    archive.mark_file_ready_for_segment(file);
+}
+
+/**
+ * Gets a description of every field of the files from the given iterator
+ * @param ix
+ * @return The descriptions, in iteration order
+ */
+static vector<string> get_file_descriptions (FileMetadataIterator& ix) {
+    vector<string> descriptions;
+    string value;
+    vector<std::pair<uint64_t, TimestampPattern>> timestamp_patterns;
+    for (; ix.has_next(); ix.next()) {
+        string description;
+        ix.get_id(value);
+        description += value + ',';
+        ix.get_orig_file_id(value);
+        description += value + ',';
+        ix.get_path(value);
+        description += value + ',';
+        description += to_string(ix.get_begin_ts()) + ',' + to_string(ix.get_end_ts()) + ',';
+        description += to_string(ix.get_num_uncompressed_bytes()) + ',' + to_string(ix.get_num_messages()) + ',' +
+                       to_string(ix.get_num_variables()) + ',';
+        description += to_string(ix.is_split()) + ',' + to_string(ix.get_split_ix()) + ',';
+        description += to_string(ix.get_segment_id()) + ',' + to_string(ix.get_segment_timestamps_pos()) + ',' +
+                       to_string(ix.get_segment_logtypes_pos()) + ',' + to_string(ix.get_segment_variables_pos());
+        ix.get_timestamp_patterns(timestamp_patterns);
+        for (const auto& timestamp_pattern : timestamp_patterns) {
+            description += ',' + to_string(timestamp_pattern.first) + ':' + to_string(timestamp_pattern.second.get_num_spaces_before_ts()) + ':' +
+                           timestamp_pattern.second.get_format();
+        }
+        descriptions.push_back(description);
+    }
+    return descriptions;
+}
+
+/**
+ * Checks that iterating over the given table and database with the given filters produces the same files
+ * @param file_table
+ * @param metadata_db
+ * @param begin_ts
+ * @param end_ts
+ * @param file_path
+ * @param in_specific_segment
+ * @param segment_id
+ * @return The descriptions of the files
+ */
+static vector<string> check_iterators_match (const FileTable& file_table, MetadataDB& metadata_db, epochtime_t begin_ts, epochtime_t end_ts,
+                                             const string& file_path, bool in_specific_segment, segment_id_t segment_id)
+{
+    auto table_ix = file_table.get_file_iterator(begin_ts, end_ts, file_path, in_specific_segment, segment_id);
+    auto table_file_descriptions = get_file_descriptions(*table_ix);
+    auto db_ix = metadata_db.get_file_iterator(begin_ts, end_ts, file_path, in_specific_segment, segment_id);
+    auto db_file_descriptions = get_file_descriptions(db_ix);
+    REQUIRE(db_file_descriptions == table_file_descriptions);
+    return table_file_descriptions;
+}
+
+/**
+ * @param file_descriptions
+ * @return The path of each file
+ */
+static vector<string> get_paths (const vector<string>& file_descriptions) {
+    vector<string> paths;
+    for (const auto& description : file_descriptions) {
+        auto path_begin = description.find(',', description.find(',') + 1) + 1;
+        paths.push_back(description.substr(path_begin, description.find(',', path_begin) - path_begin));
+    }
+    return paths;
+}
+
+TEST_CASE("Test writing and reading a file table", "[FileTable]") {
+    TimestampPattern::init();
+
+    string output_dir = "unit-test-file-table/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    GlobalMetadataDB global_metadata_db;
+    global_metadata_db.open(output_dir + streaming_archive::cMetadataDBFileName, true);
+
+    streaming_archive::writer::Archive archive;
+    archive.open(get_archive_user_config(output_dir, global_metadata_db));
+
+    // Write two files per segment, with all but the last sharing a timestamp pattern
+    TimestampPattern timestamp_pattern(0, "%Y-%m-%d %H:%M:%S,%3");
+    TimestampPattern other_timestamp_pattern(1, "[%d/%b/%Y:%H:%M:%S");
+    write_file(archive, "/logs/a.log", 1000, 10, &timestamp_pattern);
+    write_file(archive, "/logs/b.log", 2000, 10, &timestamp_pattern);
+    archive.commit();
+    write_file(archive, "/logs/c.log", 3000, 10, &timestamp_pattern);
+    write_file(archive, "/logs/d.log", 4000, 10, &other_timestamp_pattern);
+    auto archive_path = output_dir + archive.get_id_as_string() + '/';
+    archive.close();
+    global_metadata_db.close();
+
+    MetadataDB metadata_db;
+    metadata_db.open(archive_path + streaming_archive::cMetadataDBFileName, false);
+    string file_table_path = output_dir + streaming_archive::cFileTableFileName;
+    FileTable::write(metadata_db, file_table_path);
+
+    FileTable file_table;
+    REQUIRE(ErrorCode_Success == file_table.try_open(file_table_path));
+    REQUIRE(file_table.is_current());
+
+    auto file_descriptions = check_iterators_match(file_table, metadata_db, cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId);
+    REQUIRE(vector<string>({"/logs/a.log", "/logs/b.log", "/logs/c.log", "/logs/d.log"}) == get_paths(file_descriptions));
+
+    file_descriptions = check_iterators_match(file_table, metadata_db, cEpochTimeMin, cEpochTimeMax, "", true, 1);
+    REQUIRE(vector<string>({"/logs/c.log", "/logs/d.log"}) == get_paths(file_descriptions));
+    file_descriptions = check_iterators_match(file_table, metadata_db, cEpochTimeMin, cEpochTimeMax, "", true, 2);
+    REQUIRE(file_descriptions.empty());
+
+    // Only files entirely within the time range should be returned
+    file_descriptions = check_iterators_match(file_table, metadata_db, 1005, 3009, "", false, cInvalidSegmentId);
+    REQUIRE(vector<string>({"/logs/b.log", "/logs/c.log"}) == get_paths(file_descriptions));
+
+    file_descriptions = check_iterators_match(file_table, metadata_db, cEpochTimeMin, cEpochTimeMax, "/logs/c.log", false, cInvalidSegmentId);
+    REQUIRE(vector<string>({"/logs/c.log"}) == get_paths(file_descriptions));
+    file_descriptions = check_iterators_match(file_table, metadata_db, 3000, 3009, "/logs/c.log", true, 0);
+    REQUIRE(file_descriptions.empty());
+
+    // Rewriting the table replaces it, so the open table is no longer current
+    FileTable::write(metadata_db, file_table_path);
+    REQUIRE(false == file_table.is_current());
+    REQUIRE(ErrorCode_Success == file_table.try_open(file_table_path));
+    REQUIRE(file_table.is_current());
+    file_table.close();
+    metadata_db.close();
+
+    // Tables whose size doesn't match their header should be rejected
+    size_t file_table_size = boost::filesystem::file_size(file_table_path);
+    vector<char> file_table_content(file_table_size);
+    FileReader file_reader;
+    file_reader.open(file_table_path);
+    file_reader.read_exact_length(file_table_content.data(), file_table_content.size(), false);
+    file_reader.close();
+    auto write_corrupt_table = [&] (size_t length, bool append_byte) {
+        FileWriter file_writer;
+        file_writer.open(file_table_path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+        file_writer.write(file_table_content.data(), length);
+        if (append_byte) {
+            file_writer.write_char('\0');
+        }
+        file_writer.close();
+    };
+    write_corrupt_table(file_table_size - 1, false);
+    REQUIRE(ErrorCode_Corrupt == file_table.try_open(file_table_path));
+    REQUIRE(false == file_table.is_open());
+    write_corrupt_table(file_table_size, true);
+    REQUIRE(ErrorCode_Corrupt == file_table.try_open(file_table_path));
+    REQUIRE(false == file_table.is_open());
+    write_corrupt_table(sizeof(uint64_t), false);
+    REQUIRE(ErrorCode_Corrupt == file_table.try_open(file_table_path));
+    REQUIRE(false == file_table.is_open());
+
+    FileTable::remove(file_table_path);
+    REQUIRE(ErrorCode_FileNotFound == file_table.try_open(file_table_path));
+    REQUIRE(false == file_table.is_current());
+
+    boost::filesystem::remove_all(output_dir);
+}
+
+TEST_CASE("Test writing file tables with empty sections", "[FileTable]") {
+    string output_dir = "unit-test-file-table/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    GlobalMetadataDB global_metadata_db;
+    global_metadata_db.open(output_dir + streaming_archive::cMetadataDBFileName, true);
+
+    // Closing an archive writes its table, whether it contains files without timestamp patterns or no files at all
+    streaming_archive::writer::Archive archive;
+    archive.open(get_archive_user_config(output_dir, global_metadata_db));
+    write_file(archive, "/logs/a.log", 0, 10, nullptr);
+    auto archive_path = output_dir + archive.get_id_as_string() + '/';
+    archive.close();
+    archive.open(get_archive_user_config(output_dir, global_metadata_db));
+    auto empty_archive_path = output_dir + archive.get_id_as_string() + '/';
+    archive.close();
+    global_metadata_db.close();
+
+    FileTable file_table;
+    REQUIRE(ErrorCode_Success == file_table.try_open(archive_path + streaming_archive::cFileTableFileName));
+    MetadataDB metadata_db;
+    metadata_db.open(archive_path + streaming_archive::cMetadataDBFileName, false);
+    auto file_descriptions = check_iterators_match(file_table, metadata_db, cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId);
+    REQUIRE(vector<string>({"/logs/a.log"}) == get_paths(file_descriptions));
+    metadata_db.close();
+
+    REQUIRE(ErrorCode_Success == file_table.try_open(empty_archive_path + streaming_archive::cFileTableFileName));
+    auto file_ix = file_table.get_file_iterator(cEpochTimeMin, cEpochTimeMax, "", false, cInvalidSegmentId);
+    REQUIRE(false == file_ix->has_next());
+    file_table.close();
+
+    boost::filesystem::remove_all(output_dir);
+}
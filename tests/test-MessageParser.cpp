@@ -0,0 +1,192 @@
+// C standard libraries
+#include <unistd.h>
+
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/FileDescriptorReader.hpp"
+#include "../src/FileWriter.hpp"
+#include "../src/MemoryMappedFileReader.hpp"
+#include "../src/MessageParser.hpp"
+#include "../src/ParsedMessage.hpp"
+#include "../src/ReaderInterface.hpp"
+#include "../src/TimestampPattern.hpp"
+
+using std::string;
+using std::vector;
+
+/**
+ * Reader over an in-memory string
+ */
+class StringReader : public ReaderInterface {
+public:
+    // Constructors
+    explicit StringReader (const string& str) : m_str(str), m_pos(0) {}
+
+    // Methods
+    ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override {
+        if (m_str.length() == m_pos) {
+            return ErrorCode_EndOfFile;
+        }
+        num_bytes_read = std::min(num_bytes_to_read, m_str.length() - m_pos);
+        memcpy(buf, m_str.data() + m_pos, num_bytes_read);
+        m_pos += num_bytes_read;
+        return ErrorCode_Success;
+    }
+    ErrorCode try_seek_from_begin (size_t pos) override {
+        m_pos = pos;
+        return ErrorCode_Success;
+    }
+    ErrorCode try_get_pos (size_t& pos) override {
+        pos = m_pos;
+        return ErrorCode_Success;
+    }
+
+private:
+    const string& m_str;
+    size_t m_pos;
+};
+
+TEST_CASE("Parse messages spanning read buffers", "[MessageParser]") {
+    TimestampPattern::init();
+
+    // Generate enough messages that they span several of the parser's read buffers, including lines without a timestamp before the first
+    // timestamp, multiline messages, and messages with a timestamp in the middle of the line
+    string log;
+    vector<string> expected_contents;
+    vector<size_t> expected_orig_num_bytes;
+    for (size_t i = 0; i < 3; ++i) {
+        string line = "no timestamp " + std::to_string(i) + "\n";
+        log += line;
+        expected_contents.push_back(line);
+        expected_orig_num_bytes.push_back(line.length());
+    }
+    for (size_t i = 0; i < 10000; ++i) {
+        string line;
+        string content;
+        if (0 == i % 3) {
+            line = "localhost - - [01/Jan/2016:15:50:17 message " + std::to_string(i) + "\n";
+            content = "localhost - -  message " + std::to_string(i) + "\n";
+        } else {
+            line = "2015-02-28 23:59:59,999 message " + std::to_string(i) + "\n";
+            content = " message " + std::to_string(i) + "\n";
+        }
+        for (size_t j = 0; j < i % 5; ++j) {
+            string continuation = "\tat frame " + std::to_string(j) + "\n";
+            line += continuation;
+            content += continuation;
+        }
+        log += line;
+        expected_contents.push_back(content);
+        expected_orig_num_bytes.push_back(line.length());
+    }
+    // Remove the last line's delimiter so that the parser has to drain it
+    log.pop_back();
+    expected_contents.back().pop_back();
+    --expected_orig_num_bytes.back();
+
+    constexpr size_t cPrefixLength = 4096;
+    StringReader reader(log);
+    size_t prefix_length;
+    char prefix[cPrefixLength];
+    REQUIRE(ErrorCode_Success == reader.try_read(prefix, cPrefixLength, prefix_length));
+
+    MessageParser parser;
+    ParsedMessage message;
+    size_t message_ix = 0;
+    size_t buf_pos = 0;
+    while (parser.parse_next_message(false, prefix_length, prefix, buf_pos, message)) {
+        REQUIRE(message_ix < expected_contents.size());
+        REQUIRE(message.get_content() == expected_contents[message_ix]);
+        REQUIRE(message.get_orig_num_bytes() == expected_orig_num_bytes[message_ix]);
+        ++message_ix;
+    }
+    // The parser shouldn't refer to the prefix buffer once it's exhausted
+    memset(prefix, 0, cPrefixLength);
+    while (parser.parse_next_message(true, reader, message)) {
+        REQUIRE(message_ix < expected_contents.size());
+        REQUIRE(message.get_content() == expected_contents[message_ix]);
+        REQUIRE(message.get_orig_num_bytes() == expected_orig_num_bytes[message_ix]);
+        ++message_ix;
+    }
+    REQUIRE(expected_contents.size() == message_ix);
+
+    // Parse the same content from views of a memory-mapped file
+    string log_path = "unit-test-message-parser.log";
+    FileWriter file_writer;
+    file_writer.open(log_path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+    file_writer.write(log.data(), log.length());
+    file_writer.close();
+
+    MemoryMappedFileReader memory_mapped_file_reader;
+    memory_mapped_file_reader.open(log_path);
+    message_ix = 0;
+    while (parser.parse_next_message(true, memory_mapped_file_reader, message)) {
+        REQUIRE(message_ix < expected_contents.size());
+        REQUIRE(message.get_content() == expected_contents[message_ix]);
+        REQUIRE(message.get_orig_num_bytes() == expected_orig_num_bytes[message_ix]);
+        ++message_ix;
+    }
+    REQUIRE(expected_contents.size() == message_ix);
+    memory_mapped_file_reader.close();
+    boost::filesystem::remove(log_path);
+}
+
+TEST_CASE("Parse messages from an idle stream", "[MessageParser]") {
+    TimestampPattern::init();
+
+    int pipe_fds[2];
+    REQUIRE(0 == pipe(pipe_fds));
+    auto write_to_pipe = [&pipe_fds] (const string& str) {
+        REQUIRE((ssize_t)str.length() == write(pipe_fds[1], str.data(), str.length()));
+    };
+
+    FileDescriptorReader reader;
+    reader.open(pipe_fds[0], 0);
+    MessageParser parser;
+    ParsedMessage message;
+
+    // Nothing has been written yet
+    REQUIRE(false == parser.parse_next_message(true, reader, message));
+    REQUIRE(false == reader.is_at_eof());
+    REQUIRE(false == parser.take_buffered_message(message));
+
+    // The first message is buffered until the parser sees the start of the next one
+    write_to_pipe("2015-02-28 23:59:59,999 message 0\n\tat frame 0\n2015-02-28 23:59:59,999 message 1\n");
+    REQUIRE(parser.parse_next_message(true, reader, message));
+    REQUIRE(message.get_content() == " message 0\n\tat frame 0\n");
+    REQUIRE(false == parser.parse_next_message(true, reader, message));
+    REQUIRE(parser.take_buffered_message(message));
+    REQUIRE(message.get_content() == " message 1\n");
+    REQUIRE(false == parser.take_buffered_message(message));
+
+    // A partial line should be kept until the rest of it arrives
+    write_to_pipe("2015-02-28 23:59:59,999 mess");
+    REQUIRE(false == parser.parse_next_message(true, reader, message));
+    REQUIRE(false == parser.take_buffered_message(message));
+    write_to_pipe("age 2\n");
+    REQUIRE(false == parser.parse_next_message(true, reader, message));
+    REQUIRE(parser.take_buffered_message(message));
+    REQUIRE(message.get_content() == " message 2\n");
+
+    // The last line is drained once the stream ends
+    write_to_pipe("2015-02-28 23:59:59,999 message 3");
+    REQUIRE(0 == close(pipe_fds[1]));
+    REQUIRE(parser.parse_next_message(true, reader, message));
+    REQUIRE(message.get_content() == " message 3");
+    REQUIRE(false == parser.parse_next_message(true, reader, message));
+    REQUIRE(reader.is_at_eof());
+
+    reader.close();
+    REQUIRE(0 == close(pipe_fds[0]));
+}
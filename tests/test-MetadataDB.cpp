@@ -0,0 +1,64 @@
+// C++ standard libraries
+#include <string>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/SQLiteDB.hpp"
+#include "../src/streaming_archive/Constants.hpp"
+#include "../src/streaming_archive/MetadataDB.hpp"
+
+using std::string;
+using streaming_archive::MetadataDB;
+
+/**
+ * @param path
+ * @return The journal mode of the given database
+ */
+static string get_journal_mode (const string& path) {
+    SQLiteDB db;
+    db.open(path);
+    string journal_mode;
+    {
+        auto statement = db.prepare_statement("PRAGMA journal_mode");
+        REQUIRE(statement.step());
+        statement.column_string(0, journal_mode);
+    }
+    REQUIRE(db.close());
+    return journal_mode;
+}
+
+TEST_CASE("Test switching back from write-ahead logging", "[MetadataDB]") {
+    string output_dir = "unit-test-metadata-db/";
+    REQUIRE(boost::filesystem::create_directory(output_dir));
+    string metadata_db_path = output_dir + streaming_archive::cMetadataDBFileName;
+    MetadataDB writer_db;
+    MetadataDB reader_db;
+
+    SECTION("Writer closes last") {
+        writer_db.open(metadata_db_path, true);
+        reader_db.open(metadata_db_path, false);
+        REQUIRE("wal" == get_journal_mode(metadata_db_path));
+        reader_db.close();
+        REQUIRE("wal" == get_journal_mode(metadata_db_path));
+        writer_db.close();
+    }
+
+    SECTION("Reader closes last") {
+        // E.g., a search following an archive that's still open when compression finishes
+        writer_db.open(metadata_db_path, true);
+        reader_db.open(metadata_db_path, false);
+        writer_db.close();
+        REQUIRE("wal" == get_journal_mode(metadata_db_path));
+        reader_db.close();
+    }
+
+    REQUIRE("delete" == get_journal_mode(metadata_db_path));
+    REQUIRE(false == boost::filesystem::exists(metadata_db_path + "-wal"));
+
+    boost::filesystem::remove_all(output_dir);
+}
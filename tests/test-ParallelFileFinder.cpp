@@ -0,0 +1,101 @@
+// C++ standard libraries
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Boost libraries
+#include <boost/filesystem.hpp>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/clp/FileToCompress.hpp"
+#include "../src/clp/utils.hpp"
+#include "../src/FileWriter.hpp"
+
+using clp::FileToCompress;
+using std::string;
+using std::vector;
+
+/**
+ * Creates a file containing the given content
+ * @param path
+ * @param content
+ */
+static void create_file (const string& path, const string& content) {
+    FileWriter file_writer;
+    file_writer.open(path, FileWriter::OpenMode::CREATE_FOR_WRITING);
+    file_writer.write(content.data(), content.length());
+    file_writer.close();
+}
+
+/**
+ * @param files
+ * @return A description of each file's paths and size
+ */
+static vector<string> get_file_descriptions (const vector<FileToCompress>& files) {
+    vector<string> descriptions;
+    for (const auto& file : files) {
+        descriptions.push_back(file.get_path() + ',' + file.get_path_for_compression() + ',' + std::to_string(file.get_size()));
+    }
+    return descriptions;
+}
+
+TEST_CASE("Find files and empty directories in parallel", "[ParallelFileFinder]") {
+    string test_dir = "unit-test-parallel-file-finder";
+    REQUIRE(boost::filesystem::create_directory(test_dir));
+    auto root_path = boost::filesystem::absolute(test_dir).string();
+
+    // Build a tree with nested, empty, and symlinked directories, as well as symlinked files
+    vector<string> expected_file_descriptions;
+    vector<string> expected_empty_directory_paths;
+    auto add_file = [&] (const string& relative_path, const string& content) {
+        create_file(root_path + relative_path, content);
+        expected_file_descriptions.push_back(root_path + relative_path + ',' + relative_path + ',' + std::to_string(content.length()));
+    };
+    boost::filesystem::create_directories(root_path + "/logs/nested/empty");
+    add_file("/logs/a.log", "a");
+    add_file("/logs/nested/b.log", "bb");
+    expected_empty_directory_paths.emplace_back("/logs/nested/empty");
+    for (int i = 0; i < 16; ++i) {
+        auto directory_path = "/dir-" + std::to_string(i);
+        boost::filesystem::create_directories(root_path + directory_path + "/empty");
+        add_file(directory_path + "/c.log", string(i, 'c'));
+        expected_empty_directory_paths.push_back(directory_path + "/empty");
+    }
+    boost::filesystem::create_directory(root_path + "/empty");
+    expected_empty_directory_paths.emplace_back("/empty");
+
+    // Symlinked directories are searched and their content is reported under the symlink's path
+    boost::filesystem::create_directory_symlink(root_path + "/logs/nested", root_path + "/nested-link");
+    expected_file_descriptions.push_back(root_path + "/nested-link/b.log,/nested-link/b.log,2");
+    expected_empty_directory_paths.emplace_back("/nested-link/empty");
+    boost::filesystem::create_symlink(root_path + "/logs/a.log", root_path + "/a-link.log");
+    expected_file_descriptions.push_back(root_path + "/a-link.log,/a-link.log,1");
+    // Dangling symlinks are reported as empty files, leaving compression to report that they're missing
+    boost::filesystem::create_symlink(root_path + "/missing.log", root_path + "/dangling-link.log");
+    expected_file_descriptions.push_back(root_path + "/dangling-link.log,/dangling-link.log,0");
+
+    std::sort(expected_file_descriptions.begin(), expected_file_descriptions.end());
+    std::sort(expected_empty_directory_paths.begin(), expected_empty_directory_paths.end());
+
+    // The results should be sorted by path, regardless of the number of threads
+    for (size_t num_threads : {1, 2, 8}) {
+        vector<FileToCompress> files;
+        vector<string> empty_directory_paths;
+        REQUIRE(clp::find_all_files_and_empty_directories(root_path, {root_path}, num_threads, files, empty_directory_paths));
+        REQUIRE(expected_file_descriptions == get_file_descriptions(files));
+        REQUIRE(expected_empty_directory_paths == empty_directory_paths);
+    }
+
+    // Input paths can be files, and missing paths should fail the search
+    vector<FileToCompress> files;
+    vector<string> empty_directory_paths;
+    REQUIRE(clp::find_all_files_and_empty_directories(root_path, {root_path + "/logs/a.log", root_path + "/empty"}, 8, files, empty_directory_paths));
+    REQUIRE(vector<string>({root_path + "/logs/a.log,/logs/a.log,1"}) == get_file_descriptions(files));
+    REQUIRE(vector<string>({"/empty"}) == empty_directory_paths);
+    REQUIRE(false == clp::find_all_files_and_empty_directories(root_path, {root_path + "/missing.log"}, 8, files, empty_directory_paths));
+
+    boost::filesystem::remove_all(test_dir);
+}
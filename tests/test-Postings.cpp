@@ -0,0 +1,147 @@
+// C++ standard libraries
+#include <cstdio>
+#include <vector>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/streaming_archive/Postings.hpp"
+
+using namespace std;
+using streaming_archive::LogTypePostings;
+using streaming_archive::Posting;
+using streaming_archive::VariablePostings;
+
+/**
+ * Adds the runs of messages with the same logtype in the given file to the postings
+ * @param file_logtypes_pos
+ * @param logtype_ids
+ * @param postings
+ */
+static void add_file (uint64_t file_logtypes_pos, const vector<logtype_dictionary_id_t>& logtype_ids, LogTypePostings& postings) {
+    Posting posting;
+    posting.file_logtypes_pos = file_logtypes_pos;
+    for (size_t msg_ix = 0; msg_ix < logtype_ids.size();) {
+        auto logtype_id = logtype_ids[msg_ix];
+        posting.begin_msg_ix = msg_ix;
+        posting.begin_variable_ix = msg_ix * 3;
+        for (; msg_ix < logtype_ids.size() && logtype_ids[msg_ix] == logtype_id; ++msg_ix) {}
+        posting.end_msg_ix = msg_ix;
+        postings.add_posting(logtype_id, posting);
+    }
+    postings.increment_num_messages(logtype_ids.size());
+}
+
+TEST_CASE("Test writing and reading logtype postings", "[Postings]") {
+    // Logtypes 2 and 3 occur in a few long runs, while logtypes 1 and 4 alternate
+    vector<logtype_dictionary_id_t> file_100_logtype_ids(20, 2);
+    for (size_t i = 0; i < 20; ++i) {
+        file_100_logtype_ids.push_back((i % 2 == 0) ? 1 : 4);
+    }
+    file_100_logtype_ids.insert(file_100_logtype_ids.end(), 20, 2);
+    vector<logtype_dictionary_id_t> file_200_logtype_ids(10, 3);
+    for (size_t i = 0; i < 40; ++i) {
+        file_200_logtype_ids.push_back((i % 2 == 0) ? 1 : 4);
+    }
+    vector<logtype_dictionary_id_t> file_300_logtype_ids(60, 2);
+
+    LogTypePostings written_postings;
+    add_file(100, file_100_logtype_ids, written_postings);
+    add_file(200, file_200_logtype_ids, written_postings);
+    add_file(300, file_300_logtype_ids, written_postings);
+    string postings_path = "unit-test-logtype-postings";
+    REQUIRE(written_postings.write(postings_path, written_postings.get_num_messages() / LogTypePostings::cMinMessagesPerPosting) > 0);
+
+    LogTypePostings postings;
+    REQUIRE(ErrorCode_Success == postings.try_read(postings_path));
+
+    vector<Posting> file_postings;
+    REQUIRE(postings.try_get_postings({2, 3}, 100, file_postings));
+    REQUIRE(2 == file_postings.size());
+    REQUIRE(0 == file_postings[0].begin_msg_ix);
+    REQUIRE(20 == file_postings[0].end_msg_ix);
+    REQUIRE(0 == file_postings[0].begin_variable_ix);
+    REQUIRE(40 == file_postings[1].begin_msg_ix);
+    REQUIRE(60 == file_postings[1].end_msg_ix);
+    REQUIRE(120 == file_postings[1].begin_variable_ix);
+
+    REQUIRE(postings.try_get_postings({2, 3}, 200, file_postings));
+    REQUIRE(1 == file_postings.size());
+    REQUIRE(0 == file_postings[0].begin_msg_ix);
+    REQUIRE(10 == file_postings[0].end_msg_ix);
+
+    // Files and logtypes without postings
+    REQUIRE(postings.try_get_postings({3}, 300, file_postings));
+    REQUIRE(file_postings.empty());
+    REQUIRE(postings.try_get_postings({5}, 100, file_postings));
+    REQUIRE(file_postings.empty());
+
+    // The alternating logtypes have too many postings to be indexed, so they must be scanned for
+    REQUIRE(false == postings.try_get_postings({1}, 100, file_postings));
+    REQUIRE(false == postings.try_get_postings({2, 4}, 300, file_postings));
+
+    REQUIRE(ErrorCode_FileNotFound == postings.try_read(postings_path + ".missing"));
+
+    // Without any indexed logtypes, every logtype must be scanned for
+    REQUIRE(written_postings.write(postings_path, 0) > 0);
+    REQUIRE(ErrorCode_Success == postings.try_read(postings_path));
+    REQUIRE(false == postings.try_get_postings({2}, 100, file_postings));
+    REQUIRE(postings.try_get_postings({5}, 100, file_postings));
+    REQUIRE(file_postings.empty());
+
+    std::remove(postings_path.c_str());
+}
+
+TEST_CASE("Test writing and reading variable postings", "[Postings]") {
+    VariablePostings written_postings;
+    Posting posting;
+    posting.file_logtypes_pos = 100;
+    // Variable 7 is in messages 10-12, twice in message 11, while variables 8 and 9 are both in message 20
+    for (uint64_t msg_ix : {10, 11, 11, 12, 40}) {
+        posting.begin_msg_ix = msg_ix;
+        posting.end_msg_ix = msg_ix + 1;
+        posting.begin_variable_ix = msg_ix * 2;
+        written_postings.add_posting((40 == msg_ix) ? 8 : 7, posting);
+    }
+    posting.begin_msg_ix = 20;
+    posting.end_msg_ix = 21;
+    posting.begin_variable_ix = 40;
+    written_postings.add_posting(8, posting);
+    written_postings.add_posting(9, posting);
+    // Variable 10 is in every other message, so it's not worth indexing
+    posting.file_logtypes_pos = 200;
+    for (uint64_t msg_ix = 0; msg_ix < 100; msg_ix += 2) {
+        posting.begin_msg_ix = msg_ix;
+        posting.end_msg_ix = msg_ix + 1;
+        posting.begin_variable_ix = msg_ix * 2;
+        written_postings.add_posting(10, posting);
+    }
+    written_postings.increment_num_messages(200);
+    string postings_path = "unit-test-variable-postings";
+    REQUIRE(written_postings.write(postings_path, SIZE_MAX) > 0);
+
+    VariablePostings postings;
+    REQUIRE(ErrorCode_Success == postings.try_read(postings_path));
+
+    vector<Posting> file_postings;
+    REQUIRE(postings.try_get_postings({7}, 100, file_postings));
+    REQUIRE(1 == file_postings.size());
+    REQUIRE(10 == file_postings[0].begin_msg_ix);
+    REQUIRE(13 == file_postings[0].end_msg_ix);
+    REQUIRE(20 == file_postings[0].begin_variable_ix);
+
+    // Postings of messages containing more than one of the variables are merged
+    REQUIRE(postings.try_get_postings({8, 9}, 100, file_postings));
+    REQUIRE(2 == file_postings.size());
+    REQUIRE(20 == file_postings[0].begin_msg_ix);
+    REQUIRE(21 == file_postings[0].end_msg_ix);
+    REQUIRE(40 == file_postings[1].begin_msg_ix);
+    REQUIRE(41 == file_postings[1].end_msg_ix);
+
+    REQUIRE(postings.try_get_postings({7}, 200, file_postings));
+    REQUIRE(file_postings.empty());
+    REQUIRE(false == postings.try_get_postings({7, 10}, 100, file_postings));
+
+    std::remove(postings_path.c_str());
+}
@@ -0,0 +1,120 @@
+// C++ standard libraries
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/ReadAheadReader.hpp"
+
+using std::string;
+
+/**
+ * Reader over an in-memory string which returns at most a fixed number of bytes per read and can fail after a given position
+ */
+class ChunkedStringReader : public ReaderInterface {
+public:
+    // Constructors
+    ChunkedStringReader (const string& str, size_t max_chunk_size, size_t fail_pos) : m_str(str), m_max_chunk_size(max_chunk_size),
+            m_fail_pos(fail_pos), m_pos(0) {}
+
+    // Methods
+    ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override {
+        if (m_pos >= m_fail_pos) {
+            return ErrorCode_Failure;
+        }
+        if (m_str.length() == m_pos) {
+            return ErrorCode_EndOfFile;
+        }
+        num_bytes_read = std::min({num_bytes_to_read, m_max_chunk_size, m_str.length() - m_pos});
+        memcpy(buf, m_str.data() + m_pos, num_bytes_read);
+        m_pos += num_bytes_read;
+        return ErrorCode_Success;
+    }
+    ErrorCode try_seek_from_begin (size_t pos) override {
+        return ErrorCode_Unsupported;
+    }
+    ErrorCode try_get_pos (size_t& pos) override {
+        pos = m_pos;
+        return ErrorCode_Success;
+    }
+
+private:
+    const string& m_str;
+    size_t m_max_chunk_size;
+    size_t m_fail_pos;
+    size_t m_pos;
+};
+
+TEST_CASE("ReadAheadReader", "[ReadAheadReader]") {
+    // Generate content that spans many more blocks than the reader buffers
+    string content;
+    content.reserve(ReadAheadReader::cBlockSize * ReadAheadReader::cNumBlocks * 4);
+    for (size_t i = 0; content.length() < ReadAheadReader::cBlockSize * ReadAheadReader::cNumBlocks * 4; ++i) {
+        content += "line " + std::to_string(i) + '\n';
+    }
+
+    ReadAheadReader read_ahead_reader;
+    string read_content;
+    char buf[10000];
+    size_t num_bytes_read;
+    ErrorCode error_code;
+
+    SECTION("Read all content") {
+        ChunkedStringReader reader(content, 3001, SIZE_MAX);
+        read_ahead_reader.open(reader);
+        // Vary the read size so reads don't align with blocks
+        for (size_t i = 1; ; ++i) {
+            error_code = read_ahead_reader.try_read(buf, i % sizeof(buf) + 1, num_bytes_read);
+            if (ErrorCode_Success != error_code) {
+                break;
+            }
+            read_content.append(buf, num_bytes_read);
+        }
+        REQUIRE(ErrorCode_EndOfFile == error_code);
+        REQUIRE(content == read_content);
+
+        size_t pos;
+        REQUIRE(ErrorCode_Success == read_ahead_reader.try_get_pos(pos));
+        REQUIRE(content.length() == pos);
+
+        // EOF should be sticky
+        REQUIRE(ErrorCode_EndOfFile == read_ahead_reader.try_read(buf, sizeof(buf), num_bytes_read));
+        read_ahead_reader.close();
+    }
+
+    SECTION("Pass on the underlying reader's error") {
+        // Fail at a chunk boundary in the middle of the content
+        size_t fail_pos = content.length() / 2 / sizeof(buf) * sizeof(buf);
+        ChunkedStringReader reader(content, sizeof(buf), fail_pos);
+        read_ahead_reader.open(reader);
+        while (true) {
+            error_code = read_ahead_reader.try_read(buf, sizeof(buf), num_bytes_read);
+            if (ErrorCode_Success != error_code) {
+                break;
+            }
+            read_content.append(buf, num_bytes_read);
+        }
+        REQUIRE(ErrorCode_Failure == error_code);
+        REQUIRE(content.substr(0, fail_pos) == read_content);
+        read_ahead_reader.close();
+    }
+
+    SECTION("Close before reading all content") {
+        ChunkedStringReader reader(content, sizeof(buf), SIZE_MAX);
+        read_ahead_reader.open(reader);
+        REQUIRE(ErrorCode_Success == read_ahead_reader.try_read(buf, sizeof(buf), num_bytes_read));
+        read_ahead_reader.close();
+        REQUIRE(ErrorCode_NotInit == read_ahead_reader.try_read(buf, sizeof(buf), num_bytes_read));
+
+        // The reader should be reusable
+        ChunkedStringReader other_reader(content, sizeof(buf), SIZE_MAX);
+        read_ahead_reader.open(other_reader);
+        REQUIRE(ErrorCode_Success == read_ahead_reader.try_read(buf, 5, num_bytes_read));
+        REQUIRE(content.substr(0, 5) == string(buf, num_bytes_read));
+        read_ahead_reader.close();
+    }
+}
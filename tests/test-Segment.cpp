@@ -1,6 +1,11 @@
 // C libraries
 #include <unistd.h>
 
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 // Boost libraries
 #include <boost/filesystem.hpp>
 
@@ -8,6 +13,8 @@
 #include "../submodules/Catch2/single_include/catch2/catch.hpp"
 
 // Project headers
+#include "../src/EncodedVariableInterpreter.hpp"
+#include "../src/PageAllocatedVector.hpp"
 #include "../src/streaming_archive/reader/Segment.hpp"
 #include "../src/streaming_archive/writer/Segment.hpp"
 #include "../src/Utils.hpp"
@@ -68,3 +75,191 @@ TEST_CASE("Test writing and reading a segment", "[Segment]") {
     boost::filesystem::remove_all(segments_dir_path, boost_error_code);
     REQUIRE(!boost_error_code);
 }
+
+TEST_CASE("Test appending page-allocated columns to a segment", "[Segment]") {
+    ErrorCode error_code;
+
+    string segments_dir_path = "unit-test-segment-columns/";
+    error_code = create_directory_structure(segments_dir_path, 0700);
+    REQUIRE(ErrorCode_Success == error_code);
+
+    // Append several columns, interleaved with copied buffers, so that the segment has multiple buffers pending compression
+    constexpr size_t cNumColumns = 16;
+    constexpr size_t cNumValuesPerColumn = 100000;
+    vector<int64_t> expected_values;
+    writer::Segment writer_segment;
+    writer_segment.open(segments_dir_path, 0, 3);
+    auto segment_id = writer_segment.get_id();
+    uint64_t expected_offset = 0;
+    for (size_t i = 0; i < cNumColumns; ++i) {
+        PageAllocatedVector<int64_t> column;
+        for (size_t j = 0; j < cNumValuesPerColumn; ++j) {
+            int64_t value = i * cNumValuesPerColumn + j;
+            column.push_back(value);
+            expected_values.push_back(value);
+        }
+
+        uint64_t offset;
+        if (0 == i % 2) {
+            writer_segment.append(column, offset);
+            // The segment should've taken ownership of the column
+            REQUIRE(0 == column.size());
+            REQUIRE(nullptr == column.data());
+        } else {
+            writer_segment.append(reinterpret_cast<const char*>(column.data()), column.size_in_bytes(), offset);
+        }
+        REQUIRE(expected_offset == offset);
+        expected_offset += cNumValuesPerColumn * sizeof(int64_t);
+    }
+    REQUIRE(expected_offset == writer_segment.get_uncompressed_size());
+    writer_segment.close();
+    REQUIRE(writer_segment.get_compressed_size() > 0);
+
+    // Read back and validate
+    reader::Segment reader_segment;
+    error_code = reader_segment.try_open(segments_dir_path, segment_id);
+    REQUIRE(ErrorCode_Success == error_code);
+    vector<int64_t> decompressed_values(expected_values.size());
+    error_code = reader_segment.try_read(0, reinterpret_cast<char*>(decompressed_values.data()), decompressed_values.size() * sizeof(int64_t));
+    REQUIRE(ErrorCode_Success == error_code);
+    REQUIRE(expected_values == decompressed_values);
+    reader_segment.close();
+
+    boost::system::error_code boost_error_code;
+    boost::filesystem::remove_all(segments_dir_path, boost_error_code);
+    REQUIRE(!boost_error_code);
+}
+
+TEST_CASE("Test appending encoded columns to a segment", "[Segment]") {
+    ErrorCode error_code;
+
+    string segments_dir_path = "unit-test-segment-encoded-columns/";
+    error_code = create_directory_structure(segments_dir_path, 0700);
+    REQUIRE(ErrorCode_Success == error_code);
+
+    // Timestamps that mostly increase, but sometimes go backwards or jump between extremes
+    vector<epochtime_t> timestamps;
+    epochtime_t timestamp = 1600000000000;
+    for (size_t i = 0; i < 100000; ++i) {
+        timestamp += (0 == i % 1000) ? -5000 : (int64_t)(i % 7);
+        timestamps.push_back(timestamp);
+    }
+    timestamps.push_back(cEpochTimeMax);
+    timestamps.push_back(cEpochTimeMin);
+    timestamps.push_back(0);
+
+    // Logtype IDs of several widths, including ones too wide to bit-pack
+    vector<vector<logtype_dictionary_id_t>> logtype_id_columns;
+    for (int64_t max_logtype_id : {0L, 1L, 5L, 1000L, (1L << 40) + 3, INT64_MAX}) {
+        vector<logtype_dictionary_id_t> logtype_ids;
+        for (size_t i = 0; i < 10001; ++i) {
+            logtype_ids.push_back((0 == i % 3) ? max_logtype_id : std::min((int64_t)i, max_logtype_id));
+        }
+        logtype_id_columns.push_back(logtype_ids);
+    }
+
+    // Variables of every type interleaved, including doubles which repeat, change sign, or are zero, and integers at the extremes
+    vector<encoded_variable_t> variables;
+    vector<column_encoding::VariableType> variable_types;
+    for (size_t i = 0; i < 30000; ++i) {
+        switch (i % 3) {
+            case 0:
+                variables.push_back(EncodedVariableInterpreter::get_var_dict_id_range_begin() + (encoded_variable_t)(i % 17));
+                variable_types.push_back(column_encoding::VariableType::DictionaryId);
+                break;
+            case 1:
+                variables.push_back((0 == i % 101) ? INT64_MIN : (0 == i % 103) ? INT64_MAX : (int64_t)(i * 37));
+                variable_types.push_back(column_encoding::VariableType::Integer);
+                break;
+            case 2: {
+                double value = (0 == i % 11) ? 0.0 : ((i % 5) - 2) * 0.125 * (double)(i / 20);
+                encoded_variable_t encoded_value;
+                memcpy(&encoded_value, &value, sizeof(value));
+                variables.push_back(encoded_value);
+                variable_types.push_back(column_encoding::VariableType::Double);
+                break;
+            }
+        }
+    }
+
+    writer::Segment writer_segment;
+    writer_segment.open(segments_dir_path, 0, 3);
+    auto segment_id = writer_segment.get_id();
+    uint64_t variables_offset;
+    writer_segment.append_variables(variables.data(), variable_types.data(), variables.size(), variables_offset);
+    uint64_t empty_variables_offset;
+    writer_segment.append_variables(nullptr, nullptr, 0, empty_variables_offset);
+    // The encoding should be smaller than the raw column
+    REQUIRE(writer_segment.get_uncompressed_size() < variables.size() * sizeof(encoded_variable_t));
+    uint64_t timestamps_offset;
+    writer_segment.append_timestamps(timestamps.data(), timestamps.size(), timestamps_offset);
+    uint64_t empty_timestamps_offset;
+    writer_segment.append_timestamps(nullptr, 0, empty_timestamps_offset);
+    vector<uint64_t> logtype_id_column_offsets;
+    for (const auto& logtype_ids : logtype_id_columns) {
+        uint64_t offset;
+        writer_segment.append_logtype_ids(logtype_ids.data(), logtype_ids.size(), offset);
+        logtype_id_column_offsets.push_back(offset);
+    }
+    // The last column again, grouped by logtype
+    const auto& ungrouped_logtype_ids = logtype_id_columns.back();
+    vector<uint64_t> message_numbers(ungrouped_logtype_ids.size());
+    for (size_t i = 0; i < message_numbers.size(); ++i) {
+        message_numbers[i] = i;
+    }
+    std::stable_sort(message_numbers.begin(), message_numbers.end(), [&ungrouped_logtype_ids] (uint64_t lhs, uint64_t rhs) {
+        return ungrouped_logtype_ids[lhs] < ungrouped_logtype_ids[rhs];
+    });
+    vector<logtype_dictionary_id_t> grouped_logtype_ids;
+    for (auto message_number : message_numbers) {
+        grouped_logtype_ids.push_back(ungrouped_logtype_ids[message_number]);
+    }
+    uint64_t grouped_logtype_ids_offset;
+    writer_segment.append_grouped_logtype_ids(grouped_logtype_ids.data(), message_numbers.data(), grouped_logtype_ids.size(),
+                                              grouped_logtype_ids_offset);
+    // The encodings should be smaller than the raw columns
+    REQUIRE(writer_segment.get_uncompressed_size() - timestamps_offset < timestamps.size() * sizeof(epochtime_t));
+    writer_segment.close();
+
+    // Read back and validate
+    reader::Segment reader_segment;
+    error_code = reader_segment.try_open(segments_dir_path, segment_id);
+    REQUIRE(ErrorCode_Success == error_code);
+    vector<epochtime_t> decoded_timestamps(timestamps.size());
+    error_code = reader_segment.try_read_timestamps(timestamps_offset, decoded_timestamps.data(), decoded_timestamps.size());
+    REQUIRE(ErrorCode_Success == error_code);
+    REQUIRE(timestamps == decoded_timestamps);
+    error_code = reader_segment.try_read_timestamps(empty_timestamps_offset, decoded_timestamps.data(), 0);
+    REQUIRE(ErrorCode_Success == error_code);
+    // Reading more values than the column contains should fail
+    error_code = reader_segment.try_read_timestamps(empty_timestamps_offset, decoded_timestamps.data(), 1);
+    REQUIRE(ErrorCode_Truncated == error_code);
+    for (size_t i = 0; i < logtype_id_columns.size(); ++i) {
+        const auto& logtype_ids = logtype_id_columns[i];
+        vector<logtype_dictionary_id_t> decoded_logtype_ids(logtype_ids.size());
+        vector<uint64_t> decoded_message_numbers;
+        error_code = reader_segment.try_read_logtype_ids(logtype_id_column_offsets[i], decoded_logtype_ids.data(), decoded_logtype_ids.size(),
+                                                         decoded_message_numbers);
+        REQUIRE(ErrorCode_Success == error_code);
+        REQUIRE(logtype_ids == decoded_logtype_ids);
+        REQUIRE(decoded_message_numbers.empty());
+    }
+    vector<logtype_dictionary_id_t> decoded_grouped_logtype_ids(grouped_logtype_ids.size());
+    vector<uint64_t> decoded_message_numbers;
+    error_code = reader_segment.try_read_logtype_ids(grouped_logtype_ids_offset, decoded_grouped_logtype_ids.data(), decoded_grouped_logtype_ids.size(),
+                                                     decoded_message_numbers);
+    REQUIRE(ErrorCode_Success == error_code);
+    REQUIRE(grouped_logtype_ids == decoded_grouped_logtype_ids);
+    REQUIRE(message_numbers == decoded_message_numbers);
+    vector<encoded_variable_t> decoded_variables(variables.size());
+    error_code = reader_segment.try_read_variables(variables_offset, decoded_variables.data(), decoded_variables.size());
+    REQUIRE(ErrorCode_Success == error_code);
+    REQUIRE(variables == decoded_variables);
+    error_code = reader_segment.try_read_variables(empty_variables_offset, decoded_variables.data(), 0);
+    REQUIRE(ErrorCode_Success == error_code);
+    reader_segment.close();
+
+    boost::system::error_code boost_error_code;
+    boost::filesystem::remove_all(segments_dir_path, boost_error_code);
+    REQUIRE(!boost_error_code);
+}
@@ -0,0 +1,102 @@
+// C++ standard libraries
+#include <set>
+#include <vector>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/SegmentIdSet.hpp"
+
+/**
+ * Creates a SegmentIdSet and the equivalent std::set from the given IDs
+ * @param ids
+ * @param segment_id_set
+ * @param reference_set
+ */
+static void create_sets (const std::vector<segment_id_t>& ids, SegmentIdSet& segment_id_set, std::set<segment_id_t>& reference_set) {
+    for (auto id : ids) {
+        segment_id_set.insert(id);
+        reference_set.insert(id);
+    }
+}
+
+/**
+ * Checks that the given SegmentIdSet contains exactly the IDs in the given std::set
+ * @param segment_id_set
+ * @param reference_set
+ */
+static void require_same_ids (const SegmentIdSet& segment_id_set, const std::set<segment_id_t>& reference_set) {
+    REQUIRE(reference_set.size() == segment_id_set.size());
+    REQUIRE(reference_set.empty() == segment_id_set.empty());
+    REQUIRE(std::vector<segment_id_t>(reference_set.cbegin(), reference_set.cend()) ==
+            std::vector<segment_id_t>(segment_id_set.begin(), segment_id_set.end()));
+    for (segment_id_t id = 0; id < 40; ++id) {
+        REQUIRE((reference_set.count(id) > 0) == segment_id_set.contains(id));
+    }
+}
+
+TEST_CASE("SegmentIdSet", "[SegmentIdSet]") {
+    SECTION("Insertion") {
+        SegmentIdSet segment_id_set;
+        std::set<segment_id_t> reference_set;
+        require_same_ids(segment_id_set, reference_set);
+
+        // Ascending IDs merge into runs
+        create_sets({0, 1, 2, 3, 10, 11, 12}, segment_id_set, reference_set);
+        require_same_ids(segment_id_set, reference_set);
+        REQUIRE(2 == segment_id_set.get_num_runs());
+
+        // Out-of-order IDs, including one which joins two runs and duplicates
+        create_sets({7, 5, 2, 20, 9, 8, 6, 4, 12}, segment_id_set, reference_set);
+        require_same_ids(segment_id_set, reference_set);
+        REQUIRE(2 == segment_id_set.get_num_runs());
+
+        segment_id_set.clear();
+        REQUIRE(segment_id_set.empty());
+    }
+
+    SECTION("Union and intersection") {
+        const std::vector<std::vector<segment_id_t>> id_lists = {
+                {},
+                {0},
+                {1, 2, 3, 4, 5, 6, 7, 8, 9, 10},
+                {0, 2, 4, 6, 8, 10, 12},
+                {5, 6, 7, 20, 21, 22, 23, 30},
+                {11, 12, 13, 19, 24, 29, 31},
+        };
+        for (const auto& ids : id_lists) {
+            for (const auto& other_ids : id_lists) {
+                SegmentIdSet segment_id_set;
+                std::set<segment_id_t> reference_set;
+                create_sets(ids, segment_id_set, reference_set);
+                SegmentIdSet other_segment_id_set;
+                std::set<segment_id_t> other_reference_set;
+                create_sets(other_ids, other_segment_id_set, other_reference_set);
+
+                auto union_set = segment_id_set;
+                union_set.union_with(other_segment_id_set);
+                std::set<segment_id_t> reference_union_set = reference_set;
+                reference_union_set.insert(other_reference_set.cbegin(), other_reference_set.cend());
+                require_same_ids(union_set, reference_union_set);
+
+                // Sets should have a single representation, regardless of how they were built
+                SegmentIdSet inserted_union_set;
+                for (auto id : reference_union_set) {
+                    inserted_union_set.insert(id);
+                }
+                REQUIRE(inserted_union_set == union_set);
+
+                auto intersection_set = segment_id_set;
+                intersection_set.intersect_with(other_segment_id_set);
+                std::set<segment_id_t> reference_intersection_set;
+                for (auto id : reference_set) {
+                    if (other_reference_set.count(id) > 0) {
+                        reference_intersection_set.insert(id);
+                    }
+                }
+                require_same_ids(intersection_set, reference_intersection_set);
+            }
+        }
+    }
+}
@@ -289,3 +289,71 @@ TEST_CASE("Test known timestamp patterns", "[KnownTimestampPatterns]") {
     pattern->insert_formatted_timestamp(timestamp, content);
     REQUIRE(line == content);
 }
+
+TEST_CASE("Test lines without known timestamp patterns", "[NoKnownTimestampPatterns]") {
+    TimestampPattern::init();
+
+    const TimestampPattern* pattern;
+    epochtime_t timestamp;
+    size_t timestamp_begin_pos;
+    size_t timestamp_end_pos;
+
+    const char* lines[] = {
+        "", " ", "\tat com.example.Foo.bar(Foo.java:42)", "Caused by: java.lang.IllegalStateException: content after",
+        "Jan 32 01:02:03 content after", "a b c d e f g h i j k", "2015-02-01", "... 12 more"
+    };
+    for (auto line : lines) {
+        pattern = TimestampPattern::search_known_ts_patterns(line, timestamp, timestamp_begin_pos, timestamp_end_pos);
+        REQUIRE(nullptr == pattern);
+        REQUIRE(std::string::npos == timestamp_begin_pos);
+        REQUIRE(std::string::npos == timestamp_end_pos);
+    }
+}
+
+TEST_CASE("Test formatting consecutive timestamps", "[FormatConsecutiveTimestamps]") {
+    TimestampPattern pattern(0, "%a %Y-%m-%d %H:%M:%S.%3 [%3]");
+
+    // Timestamps crossing millisecond, second, day, and epoch boundaries
+    epochtime_t timestamps[] = {
+        1422752523004, 1422752523004, 1422752523999, 1422752524000, 1422752524001, 1422835199999, 1422835200000, 1422752523004, 0, -1, -86400000,
+        -86400001
+    };
+    string content;
+    string expected_content;
+    epochtime_t timestamp;
+    size_t timestamp_begin_pos;
+    size_t timestamp_end_pos;
+    for (auto ts : timestamps) {
+        // Format with a fresh pattern (i.e., without any cached state) for comparison
+        TimestampPattern fresh_pattern(0, pattern.get_format());
+        expected_content = " content after";
+        fresh_pattern.insert_formatted_timestamp(ts, expected_content);
+
+        content = " content after";
+        pattern.insert_formatted_timestamp(ts, content);
+        REQUIRE(expected_content == content);
+
+        // Ensure the formatted timestamp can be parsed back
+        REQUIRE(pattern.parse_timestamp(content, timestamp, timestamp_begin_pos, timestamp_end_pos));
+        REQUIRE(ts == timestamp);
+    }
+}
+
+TEST_CASE("Test parsing consecutive timestamps", "[ParseConsecutiveTimestamps]") {
+    TimestampPattern pattern(0, "%Y-%m-%d %H:%M:%S,%3");
+    epochtime_t timestamp;
+    size_t timestamp_begin_pos;
+    size_t timestamp_end_pos;
+
+    REQUIRE(pattern.parse_timestamp("2015-02-28 23:59:59,999 content after", timestamp, timestamp_begin_pos, timestamp_end_pos));
+    REQUIRE(1425167999999 == timestamp);
+    REQUIRE(pattern.parse_timestamp("2015-02-28 00:00:00,000 content after", timestamp, timestamp_begin_pos, timestamp_end_pos));
+    REQUIRE(1425081600000 == timestamp);
+    REQUIRE(false == pattern.parse_timestamp("2015-02-29 00:00:00,000 content after", timestamp, timestamp_begin_pos, timestamp_end_pos));
+    REQUIRE(pattern.parse_timestamp("2015-03-01 00:00:00,000 content after", timestamp, timestamp_begin_pos, timestamp_end_pos));
+    REQUIRE(1425168000000 == timestamp);
+    REQUIRE(pattern.parse_timestamp("1969-12-31 23:59:59,999 content after", timestamp, timestamp_begin_pos, timestamp_end_pos));
+    REQUIRE(-1 == timestamp);
+    REQUIRE(pattern.parse_timestamp("1970-01-01 00:00:00,001 content after", timestamp, timestamp_begin_pos, timestamp_end_pos));
+    REQUIRE(1 == timestamp);
+}
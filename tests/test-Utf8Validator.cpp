@@ -0,0 +1,161 @@
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <string>
+
+// Catch2
+#include "../submodules/Catch2/single_include/catch2/catch.hpp"
+
+// Project headers
+#include "../src/Utf8ValidatingReader.hpp"
+#include "../src/Utf8Validator.hpp"
+
+using std::string;
+
+/**
+ * Reader over an in-memory string which returns at most a fixed number of bytes per read
+ */
+class FixedChunkStringReader : public ReaderInterface {
+public:
+    // Constructors
+    FixedChunkStringReader (const string& str, size_t max_chunk_size) : m_str(str), m_max_chunk_size(max_chunk_size), m_pos(0) {}
+
+    // Methods
+    ErrorCode try_read (char* buf, size_t num_bytes_to_read, size_t& num_bytes_read) override {
+        if (m_str.length() == m_pos) {
+            return ErrorCode_EndOfFile;
+        }
+        num_bytes_read = std::min({num_bytes_to_read, m_max_chunk_size, m_str.length() - m_pos});
+        memcpy(buf, m_str.data() + m_pos, num_bytes_read);
+        m_pos += num_bytes_read;
+        return ErrorCode_Success;
+    }
+    ErrorCode try_seek_from_begin (size_t pos) override {
+        return ErrorCode_Unsupported;
+    }
+    ErrorCode try_get_pos (size_t& pos) override {
+        pos = m_pos;
+        return ErrorCode_Success;
+    }
+
+private:
+    const string& m_str;
+    size_t m_max_chunk_size;
+    size_t m_pos;
+};
+
+/**
+ * Validates the given content one byte at a time
+ * @param content
+ * @return Whether the content is valid
+ */
+static bool validate_bytewise (const string& content) {
+    Utf8Validator validator;
+    for (auto c : content) {
+        if (false == validator.validate(&c, 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Utf8Validator", "[Utf8Validator]") {
+    // Mix of ASCII, 2-byte, 3-byte, and 4-byte characters
+    const string characters[] = {"a", "Z", " ", "\n", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80"};
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<size_t> character_distribution(0, std::size(characters) - 1);
+
+    string content;
+    while (content.length() < 4096) {
+        content += characters[character_distribution(generator)];
+    }
+
+    SECTION("Valid content") {
+        Utf8Validator validator;
+        REQUIRE(validator.validate(content.data(), content.length()));
+
+        // Validate in chunks that split blocks and characters at every offset
+        for (size_t chunk_size = 1; chunk_size <= 130; ++chunk_size) {
+            validator.reset();
+            for (size_t pos = 0; pos < content.length(); pos += chunk_size) {
+                REQUIRE(validator.validate(content.data() + pos, std::min(chunk_size, content.length() - pos)));
+            }
+        }
+
+        // Content that's all ASCII
+        string ascii_content(1000, 'x');
+        validator.reset();
+        REQUIRE(validator.validate(ascii_content.data(), ascii_content.length()));
+    }
+
+    SECTION("Invalid content") {
+        Utf8Validator validator;
+
+        // Truncated character at the end of a chunk is only invalid if the next chunk doesn't continue it
+        string truncated_character = "\xE2\x82";
+        REQUIRE(validator.validate(truncated_character.data(), truncated_character.length()));
+        REQUIRE(validator.validate("\xAC", 1));
+        REQUIRE(validator.validate(truncated_character.data(), truncated_character.length()));
+        REQUIRE(false == validator.validate("a", 1));
+        REQUIRE(false == validator.is_valid());
+        // Once invalid, the validator stays invalid until it's reset
+        REQUIRE(false == validator.validate("a", 1));
+        validator.reset();
+        REQUIRE(validator.validate("a", 1));
+
+        // Corrupt each byte position in turn and compare with validating one byte at a time
+        const char invalid_bytes[] = {'\x80', '\xBF', '\xC3', '\xE2', '\xF0', '\xF8', '\xFF'};
+        for (size_t pos = 0; pos < 200; ++pos) {
+            for (auto invalid_byte : invalid_bytes) {
+                auto corrupted_content = content;
+                corrupted_content[pos] = invalid_byte;
+                validator.reset();
+                REQUIRE(validator.validate(corrupted_content.data(), corrupted_content.length()) == validate_bytewise(corrupted_content));
+            }
+        }
+    }
+}
+
+TEST_CASE("Utf8ValidatingReader", "[Utf8ValidatingReader]") {
+    string content;
+    for (size_t i = 0; content.length() < 10000; ++i) {
+        content += "Message " + std::to_string(i) + " \xE2\x82\xAC\n";
+    }
+    constexpr size_t cInvalidPos = 7000;
+    auto invalid_content = content;
+    invalid_content[cInvalidPos] = '\xFF';
+
+    constexpr size_t cChunkSize = 1000;
+    char buf[cChunkSize];
+    size_t num_bytes_read;
+    Utf8Validator validator;
+    Utf8ValidatingReader validating_reader;
+
+    // Valid content should be read in full
+    FixedChunkStringReader reader(content, cChunkSize);
+    validating_reader.open(reader, validator);
+    string content_read;
+    while (ErrorCode_Success == validating_reader.try_read(buf, cChunkSize, num_bytes_read)) {
+        content_read.append(buf, num_bytes_read);
+    }
+    REQUIRE(content == content_read);
+    REQUIRE(validator.is_valid());
+    REQUIRE(content.length() == validating_reader.get_pos());
+    validating_reader.close();
+
+    // Invalid content should end the read before the chunk containing it
+    validator.reset();
+    FixedChunkStringReader invalid_reader(invalid_content, cChunkSize);
+    validating_reader.open(invalid_reader, validator);
+    content_read.clear();
+    while (ErrorCode_Success == validating_reader.try_read(buf, cChunkSize, num_bytes_read)) {
+        content_read.append(buf, num_bytes_read);
+    }
+    REQUIRE(false == validator.is_valid());
+    REQUIRE(cInvalidPos / cChunkSize * cChunkSize == content_read.length());
+    REQUIRE(content_read.length() == validating_reader.get_pos());
+    REQUIRE(ErrorCode_EndOfFile == validating_reader.try_read(buf, cChunkSize, num_bytes_read));
+    validating_reader.close();
+}
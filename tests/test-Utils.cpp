@@ -15,6 +15,7 @@
 
 // Project headers
 #include "../src/Utils.hpp"
+#include "../src/VariableTokenizer.hpp"
 
 using namespace std;
 
@@ -233,6 +234,33 @@ TEST_CASE("get_bounds_of_next_var", "[get_bounds_of_next_var]") {
     REQUIRE(str.length() == begin_pos);
 }
 
+TEST_CASE("VariableTokenizer", "[get_bounds_of_next_var][VariableTokenizer]") {
+    // Tokens that span the tokenizer's blocks, including a token longer than a block
+    string str = string(VariableTokenizer::cBlockSize - 2, ' ') + "0x1f2e " + string(VariableTokenizer::cBlockSize, 'a') + "9 key=value deadbeef. " +
+            "/path/to/file.txt xyz -cd- +42 \\x7f \xff";
+    vector<string> expected_vars = {"0x1f2e", string(VariableTokenizer::cBlockSize, 'a') + "9", "value", "deadbeef", "+42", "x7f"};
+
+    VariableTokenizer tokenizer(str);
+    size_t token_end_pos = 0;
+    size_t begin_pos = 0;
+    size_t end_pos = 0;
+    size_t single_call_token_end_pos = 0;
+    size_t single_call_begin_pos = 0;
+    size_t single_call_end_pos = 0;
+    for (const auto& expected_var : expected_vars) {
+        REQUIRE(tokenizer.get_bounds_of_next_var(token_end_pos, begin_pos, end_pos));
+        REQUIRE(expected_var == str.substr(begin_pos, end_pos - begin_pos));
+
+        // Tokenizing the rest of the message from scratch should produce the same result
+        REQUIRE(get_bounds_of_next_var(str, single_call_token_end_pos, single_call_begin_pos, single_call_end_pos));
+        REQUIRE(single_call_token_end_pos == token_end_pos);
+        REQUIRE(single_call_begin_pos == begin_pos);
+        REQUIRE(single_call_end_pos == end_pos);
+    }
+    REQUIRE(false == tokenizer.get_bounds_of_next_var(token_end_pos, begin_pos, end_pos));
+    REQUIRE(str.length() == begin_pos);
+}
+
 TEST_CASE("get_bounds_of_next_potential_var", "[get_bounds_of_next_potential_var]") {
     string str;
     size_t begin_pos;